@@ -0,0 +1,77 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "async_pipelines.h"
+
+#include "rendering/render_context.h"
+#include "vulkan_sample.h"
+
+namespace plugins
+{
+AsyncPipelines::AsyncPipelines() :
+    AsyncPipelinesTags("Async Pipelines",
+                       "Build graphics pipelines on worker threads.",
+                       {vkb::Hook::OnAppStart, vkb::Hook::PostDraw, vkb::Hook::OnAppClose},
+                       {&async_pipelines_flag})
+{
+}
+
+bool AsyncPipelines::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&async_pipelines_flag);
+}
+
+void AsyncPipelines::init(const vkb::CommandParser &parser)
+{
+}
+
+void AsyncPipelines::on_app_start(const std::string &app_id)
+{
+	total_stats = {};
+
+	// Only vkb::CommandBuffer flushes pipelines asynchronously
+	if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample<vkb::BindingType::C> *>(&platform->get_app()))
+	{
+		vulkan_app->get_render_context().get_device().get_resource_cache().set_async_pipeline_compilation(true);
+	}
+	else
+	{
+		LOGW("Asynchronous pipeline compilation is not supported by {}", app_id);
+	}
+}
+
+void AsyncPipelines::on_post_draw(vkb::RenderContext &context)
+{
+	auto stats = context.get_device().get_resource_cache().get_pipeline_compilation_stats();
+
+	if (stats.deferred_draws > 0 || stats.fallback_draws > 0)
+	{
+		LOGD("Pipelines still building: {} draws deferred, {} draws with a fallback pipeline", stats.deferred_draws, stats.fallback_draws);
+	}
+
+	total_stats.deferred_draws += stats.deferred_draws;
+	total_stats.fallback_draws += stats.fallback_draws;
+	total_stats.compiled_pipelines += stats.compiled_pipelines;
+	total_stats.compile_time_ms += stats.compile_time_ms;
+}
+
+void AsyncPipelines::on_app_close(const std::string &app_id)
+{
+	LOGI("Async pipelines for {}: {} pipelines built in {:.1f} ms, {} draws deferred, {} draws with a fallback pipeline",
+	     app_id, total_stats.compiled_pipelines, total_stats.compile_time_ms, total_stats.deferred_draws, total_stats.fallback_draws);
+}
+}        // namespace plugins
@@ -0,0 +1,59 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+#include "resource_cache.h"
+
+namespace plugins
+{
+using AsyncPipelinesTags = vkb::PluginBase<vkb::tags::Passive>;
+
+/**
+ * @brief Async Pipelines
+ *
+ * Builds missing graphics pipelines on worker threads instead of stalling the frame which first needs them.
+ * Until a pipeline is ready, its draws use a compatible fallback pipeline or are skipped.
+ * The number of deferred draws and the compilation time are logged when an app closes.
+ *
+ * Usage: vulkan_sample sample afbc --async-pipelines
+ *
+ */
+class AsyncPipelines : public AsyncPipelinesTags
+{
+  public:
+	AsyncPipelines();
+
+	virtual ~AsyncPipelines() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	void on_app_start(const std::string &app_id) override;
+
+	void on_post_draw(vkb::RenderContext &context) override;
+
+	void on_app_close(const std::string &app_id) override;
+
+	vkb::FlagCommand async_pipelines_flag = {vkb::FlagType::FlagOnly, "async-pipelines", "", "Build graphics pipelines on worker threads"};
+
+  private:
+	vkb::PipelineCompilationStats total_stats;
+};
+}        // namespace plugins
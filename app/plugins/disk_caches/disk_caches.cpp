@@ -0,0 +1,80 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disk_caches.h"
+
+#include "filesystem/filesystem.hpp"
+#include "scene_graph/components/image/astc_cache.h"
+#include "shader_cache.h"
+
+namespace plugins
+{
+DiskCaches::DiskCaches() :
+    DiskCachesTags("Disk Caches",
+                   "Cache compiled shaders and CPU-decoded ASTC images on disk across runs.",
+                   {vkb::Hook::OnAppStart, vkb::Hook::OnAppClose},
+                   {&shader_cache_flag, &shader_cache_path_flag, &astc_cache_flag, &astc_cache_path_flag})
+{
+}
+
+bool DiskCaches::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&shader_cache_flag) || parser.contains(&shader_cache_path_flag) ||
+	       parser.contains(&astc_cache_flag) || parser.contains(&astc_cache_path_flag);
+}
+
+void DiskCaches::init(const vkb::CommandParser &parser)
+{
+	enable_cache(parser, vkb::ShaderCache::get_disk_cache(), shader_cache_flag, shader_cache_path_flag, "shader_cache");
+	enable_cache(parser, vkb::sg::AstcCache::get_disk_cache(), astc_cache_flag, astc_cache_path_flag, "astc_cache");
+}
+
+void DiskCaches::on_app_start(const std::string &app_id)
+{
+	for (auto *cache : caches)
+	{
+		cache->reset_stats();
+	}
+}
+
+void DiskCaches::on_app_close(const std::string &app_id)
+{
+	for (auto *cache : caches)
+	{
+		auto stats = cache->get_stats();
+		LOGI("{} cache for {}: {} hits, {} misses, {:.1f} ms saved", cache->get_name(), app_id, stats.hits, stats.misses, stats.time_saved_ms);
+	}
+}
+
+void DiskCaches::enable_cache(const vkb::CommandParser &parser, vkb::DiskCache &cache, vkb::FlagCommand &flag, vkb::FlagCommand &path_flag, const std::string &default_folder)
+{
+	if (parser.contains(&path_flag))
+	{
+		cache.enable(parser.as<std::string>(&path_flag));
+	}
+	else if (parser.contains(&flag))
+	{
+		cache.enable((vkb::filesystem::get()->temp_directory() / default_folder).string());
+	}
+	else
+	{
+		return;
+	}
+
+	caches.push_back(&cache);
+}
+}        // namespace plugins
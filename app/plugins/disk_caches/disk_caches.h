@@ -0,0 +1,76 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "platform/plugins/plugin_base.h"
+
+namespace vkb
+{
+class DiskCache;
+}        // namespace vkb
+
+namespace plugins
+{
+using DiskCachesTags = vkb::PluginBase<vkb::tags::Passive>;
+
+/**
+ * @brief Disk Caches
+ *
+ * Stores compiled SPIR-V and reflection data, and ASTC images decoded on the CPU (on devices without ASTC support)
+ * together with their generated mip chain, on disk, so that subsequent runs skip compiling and decoding them.
+ * The number of cache hits and misses and the time saved by each enabled cache are logged when an app closes.
+ *
+ * Usage: vulkan_sample sample afbc --shader-cache --astc-cache
+ *        vulkan_sample sample afbc --shader-cache-path <folder> --astc-cache-path <folder>
+ *
+ */
+class DiskCaches : public DiskCachesTags
+{
+  public:
+	DiskCaches();
+
+	virtual ~DiskCaches() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	void on_app_start(const std::string &app_id) override;
+
+	void on_app_close(const std::string &app_id) override;
+
+	vkb::FlagCommand shader_cache_flag = {vkb::FlagType::FlagOnly, "shader-cache", "", "Cache compiled shaders on disk"};
+
+	vkb::FlagCommand shader_cache_path_flag = {vkb::FlagType::OneValue, "shader-cache-path", "", "Folder to store the shader cache in (defaults to the temporary directory)"};
+
+	vkb::FlagCommand astc_cache_flag = {vkb::FlagType::FlagOnly, "astc-cache", "", "Cache CPU-decoded ASTC images on disk"};
+
+	vkb::FlagCommand astc_cache_path_flag = {vkb::FlagType::OneValue, "astc-cache-path", "", "Folder to store the ASTC decode cache in (defaults to the temporary directory)"};
+
+  private:
+	/**
+	 * @brief Enables a cache if its flag or its path flag is set
+	 * @param default_folder The folder in the temporary directory used when the path flag is not set
+	 */
+	void enable_cache(const vkb::CommandParser &parser, vkb::DiskCache &cache, vkb::FlagCommand &flag, vkb::FlagCommand &path_flag, const std::string &default_folder);
+
+	std::vector<vkb::DiskCache *> caches;
+};
+}        // namespace plugins
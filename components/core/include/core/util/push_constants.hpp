@@ -0,0 +1,63 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+/**
+ * @brief Appends byte data to the push constants stored for the next draw call
+ *        The storage keeps its capacity when cleared, so this does not allocate once it has grown.
+ * @param stored_push_constants The push constants stored so far
+ * @param data The byte data to append
+ * @param size The amount of bytes to append
+ * @param max_push_constants_size The push constant limit of the device
+ * @throws std::runtime_error if the push constant limit is exceeded
+ */
+template <class Allocator>
+inline void append_push_constants(std::vector<uint8_t, Allocator> &stored_push_constants, const uint8_t *data, size_t size, uint32_t max_push_constants_size)
+{
+	size_t push_constant_size = stored_push_constants.size() + size;
+
+	if (push_constant_size > max_push_constants_size)
+	{
+		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, size, push_constant_size);
+		throw std::runtime_error("Push constant limit exceeded.");
+	}
+
+	stored_push_constants.insert(stored_push_constants.end(), data, data + size);
+}
+
+/**
+ * @brief Appends the bytes of a value to the push constants stored for the next draw call, without any intermediate copy
+ */
+template <class Allocator, class T>
+inline void append_push_constants(std::vector<uint8_t, Allocator> &stored_push_constants, const T &value, uint32_t max_push_constants_size)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Push constants are copied byte by byte");
+
+	append_push_constants(stored_push_constants, reinterpret_cast<const uint8_t *>(&value), sizeof(T), max_push_constants_size);
+}
+}        // namespace vkb
@@ -0,0 +1,89 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Stable least significant digit radix sort of elements by a 64-bit key, one byte per pass
+ *
+ * Passes over a byte that is the same in every key are skipped, so keys that only use a few bits sort faster.
+ * The sorted elements end up in items, which may have swapped storage with scratch.
+ * Once both vectors have grown to the number of elements, sorting does not allocate anymore.
+ *
+ * @param items The elements to sort
+ * @param scratch Temporary storage, reused between sorts
+ * @param get_key Returns the uint64_t key of an element
+ */
+template <typename T, typename KeyFunc>
+void radix_sort(std::vector<T> &items, std::vector<T> &scratch, KeyFunc get_key)
+{
+	constexpr size_t pass_count = sizeof(uint64_t);
+
+	if (items.size() < 2)
+	{
+		return;
+	}
+
+	std::array<std::array<size_t, 256>, pass_count> histograms{};
+
+	for (auto &item : items)
+	{
+		uint64_t key = get_key(item);
+		for (size_t pass = 0; pass < pass_count; ++pass)
+		{
+			histograms[pass][(key >> (pass * 8)) & 0xff]++;
+		}
+	}
+
+	scratch.resize(items.size());
+
+	for (size_t pass = 0; pass < pass_count; ++pass)
+	{
+		auto &histogram = histograms[pass];
+		auto  shift     = pass * 8;
+
+		if (histogram[(get_key(items.front()) >> shift) & 0xff] == items.size())
+		{
+			continue;
+		}
+
+		// Turn the counts into the first output position of each byte value
+		size_t offset = 0;
+		for (auto &count : histogram)
+		{
+			size_t bucket_size = count;
+			count              = offset;
+			offset += bucket_size;
+		}
+
+		for (auto &item : items)
+		{
+			scratch[histogram[(get_key(item) >> shift) & 0xff]++] = std::move(item);
+		}
+
+		items.swap(scratch);
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,495 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <ctpl_stl.h>
+
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+/**
+ * @brief Usage statistics of one type of cached resources
+ */
+struct ResourceCacheTypeStats
+{
+	/// Number of resources in the cache
+	size_t entries{0};
+
+	size_t hits{0};
+
+	size_t misses{0};
+
+	/// Number of resources whose hash collided with a resource cached under a different key
+	size_t collisions{0};
+
+	/// Number of resources evicted to stay within the budget
+	size_t evictions{0};
+};
+
+/**
+ * @brief Bookkeeping of one resource in the cache
+ */
+struct ResourceCacheEntry
+{
+	/// Hash of the resource, which may differ from its slot if it collided with another resource
+	std::size_t hash{0};
+
+	/// Full key of the resource, compared on lookup when the hashes match so that resources with colliding hashes never alias
+	std::string key;
+
+	/// Frame in which the resource was last requested
+	std::atomic<uint64_t> last_used_frame{0};
+
+	/// Set once the resource is removed, the entry stays so that lookups still probe past it to colliding resources
+	bool removed{false};
+};
+
+/**
+ * @brief Synchronizes access to one map of the resource cache
+ *
+ * Lookups of cached resources only take a shared lock, so hits never wait on each other.
+ * A miss registers a future for its key before building the resource outside of the lock,
+ * so that misses for distinct keys build in parallel and duplicate misses wait on the same build.
+ *
+ * Resources are stored in the slot of their hash. A resource whose hash collides with the one of another key
+ * takes the next free slot, so a lookup probes the slots from its hash onwards until it finds its full key.
+ * Removing a resource leaves a tombstone in its slot, so that the resources after it remain reachable.
+ */
+struct ResourceCacheLock
+{
+	/**
+	 * @brief Finds the slot of a resource which is either cached or being built
+	 * @param hash The hash of the resource
+	 * @param matches Called with the full key of each entry with the same hash, returns true if it is the key of the resource
+	 * @param[out] slot The slot of the resource if found, otherwise the first free or removed slot from its hash onwards
+	 * @return True if the resource was found
+	 */
+	template <class M>
+	bool find_slot(std::size_t hash, const M &matches, std::size_t &slot) const;
+
+	/**
+	 * @brief Finds the slot of a resource by its full key
+	 */
+	bool find_slot(std::size_t hash, const std::string &key, std::size_t &slot) const;
+
+	/**
+	 * @brief Reserves a slot returned by find_slot for a resource
+	 * @param slot The slot to reserve
+	 * @param hash The hash of the resource
+	 * @param key The full key of the resource
+	 * @param frame The current frame
+	 */
+	void insert(std::size_t slot, std::size_t hash, const std::string &key, uint64_t frame);
+
+	/**
+	 * @brief Returns a resource, building it only if it is neither cached nor being built by another thread
+	 *        Hits only share the lock. The resource is built outside of the lock, and concurrent requests for it wait for that build.
+	 * @param resources The resources guarded by this lock
+	 * @param hash The hash of the resource
+	 * @param matches Called with the full key of each entry with the same hash, returns true if it is the key of the resource
+	 * @param make_key Returns the full key of the resource, only called on a miss
+	 * @param frame The current frame
+	 * @param build Returns the built resource
+	 * @param on_built Called with the resource once it is cached, before the requests waiting for it return
+	 * @param[out] slot The slot the resource is stored in
+	 */
+	template <class T, class M, class K, class B, class R>
+	T &request(std::unordered_map<std::size_t, T> &resources, std::size_t hash, const M &matches, const K &make_key, uint64_t frame, const B &build, const R &on_built, std::size_t &slot);
+
+	/**
+	 * @brief Builds the resources of a batch of requests in parallel, skipping the ones which are already cached or requested twice
+	 *        The resources are then found by request(), which waits for the ones another thread is still building.
+	 * @param resources The resources guarded by this lock
+	 * @param hashes The hash of each request
+	 * @param keys The full key of each request
+	 * @param frame The current frame
+	 * @param get_thread_pool Returns the pool which builds the resources, only called if there are resources to build
+	 * @param build Returns the built resource of a request, given its index
+	 * @param on_built Called with the index of a request and its resource once it is cached
+	 */
+	template <class T, class P, class B, class R>
+	void build_batch(std::unordered_map<std::size_t, T> &resources, const std::vector<std::size_t> &hashes, const std::vector<std::string> &keys, uint64_t frame, const P &get_thread_pool, const B &build, const R &on_built);
+
+	/**
+	 * @brief Removes the entry of a resource, leaving a tombstone unless no resource is stored after it
+	 * @param slot The slot of the resource
+	 */
+	void remove(std::size_t slot);
+
+	/**
+	 * @brief Evicts the least recently used resources until the budget is met
+	 *        Resources used by frames which may still be in flight are kept, even if that exceeds the budget.
+	 * @param resources The resources guarded by this lock
+	 * @param frame The current frame
+	 * @param frames_in_flight The number of frames which may still be executing on the GPU
+	 */
+	template <class T>
+	void evict(std::unordered_map<std::size_t, T> &resources, uint64_t frame, uint32_t frames_in_flight);
+
+	ResourceCacheTypeStats get_stats();
+
+	void clear();
+
+	std::shared_mutex mutex;
+
+	std::unordered_map<std::size_t, std::shared_future<void>> in_flight;
+
+	std::unordered_map<std::size_t, ResourceCacheEntry> entries;
+
+	/// Number of entries which are tombstones of removed resources
+	size_t removed_entries{0};
+
+	size_t budget{0};
+
+	std::atomic<size_t> hits{0};
+
+	std::atomic<size_t> misses{0};
+
+	std::atomic<size_t> collisions{0};
+
+	std::atomic<size_t> evictions{0};
+};
+
+template <class M>
+bool ResourceCacheLock::find_slot(std::size_t hash, const M &matches, std::size_t &slot) const
+{
+	bool        found_removed{false};
+	std::size_t removed_slot{hash};
+
+	for (std::size_t probe = hash;; ++probe)
+	{
+		auto entry_it = entries.find(probe);
+		if (entry_it == entries.end())
+		{
+			// Reuse the first tombstone on the way, as the key is not stored anywhere after it
+			slot = found_removed ? removed_slot : probe;
+			return false;
+		}
+
+		if (entry_it->second.removed)
+		{
+			if (!found_removed)
+			{
+				found_removed = true;
+				removed_slot  = probe;
+			}
+		}
+		else if (entry_it->second.hash == hash && matches(entry_it->second.key))
+		{
+			slot = probe;
+			return true;
+		}
+	}
+}
+
+template <class T>
+void ResourceCacheLock::evict(std::unordered_map<std::size_t, T> &resources, uint64_t frame, uint32_t frames_in_flight)
+{
+	std::lock_guard<std::shared_mutex> guard(mutex);
+
+	if (budget == 0 || resources.size() <= budget)
+	{
+		return;
+	}
+
+	std::vector<std::pair<uint64_t, std::size_t>> candidates;
+	for (auto &entry : entries)
+	{
+		auto last_used_frame = entry.second.last_used_frame.load();
+		if (!entry.second.removed && last_used_frame + frames_in_flight <= frame && resources.find(entry.first) != resources.end())
+		{
+			candidates.emplace_back(last_used_frame, entry.first);
+		}
+	}
+
+	auto count = std::min(resources.size() - budget, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		resources.erase(candidates[i].second);
+		remove(candidates[i].second);
+	}
+
+	evictions += count;
+}
+
+template <class T, class M, class K, class B, class R>
+T &ResourceCacheLock::request(std::unordered_map<std::size_t, T> &resources, std::size_t hash, const M &matches, const K &make_key, uint64_t frame, const B &build, const R &on_built, std::size_t &slot)
+{
+	slot = hash;
+
+	// Concurrent hits only share the lock
+	{
+		std::shared_lock<std::shared_mutex> guard(mutex);
+
+		if (find_slot(hash, matches, slot))
+		{
+			auto res_it = resources.find(slot);
+			if (res_it != resources.end())
+			{
+				entries.at(slot).last_used_frame = frame;
+				hits++;
+				return res_it->second;
+			}
+		}
+	}
+
+	std::promise<void> build_promise;
+
+	{
+		std::unique_lock<std::shared_mutex> guard(mutex);
+
+		if (find_slot(hash, matches, slot))
+		{
+			entries.at(slot).last_used_frame = frame;
+			hits++;
+
+			auto res_it = resources.find(slot);
+			if (res_it != resources.end())
+			{
+				return res_it->second;
+			}
+
+			// Another thread is already building this resource, wait for it rather than building a duplicate
+			auto build_future = in_flight.at(slot);
+			guard.unlock();
+
+			// Rethrows if the other thread failed to build the resource
+			build_future.get();
+
+			std::shared_lock<std::shared_mutex> shared_guard(mutex);
+			return resources.at(slot);
+		}
+
+		if (slot != hash)
+		{
+			collisions++;
+		}
+		misses++;
+
+		// Reserve the slot, so that requests for the same key wait for this build and colliding keys probe past it
+		insert(slot, hash, make_key(), frame);
+
+		in_flight.emplace(slot, build_promise.get_future().share());
+	}
+
+	const char *res_type = typeid(T).name();
+
+	LOGD("Building cache object ({})", res_type);
+
+	try
+	{
+		// Build outside of the lock, so that misses for distinct keys build in parallel
+		T resource = build();
+
+		std::unique_lock<std::shared_mutex> guard(mutex);
+
+		T &res = resources.emplace(slot, std::move(resource)).first->second;
+		in_flight.erase(slot);
+
+		guard.unlock();
+
+		on_built(res);
+
+		build_promise.set_value();
+
+		return res;
+	}
+	catch (const std::exception &)
+	{
+		LOGE("Creation error for cache object ({})", res_type);
+
+		{
+			std::lock_guard<std::shared_mutex> guard(mutex);
+			in_flight.erase(slot);
+			remove(slot);
+		}
+
+		build_promise.set_exception(std::current_exception());
+		throw;
+	}
+}
+
+template <class T, class P, class B, class R>
+void ResourceCacheLock::build_batch(std::unordered_map<std::size_t, T> &resources, const std::vector<std::size_t> &hashes, const std::vector<std::string> &keys, uint64_t frame, const P &get_thread_pool, const B &build, const R &on_built)
+{
+	// Collect the first request of every resource which is not cached yet
+	std::vector<size_t> pending;
+	{
+		std::shared_lock<std::shared_mutex> guard(mutex);
+
+		std::unordered_set<std::string> unique_keys;
+		for (size_t i = 0; i < hashes.size(); ++i)
+		{
+			std::size_t slot;
+			if (!find_slot(hashes[i], keys[i], slot) && unique_keys.insert(keys[i]).second)
+			{
+				pending.push_back(i);
+			}
+		}
+	}
+
+	if (pending.empty())
+	{
+		return;
+	}
+
+	ctpl::thread_pool &thread_pool = get_thread_pool();
+
+	LOGD("Building {} cache objects ({}) on {} threads", pending.size(), typeid(T).name(), thread_pool.size());
+
+	std::vector<std::future<T>> futures;
+	futures.reserve(pending.size());
+	for (auto index : pending)
+	{
+		futures.push_back(thread_pool.push([&build, index](size_t) { return build(index); }));
+	}
+
+	// The workers reference the build function, so all of them must finish before a build error is rethrown
+	for (auto &future : futures)
+	{
+		future.wait();
+	}
+
+	std::vector<T> built;
+	built.reserve(pending.size());
+	for (auto &future : futures)
+	{
+		built.push_back(future.get());
+	}
+
+	std::lock_guard<std::shared_mutex> guard(mutex);
+
+	for (size_t i = 0; i < pending.size(); ++i)
+	{
+		auto index = pending[i];
+
+		// Another thread may have built the same resource in the meantime, in which case ours is discarded
+		std::size_t slot;
+		if (find_slot(hashes[index], keys[index], slot))
+		{
+			continue;
+		}
+
+		if (slot != hashes[index])
+		{
+			collisions++;
+		}
+		misses++;
+
+		insert(slot, hashes[index], keys[index], frame);
+
+		auto &resource = resources.emplace(slot, std::move(built[i])).first->second;
+		on_built(index, resource);
+	}
+}
+
+inline bool ResourceCacheLock::find_slot(std::size_t hash, const std::string &key, std::size_t &slot) const
+{
+	return find_slot(
+	    hash, [&key](const std::string &stored_key) { return stored_key == key; }, slot);
+}
+
+inline void ResourceCacheLock::insert(std::size_t slot, std::size_t hash, const std::string &key, uint64_t frame)
+{
+	auto &entry = entries[slot];
+	if (entry.removed)
+	{
+		entry.removed = false;
+		removed_entries--;
+	}
+
+	entry.hash            = hash;
+	entry.key             = key;
+	entry.last_used_frame = frame;
+}
+
+inline void ResourceCacheLock::remove(std::size_t slot)
+{
+	auto &entry = entries.at(slot);
+	entry.key.clear();
+	entry.removed = true;
+	removed_entries++;
+
+	// Lookups stop at the first free slot, so the tombstones just before one are not needed to reach any resource
+	if (entries.find(slot + 1) != entries.end())
+	{
+		return;
+	}
+
+	for (auto entry_it = entries.find(slot); entry_it != entries.end() && entry_it->second.removed; entry_it = entries.find(--slot))
+	{
+		entries.erase(entry_it);
+		removed_entries--;
+	}
+}
+
+inline ResourceCacheTypeStats ResourceCacheLock::get_stats()
+{
+	std::shared_lock<std::shared_mutex> guard(mutex);
+
+	ResourceCacheTypeStats stats;
+	stats.entries    = entries.size() - in_flight.size() - removed_entries;
+	stats.hits       = hits;
+	stats.misses     = misses;
+	stats.collisions = collisions;
+	stats.evictions  = evictions;
+
+	return stats;
+}
+
+inline void ResourceCacheLock::clear()
+{
+	std::lock_guard<std::shared_mutex> guard(mutex);
+
+	if (in_flight.empty())
+	{
+		entries.clear();
+		removed_entries = 0;
+		return;
+	}
+
+	// Resources being built keep their slot, and the others leave tombstones so that lookups still reach them
+	for (auto &entry : entries)
+	{
+		if (!entry.second.removed && in_flight.find(entry.first) == in_flight.end())
+		{
+			entry.second.key.clear();
+			entry.second.removed = true;
+			removed_entries++;
+		}
+	}
+}
+}        // namespace vkb
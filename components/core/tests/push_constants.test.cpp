@@ -0,0 +1,141 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <memory>
+
+#include <core/util/push_constants.hpp>
+
+using namespace vkb;
+
+namespace
+{
+/// Number of allocations made through CountingAllocator, which the tests sample around the code they check
+size_t allocation_count = 0;
+
+template <class T>
+struct CountingAllocator
+{
+	using value_type = T;
+
+	CountingAllocator() = default;
+
+	template <class U>
+	CountingAllocator(const CountingAllocator<U> &)
+	{}
+
+	T *allocate(size_t count)
+	{
+		allocation_count++;
+		return std::allocator<T>{}.allocate(count);
+	}
+
+	void deallocate(T *ptr, size_t count)
+	{
+		std::allocator<T>{}.deallocate(ptr, count);
+	}
+
+	bool operator==(const CountingAllocator &) const
+	{
+		return true;
+	}
+
+	bool operator!=(const CountingAllocator &) const
+	{
+		return false;
+	}
+};
+
+using ByteVector = std::vector<uint8_t, CountingAllocator<uint8_t>>;
+
+struct PushConstants
+{
+	float model[16];
+
+	uint32_t material_index;
+};
+
+constexpr uint32_t MAX_PUSH_CONSTANTS_SIZE = 128;
+}        // namespace
+
+TEST_CASE("vkb::append_push_constants does not allocate once the storage has grown", "[push_constants]")
+{
+	constexpr size_t frame_count     = 100;
+	constexpr size_t draws_per_frame = 64;
+
+	ByteVector           stored_push_constants;
+	PushConstants        push_constants{};
+
+	auto record_frame = [&]() {
+		for (size_t draw = 0; draw < draws_per_frame; ++draw)
+		{
+			push_constants.material_index = static_cast<uint32_t>(draw);
+			append_push_constants(stored_push_constants, push_constants, MAX_PUSH_CONSTANTS_SIZE);
+
+			// Flushing the push constants of a draw clears them
+			stored_push_constants.clear();
+		}
+	};
+
+	// The first push grows the storage
+	record_frame();
+
+	size_t allocations_before = allocation_count;
+	for (size_t frame = 1; frame < frame_count; ++frame)
+	{
+		record_frame();
+	}
+	REQUIRE(allocation_count - allocations_before == 0);
+
+	// Pushing through a staging vector, as the value overloads used to, allocates once per draw
+	allocations_before = allocation_count;
+	for (size_t draw = 0; draw < draws_per_frame; ++draw)
+	{
+		ByteVector data(reinterpret_cast<const uint8_t *>(&push_constants), reinterpret_cast<const uint8_t *>(&push_constants) + sizeof(push_constants));
+		append_push_constants(stored_push_constants, data.data(), data.size(), MAX_PUSH_CONSTANTS_SIZE);
+		stored_push_constants.clear();
+	}
+	REQUIRE(allocation_count - allocations_before == draws_per_frame);
+}
+
+TEST_CASE("vkb::append_push_constants appends the bytes of the value", "[push_constants]")
+{
+	ByteVector stored_push_constants;
+
+	uint32_t first  = 0x01020304;
+	uint64_t second = 0x05060708090a0b0c;
+	append_push_constants(stored_push_constants, first, MAX_PUSH_CONSTANTS_SIZE);
+	append_push_constants(stored_push_constants, second, MAX_PUSH_CONSTANTS_SIZE);
+
+	REQUIRE(stored_push_constants.size() == sizeof(first) + sizeof(second));
+	REQUIRE(std::memcmp(stored_push_constants.data(), &first, sizeof(first)) == 0);
+	REQUIRE(std::memcmp(stored_push_constants.data() + sizeof(first), &second, sizeof(second)) == 0);
+}
+
+TEST_CASE("vkb::append_push_constants enforces the push constant limit", "[push_constants]")
+{
+	ByteVector           stored_push_constants;
+	PushConstants        push_constants{};
+
+	append_push_constants(stored_push_constants, push_constants, MAX_PUSH_CONSTANTS_SIZE);
+	REQUIRE_THROWS_AS(append_push_constants(stored_push_constants, push_constants, MAX_PUSH_CONSTANTS_SIZE), std::runtime_error);
+	REQUIRE(stored_push_constants.size() == sizeof(PushConstants));
+}
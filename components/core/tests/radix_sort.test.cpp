@@ -0,0 +1,135 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <random>
+
+#include <core/util/radix_sort.hpp>
+
+using namespace vkb;
+
+namespace
+{
+struct Item
+{
+	uint64_t key;
+
+	uint32_t index;
+};
+
+std::vector<Item> make_items(size_t count, uint64_t key_mask)
+{
+	std::mt19937_64                         rng{42};
+	std::uniform_int_distribution<uint64_t> distribution;
+
+	std::vector<Item> items(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		items[i] = {distribution(rng) & key_mask, static_cast<uint32_t>(i)};
+	}
+	return items;
+}
+
+uint64_t get_key(const Item &item)
+{
+	return item.key;
+}
+}        // namespace
+
+TEST_CASE("vkb::radix_sort matches std::stable_sort", "[common]")
+{
+	// Small key ranges produce many duplicates and skipped passes
+	for (uint64_t key_mask : {0xffffffffffffffffULL, 0xff00ff00ULL, 0x3ULL, 0x0ULL})
+	{
+		auto items    = make_items(1000, key_mask);
+		auto expected = items;
+
+		std::stable_sort(expected.begin(), expected.end(), [](const Item &a, const Item &b) { return a.key < b.key; });
+
+		std::vector<Item> scratch;
+		radix_sort(items, scratch, get_key);
+
+		REQUIRE(items.size() == expected.size());
+		for (size_t i = 0; i < items.size(); ++i)
+		{
+			REQUIRE(items[i].key == expected[i].key);
+			REQUIRE(items[i].index == expected[i].index);
+		}
+	}
+}
+
+TEST_CASE("vkb::radix_sort handles empty and single element ranges", "[common]")
+{
+	std::vector<Item> scratch;
+
+	std::vector<Item> items;
+	radix_sort(items, scratch, get_key);
+	REQUIRE(items.empty());
+
+	items.push_back({7, 0});
+	radix_sort(items, scratch, get_key);
+	REQUIRE(items.size() == 1);
+	REQUIRE(items[0].key == 7);
+}
+
+TEST_CASE("vkb::radix_sort against std::multimap", "[.][benchmark]")
+{
+	// Synthetic draw keys: 32 bits of state and a positive float distance, as built for the draw lists
+	for (size_t count : {10000, 100000})
+	{
+		auto items = make_items(count, 0xffffffffULL);
+
+		std::vector<std::pair<float, uint32_t>> draws(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			float distance = static_cast<float>(items[i].key & 0xffff) * 0.01f;
+
+			uint32_t distance_bits;
+			std::memcpy(&distance_bits, &distance, sizeof(distance_bits));
+
+			items[i].key = ((items[i].key >> 16) << 32) | distance_bits;
+			draws[i]     = {distance, items[i].index};
+		}
+
+		BENCHMARK("std::multimap " + std::to_string(count))
+		{
+			std::multimap<float, uint32_t> sorted;
+			for (auto &draw : draws)
+			{
+				sorted.emplace(draw.first, draw.second);
+			}
+			return sorted.size();
+		};
+
+		std::vector<Item> sorted;
+		std::vector<Item> scratch;
+		BENCHMARK("vkb::radix_sort " + std::to_string(count))
+		{
+			// Storage is reused, as it is by the draw lists from one frame to the next
+			sorted.assign(items.begin(), items.end());
+			radix_sort(sorted, scratch, get_key);
+			return sorted.size();
+		};
+	}
+}
@@ -0,0 +1,344 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include <core/util/resource_cache_lock.hpp>
+
+using namespace vkb;
+
+namespace
+{
+struct Resource
+{
+	uint64_t id;
+};
+
+std::size_t identity_hash(uint64_t id)
+{
+	return static_cast<std::size_t>(id);
+}
+
+std::string make_key(uint64_t id)
+{
+	return std::string{reinterpret_cast<const char *>(&id), sizeof(id)};
+}
+
+/**
+ * @brief Stands in for a shader compilation, by hashing a buffer for a while
+ */
+uint64_t simulate_build(uint64_t id, size_t iterations)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL ^ id;
+	for (size_t i = 0; i < iterations; ++i)
+	{
+		hash ^= i & 0xff;
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+/**
+ * @brief Requests the resource of an id, keyed by the bytes of the id and hashed by the given function
+ */
+template <class H, class B>
+Resource &request(ResourceCacheLock &lock, std::unordered_map<std::size_t, Resource> &resources, uint64_t id, const H &hash, const B &build, uint64_t frame = 0)
+{
+	std::size_t slot;
+	return lock.request(
+	    resources, hash(id),
+	    [id](const std::string &stored_key) { return stored_key.size() == sizeof(id) && std::memcmp(stored_key.data(), &id, sizeof(id)) == 0; },
+	    [id]() { return make_key(id); },
+	    frame, build, [](Resource &) {}, slot);
+}
+
+/**
+ * @brief Runs requests for the given ids, split over the given number of threads
+ */
+void request_on_threads(ResourceCacheLock &lock, std::unordered_map<std::size_t, Resource> &resources, const std::vector<uint64_t> &ids, size_t thread_count)
+{
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < thread_count; ++t)
+	{
+		threads.emplace_back([&, t]() {
+			for (size_t i = t; i < ids.size(); i += thread_count)
+			{
+				request(lock, resources, ids[i], identity_hash, [&]() { return Resource{ids[i]}; });
+			}
+		});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+}        // namespace
+
+TEST_CASE("vkb::ResourceCacheLock hits return the cached resource", "[resource_cache_lock]")
+{
+	ResourceCacheLock                         lock;
+	std::unordered_map<std::size_t, Resource> resources;
+
+	size_t builds = 0;
+	auto   build  = [&]() {
+		builds++;
+		return Resource{42};
+	};
+
+	auto &first  = request(lock, resources, 42, identity_hash, build);
+	auto &second = request(lock, resources, 42, identity_hash, build);
+
+	REQUIRE(&first == &second);
+	REQUIRE(builds == 1);
+
+	auto stats = lock.get_stats();
+	REQUIRE(stats.entries == 1);
+	REQUIRE(stats.hits == 1);
+	REQUIRE(stats.misses == 1);
+}
+
+TEST_CASE("vkb::ResourceCacheLock tells colliding keys apart", "[resource_cache_lock]")
+{
+	ResourceCacheLock                         lock;
+	std::unordered_map<std::size_t, Resource> resources;
+
+	auto same_hash = [](uint64_t) { return std::size_t{7}; };
+
+	auto &first  = request(lock, resources, 1, same_hash, []() { return Resource{1}; });
+	auto &second = request(lock, resources, 2, same_hash, []() { return Resource{2}; });
+
+	REQUIRE(first.id == 1);
+	REQUIRE(second.id == 2);
+	REQUIRE(lock.get_stats().collisions == 1);
+
+	// Removing the first resource leaves a tombstone, through which the second one is still found
+	resources.erase(7);
+	lock.remove(7);
+	REQUIRE(&request(lock, resources, 2, same_hash, []() { return Resource{0}; }) == &second);
+}
+
+TEST_CASE("vkb::ResourceCacheLock failed builds are not cached", "[resource_cache_lock]")
+{
+	ResourceCacheLock                         lock;
+	std::unordered_map<std::size_t, Resource> resources;
+
+	REQUIRE_THROWS_AS(request(lock, resources, 3, identity_hash, []() -> Resource { throw std::runtime_error{"build failed"}; }), std::runtime_error);
+	REQUIRE(lock.get_stats().entries == 0);
+
+	REQUIRE(request(lock, resources, 3, identity_hash, []() { return Resource{3}; }).id == 3);
+}
+
+TEST_CASE("vkb::ResourceCacheLock concurrent misses of one key build it once", "[resource_cache_lock]")
+{
+	ResourceCacheLock                         lock;
+	std::unordered_map<std::size_t, Resource> resources;
+
+	std::atomic<size_t> builds{0};
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < 8; ++t)
+	{
+		threads.emplace_back([&]() {
+			request(lock, resources, 5, identity_hash, [&]() {
+				builds++;
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+				return Resource{5};
+			});
+		});
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(builds == 1);
+	REQUIRE(lock.get_stats().misses == 1);
+	REQUIRE(lock.get_stats().hits == 7);
+}
+
+TEST_CASE("vkb::ResourceCacheLock batches build each missing resource once", "[resource_cache_lock]")
+{
+	ResourceCacheLock                         lock;
+	std::unordered_map<std::size_t, Resource> resources;
+	ctpl::thread_pool                         thread_pool{4};
+
+	request(lock, resources, 1, identity_hash, []() { return Resource{1}; });
+
+	// One cached resource, one requested twice and two colliding ones
+	std::vector<uint64_t>    ids{1, 2, 2, 3, 11};
+	std::vector<std::size_t> hashes{1, 2, 2, 3, 3};
+	std::vector<std::string> keys;
+	for (auto id : ids)
+	{
+		keys.push_back(make_key(id));
+	}
+
+	std::atomic<size_t> builds{0};
+	std::vector<size_t> built_indices;
+	lock.build_batch(
+	    resources, hashes, keys, 0, [&]() -> ctpl::thread_pool & { return thread_pool; },
+	    [&](size_t index) {
+		    builds++;
+		    return Resource{ids[index]};
+	    },
+	    [&](size_t index, Resource &resource) {
+		    REQUIRE(resource.id == ids[index]);
+		    built_indices.push_back(index);
+	    });
+
+	REQUIRE(builds == 3);
+	REQUIRE(built_indices == std::vector<size_t>{1, 3, 4});
+	REQUIRE(lock.get_stats().collisions == 1);
+
+	for (size_t i = 0; i < ids.size(); ++i)
+	{
+		REQUIRE(request(lock, resources, ids[i], [&](uint64_t) { return hashes[i]; }, []() { return Resource{0}; }).id == ids[i]);
+	}
+	REQUIRE(lock.get_stats().misses == 4);
+}
+
+TEST_CASE("vkb::ResourceCacheLock batches rethrow build errors once all builds finished", "[resource_cache_lock]")
+{
+	ResourceCacheLock                         lock;
+	std::unordered_map<std::size_t, Resource> resources;
+	ctpl::thread_pool                         thread_pool{2};
+
+	std::vector<std::size_t> hashes{1, 2, 3};
+	std::vector<std::string> keys{make_key(1), make_key(2), make_key(3)};
+
+	std::atomic<size_t> builds{0};
+	REQUIRE_THROWS_AS(lock.build_batch(
+	                      resources, hashes, keys, 0, [&]() -> ctpl::thread_pool & { return thread_pool; },
+	                      [&](size_t index) {
+		                      std::this_thread::sleep_for(std::chrono::milliseconds(index * 5));
+		                      builds++;
+		                      if (index == 0)
+		                      {
+			                      throw std::runtime_error{"build failed"};
+		                      }
+		                      return Resource{index};
+	                      },
+	                      [](size_t, Resource &) {}),
+	                  std::runtime_error);
+
+	REQUIRE(builds == 3);
+	REQUIRE(resources.empty());
+}
+
+TEST_CASE("vkb::ResourceCacheLock multi-threaded hits and misses", "[.][benchmark]")
+{
+	// A frame's worth of requests, most of them for resources cached by previous frames
+	constexpr size_t cached_count  = 1024;
+	constexpr size_t request_count = 16384;
+
+	std::mt19937_64                         rng{0};
+	std::uniform_int_distribution<uint64_t> cached_ids{0, cached_count - 1};
+
+	std::vector<uint64_t> hit_ids(request_count);
+	for (auto &id : hit_ids)
+	{
+		id = cached_ids(rng);
+	}
+
+	for (size_t thread_count : {1, 2, 4, 8})
+	{
+		ResourceCacheLock                         lock;
+		std::unordered_map<std::size_t, Resource> resources;
+		for (uint64_t id = 0; id < cached_count; ++id)
+		{
+			request(lock, resources, id, identity_hash, [id]() { return Resource{id}; });
+		}
+
+		BENCHMARK("hits, " + std::to_string(thread_count) + " threads")
+		{
+			request_on_threads(lock, resources, hit_ids, thread_count);
+			return resources.size();
+		};
+
+		// One request in 16 misses, on ids which no previous run requested
+		BENCHMARK_ADVANCED("1/16 misses, " + std::to_string(thread_count) + " threads")
+		(Catch::Benchmark::Chronometer meter)
+		{
+			std::vector<std::vector<uint64_t>> run_ids(meter.runs(), hit_ids);
+			for (size_t run = 0; run < run_ids.size(); ++run)
+			{
+				for (size_t i = 0; i < request_count; i += 16)
+				{
+					run_ids[run][i] = cached_count + run * request_count + i;
+				}
+			}
+
+			meter.measure([&](int run) {
+				request_on_threads(lock, resources, run_ids[run], thread_count);
+				return resources.size();
+			});
+		};
+	}
+}
+
+TEST_CASE("vkb::ResourceCacheLock batched builds against one by one", "[.][benchmark]")
+{
+	// A sample's worth of shader variants, each build standing in for a compilation of a few milliseconds
+	constexpr size_t resource_count   = 64;
+	constexpr size_t build_iterations = 1000000;
+
+	std::vector<std::size_t> hashes(resource_count);
+	std::vector<std::string> keys(resource_count);
+	for (uint64_t id = 0; id < resource_count; ++id)
+	{
+		hashes[id] = identity_hash(id);
+		keys[id]   = make_key(id);
+	}
+
+	BENCHMARK("one by one")
+	{
+		ResourceCacheLock                         lock;
+		std::unordered_map<std::size_t, Resource> resources;
+		for (uint64_t id = 0; id < resource_count; ++id)
+		{
+			request(lock, resources, id, identity_hash, [id]() { return Resource{simulate_build(id, build_iterations)}; });
+		}
+		return resources.size();
+	};
+
+	for (size_t thread_count : {1, 2, 4, 8})
+	{
+		ctpl::thread_pool thread_pool{static_cast<int>(thread_count)};
+
+		BENCHMARK("batched, " + std::to_string(thread_count) + " threads")
+		{
+			ResourceCacheLock                         lock;
+			std::unordered_map<std::size_t, Resource> resources;
+			lock.build_batch(
+			    resources, hashes, keys, 0, [&]() -> ctpl::thread_pool & { return thread_pool; },
+			    [](size_t index) { return Resource{simulate_build(index, build_iterations)}; },
+			    [](size_t, Resource &) {});
+			return resources.size();
+		};
+	}
+}
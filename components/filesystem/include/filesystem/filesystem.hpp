@@ -38,6 +38,38 @@ struct FileStat
 
 using Path = std::filesystem::path;
 
+// Read-only contents of a file, valid for as long as the view lives
+// Memory-mapped where the platform supports it, read into memory otherwise
+class FileView
+{
+  public:
+	FileView()          = default;
+	virtual ~FileView() = default;
+
+	FileView(const FileView &)            = delete;
+	FileView &operator=(const FileView &) = delete;
+
+	virtual const uint8_t *data() const = 0;
+	virtual size_t         size() const = 0;
+
+	const uint8_t *begin() const
+	{
+		return data();
+	}
+
+	const uint8_t *end() const
+	{
+		return data() + size();
+	}
+
+	bool empty() const
+	{
+		return size() == 0;
+	}
+};
+
+using FileViewPtr = std::unique_ptr<FileView>;
+
 // A thin filesystem wrapper
 class FileSystem
 {
@@ -64,6 +96,9 @@ class FileSystem
 
 	// Read the entire file into a vector of bytes
 	std::vector<uint8_t> read_file_binary(const Path &path);
+
+	// Map the entire file without copying it, the default implementation reads it into memory
+	virtual FileViewPtr map_file(const Path &path);
 };
 
 using FileSystemPtr = std::shared_ptr<FileSystem>;
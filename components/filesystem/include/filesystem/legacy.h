@@ -25,6 +25,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "filesystem/filesystem.hpp"
+
 namespace vkb
 {
 namespace fs
@@ -94,6 +96,14 @@ void create_path(const std::string &root, const std::string &path);
  */
 std::vector<uint8_t> read_asset(const std::string &filename);
 
+/**
+ * @brief Helper to map an asset file without copying it
+ *
+ * @param filename The path to the file (relative to the assets directory)
+ * @return A read-only view of the file contents, valid until it is destroyed
+ */
+vkb::filesystem::FileViewPtr map_asset(const std::string &filename);
+
 /**
  * @brief Helper to read a shader file into a single string
  *
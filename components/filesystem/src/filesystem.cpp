@@ -28,6 +28,30 @@ namespace filesystem
 {
 static FileSystemPtr fs = nullptr;
 
+namespace
+{
+class BufferFileView final : public FileView
+{
+  public:
+	explicit BufferFileView(std::vector<uint8_t> &&buffer) :
+	    buffer{std::move(buffer)}
+	{}
+
+	const uint8_t *data() const override
+	{
+		return buffer.data();
+	}
+
+	size_t size() const override
+	{
+		return buffer.size();
+	}
+
+  private:
+	std::vector<uint8_t> buffer;
+};
+}        // namespace
+
 void init()
 {
 	fs = std::make_shared<StdFileSystem>();
@@ -53,8 +77,9 @@ void FileSystem::write_file(const Path &path, const std::string &data)
 
 std::string FileSystem::read_file_string(const Path &path)
 {
-	auto bin = read_file_binary(path);
-	return {bin.begin(), bin.end()};
+	// Copy straight from the mapping, instead of through a vector of bytes
+	auto view = map_file(path);
+	return {view->begin(), view->end()};
 }
 
 std::vector<uint8_t> FileSystem::read_file_binary(const Path &path)
@@ -63,5 +88,10 @@ std::vector<uint8_t> FileSystem::read_file_binary(const Path &path)
 	return read_chunk(path, 0, stat.size);
 }
 
+FileViewPtr FileSystem::map_file(const Path &path)
+{
+	return std::make_unique<BufferFileView>(read_file_binary(path));
+}
+
 }        // namespace filesystem
 }        // namespace vkb
\ No newline at end of file
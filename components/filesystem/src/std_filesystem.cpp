@@ -22,10 +22,145 @@
 #include <filesystem>
 #include <fstream>
 
+#if defined(_WIN32)
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#	define VKB_FILESYSTEM_MMAP
+#endif
+
 namespace vkb
 {
 namespace filesystem
 {
+namespace
+{
+#if defined(_WIN32)
+class MappedFileView final : public FileView
+{
+  public:
+	static FileViewPtr map(const Path &path)
+	{
+		HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return nullptr;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return nullptr;
+		}
+
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!mapping)
+		{
+			return nullptr;
+		}
+
+		// The view keeps the mapping alive on its own
+		const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!data)
+		{
+			return nullptr;
+		}
+
+		return std::unique_ptr<MappedFileView>(new MappedFileView(static_cast<const uint8_t *>(data), static_cast<size_t>(size.QuadPart)));
+	}
+
+	~MappedFileView() override
+	{
+		UnmapViewOfFile(_data);
+	}
+
+	const uint8_t *data() const override
+	{
+		return _data;
+	}
+
+	size_t size() const override
+	{
+		return _size;
+	}
+
+  private:
+	MappedFileView(const uint8_t *data, size_t size) :
+	    _data{data},
+	    _size{size}
+	{}
+
+	const uint8_t *_data;
+	size_t         _size;
+};
+#elif defined(VKB_FILESYSTEM_MMAP)
+class MappedFileView final : public FileView
+{
+  public:
+	static FileViewPtr map(const Path &path)
+	{
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return nullptr;
+		}
+
+		struct stat file_stat;
+		if (fstat(fd, &file_stat) != 0 || !S_ISREG(file_stat.st_mode) || file_stat.st_size == 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		size_t size = static_cast<size_t>(file_stat.st_size);
+
+		// The mapping stays valid after the file is closed
+		void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED)
+		{
+			return nullptr;
+		}
+
+		return std::unique_ptr<MappedFileView>(new MappedFileView(static_cast<const uint8_t *>(data), size));
+	}
+
+	~MappedFileView() override
+	{
+		munmap(const_cast<uint8_t *>(_data), _size);
+	}
+
+	const uint8_t *data() const override
+	{
+		return _data;
+	}
+
+	size_t size() const override
+	{
+		return _size;
+	}
+
+  private:
+	MappedFileView(const uint8_t *data, size_t size) :
+	    _data{data},
+	    _size{size}
+	{}
+
+	const uint8_t *_data;
+	size_t         _size;
+};
+#endif
+}        // namespace
+
 FileStat StdFileSystem::stat_file(const Path &path)
 {
 	std::error_code ec;
@@ -94,7 +229,8 @@ std::vector<uint8_t> StdFileSystem::read_chunk(const Path &path, size_t offset,
 		throw std::runtime_error("Failed to open file for reading");
 	}
 
-	auto size = stat_file(path).size;
+	// The file is opened at its end, which saves querying its size separately
+	auto size = static_cast<size_t>(file.tellg());
 
 	if (offset + count > size)
 	{
@@ -109,6 +245,19 @@ std::vector<uint8_t> StdFileSystem::read_chunk(const Path &path, size_t offset,
 	return data;
 }
 
+FileViewPtr StdFileSystem::map_file(const Path &path)
+{
+#if defined(_WIN32) || defined(VKB_FILESYSTEM_MMAP)
+	if (auto view = MappedFileView::map(path))
+	{
+		return view;
+	}
+#endif
+
+	// Empty files cannot be mapped, and some files (e.g. pipes) do not support it
+	return FileSystem::map_file(path);
+}
+
 void StdFileSystem::write_file(const Path &path, const std::vector<uint8_t> &data)
 {
 	// create directory if it doesn't exist
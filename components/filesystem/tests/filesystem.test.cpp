@@ -15,6 +15,7 @@
  * limitations under the License.
  */
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include "filesystem/filesystem.hpp"
@@ -123,4 +124,87 @@ TEST_CASE("Read binary file", "[filesystem]")
 	REQUIRE(binary_str == test_data);
 
 	delete_test_file(fs, test_file);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Map file", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto        test_file = fs->temp_directory() / "vulkan_samples" / "map_test.txt";
+	const std::string test_data = "Hello, World!";
+
+	create_test_file(fs, test_file, test_data);
+
+	{
+		const auto view = fs->map_file(test_file);
+		REQUIRE(view);
+		REQUIRE(view->size() == test_data.size());
+
+		std::string view_str(view->begin(), view->end());
+		REQUIRE(view_str == test_data);
+	}
+
+	delete_test_file(fs, test_file);
+}
+
+TEST_CASE("Map empty file", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto test_file = fs->temp_directory() / "vulkan_samples" / "map_empty_test.txt";
+
+	create_test_file(fs, test_file, "");
+
+	{
+		const auto view = fs->map_file(test_file);
+		REQUIRE(view);
+		REQUIRE(view->empty());
+	}
+
+	delete_test_file(fs, test_file);
+}
+
+TEST_CASE("Map missing file", "[filesystem]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto test_file = fs->temp_directory() / "vulkan_samples" / "map_missing_test.txt";
+
+	REQUIRE_THROWS(fs->map_file(test_file));
+}
+
+TEST_CASE("Map file benchmark", "[.][benchmark]")
+{
+	vkb::filesystem::init();
+
+	auto fs = vkb::filesystem::get();
+
+	const auto test_file = fs->temp_directory() / "vulkan_samples" / "map_benchmark.bin";
+
+	REQUIRE_NOTHROW(fs->write_file(test_file, std::vector<uint8_t>(64 * 1024 * 1024, 0x5a)));
+
+	BENCHMARK("read_file_binary")
+	{
+		return fs->read_file_binary(test_file).size();
+	};
+
+	// Touch every page, a mapping which is never read costs nothing
+	BENCHMARK("map_file")
+	{
+		auto     view = fs->map_file(test_file);
+		uint32_t sum  = 0;
+		for (size_t i = 0; i < view->size(); i += 4096)
+		{
+			sum += view->data()[i];
+		}
+		return sum;
+	};
+
+	REQUIRE_NOTHROW(fs->remove(test_file));
+}
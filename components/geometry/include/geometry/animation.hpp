@@ -0,0 +1,130 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ctpl
+{
+class thread_pool;
+}
+
+namespace vkb
+{
+namespace geometry
+{
+enum class Interpolation
+{
+	Linear,
+	Step,
+	CubicSpline
+};
+
+/**
+ * @brief Finds the keyframe starting the interval which contains a time
+ *        The search starts from the keyframe found for the previous time and steps forward,
+ *        falling back to a binary search when going back in time or skipping many keyframes.
+ * @param inputs The times of the keyframes, at least two
+ * @param count The number of keyframes
+ * @param cursor The keyframe found for the previous time
+ * @param time A time between the first and the last keyframe
+ */
+uint32_t find_keyframe(const float *inputs, uint32_t count, uint32_t cursor, float time);
+
+/**
+ * @brief Samples the channels of glTF animations
+ *
+ * The keyframes of all the channels are stored in two contiguous arrays, and each channel is described by
+ * parallel arrays indexed by the channel. Every channel caches the keyframe it sampled last, which is where
+ * find_keyframe() starts the next time.
+ */
+class AnimationChannels
+{
+  public:
+	/// Number of keyframes the cursor steps over before a binary search is used
+	static constexpr uint32_t MAX_CURSOR_STEPS = 4;
+
+	/// Sets with fewer channels are evaluated on the calling thread
+	static constexpr size_t PARALLEL_CHANNEL_COUNT = 1024;
+
+	/**
+	 * @brief Adds a channel
+	 * @param interpolation The interpolation between the keyframes
+	 * @param rotation Whether the outputs are quaternions stored as x, y, z, w, which are normalized after interpolation
+	 * @param inputs The times of the keyframes
+	 * @param outputs The values of the keyframes, three per keyframe for cubic splines (in tangent, value, out tangent)
+	 * @return False if there are fewer outputs than keyframes, in which case the channel is not added
+	 */
+	bool add(Interpolation interpolation, bool rotation, const std::vector<float> &inputs, const std::vector<glm::vec4> &outputs);
+
+	/**
+	 * @brief Samples all the channels at a time
+	 * @param time The time to sample at
+	 * @param thread_pool A pool to split large sets of channels across, or null to evaluate on the calling thread only
+	 */
+	void evaluate(float time, ctpl::thread_pool *thread_pool = nullptr);
+
+	/**
+	 * @brief Samples the channels of a range at a time
+	 */
+	void evaluate(float time, size_t begin, size_t end);
+
+	size_t size() const;
+
+	/**
+	 * @return Whether the last evaluated time was within the keyframes of a channel
+	 */
+	bool is_active(size_t channel) const;
+
+	/**
+	 * @return The value a channel evaluated last, only meaningful if it is active
+	 */
+	const glm::vec4 &get_value(size_t channel) const;
+
+  private:
+	// Keyframes of all the channels, cubic spline channels have three outputs per keyframe
+	std::vector<float> key_inputs;
+
+	std::vector<glm::vec4> key_outputs;
+
+	// Channels, one element per channel in each array
+	std::vector<Interpolation> interpolations;
+
+	std::vector<uint8_t> rotations;
+
+	std::vector<uint32_t> input_offsets;
+
+	std::vector<uint32_t> input_counts;
+
+	std::vector<uint32_t> output_offsets;
+
+	/// Keyframe sampled last by each channel
+	std::vector<uint32_t> cursors;
+
+	/// Values evaluated by each channel
+	std::vector<glm::vec4> values;
+
+	/// Whether the last evaluated time was within the keyframes of each channel
+	std::vector<uint8_t> active;
+};
+}        // namespace geometry
+}        // namespace vkb
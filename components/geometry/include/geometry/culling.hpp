@@ -0,0 +1,151 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace ctpl
+{
+class thread_pool;
+}
+
+namespace vkb
+{
+namespace geometry
+{
+/**
+ * @brief Bounding spheres stored as one array per coordinate, so that several spheres are tested at once
+ */
+struct BoundingSpheres
+{
+	std::vector<float> center_x;
+
+	std::vector<float> center_y;
+
+	std::vector<float> center_z;
+
+	std::vector<float> radius;
+
+	void push_back(const glm::vec3 &center, float radius);
+
+	void reserve(size_t count);
+
+	void clear();
+
+	size_t size() const;
+};
+
+/**
+ * @brief Axis aligned bounding boxes stored as one array per coordinate
+ */
+struct BoundingBoxes
+{
+	std::vector<float> center_x;
+
+	std::vector<float> center_y;
+
+	std::vector<float> center_z;
+
+	/// Half sizes of the boxes
+	std::vector<float> extent_x;
+
+	std::vector<float> extent_y;
+
+	std::vector<float> extent_z;
+
+	void push_back(const glm::vec3 &min, const glm::vec3 &max);
+
+	void reserve(size_t count);
+
+	void clear();
+
+	size_t size() const;
+};
+
+/**
+ * @brief Tests bounding volumes against a frustum, four at a time with SSE or NEON, and splits large sets across threads
+ *
+ * The frustum is given by its normalized planes, as returned by vkb::Frustum::get_planes(),
+ * a point p being on the visible side of a plane if dot(plane.xyz, p) + plane.w >= 0.
+ *
+ * The visibility of each object is written as 1 or 0 to a strided array, without ever reading it back.
+ * Pointing it at the instanceCount of persistently mapped indirect draw commands culls the draws in place.
+ */
+class FrustumCuller
+{
+  public:
+	/// Sets with fewer objects per thread are culled on the calling thread
+	static constexpr size_t PARALLEL_OBJECT_COUNT = 16384;
+
+	/// Tests all the planes of the frustum
+	static constexpr uint32_t ALL_PLANES = 0x3f;
+
+	using Planes = std::array<glm::vec4, 6>;
+
+	FrustumCuller();
+
+	~FrustumCuller();
+
+	FrustumCuller(const FrustumCuller &) = delete;
+
+	FrustumCuller(FrustumCuller &&) = delete;
+
+	FrustumCuller &operator=(const FrustumCuller &) = delete;
+
+	FrustumCuller &operator=(FrustumCuller &&) = delete;
+
+	/**
+	 * @brief Splits the objects across threads in cull()
+	 * @param thread_count Number of threads, 1 to cull on the calling thread only
+	 */
+	void set_thread_count(uint32_t thread_count);
+
+	/**
+	 * @brief Writes the visibility of each sphere
+	 * @param planes The planes of the frustum
+	 * @param plane_mask Bit i tests plane i, to skip the planes which cannot cull anything in a scene
+	 * @param visibility Receives 1 for the visible spheres and 0 for the culled ones
+	 * @param stride Distance in bytes between two visibility values
+	 * @return The number of visible spheres
+	 */
+	size_t cull(const Planes &planes, uint32_t plane_mask, const BoundingSpheres &spheres, uint32_t *visibility, size_t stride = sizeof(uint32_t));
+
+	/**
+	 * @brief Writes the visibility of each box
+	 * @param planes The planes of the frustum
+	 * @param plane_mask Bit i tests plane i, to skip the planes which cannot cull anything in a scene
+	 * @param visibility Receives 1 for the visible boxes and 0 for the culled ones
+	 * @param stride Distance in bytes between two visibility values
+	 * @return The number of visible boxes
+	 */
+	size_t cull(const Planes &planes, uint32_t plane_mask, const BoundingBoxes &boxes, uint32_t *visibility, size_t stride = sizeof(uint32_t));
+
+  private:
+	std::unique_ptr<ctpl::thread_pool> thread_pool;
+
+	template <typename Test>
+	size_t cull_parallel(const Test &test, const Planes &planes, uint32_t plane_mask, size_t count, uint32_t *visibility, size_t stride);
+};
+}        // namespace geometry
+}        // namespace vkb
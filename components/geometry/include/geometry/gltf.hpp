@@ -0,0 +1,164 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// Images are never decoded by tinygltf, the loaders decode them themselves
+#ifndef TINYGLTF_NO_STB_IMAGE
+#	define TINYGLTF_NO_STB_IMAGE
+#endif
+#ifndef TINYGLTF_NO_STB_IMAGE_WRITE
+#	define TINYGLTF_NO_STB_IMAGE_WRITE
+#endif
+#ifndef TINYGLTF_NO_EXTERNAL_IMAGE
+#	define TINYGLTF_NO_EXTERNAL_IMAGE
+#endif
+#include <tiny_gltf.h>
+
+namespace vkb
+{
+namespace geometry
+{
+/**
+ * @brief A glTF primitive with its vertex attributes stored as separate arrays
+ *
+ * Attributes which the primitive does not have are left empty, otherwise they have one element per vertex.
+ */
+struct Primitive
+{
+	std::vector<glm::vec3> positions;
+
+	std::vector<glm::vec3> normals;
+
+	/// TEXCOORD_0, normalized integer coordinates are converted to floats
+	std::vector<glm::vec2> texcoords;
+
+	/// Triangle list indices, widened to 32 bits. Empty for non-indexed primitives.
+	std::vector<uint32_t> indices;
+
+	/// Bounds of the positions
+	glm::vec3 min{0.0f};
+
+	glm::vec3 max{0.0f};
+
+	/// Index in Model::materials, -1 for the default material
+	int32_t material{-1};
+};
+
+struct Mesh
+{
+	std::string name;
+
+	std::vector<Primitive> primitives;
+};
+
+/**
+ * @brief Metallic-roughness material factors, textures are referred to by their glTF texture index
+ */
+struct Material
+{
+	std::string name;
+
+	glm::vec4 base_color_factor{1.0f};
+
+	float metallic_factor{1.0f};
+
+	float roughness_factor{1.0f};
+
+	glm::vec3 emissive_factor{0.0f};
+
+	/// "OPAQUE", "MASK" or "BLEND"
+	std::string alpha_mode{"OPAQUE"};
+
+	float alpha_cutoff{0.5f};
+
+	bool double_sided{false};
+
+	int32_t base_color_texture{-1};
+
+	int32_t metallic_roughness_texture{-1};
+
+	int32_t normal_texture{-1};
+
+	int32_t occlusion_texture{-1};
+
+	int32_t emissive_texture{-1};
+};
+
+struct Node
+{
+	std::string name;
+
+	/// Index in Model::meshes, -1 if the node has no mesh
+	int32_t mesh{-1};
+
+	/// Index in Model::nodes, -1 for root nodes
+	int32_t parent{-1};
+
+	std::vector<uint32_t> children;
+
+	glm::mat4 local_transform{1.0f};
+};
+
+/**
+ * @brief CPU-side description of the geometry of a glTF model, built without any GPU resources
+ *
+ * The indices of meshes, materials and nodes match those of the glTF file.
+ */
+struct Model
+{
+	std::vector<Mesh> meshes;
+
+	std::vector<Material> materials;
+
+	std::vector<Node> nodes;
+
+	/// Root nodes of the selected scene
+	std::vector<uint32_t> scene_nodes;
+};
+
+/**
+ * @brief Converts a parsed glTF model
+ *        Throws if an accessor can not be read, e.g. because it points outside of its buffer
+ * @param gltf_model The parsed glTF model
+ * @param scene_index The scene whose root nodes are listed, -1 for the default scene
+ */
+Model load_gltf(const tinygltf::Model &gltf_model, int scene_index = -1);
+
+/**
+ * @brief Reads a .gltf or .glb file and converts it, images are not decoded
+ *        Throws if the file can not be parsed
+ * @param path Path of the file
+ * @param scene_index The scene whose root nodes are listed, -1 for the default scene
+ */
+Model load_gltf_from_file(const std::string &path, int scene_index = -1);
+
+/**
+ * @brief Parses a .gltf document from memory and converts it, images are not decoded
+ *        Throws if the document can not be parsed
+ * @param json The contents of the .gltf file
+ * @param base_dir The directory used to resolve external buffers
+ */
+Model load_gltf_from_memory(const std::string &json, const std::string &base_dir = {});
+}        // namespace geometry
+}        // namespace vkb
@@ -0,0 +1,119 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace vkb
+{
+namespace geometry
+{
+struct MeshletOptions
+{
+	/// At most 255, so that local indices fit in a byte
+	uint32_t max_vertices{64};
+
+	uint32_t max_triangles{32};
+
+	/// Picks the triangles sharing the most vertices with the current meshlet first, instead of following the index order
+	bool optimize_vertex_reuse{true};
+};
+
+/**
+ * @brief A range of Meshlets::vertices and of Meshlets::triangles
+ */
+struct Meshlet
+{
+	uint32_t vertex_offset;
+
+	uint32_t vertex_count;
+
+	/// Offset of the first local index in Meshlets::triangles
+	uint32_t triangle_offset;
+
+	uint32_t triangle_count;
+};
+
+/**
+ * @brief Culling data of a meshlet
+ *
+ * The meshlet is entirely backfacing for a camera at position p if
+ * dot(center - p, cone_axis) >= cone_cutoff * length(center - p) + radius
+ */
+struct MeshletBounds
+{
+	glm::vec3 center;
+
+	float radius;
+
+	/// Average direction of the triangle normals
+	glm::vec3 cone_axis;
+
+	/// Sine of the half angle of the cone containing the triangle normals, 1 if the meshlet can never be culled
+	float cone_cutoff;
+};
+
+struct Meshlets
+{
+	std::vector<Meshlet> meshlets;
+
+	/// Mesh vertex indices referred to by the meshlets
+	std::vector<uint32_t> vertices;
+
+	/// Three local indices per triangle, relative to the vertex range of their meshlet
+	std::vector<uint8_t> triangles;
+
+	/// One entry per meshlet, empty if no positions were given
+	std::vector<MeshletBounds> bounds;
+};
+
+/**
+ * @brief An indexed triangle list to split into meshlets
+ */
+struct MeshletSource
+{
+	const uint32_t *indices{nullptr};
+
+	size_t index_count{0};
+
+	size_t vertex_count{0};
+
+	/// Optional, the bounds are only computed if positions are given
+	const float *positions{nullptr};
+
+	/// Distance between two positions in bytes
+	size_t position_stride{3 * sizeof(float)};
+};
+
+/**
+ * @brief Splits a triangle list into meshlets
+ *        Throws if the options are invalid or if an index is out of range
+ */
+Meshlets build_meshlets(const MeshletSource &source, const MeshletOptions &options = {});
+
+/**
+ * @brief Splits several triangle lists into meshlets, one mesh per task on a pool of threads
+ * @param thread_count Number of threads, 0 to use one per core
+ */
+std::vector<Meshlets> build_meshlets(const std::vector<MeshletSource> &sources, const MeshletOptions &options = {}, uint32_t thread_count = 0);
+}        // namespace geometry
+}        // namespace vkb
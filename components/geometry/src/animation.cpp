@@ -0,0 +1,202 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry/animation.hpp"
+
+#include <algorithm>
+#include <future>
+
+#include <ctpl_stl.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+namespace vkb
+{
+namespace geometry
+{
+namespace
+{
+inline glm::quat to_quat(const glm::vec4 &value)
+{
+	glm::quat q;
+	q.x = value.x;
+	q.y = value.y;
+	q.z = value.z;
+	q.w = value.w;
+
+	return q;
+}
+
+inline glm::vec4 to_vec4(const glm::quat &q)
+{
+	return glm::vec4(q.x, q.y, q.z, q.w);
+}
+}        // namespace
+
+uint32_t find_keyframe(const float *inputs, uint32_t count, uint32_t cursor, float time)
+{
+	// Playing forward usually stays on the same keyframe or moves to the next one
+	if (time >= inputs[cursor])
+	{
+		for (uint32_t step = 0; step <= AnimationChannels::MAX_CURSOR_STEPS; ++step)
+		{
+			if (cursor + 2 >= count || time < inputs[cursor + 1])
+			{
+				return cursor;
+			}
+			++cursor;
+		}
+	}
+
+	// The animation looped, or skipped many keyframes
+	auto keyframe = static_cast<uint32_t>(std::upper_bound(inputs, inputs + count, time) - inputs);
+
+	return std::min(keyframe == 0 ? 0 : keyframe - 1, count - 2);
+}
+
+bool AnimationChannels::add(Interpolation interpolation, bool rotation, const std::vector<float> &inputs, const std::vector<glm::vec4> &outputs)
+{
+	size_t output_count = interpolation == Interpolation::CubicSpline ? inputs.size() * 3 : inputs.size();
+
+	if (outputs.size() < output_count)
+	{
+		return false;
+	}
+
+	interpolations.push_back(interpolation);
+	rotations.push_back(rotation ? 1 : 0);
+	input_offsets.push_back(static_cast<uint32_t>(key_inputs.size()));
+	input_counts.push_back(static_cast<uint32_t>(inputs.size()));
+	output_offsets.push_back(static_cast<uint32_t>(key_outputs.size()));
+	cursors.push_back(0);
+	values.push_back(glm::vec4(0.0f));
+	active.push_back(0);
+
+	key_inputs.insert(key_inputs.end(), inputs.begin(), inputs.end());
+	key_outputs.insert(key_outputs.end(), outputs.begin(), outputs.begin() + output_count);
+
+	return true;
+}
+
+void AnimationChannels::evaluate(float time, ctpl::thread_pool *thread_pool)
+{
+	size_t channel_count = size();
+
+	if (!thread_pool || channel_count < PARALLEL_CHANNEL_COUNT)
+	{
+		evaluate(time, 0, channel_count);
+		return;
+	}
+
+	// Channels only write their own cursor and value
+	size_t chunk_count = thread_pool->size();
+	size_t chunk_size  = (channel_count + chunk_count - 1) / chunk_count;
+
+	std::vector<std::future<void>> futures;
+	for (size_t chunk_begin = 0; chunk_begin < channel_count; chunk_begin += chunk_size)
+	{
+		size_t chunk_end = std::min(chunk_begin + chunk_size, channel_count);
+		futures.push_back(thread_pool->push([this, time, chunk_begin, chunk_end](size_t) { evaluate(time, chunk_begin, chunk_end); }));
+	}
+
+	for (auto &future : futures)
+	{
+		future.get();
+	}
+}
+
+void AnimationChannels::evaluate(float time, size_t begin, size_t end)
+{
+	for (size_t c = begin; c < end; ++c)
+	{
+		active[c] = 0;
+
+		uint32_t     count  = input_counts[c];
+		const float *inputs = &key_inputs[input_offsets[c]];
+
+		if (count < 2 || time < inputs[0] || time > inputs[count - 1])
+		{
+			continue;
+		}
+
+		uint32_t i = find_keyframe(inputs, count, cursors[c], time);
+		cursors[c] = i;
+
+		float delta = inputs[i + 1] - inputs[i];
+		float t     = delta > 0.0f ? (time - inputs[i]) / delta : 0.0f;
+
+		const glm::vec4 *outputs  = &key_outputs[output_offsets[c]];
+		bool             rotation = rotations[c] != 0;
+
+		switch (interpolations[c])
+		{
+			case Interpolation::Linear:
+			{
+				if (rotation)
+				{
+					values[c] = to_vec4(glm::normalize(glm::slerp(to_quat(outputs[i]), to_quat(outputs[i + 1]), t)));
+				}
+				else
+				{
+					values[c] = glm::mix(outputs[i], outputs[i + 1], t);
+				}
+				break;
+			}
+			case Interpolation::Step:
+			{
+				values[c] = rotation ? to_vec4(glm::normalize(to_quat(outputs[i]))) : outputs[i];
+				break;
+			}
+			case Interpolation::CubicSpline:
+			{
+				glm::vec4 p0 = outputs[i * 3 + 1];              // Starting point
+				glm::vec4 p1 = outputs[(i + 1) * 3 + 1];        // Ending point
+
+				glm::vec4 m0 = delta * outputs[i * 3 + 2];              // Delta time * out tangent
+				glm::vec4 m1 = delta * outputs[(i + 1) * 3 + 0];        // Delta time * in tangent of next point
+
+				float t2 = t * t;
+				float t3 = t2 * t;
+
+				// This equation is taken from the GLTF 2.0 specification Appendix C (https://github.com/KhronosGroup/glTF/tree/main/specification/2.0#appendix-c-spline-interpolation)
+				glm::vec4 result = (2.0f * t3 - 3.0f * t2 + 1.0f) * p0 + (t3 - 2.0f * t2 + t) * m0 + (-2.0f * t3 + 3.0f * t2) * p1 + (t3 - t2) * m1;
+
+				values[c] = rotation ? to_vec4(glm::normalize(to_quat(result))) : result;
+				break;
+			}
+		}
+
+		active[c] = 1;
+	}
+}
+
+size_t AnimationChannels::size() const
+{
+	return interpolations.size();
+}
+
+bool AnimationChannels::is_active(size_t channel) const
+{
+	return active[channel] != 0;
+}
+
+const glm::vec4 &AnimationChannels::get_value(size_t channel) const
+{
+	return values[channel];
+}
+}        // namespace geometry
+}        // namespace vkb
@@ -0,0 +1,364 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry/culling.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+#include <ctpl_stl.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define VKB_GEOMETRY_SSE
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#	include <arm_neon.h>
+#	define VKB_GEOMETRY_NEON
+#endif
+
+namespace vkb
+{
+namespace geometry
+{
+namespace
+{
+#if defined(VKB_GEOMETRY_SSE)
+using Float4 = __m128;
+
+inline Float4 load(const float *values)
+{
+	return _mm_loadu_ps(values);
+}
+
+inline Float4 splat(float value)
+{
+	return _mm_set1_ps(value);
+}
+
+inline Float4 add(Float4 a, Float4 b)
+{
+	return _mm_add_ps(a, b);
+}
+
+/// Returns a * b + c
+inline Float4 mul_add(Float4 a, Float4 b, Float4 c)
+{
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+}
+
+/// Bit i is set if lane i is positive or zero
+inline uint32_t non_negative_mask(Float4 values)
+{
+	return static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(values, _mm_setzero_ps())));
+}
+#elif defined(VKB_GEOMETRY_NEON)
+using Float4 = float32x4_t;
+
+inline Float4 load(const float *values)
+{
+	return vld1q_f32(values);
+}
+
+inline Float4 splat(float value)
+{
+	return vdupq_n_f32(value);
+}
+
+inline Float4 add(Float4 a, Float4 b)
+{
+	return vaddq_f32(a, b);
+}
+
+inline Float4 mul_add(Float4 a, Float4 b, Float4 c)
+{
+	return vmlaq_f32(c, a, b);
+}
+
+inline uint32_t non_negative_mask(Float4 values)
+{
+	static const uint32_t lane_bits[4] = {1, 2, 4, 8};
+
+	uint32x4_t bits = vandq_u32(vcgeq_f32(values, vdupq_n_f32(0.0f)), vld1q_u32(lane_bits));
+	uint32x2_t sum  = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+	return vget_lane_u32(vpadd_u32(sum, sum), 0);
+}
+#endif
+
+#if defined(VKB_GEOMETRY_SSE) || defined(VKB_GEOMETRY_NEON)
+#	define VKB_GEOMETRY_SIMD
+
+/**
+ * @brief A plane with each component copied to all the lanes
+ */
+struct Plane4
+{
+	Float4 x, y, z, w;
+
+	/// Absolute values of the normal, to project box extents on it
+	Float4 abs_x, abs_y, abs_z;
+
+	explicit Plane4(const glm::vec4 &plane) :
+	    x{splat(plane.x)},
+	    y{splat(plane.y)},
+	    z{splat(plane.z)},
+	    w{splat(plane.w)},
+	    abs_x{splat(std::abs(plane.x))},
+	    abs_y{splat(std::abs(plane.y))},
+	    abs_z{splat(std::abs(plane.z))}
+	{}
+
+	Plane4() = default;
+};
+#endif
+
+/**
+ * @brief Signed distances of bounding spheres to a plane, offset by their radius
+ */
+struct SphereTest
+{
+	const BoundingSpheres &spheres;
+
+	float distance(size_t i, const glm::vec4 &plane) const
+	{
+		return spheres.center_x[i] * plane.x + spheres.center_y[i] * plane.y + spheres.center_z[i] * plane.z + plane.w + spheres.radius[i];
+	}
+
+#if defined(VKB_GEOMETRY_SIMD)
+	Float4 distance(size_t i, const Plane4 &plane) const
+	{
+		Float4 d = mul_add(load(&spheres.center_x[i]), plane.x, plane.w);
+		d        = mul_add(load(&spheres.center_y[i]), plane.y, d);
+		d        = mul_add(load(&spheres.center_z[i]), plane.z, d);
+		return add(load(&spheres.radius[i]), d);
+	}
+#endif
+};
+
+/**
+ * @brief Signed distances of bounding boxes to a plane, offset by the projection of their extent on its normal
+ */
+struct BoxTest
+{
+	const BoundingBoxes &boxes;
+
+	float distance(size_t i, const glm::vec4 &plane) const
+	{
+		return boxes.center_x[i] * plane.x + boxes.center_y[i] * plane.y + boxes.center_z[i] * plane.z + plane.w +
+		       boxes.extent_x[i] * std::abs(plane.x) + boxes.extent_y[i] * std::abs(plane.y) + boxes.extent_z[i] * std::abs(plane.z);
+	}
+
+#if defined(VKB_GEOMETRY_SIMD)
+	Float4 distance(size_t i, const Plane4 &plane) const
+	{
+		Float4 d = mul_add(load(&boxes.center_x[i]), plane.x, plane.w);
+		d        = mul_add(load(&boxes.center_y[i]), plane.y, d);
+		d        = mul_add(load(&boxes.center_z[i]), plane.z, d);
+		d        = mul_add(load(&boxes.extent_x[i]), plane.abs_x, d);
+		d        = mul_add(load(&boxes.extent_y[i]), plane.abs_y, d);
+		return mul_add(load(&boxes.extent_z[i]), plane.abs_z, d);
+	}
+#endif
+};
+
+inline void write_visibility(uint32_t *visibility, size_t stride, size_t i, uint32_t visible)
+{
+	*reinterpret_cast<uint32_t *>(reinterpret_cast<uint8_t *>(visibility) + i * stride) = visible;
+}
+
+template <typename Test>
+size_t cull_range(const Test &test, const glm::vec4 *frustum_planes, uint32_t plane_count, size_t begin, size_t end, uint32_t *visibility, size_t stride)
+{
+	size_t visible_count = 0;
+	size_t i             = begin;
+
+#if defined(VKB_GEOMETRY_SIMD)
+	std::array<Plane4, 6> planes;
+	for (uint32_t p = 0; p < plane_count; ++p)
+	{
+		planes[p] = Plane4(frustum_planes[p]);
+	}
+
+	for (; i + 4 <= end; i += 4)
+	{
+		// Stop testing planes once all four objects are culled
+		uint32_t mask = 0xf;
+		for (uint32_t p = 0; p < plane_count && mask; ++p)
+		{
+			mask &= non_negative_mask(test.distance(i, planes[p]));
+		}
+
+		for (uint32_t lane = 0; lane < 4; ++lane)
+		{
+			uint32_t visible = (mask >> lane) & 1;
+			write_visibility(visibility, stride, i + lane, visible);
+			visible_count += visible;
+		}
+	}
+#endif
+
+	for (; i < end; ++i)
+	{
+		uint32_t visible = 1;
+		for (uint32_t p = 0; p < plane_count && visible; ++p)
+		{
+			visible = test.distance(i, frustum_planes[p]) >= 0.0f;
+		}
+
+		write_visibility(visibility, stride, i, visible);
+		visible_count += visible;
+	}
+
+	return visible_count;
+}
+}        // namespace
+
+void BoundingSpheres::push_back(const glm::vec3 &center, float r)
+{
+	center_x.push_back(center.x);
+	center_y.push_back(center.y);
+	center_z.push_back(center.z);
+	radius.push_back(r);
+}
+
+void BoundingSpheres::reserve(size_t count)
+{
+	center_x.reserve(count);
+	center_y.reserve(count);
+	center_z.reserve(count);
+	radius.reserve(count);
+}
+
+void BoundingSpheres::clear()
+{
+	center_x.clear();
+	center_y.clear();
+	center_z.clear();
+	radius.clear();
+}
+
+size_t BoundingSpheres::size() const
+{
+	return radius.size();
+}
+
+void BoundingBoxes::push_back(const glm::vec3 &min, const glm::vec3 &max)
+{
+	glm::vec3 center = (min + max) * 0.5f;
+	glm::vec3 extent = (max - min) * 0.5f;
+
+	center_x.push_back(center.x);
+	center_y.push_back(center.y);
+	center_z.push_back(center.z);
+	extent_x.push_back(extent.x);
+	extent_y.push_back(extent.y);
+	extent_z.push_back(extent.z);
+}
+
+void BoundingBoxes::reserve(size_t count)
+{
+	center_x.reserve(count);
+	center_y.reserve(count);
+	center_z.reserve(count);
+	extent_x.reserve(count);
+	extent_y.reserve(count);
+	extent_z.reserve(count);
+}
+
+void BoundingBoxes::clear()
+{
+	center_x.clear();
+	center_y.clear();
+	center_z.clear();
+	extent_x.clear();
+	extent_y.clear();
+	extent_z.clear();
+}
+
+size_t BoundingBoxes::size() const
+{
+	return extent_x.size();
+}
+
+FrustumCuller::FrustumCuller() = default;
+
+FrustumCuller::~FrustumCuller() = default;
+
+void FrustumCuller::set_thread_count(uint32_t thread_count)
+{
+	if (thread_count > 1)
+	{
+		thread_pool = std::make_unique<ctpl::thread_pool>(thread_count);
+	}
+	else
+	{
+		thread_pool.reset();
+	}
+}
+
+size_t FrustumCuller::cull(const Planes &planes, uint32_t plane_mask, const BoundingSpheres &spheres, uint32_t *visibility, size_t stride)
+{
+	return cull_parallel(SphereTest{spheres}, planes, plane_mask, spheres.size(), visibility, stride);
+}
+
+size_t FrustumCuller::cull(const Planes &planes, uint32_t plane_mask, const BoundingBoxes &boxes, uint32_t *visibility, size_t stride)
+{
+	return cull_parallel(BoxTest{boxes}, planes, plane_mask, boxes.size(), visibility, stride);
+}
+
+template <typename Test>
+size_t FrustumCuller::cull_parallel(const Test &test, const Planes &planes, uint32_t plane_mask, size_t count, uint32_t *visibility, size_t stride)
+{
+	// Gather the tested planes, so that the kernel loops over them without checking the mask
+	Planes   tested_planes;
+	uint32_t plane_count = 0;
+	for (uint32_t p = 0; p < planes.size(); ++p)
+	{
+		if (plane_mask & (1 << p))
+		{
+			tested_planes[plane_count++] = planes[p];
+		}
+	}
+
+	if (!thread_pool || count < 2 * PARALLEL_OBJECT_COUNT)
+	{
+		return cull_range(test, tested_planes.data(), plane_count, 0, count, visibility, stride);
+	}
+
+	// Each thread writes a contiguous range of the output, multiple of 64 objects to keep threads off each other's cache lines
+	size_t chunk_count = std::min(static_cast<size_t>(thread_pool->size()), count / PARALLEL_OBJECT_COUNT);
+	size_t chunk_size  = ((count + chunk_count - 1) / chunk_count + 63) & ~size_t(63);
+
+	std::vector<std::future<size_t>> futures;
+	for (size_t chunk_begin = 0; chunk_begin < count; chunk_begin += chunk_size)
+	{
+		size_t chunk_end = std::min(chunk_begin + chunk_size, count);
+		futures.push_back(thread_pool->push([&test, &tested_planes, plane_count, chunk_begin, chunk_end, visibility, stride](size_t) {
+			return cull_range(test, tested_planes.data(), plane_count, chunk_begin, chunk_end, visibility, stride);
+		}));
+	}
+
+	size_t visible_count = 0;
+	for (auto &future : futures)
+	{
+		visible_count += future.get();
+	}
+
+	return visible_count;
+}
+}        // namespace geometry
+}        // namespace vkb
@@ -0,0 +1,429 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry/gltf.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "core/util/error.hpp"
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+namespace geometry
+{
+namespace
+{
+/**
+ * @brief Returns the first element of an accessor, checking that all of its elements lie within the buffer
+ */
+const uint8_t *get_accessor_data(const tinygltf::Model &gltf_model, const tinygltf::Accessor &accessor, size_t &stride)
+{
+	if (accessor.sparse.isSparse)
+	{
+		ERRORF("Sparse accessors are not supported");
+	}
+
+	if (accessor.bufferView < 0 || static_cast<size_t>(accessor.bufferView) >= gltf_model.bufferViews.size())
+	{
+		ERRORF("Accessor has no valid buffer view");
+	}
+
+	auto &buffer_view = gltf_model.bufferViews[accessor.bufferView];
+
+	if (buffer_view.buffer < 0 || static_cast<size_t>(buffer_view.buffer) >= gltf_model.buffers.size())
+	{
+		ERRORF("Buffer view has no valid buffer");
+	}
+
+	auto &buffer = gltf_model.buffers[buffer_view.buffer];
+
+	int byte_stride = accessor.ByteStride(buffer_view);
+	if (byte_stride <= 0)
+	{
+		ERRORF("Accessor has an invalid stride");
+	}
+
+	stride = static_cast<size_t>(byte_stride);
+
+	size_t element_size = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(accessor.componentType)) *
+	                      static_cast<size_t>(tinygltf::GetNumComponentsInType(accessor.type));
+	size_t offset       = buffer_view.byteOffset + accessor.byteOffset;
+
+	if (accessor.count > 0 && offset + stride * (accessor.count - 1) + element_size > buffer.data.size())
+	{
+		ERRORF("Accessor points outside of its buffer");
+	}
+
+	return buffer.data.data() + offset;
+}
+
+float read_float(const uint8_t *data, int component_type, bool normalized)
+{
+	switch (component_type)
+	{
+		case TINYGLTF_COMPONENT_TYPE_FLOAT:
+		{
+			float value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+		{
+			float value = static_cast<float>(*data);
+			return normalized ? value / 255.0f : value;
+		}
+		case TINYGLTF_COMPONENT_TYPE_BYTE:
+		{
+			float value = static_cast<float>(static_cast<int8_t>(*data));
+			return normalized ? std::max(value / 127.0f, -1.0f) : value;
+		}
+		case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+		{
+			uint16_t value;
+			std::memcpy(&value, data, sizeof(value));
+			return normalized ? static_cast<float>(value) / 65535.0f : static_cast<float>(value);
+		}
+		case TINYGLTF_COMPONENT_TYPE_SHORT:
+		{
+			int16_t value;
+			std::memcpy(&value, data, sizeof(value));
+			return normalized ? std::max(static_cast<float>(value) / 32767.0f, -1.0f) : static_cast<float>(value);
+		}
+		default:
+			ERRORF("Unsupported vertex attribute component type {}", component_type);
+	}
+
+	return 0.0f;
+}
+
+template <glm::length_t N>
+std::vector<glm::vec<N, float, glm::defaultp>> read_vectors(const tinygltf::Model &gltf_model, int accessor_index)
+{
+	auto &accessor = gltf_model.accessors.at(accessor_index);
+
+	if (tinygltf::GetNumComponentsInType(accessor.type) != N)
+	{
+		ERRORF("Expected an accessor with {} components", N);
+	}
+
+	size_t stride         = 0;
+	auto   data           = get_accessor_data(gltf_model, accessor, stride);
+	size_t component_size = static_cast<size_t>(tinygltf::GetComponentSizeInBytes(accessor.componentType));
+
+	std::vector<glm::vec<N, float, glm::defaultp>> vectors(accessor.count);
+
+	for (size_t i = 0; i < accessor.count; ++i)
+	{
+		for (glm::length_t c = 0; c < N; ++c)
+		{
+			vectors[i][c] = read_float(data + i * stride + c * component_size, accessor.componentType, accessor.normalized);
+		}
+	}
+
+	return vectors;
+}
+
+std::vector<uint32_t> read_indices(const tinygltf::Model &gltf_model, int accessor_index)
+{
+	auto &accessor = gltf_model.accessors.at(accessor_index);
+
+	size_t stride = 0;
+	auto   data   = get_accessor_data(gltf_model, accessor, stride);
+
+	std::vector<uint32_t> indices(accessor.count);
+
+	for (size_t i = 0; i < accessor.count; ++i)
+	{
+		auto element = data + i * stride;
+
+		switch (accessor.componentType)
+		{
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+				indices[i] = *element;
+				break;
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+			{
+				uint16_t index;
+				std::memcpy(&index, element, sizeof(index));
+				indices[i] = index;
+				break;
+			}
+			case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+				std::memcpy(&indices[i], element, sizeof(uint32_t));
+				break;
+			default:
+				ERRORF("Unsupported index component type {}", accessor.componentType);
+		}
+	}
+
+	return indices;
+}
+
+Primitive load_primitive(const tinygltf::Model &gltf_model, const tinygltf::Primitive &gltf_primitive)
+{
+	Primitive primitive;
+
+	auto position_it = gltf_primitive.attributes.find("POSITION");
+	if (position_it != gltf_primitive.attributes.end())
+	{
+		primitive.positions = read_vectors<3>(gltf_model, position_it->second);
+
+		// glTF requires the bounds of the positions, compute them if they are missing anyway
+		auto &accessor = gltf_model.accessors.at(position_it->second);
+		if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+		{
+			primitive.min = glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]);
+			primitive.max = glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2]);
+		}
+		else if (!primitive.positions.empty())
+		{
+			primitive.min = glm::vec3(std::numeric_limits<float>::max());
+			primitive.max = glm::vec3(std::numeric_limits<float>::lowest());
+
+			for (auto &position : primitive.positions)
+			{
+				primitive.min = glm::min(primitive.min, position);
+				primitive.max = glm::max(primitive.max, position);
+			}
+		}
+	}
+
+	auto normal_it = gltf_primitive.attributes.find("NORMAL");
+	if (normal_it != gltf_primitive.attributes.end())
+	{
+		primitive.normals = read_vectors<3>(gltf_model, normal_it->second);
+	}
+
+	auto texcoord_it = gltf_primitive.attributes.find("TEXCOORD_0");
+	if (texcoord_it != gltf_primitive.attributes.end())
+	{
+		primitive.texcoords = read_vectors<2>(gltf_model, texcoord_it->second);
+	}
+
+	if (gltf_primitive.indices >= 0)
+	{
+		primitive.indices = read_indices(gltf_model, gltf_primitive.indices);
+	}
+
+	primitive.material = gltf_primitive.material;
+
+	return primitive;
+}
+
+Material load_material(const tinygltf::Material &gltf_material)
+{
+	Material material;
+
+	material.name = gltf_material.name;
+
+	auto &pbr = gltf_material.pbrMetallicRoughness;
+	if (pbr.baseColorFactor.size() == 4)
+	{
+		material.base_color_factor = glm::vec4(pbr.baseColorFactor[0], pbr.baseColorFactor[1], pbr.baseColorFactor[2], pbr.baseColorFactor[3]);
+	}
+	material.metallic_factor            = static_cast<float>(pbr.metallicFactor);
+	material.roughness_factor           = static_cast<float>(pbr.roughnessFactor);
+	material.base_color_texture         = pbr.baseColorTexture.index;
+	material.metallic_roughness_texture = pbr.metallicRoughnessTexture.index;
+
+	if (gltf_material.emissiveFactor.size() == 3)
+	{
+		material.emissive_factor = glm::vec3(gltf_material.emissiveFactor[0], gltf_material.emissiveFactor[1], gltf_material.emissiveFactor[2]);
+	}
+
+	material.alpha_mode        = gltf_material.alphaMode;
+	material.alpha_cutoff      = static_cast<float>(gltf_material.alphaCutoff);
+	material.double_sided      = gltf_material.doubleSided;
+	material.normal_texture    = gltf_material.normalTexture.index;
+	material.occlusion_texture = gltf_material.occlusionTexture.index;
+	material.emissive_texture  = gltf_material.emissiveTexture.index;
+
+	return material;
+}
+
+glm::mat4 get_local_transform(const tinygltf::Node &gltf_node)
+{
+	if (gltf_node.matrix.size() == 16)
+	{
+		glm::mat4 matrix;
+		std::transform(gltf_node.matrix.begin(), gltf_node.matrix.end(), glm::value_ptr(matrix), [](double value) { return static_cast<float>(value); });
+		return matrix;
+	}
+
+	glm::mat4 transform{1.0f};
+
+	if (gltf_node.translation.size() == 3)
+	{
+		transform = glm::translate(transform, glm::vec3(gltf_node.translation[0], gltf_node.translation[1], gltf_node.translation[2]));
+	}
+
+	if (gltf_node.rotation.size() == 4)
+	{
+		// glTF stores quaternions as x, y, z, w
+		transform *= glm::mat4_cast(glm::quat(static_cast<float>(gltf_node.rotation[3]),
+		                                      static_cast<float>(gltf_node.rotation[0]),
+		                                      static_cast<float>(gltf_node.rotation[1]),
+		                                      static_cast<float>(gltf_node.rotation[2])));
+	}
+
+	if (gltf_node.scale.size() == 3)
+	{
+		transform = glm::scale(transform, glm::vec3(gltf_node.scale[0], gltf_node.scale[1], gltf_node.scale[2]));
+	}
+
+	return transform;
+}
+
+bool skip_image_data(tinygltf::Image *, const int, std::string *, std::string *, int, int, const unsigned char *, int, void *)
+{
+	// Only the geometry is imported, images are left undecoded
+	return true;
+}
+
+Model convert(bool result, const tinygltf::Model &gltf_model, const std::string &err, const std::string &warn, const std::string &name, int scene_index)
+{
+	if (!result || !err.empty())
+	{
+		ERRORF("Failed to load glTF {}: {}", name, err);
+	}
+
+	if (!warn.empty())
+	{
+		LOGW("glTF {}: {}", name, warn);
+	}
+
+	return load_gltf(gltf_model, scene_index);
+}
+}        // namespace
+
+Model load_gltf(const tinygltf::Model &gltf_model, int scene_index)
+{
+	Model model;
+
+	model.meshes.reserve(gltf_model.meshes.size());
+	for (auto &gltf_mesh : gltf_model.meshes)
+	{
+		Mesh mesh;
+		mesh.name = gltf_mesh.name;
+
+		for (auto &gltf_primitive : gltf_mesh.primitives)
+		{
+			if (gltf_primitive.mode != TINYGLTF_MODE_TRIANGLES && gltf_primitive.mode != -1)
+			{
+				LOGW("Skipping primitive of mesh '{}' which is not a triangle list", gltf_mesh.name);
+				continue;
+			}
+
+			mesh.primitives.push_back(load_primitive(gltf_model, gltf_primitive));
+		}
+
+		model.meshes.push_back(std::move(mesh));
+	}
+
+	model.materials.reserve(gltf_model.materials.size());
+	for (auto &gltf_material : gltf_model.materials)
+	{
+		model.materials.push_back(load_material(gltf_material));
+	}
+
+	model.nodes.resize(gltf_model.nodes.size());
+	for (size_t node_index = 0; node_index < gltf_model.nodes.size(); ++node_index)
+	{
+		auto &gltf_node = gltf_model.nodes[node_index];
+		auto &node      = model.nodes[node_index];
+
+		node.name            = gltf_node.name;
+		node.mesh            = gltf_node.mesh;
+		node.local_transform = get_local_transform(gltf_node);
+
+		for (int child : gltf_node.children)
+		{
+			if (child < 0 || static_cast<size_t>(child) >= gltf_model.nodes.size())
+			{
+				ERRORF("Node '{}' has an invalid child", gltf_node.name);
+			}
+
+			node.children.push_back(static_cast<uint32_t>(child));
+			model.nodes[child].parent = static_cast<int32_t>(node_index);
+		}
+	}
+
+	if (scene_index < 0)
+	{
+		scene_index = gltf_model.defaultScene;
+	}
+
+	if (scene_index >= 0 && static_cast<size_t>(scene_index) < gltf_model.scenes.size())
+	{
+		for (int node_index : gltf_model.scenes[scene_index].nodes)
+		{
+			model.scene_nodes.push_back(static_cast<uint32_t>(node_index));
+		}
+	}
+	else
+	{
+		// Without a scene, every root node is part of the model
+		for (size_t node_index = 0; node_index < model.nodes.size(); ++node_index)
+		{
+			if (model.nodes[node_index].parent < 0)
+			{
+				model.scene_nodes.push_back(static_cast<uint32_t>(node_index));
+			}
+		}
+	}
+
+	return model;
+}
+
+Model load_gltf_from_file(const std::string &path, int scene_index)
+{
+	tinygltf::TinyGLTF loader;
+	loader.SetImageLoader(skip_image_data, nullptr);
+
+	tinygltf::Model gltf_model;
+	std::string     err;
+	std::string     warn;
+
+	bool binary = path.size() >= 4 && path.compare(path.size() - 4, 4, ".glb") == 0;
+	bool result = binary ? loader.LoadBinaryFromFile(&gltf_model, &err, &warn, path) :
+	                       loader.LoadASCIIFromFile(&gltf_model, &err, &warn, path);
+
+	return convert(result, gltf_model, err, warn, path, scene_index);
+}
+
+Model load_gltf_from_memory(const std::string &json, const std::string &base_dir)
+{
+	tinygltf::TinyGLTF loader;
+	loader.SetImageLoader(skip_image_data, nullptr);
+
+	tinygltf::Model gltf_model;
+	std::string     err;
+	std::string     warn;
+
+	bool result = loader.LoadASCIIFromString(&gltf_model, &err, &warn, json.c_str(), static_cast<unsigned int>(json.size()), base_dir);
+
+	return convert(result, gltf_model, err, warn, "from memory", -1);
+}
+}        // namespace geometry
+}        // namespace vkb
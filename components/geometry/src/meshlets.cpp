@@ -0,0 +1,376 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "geometry/meshlets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <memory>
+#include <thread>
+
+#include <ctpl_stl.h>
+
+#include "core/util/error.hpp"
+
+namespace vkb
+{
+namespace geometry
+{
+namespace
+{
+/// Marks the mesh vertices which are not in the current meshlet
+constexpr uint8_t NOT_IN_MESHLET = 0xff;
+
+/**
+ * @brief The triangles using each vertex, stored contiguously
+ *        Emitted triangles are removed so that the lists only hold candidates.
+ */
+struct TriangleAdjacency
+{
+	std::vector<uint32_t> counts;
+
+	std::vector<uint32_t> offsets;
+
+	std::vector<uint32_t> triangles;
+
+	TriangleAdjacency(const uint32_t *indices, size_t index_count, size_t vertex_count) :
+	    counts(vertex_count, 0),
+	    offsets(vertex_count, 0),
+	    triangles(index_count)
+	{
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			counts[indices[i]]++;
+		}
+
+		uint32_t offset = 0;
+		for (size_t v = 0; v < vertex_count; ++v)
+		{
+			offsets[v] = offset;
+			offset += counts[v];
+		}
+
+		std::fill(counts.begin(), counts.end(), 0);
+
+		for (size_t i = 0; i < index_count; ++i)
+		{
+			uint32_t v                          = indices[i];
+			triangles[offsets[v] + counts[v]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+
+	void remove(uint32_t vertex, uint32_t triangle)
+	{
+		auto begin = triangles.begin() + offsets[vertex];
+		auto end   = begin + counts[vertex];
+		auto it    = std::find(begin, end, triangle);
+
+		// A degenerate triangle is listed several times for the same vertex, and already removed after the first time
+		if (it != end)
+		{
+			*it = *(end - 1);
+			counts[vertex]--;
+		}
+	}
+};
+
+/**
+ * @brief Counts the distinct vertices of a triangle which are not in the current meshlet yet
+ */
+inline uint32_t count_new_vertices(const uint32_t *triangle, const std::vector<uint8_t> &local_indices)
+{
+	uint32_t a = triangle[0];
+	uint32_t b = triangle[1];
+	uint32_t c = triangle[2];
+
+	return (local_indices[a] == NOT_IN_MESHLET) +
+	       (local_indices[b] == NOT_IN_MESHLET && b != a) +
+	       (local_indices[c] == NOT_IN_MESHLET && c != a && c != b);
+}
+
+inline glm::vec3 read_position(const MeshletSource &source, uint32_t vertex)
+{
+	glm::vec3 position;
+	std::memcpy(&position, reinterpret_cast<const uint8_t *>(source.positions) + vertex * source.position_stride, sizeof(position));
+	return position;
+}
+
+MeshletBounds compute_bounds(const MeshletSource &source, const Meshlets &meshlets, const Meshlet &meshlet)
+{
+	MeshletBounds bounds{};
+
+	// Center the sphere on the bounding box, which is cheap and close enough to the optimal sphere for culling
+	glm::vec3 min{std::numeric_limits<float>::max()};
+	glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+	for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+	{
+		auto position = read_position(source, meshlets.vertices[meshlet.vertex_offset + i]);
+		min           = glm::min(min, position);
+		max           = glm::max(max, position);
+	}
+
+	bounds.center = (min + max) * 0.5f;
+
+	for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+	{
+		auto position = read_position(source, meshlets.vertices[meshlet.vertex_offset + i]);
+		bounds.radius = std::max(bounds.radius, glm::length(position - bounds.center));
+	}
+
+	std::vector<glm::vec3> normals;
+	normals.reserve(meshlet.triangle_count);
+
+	glm::vec3 normal_sum{0.0f};
+
+	for (uint32_t t = 0; t < meshlet.triangle_count; ++t)
+	{
+		auto local = &meshlets.triangles[meshlet.triangle_offset + t * 3];
+
+		auto a = read_position(source, meshlets.vertices[meshlet.vertex_offset + local[0]]);
+		auto b = read_position(source, meshlets.vertices[meshlet.vertex_offset + local[1]]);
+		auto c = read_position(source, meshlets.vertices[meshlet.vertex_offset + local[2]]);
+
+		auto  normal = glm::cross(b - a, c - a);
+		float length = glm::length(normal);
+
+		// Degenerate triangles face no direction
+		if (length > 0.0f)
+		{
+			normals.push_back(normal / length);
+			normal_sum += normals.back();
+		}
+	}
+
+	bounds.cone_axis   = glm::vec3(0.0f, 0.0f, 1.0f);
+	bounds.cone_cutoff = 1.0f;
+
+	float axis_length = glm::length(normal_sum);
+	if (normals.empty() || axis_length == 0.0f)
+	{
+		return bounds;
+	}
+
+	bounds.cone_axis = normal_sum / axis_length;
+
+	float min_dot = 1.0f;
+	for (auto &normal : normals)
+	{
+		min_dot = std::min(min_dot, glm::dot(bounds.cone_axis, normal));
+	}
+
+	// Normals spread over more than a hemisphere, some triangles always face the camera
+	if (min_dot > 0.0f)
+	{
+		bounds.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+	}
+
+	return bounds;
+}
+}        // namespace
+
+Meshlets build_meshlets(const MeshletSource &source, const MeshletOptions &options)
+{
+	if (options.max_vertices < 3 || options.max_vertices > NOT_IN_MESHLET)
+	{
+		ERRORF("Meshlets need between 3 and 255 vertices");
+	}
+
+	if (options.max_triangles == 0)
+	{
+		ERRORF("Meshlets need at least one triangle");
+	}
+
+	if (source.index_count % 3 != 0)
+	{
+		ERRORF("Meshlets can only be built from triangle lists");
+	}
+
+	const uint32_t *indices = source.indices;
+	for (size_t i = 0; i < source.index_count; ++i)
+	{
+		if (indices[i] >= source.vertex_count)
+		{
+			ERRORF("Index {} is out of range", i);
+		}
+	}
+
+	size_t triangle_count = source.index_count / 3;
+
+	Meshlets meshlets;
+	meshlets.triangles.reserve(source.index_count);
+	meshlets.vertices.reserve(source.index_count / 2);
+
+	// Local index of each mesh vertex in the current meshlet, reset whenever a meshlet is completed
+	std::vector<uint8_t> local_indices(source.vertex_count, NOT_IN_MESHLET);
+
+	std::unique_ptr<TriangleAdjacency> adjacency;
+	std::vector<uint8_t>               emitted;
+	if (options.optimize_vertex_reuse)
+	{
+		adjacency = std::make_unique<TriangleAdjacency>(indices, source.index_count, source.vertex_count);
+		emitted.resize(triangle_count, 0);
+	}
+
+	Meshlet meshlet{};
+
+	auto finish_meshlet = [&]() {
+		for (uint32_t i = 0; i < meshlet.vertex_count; ++i)
+		{
+			local_indices[meshlets.vertices[meshlet.vertex_offset + i]] = NOT_IN_MESHLET;
+		}
+
+		meshlets.meshlets.push_back(meshlet);
+
+		meshlet                 = Meshlet{};
+		meshlet.vertex_offset   = static_cast<uint32_t>(meshlets.vertices.size());
+		meshlet.triangle_offset = static_cast<uint32_t>(meshlets.triangles.size());
+	};
+
+	// Next triangle in index order which has not been emitted, used to start a meshlet when no neighbour is left
+	size_t seed_cursor = 0;
+
+	for (size_t emitted_count = 0; emitted_count < triangle_count; ++emitted_count)
+	{
+		size_t triangle = seed_cursor;
+
+		if (adjacency)
+		{
+			// Pick the neighbour adding the fewest vertices to the meshlet
+			uint32_t best_count = 4;
+			for (uint32_t i = 0; i < meshlet.vertex_count && best_count > 0; ++i)
+			{
+				uint32_t vertex    = meshlets.vertices[meshlet.vertex_offset + i];
+				auto     neighbour = &adjacency->triangles[adjacency->offsets[vertex]];
+
+				for (uint32_t j = 0; j < adjacency->counts[vertex]; ++j)
+				{
+					uint32_t count = count_new_vertices(&indices[neighbour[j] * 3], local_indices);
+					if (count < best_count)
+					{
+						best_count = count;
+						triangle   = neighbour[j];
+
+						if (count == 0)
+						{
+							break;
+						}
+					}
+				}
+			}
+
+			if (best_count == 4)
+			{
+				while (emitted[seed_cursor])
+				{
+					++seed_cursor;
+				}
+				triangle = seed_cursor;
+			}
+		}
+		else
+		{
+			seed_cursor++;
+		}
+
+		const uint32_t *corners = &indices[triangle * 3];
+
+		uint32_t new_count = count_new_vertices(corners, local_indices);
+
+		if (meshlet.vertex_count + new_count > options.max_vertices || meshlet.triangle_count == options.max_triangles)
+		{
+			finish_meshlet();
+		}
+
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			uint32_t vertex = corners[c];
+
+			if (local_indices[vertex] == NOT_IN_MESHLET)
+			{
+				local_indices[vertex] = static_cast<uint8_t>(meshlet.vertex_count++);
+				meshlets.vertices.push_back(vertex);
+			}
+
+			meshlets.triangles.push_back(local_indices[vertex]);
+		}
+
+		meshlet.triangle_count++;
+
+		if (adjacency)
+		{
+			emitted[triangle] = 1;
+
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				adjacency->remove(corners[c], static_cast<uint32_t>(triangle));
+			}
+		}
+	}
+
+	if (meshlet.triangle_count > 0)
+	{
+		finish_meshlet();
+	}
+
+	if (source.positions)
+	{
+		meshlets.bounds.reserve(meshlets.meshlets.size());
+		for (auto &meshlet : meshlets.meshlets)
+		{
+			meshlets.bounds.push_back(compute_bounds(source, meshlets, meshlet));
+		}
+	}
+
+	return meshlets;
+}
+
+std::vector<Meshlets> build_meshlets(const std::vector<MeshletSource> &sources, const MeshletOptions &options, uint32_t thread_count)
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1U, std::thread::hardware_concurrency());
+	}
+
+	thread_count = std::min(thread_count, static_cast<uint32_t>(std::max<size_t>(sources.size(), 1)));
+
+	ctpl::thread_pool thread_pool(thread_count);
+
+	std::vector<std::future<Meshlets>> futures;
+	futures.reserve(sources.size());
+
+	for (auto &source : sources)
+	{
+		futures.push_back(thread_pool.push([&source, &options](size_t) { return build_meshlets(source, options); }));
+	}
+
+	std::vector<Meshlets> meshlets;
+	meshlets.reserve(sources.size());
+
+	// Rethrows the first error of a task
+	for (auto &future : futures)
+	{
+		meshlets.push_back(future.get());
+	}
+
+	return meshlets;
+}
+}        // namespace geometry
+}        // namespace vkb
@@ -0,0 +1,290 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <ctpl_stl.h>
+
+#include "geometry/animation.hpp"
+
+using namespace vkb::geometry;
+
+// Keyframes at uneven times, like the ones of an exported animation
+std::vector<float> make_random_inputs(size_t count, std::mt19937 &random)
+{
+	std::uniform_real_distribution<float> step{0.01f, 0.05f};
+
+	std::vector<float> inputs(count);
+	float              time = 0.0f;
+	for (auto &input : inputs)
+	{
+		input = time;
+		time += step(random);
+	}
+
+	return inputs;
+}
+
+uint32_t find_keyframe_binary_search(const std::vector<float> &inputs, float time)
+{
+	auto keyframe = static_cast<uint32_t>(std::upper_bound(inputs.begin(), inputs.end(), time) - inputs.begin());
+
+	return std::min(keyframe == 0 ? 0 : keyframe - 1, static_cast<uint32_t>(inputs.size()) - 2);
+}
+
+bool approx_equal(const glm::vec4 &a, const glm::vec4 &b)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		if (std::abs(a[i] - b[i]) > 1e-5f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("find_keyframe matches a binary search forward, backward and when skipping keyframes", "[animation]")
+{
+	std::mt19937 random{42};
+	auto         inputs = make_random_inputs(64, random);
+	auto         count  = static_cast<uint32_t>(inputs.size());
+
+	std::uniform_real_distribution<float> any_time{inputs.front(), inputs.back()};
+
+	std::vector<float> times;
+	for (float time = inputs.front(); time <= inputs.back(); time += 0.004f)
+	{
+		times.push_back(time);
+	}
+	for (size_t i = 0; i < 256; ++i)
+	{
+		times.push_back(any_time(random));
+	}
+	// Keyframe times themselves and the very end
+	times.insert(times.end(), inputs.begin(), inputs.end());
+	times.insert(times.end(), inputs.rbegin(), inputs.rend());
+
+	uint32_t cursor = 0;
+	for (float time : times)
+	{
+		cursor = find_keyframe(inputs.data(), count, cursor, time);
+		REQUIRE(cursor == find_keyframe_binary_search(inputs, time));
+		REQUIRE(inputs[cursor] <= time);
+		REQUIRE((time < inputs[cursor + 1] || cursor == count - 2));
+	}
+}
+
+TEST_CASE("AnimationChannels interpolates linear, step and cubic spline channels", "[animation]")
+{
+	AnimationChannels channels;
+
+	std::vector<float> inputs{0.0f, 1.0f, 3.0f};
+
+	REQUIRE(channels.add(Interpolation::Linear, false, inputs, {glm::vec4(0.0f), glm::vec4(2.0f), glm::vec4(6.0f)}));
+	REQUIRE(channels.add(Interpolation::Step, false, inputs, {glm::vec4(1.0f), glm::vec4(2.0f), glm::vec4(3.0f)}));
+
+	// A cubic spline with zero tangents goes through its values with a smoothstep
+	REQUIRE(channels.add(Interpolation::CubicSpline, false, inputs,
+	                     {glm::vec4(0.0f), glm::vec4(0.0f), glm::vec4(0.0f),
+	                      glm::vec4(0.0f), glm::vec4(4.0f), glm::vec4(0.0f),
+	                      glm::vec4(0.0f), glm::vec4(8.0f), glm::vec4(0.0f)}));
+
+	REQUIRE(channels.size() == 3);
+
+	channels.evaluate(2.0f);
+	REQUIRE(channels.is_active(0));
+	REQUIRE(approx_equal(channels.get_value(0), glm::vec4(4.0f)));
+	REQUIRE(approx_equal(channels.get_value(1), glm::vec4(2.0f)));
+	REQUIRE(approx_equal(channels.get_value(2), glm::vec4(6.0f)));
+
+	channels.evaluate(0.25f);
+	REQUIRE(approx_equal(channels.get_value(0), glm::vec4(0.5f)));
+	REQUIRE(approx_equal(channels.get_value(1), glm::vec4(1.0f)));
+	REQUIRE(approx_equal(channels.get_value(2), glm::vec4(4.0f * (3.0f * 0.0625f - 2.0f * 0.015625f))));
+
+	channels.evaluate(3.0f);
+	REQUIRE(approx_equal(channels.get_value(0), glm::vec4(6.0f)));
+	REQUIRE(approx_equal(channels.get_value(2), glm::vec4(8.0f)));
+}
+
+TEST_CASE("AnimationChannels normalizes rotations", "[animation]")
+{
+	AnimationChannels channels;
+
+	// A quarter turn around z, stored as x, y, z, w
+	float     half_angle = glm::radians(45.0f);
+	glm::vec4 identity{0.0f, 0.0f, 0.0f, 1.0f};
+	glm::vec4 quarter_turn{0.0f, 0.0f, std::sin(half_angle), std::cos(half_angle)};
+
+	REQUIRE(channels.add(Interpolation::Linear, true, {0.0f, 1.0f}, {identity, quarter_turn}));
+	REQUIRE(channels.add(Interpolation::Step, true, {0.0f, 1.0f}, {2.0f * quarter_turn, identity}));
+
+	channels.evaluate(0.5f);
+
+	float eighth_turn = glm::radians(22.5f);
+	REQUIRE(approx_equal(channels.get_value(0), glm::vec4(0.0f, 0.0f, std::sin(eighth_turn), std::cos(eighth_turn))));
+	REQUIRE(approx_equal(channels.get_value(1), quarter_turn));
+}
+
+TEST_CASE("AnimationChannels are inactive outside of their keyframes", "[animation]")
+{
+	AnimationChannels channels;
+
+	REQUIRE(channels.add(Interpolation::Linear, false, {1.0f, 2.0f}, {glm::vec4(0.0f), glm::vec4(1.0f)}));
+	REQUIRE(channels.add(Interpolation::Linear, false, {0.0f}, {glm::vec4(0.0f)}));
+
+	channels.evaluate(0.5f);
+	REQUIRE_FALSE(channels.is_active(0));
+	REQUIRE_FALSE(channels.is_active(1));
+
+	channels.evaluate(1.5f);
+	REQUIRE(channels.is_active(0));
+
+	channels.evaluate(2.5f);
+	REQUIRE_FALSE(channels.is_active(0));
+}
+
+TEST_CASE("AnimationChannels rejects channels with too few outputs", "[animation]")
+{
+	AnimationChannels channels;
+
+	std::vector<float> inputs{0.0f, 1.0f};
+
+	REQUIRE_FALSE(channels.add(Interpolation::Linear, false, inputs, {glm::vec4(0.0f)}));
+	REQUIRE_FALSE(channels.add(Interpolation::CubicSpline, false, inputs, {glm::vec4(0.0f), glm::vec4(0.0f), glm::vec4(0.0f)}));
+	REQUIRE(channels.size() == 0);
+}
+
+TEST_CASE("AnimationChannels evaluated on a thread pool match the calling thread", "[animation]")
+{
+	std::mt19937 random{42};
+
+	AnimationChannels single_threaded;
+	AnimationChannels parallel;
+	for (size_t c = 0; c < AnimationChannels::PARALLEL_CHANNEL_COUNT * 2; ++c)
+	{
+		auto inputs = make_random_inputs(8, random);
+
+		std::vector<glm::vec4> outputs(inputs.size());
+		for (size_t i = 0; i < outputs.size(); ++i)
+		{
+			outputs[i] = glm::vec4(static_cast<float>(c + i));
+		}
+
+		single_threaded.add(Interpolation::Linear, false, inputs, outputs);
+		parallel.add(Interpolation::Linear, false, inputs, outputs);
+	}
+
+	ctpl::thread_pool thread_pool{4};
+
+	single_threaded.evaluate(0.1f);
+	parallel.evaluate(0.1f, &thread_pool);
+
+	for (size_t c = 0; c < single_threaded.size(); ++c)
+	{
+		REQUIRE(single_threaded.is_active(c) == parallel.is_active(c));
+		REQUIRE(single_threaded.get_value(c) == parallel.get_value(c));
+	}
+}
+
+TEST_CASE("AnimationChannels playback of thousands of channels", "[.][benchmark]")
+{
+	constexpr size_t channel_count  = 4096;
+	constexpr size_t keyframe_count = 64;
+
+	// One second of playback at 60 frames per second
+	constexpr size_t frame_count = 60;
+
+	std::mt19937 random{42};
+
+	AnimationChannels               channels;
+	std::vector<std::vector<float>> channel_inputs;
+	for (size_t c = 0; c < channel_count; ++c)
+	{
+		auto inputs = make_random_inputs(keyframe_count, random);
+
+		std::vector<glm::vec4> outputs(inputs.size());
+		for (auto &output : outputs)
+		{
+			output = glm::vec4(std::uniform_real_distribution<float>{-1.0f, 1.0f}(random));
+		}
+
+		channels.add(c % 3 == 0 ? Interpolation::Linear : Interpolation::Step, c % 4 == 0, inputs, outputs);
+		channel_inputs.push_back(std::move(inputs));
+	}
+
+	BENCHMARK("find_keyframe, binary search")
+	{
+		uint32_t sum = 0;
+		for (size_t frame = 0; frame < frame_count; ++frame)
+		{
+			float time = frame / 60.0f;
+			for (auto &inputs : channel_inputs)
+			{
+				sum += find_keyframe_binary_search(inputs, time);
+			}
+		}
+		return sum;
+	};
+
+	BENCHMARK("find_keyframe, cursor")
+	{
+		std::vector<uint32_t> cursors(channel_count, 0);
+
+		uint32_t sum = 0;
+		for (size_t frame = 0; frame < frame_count; ++frame)
+		{
+			float time = frame / 60.0f;
+			for (size_t c = 0; c < channel_count; ++c)
+			{
+				auto &inputs = channel_inputs[c];
+				cursors[c]   = find_keyframe(inputs.data(), static_cast<uint32_t>(inputs.size()), cursors[c], time);
+				sum += cursors[c];
+			}
+		}
+		return sum;
+	};
+
+	BENCHMARK("evaluate, calling thread")
+	{
+		for (size_t frame = 0; frame < frame_count; ++frame)
+		{
+			channels.evaluate(frame / 60.0f);
+		}
+		return channels.get_value(0);
+	};
+
+	for (int thread_count : {2, 4})
+	{
+		ctpl::thread_pool thread_pool{thread_count};
+
+		BENCHMARK("evaluate, " + std::to_string(thread_count) + " threads")
+		{
+			for (size_t frame = 0; frame < frame_count; ++frame)
+			{
+				channels.evaluate(frame / 60.0f, &thread_pool);
+			}
+			return channels.get_value(0);
+		};
+	}
+}
@@ -0,0 +1,184 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <random>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "geometry/culling.hpp"
+
+using namespace vkb::geometry;
+
+// Same layout as VkDrawIndexedIndirectCommand
+struct DrawCommand
+{
+	uint32_t index_count;
+	uint32_t instance_count;
+	uint32_t first_index;
+	int32_t  vertex_offset;
+	uint32_t first_instance;
+};
+
+// Planes of an identity view projection, in the order of vkb::Frustum, the visible volume is the cube [-1, 1]
+const FrustumCuller::Planes unit_cube{glm::vec4{1.0f, 0.0f, 0.0f, 1.0f},
+                                      glm::vec4{-1.0f, 0.0f, 0.0f, 1.0f},
+                                      glm::vec4{0.0f, -1.0f, 0.0f, 1.0f},
+                                      glm::vec4{0.0f, 1.0f, 0.0f, 1.0f},
+                                      glm::vec4{0.0f, 0.0f, 1.0f, 1.0f},
+                                      glm::vec4{0.0f, 0.0f, -1.0f, 1.0f}};
+
+BoundingSpheres make_random_spheres(size_t count)
+{
+	std::mt19937                          random{42};
+	std::uniform_real_distribution<float> position{-3.0f, 3.0f};
+	std::uniform_real_distribution<float> radius{0.0f, 1.0f};
+
+	BoundingSpheres spheres;
+	spheres.reserve(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		spheres.push_back({position(random), position(random), position(random)}, radius(random));
+	}
+
+	return spheres;
+}
+
+// Tests one sphere at a time, like the culling this kernel replaced
+std::vector<uint32_t> cull_one_by_one(const FrustumCuller::Planes &planes, uint32_t plane_mask, const BoundingSpheres &spheres)
+{
+	std::vector<uint32_t> visibility(spheres.size());
+
+	for (size_t i = 0; i < spheres.size(); ++i)
+	{
+		glm::vec3 center{spheres.center_x[i], spheres.center_y[i], spheres.center_z[i]};
+
+		visibility[i] = 1;
+		for (uint32_t p = 0; p < planes.size(); ++p)
+		{
+			if ((plane_mask & (1 << p)) && glm::dot(center, glm::vec3(planes[p])) + planes[p].w + spheres.radius[i] < 0.0f)
+			{
+				visibility[i] = 0;
+			}
+		}
+	}
+
+	return visibility;
+}
+
+TEST_CASE("Spheres are culled against a frustum", "[geometry]")
+{
+	BoundingSpheres spheres;
+	spheres.push_back({0.0f, 0.0f, 0.0f}, 0.1f);           // inside
+	spheres.push_back({3.0f, 0.0f, 0.0f}, 0.5f);           // outside
+	spheres.push_back({1.5f, 0.0f, 0.0f}, 0.6f);           // intersecting a plane
+	spheres.push_back({0.0f, -2.0f, 0.0f}, 0.5f);          // outside
+	spheres.push_back({0.0f, 0.0f, 1.2f}, 0.1f);           // outside, in the tail after the first four
+	spheres.push_back({0.0f, 0.0f, 0.0f}, 100.0f);         // containing the frustum
+
+	FrustumCuller culler;
+
+	std::vector<uint32_t> visibility(spheres.size(), 7);
+	REQUIRE(culler.cull(unit_cube, FrustumCuller::ALL_PLANES, spheres, visibility.data()) == 3);
+	REQUIRE(visibility == std::vector<uint32_t>{1, 0, 1, 0, 0, 1});
+}
+
+TEST_CASE("Boxes are culled against a frustum", "[geometry]")
+{
+	BoundingBoxes boxes;
+	boxes.push_back({-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f});        // inside
+	boxes.push_back({2.0f, 2.0f, 2.0f}, {3.0f, 3.0f, 3.0f});           // outside
+	boxes.push_back({0.9f, -3.0f, 0.0f}, {1.1f, 3.0f, 0.1f});          // intersecting several planes
+	boxes.push_back({-5.0f, 0.0f, 0.0f}, {-1.01f, 0.1f, 0.1f});        // outside
+	boxes.push_back({-5.0f, -5.0f, -5.0f}, {5.0f, 5.0f, 5.0f});        // containing the frustum
+
+	FrustumCuller culler;
+
+	std::vector<uint32_t> visibility(boxes.size(), 7);
+	REQUIRE(culler.cull(unit_cube, FrustumCuller::ALL_PLANES, boxes, visibility.data()) == 3);
+	REQUIRE(visibility == std::vector<uint32_t>{1, 0, 1, 0, 1});
+}
+
+TEST_CASE("Culling writes instance counts of draw commands in place", "[geometry]")
+{
+	auto spheres = make_random_spheres(37);
+
+	std::vector<DrawCommand> commands(spheres.size(), {11, 7, 22, -33, 44});
+
+	FrustumCuller culler;
+	culler.cull(unit_cube, FrustumCuller::ALL_PLANES, spheres, &commands[0].instance_count, sizeof(DrawCommand));
+
+	auto expected = cull_one_by_one(unit_cube, FrustumCuller::ALL_PLANES, spheres);
+	for (size_t i = 0; i < commands.size(); ++i)
+	{
+		REQUIRE(commands[i].instance_count == expected[i]);
+		REQUIRE(commands[i].index_count == 11);
+		REQUIRE(commands[i].first_index == 22);
+		REQUIRE(commands[i].vertex_offset == -33);
+		REQUIRE(commands[i].first_instance == 44);
+	}
+}
+
+TEST_CASE("Culling in parallel matches culling one sphere at a time", "[geometry]")
+{
+	// Not a multiple of the chunk sizes
+	auto spheres = make_random_spheres(4 * FrustumCuller::PARALLEL_OBJECT_COUNT + 13);
+
+	for (uint32_t plane_mask : {FrustumCuller::ALL_PLANES, 0x33u})
+	{
+		auto expected = cull_one_by_one(unit_cube, plane_mask, spheres);
+
+		for (uint32_t thread_count : {1, 4})
+		{
+			FrustumCuller culler;
+			culler.set_thread_count(thread_count);
+
+			std::vector<uint32_t> visibility(spheres.size(), 7);
+			size_t                visible_count = culler.cull(unit_cube, plane_mask, spheres, visibility.data());
+
+			REQUIRE(visibility == expected);
+			REQUIRE(visible_count == static_cast<size_t>(std::count(expected.begin(), expected.end(), 1u)));
+		}
+	}
+}
+
+TEST_CASE("Culling benchmark", "[.][benchmark]")
+{
+	auto spheres = make_random_spheres(1000000);
+
+	std::vector<DrawCommand> commands(spheres.size());
+
+	BENCHMARK("one sphere at a time")
+	{
+		return cull_one_by_one(unit_cube, FrustumCuller::ALL_PLANES, spheres);
+	};
+
+	FrustumCuller culler;
+
+	BENCHMARK("four spheres at a time")
+	{
+		return culler.cull(unit_cube, FrustumCuller::ALL_PLANES, spheres, &commands[0].instance_count, sizeof(DrawCommand));
+	};
+
+	culler.set_thread_count(4);
+
+	BENCHMARK("four spheres at a time on four threads")
+	{
+		return culler.cull(unit_cube, FrustumCuller::ALL_PLANES, spheres, &commands[0].instance_count, sizeof(DrawCommand));
+	};
+}
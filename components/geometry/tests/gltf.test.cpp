@@ -0,0 +1,129 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "geometry/gltf.hpp"
+
+using namespace vkb::geometry;
+
+// One triangle: three float positions, three normalized unsigned short texture coordinates and three unsigned short indices
+const std::string TRIANGLE_BUFFER = "data:application/octet-stream;base64,AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAAEAAAAAAAAAAAP//AAAAAP//AAABAAIAAAA=";
+
+std::string make_triangle_gltf(uint32_t index_count)
+{
+	return R"({
+		"asset": {"version": "2.0"},
+		"buffers": [{"byteLength": 56, "uri": ")" +
+	       TRIANGLE_BUFFER + R"("}],
+		"bufferViews": [
+			{"buffer": 0, "byteOffset": 0, "byteLength": 36},
+			{"buffer": 0, "byteOffset": 36, "byteLength": 12},
+			{"buffer": 0, "byteOffset": 48, "byteLength": 6}
+		],
+		"accessors": [
+			{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"},
+			{"bufferView": 1, "componentType": 5123, "normalized": true, "count": 3, "type": "VEC2"},
+			{"bufferView": 2, "componentType": 5123, "count": )" +
+	       std::to_string(index_count) + R"(, "type": "SCALAR"}
+		],
+		"materials": [{
+			"name": "red",
+			"pbrMetallicRoughness": {"baseColorFactor": [1.0, 0.0, 0.0, 1.0], "metallicFactor": 0.25, "roughnessFactor": 0.75},
+			"alphaMode": "MASK",
+			"doubleSided": true
+		}],
+		"meshes": [{
+			"name": "triangle",
+			"primitives": [{"attributes": {"POSITION": 0, "TEXCOORD_0": 1}, "indices": 2, "material": 0}]
+		}],
+		"nodes": [
+			{"name": "root", "children": [1], "translation": [1.0, 2.0, 3.0]},
+			{"name": "child", "mesh": 0, "scale": [2.0, 2.0, 2.0]}
+		],
+		"scenes": [{"nodes": [0]}],
+		"scene": 0
+	})";
+}
+
+TEST_CASE("Load the geometry of a glTF model", "[geometry]")
+{
+	Model model;
+	REQUIRE_NOTHROW(model = load_gltf_from_memory(make_triangle_gltf(3)));
+
+	REQUIRE(model.meshes.size() == 1);
+	REQUIRE(model.meshes[0].name == "triangle");
+	REQUIRE(model.meshes[0].primitives.size() == 1);
+
+	auto &primitive = model.meshes[0].primitives[0];
+
+	REQUIRE(primitive.positions == std::vector<glm::vec3>{{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}});
+	REQUIRE(primitive.texcoords == std::vector<glm::vec2>{{0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}});
+	REQUIRE(primitive.normals.empty());
+	REQUIRE(primitive.indices == std::vector<uint32_t>{0, 1, 2});
+	REQUIRE(primitive.min == glm::vec3(0.0f, 0.0f, 0.0f));
+	REQUIRE(primitive.max == glm::vec3(1.0f, 2.0f, 0.0f));
+	REQUIRE(primitive.material == 0);
+}
+
+TEST_CASE("Load the materials of a glTF model", "[geometry]")
+{
+	auto model = load_gltf_from_memory(make_triangle_gltf(3));
+
+	REQUIRE(model.materials.size() == 1);
+
+	auto &material = model.materials[0];
+
+	REQUIRE(material.name == "red");
+	REQUIRE(material.base_color_factor == glm::vec4(1.0f, 0.0f, 0.0f, 1.0f));
+	REQUIRE(material.metallic_factor == 0.25f);
+	REQUIRE(material.roughness_factor == 0.75f);
+	REQUIRE(material.alpha_mode == "MASK");
+	REQUIRE(material.double_sided);
+	REQUIRE(material.base_color_texture == -1);
+}
+
+TEST_CASE("Load the node hierarchy of a glTF model", "[geometry]")
+{
+	auto model = load_gltf_from_memory(make_triangle_gltf(3));
+
+	REQUIRE(model.nodes.size() == 2);
+	REQUIRE(model.scene_nodes == std::vector<uint32_t>{0});
+
+	auto &root  = model.nodes[0];
+	auto &child = model.nodes[1];
+
+	REQUIRE(root.parent == -1);
+	REQUIRE(root.mesh == -1);
+	REQUIRE(root.children == std::vector<uint32_t>{1});
+	REQUIRE(root.local_transform[3] == glm::vec4(1.0f, 2.0f, 3.0f, 1.0f));
+
+	REQUIRE(child.parent == 0);
+	REQUIRE(child.mesh == 0);
+	REQUIRE(child.local_transform[0] == glm::vec4(2.0f, 0.0f, 0.0f, 0.0f));
+	REQUIRE(child.local_transform[3] == glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+TEST_CASE("Reject accessors outside of their buffer", "[geometry]")
+{
+	REQUIRE_THROWS(load_gltf_from_memory(make_triangle_gltf(64)));
+}
+
+TEST_CASE("Reject invalid glTF documents", "[geometry]")
+{
+	REQUIRE_THROWS(load_gltf_from_memory("{ not json"));
+}
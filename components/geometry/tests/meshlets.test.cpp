@@ -0,0 +1,296 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <set>
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include "geometry/meshlets.hpp"
+
+using namespace vkb::geometry;
+
+struct Grid
+{
+	std::vector<glm::vec3> positions;
+
+	std::vector<uint32_t> indices;
+
+	MeshletSource source() const
+	{
+		MeshletSource source;
+		source.indices      = indices.data();
+		source.index_count  = indices.size();
+		source.vertex_count = positions.size();
+		source.positions    = &positions[0].x;
+		return source;
+	}
+};
+
+// A flat grid in the XY plane facing +Z, with two triangles per cell
+Grid make_grid(uint32_t size)
+{
+	Grid grid;
+
+	for (uint32_t y = 0; y <= size; ++y)
+	{
+		for (uint32_t x = 0; x <= size; ++x)
+		{
+			grid.positions.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.0f);
+		}
+	}
+
+	for (uint32_t y = 0; y < size; ++y)
+	{
+		for (uint32_t x = 0; x < size; ++x)
+		{
+			uint32_t v = y * (size + 1) + x;
+			grid.indices.insert(grid.indices.end(), {v, v + 1, v + size + 2, v, v + size + 2, v + size + 1});
+		}
+	}
+
+	return grid;
+}
+
+std::multiset<std::array<uint32_t, 3>> get_triangles(const Meshlets &meshlets, const MeshletOptions &options)
+{
+	std::multiset<std::array<uint32_t, 3>> triangles;
+
+	for (auto &meshlet : meshlets.meshlets)
+	{
+		REQUIRE(meshlet.vertex_count <= options.max_vertices);
+		REQUIRE(meshlet.triangle_count <= options.max_triangles);
+
+		for (uint32_t t = 0; t < meshlet.triangle_count; ++t)
+		{
+			std::array<uint32_t, 3> triangle;
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				uint8_t local = meshlets.triangles[meshlet.triangle_offset + t * 3 + c];
+				REQUIRE(local < meshlet.vertex_count);
+				triangle[c] = meshlets.vertices[meshlet.vertex_offset + local];
+			}
+			triangles.insert(triangle);
+		}
+	}
+
+	return triangles;
+}
+
+std::multiset<std::array<uint32_t, 3>> get_triangles(const std::vector<uint32_t> &indices)
+{
+	std::multiset<std::array<uint32_t, 3>> triangles;
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		triangles.insert({indices[i], indices[i + 1], indices[i + 2]});
+	}
+
+	return triangles;
+}
+
+TEST_CASE("Meshlets contain every triangle once", "[geometry]")
+{
+	auto grid = make_grid(40);
+
+	for (bool optimize_vertex_reuse : {false, true})
+	{
+		MeshletOptions options;
+		options.optimize_vertex_reuse = optimize_vertex_reuse;
+
+		auto meshlets = build_meshlets(grid.source(), options);
+
+		REQUIRE(get_triangles(meshlets, options) == get_triangles(grid.indices));
+	}
+}
+
+TEST_CASE("Meshlets respect vertex limits", "[geometry]")
+{
+	auto grid = make_grid(40);
+
+	MeshletOptions options;
+	options.max_vertices  = 16;
+	options.max_triangles = 128;
+
+	auto meshlets = build_meshlets(grid.source(), options);
+
+	REQUIRE(get_triangles(meshlets, options) == get_triangles(grid.indices));
+}
+
+TEST_CASE("Optimizing vertex reuse shares more vertices", "[geometry]")
+{
+	auto grid = make_grid(40);
+
+	MeshletOptions options;
+	options.optimize_vertex_reuse = false;
+	auto in_order                 = build_meshlets(grid.source(), options);
+
+	options.optimize_vertex_reuse = true;
+	auto optimized                = build_meshlets(grid.source(), options);
+
+	REQUIRE(optimized.vertices.size() < in_order.vertices.size());
+}
+
+TEST_CASE("Meshlet bounds contain their vertices", "[geometry]")
+{
+	auto grid     = make_grid(16);
+	auto meshlets = build_meshlets(grid.source());
+
+	REQUIRE(meshlets.bounds.size() == meshlets.meshlets.size());
+
+	for (size_t i = 0; i < meshlets.meshlets.size(); ++i)
+	{
+		auto &meshlet = meshlets.meshlets[i];
+		auto &bounds  = meshlets.bounds[i];
+
+		for (uint32_t v = 0; v < meshlet.vertex_count; ++v)
+		{
+			auto &position = grid.positions[meshlets.vertices[meshlet.vertex_offset + v]];
+			REQUIRE(glm::length(position - bounds.center) <= bounds.radius + 1e-4f);
+		}
+
+		// All the triangles of a plane face the same direction
+		REQUIRE(bounds.cone_axis.z > 0.999f);
+		REQUIRE(bounds.cone_cutoff < 1e-3f);
+	}
+}
+
+TEST_CASE("Meshlets are built in parallel", "[geometry]")
+{
+	std::vector<Grid> grids;
+	for (uint32_t size = 1; size < 9; ++size)
+	{
+		grids.push_back(make_grid(size * 4));
+	}
+
+	std::vector<MeshletSource> sources;
+	for (auto &grid : grids)
+	{
+		sources.push_back(grid.source());
+	}
+
+	auto meshlets = build_meshlets(sources, {}, 4);
+
+	REQUIRE(meshlets.size() == grids.size());
+	for (size_t i = 0; i < grids.size(); ++i)
+	{
+		REQUIRE(get_triangles(meshlets[i], {}) == get_triangles(grids[i].indices));
+	}
+}
+
+TEST_CASE("Invalid meshlet sources are rejected", "[geometry]")
+{
+	std::vector<uint32_t> indices{0, 1, 2, 2, 1, 3};
+
+	MeshletSource source;
+	source.indices      = indices.data();
+	source.index_count  = indices.size();
+	source.vertex_count = 3;
+
+	REQUIRE_THROWS(build_meshlets(source));
+
+	source.vertex_count = 4;
+	source.index_count  = 5;
+	REQUIRE_THROWS(build_meshlets(source));
+
+	MeshletOptions options;
+	options.max_vertices = 256;
+	source.index_count   = indices.size();
+	REQUIRE_THROWS(build_meshlets(source, options));
+}
+
+// The std::set based implementation the builder replaced, kept as a baseline
+struct SetMeshlet
+{
+	uint32_t vertices[64];
+	uint32_t indices[126];
+	uint32_t vertex_count;
+	uint32_t index_count;
+};
+
+std::vector<SetMeshlet> build_meshlets_with_set(const std::vector<uint32_t> &indices)
+{
+	std::vector<SetMeshlet> meshlets;
+
+	SetMeshlet meshlet;
+	meshlet.vertex_count = 0;
+	meshlet.index_count  = 0;
+
+	std::set<uint32_t> vertices;
+	uint32_t           triangle_check = 0;
+
+	for (uint32_t i = 0; i < indices.size(); i++)
+	{
+		meshlet.indices[meshlet.index_count] = indices[i];
+
+		if (vertices.insert(meshlet.indices[meshlet.index_count]).second)
+		{
+			++meshlet.vertex_count;
+		}
+
+		meshlet.index_count++;
+		triangle_check = triangle_check < 3 ? triangle_check + 1 : 1;
+
+		if (meshlet.vertex_count == 64 || meshlet.index_count == 96 || i == indices.size() - 1)
+		{
+			uint32_t counter = 0;
+			for (auto v : vertices)
+			{
+				meshlet.vertices[counter++] = v;
+			}
+			if (triangle_check != 3)
+			{
+				meshlet.index_count -= triangle_check;
+				i -= triangle_check;
+				triangle_check = 0;
+			}
+
+			meshlets.push_back(meshlet);
+			meshlet.vertex_count = 0;
+			meshlet.index_count  = 0;
+			vertices.clear();
+		}
+	}
+
+	return meshlets;
+}
+
+TEST_CASE("Meshlet builder benchmark", "[.][benchmark]")
+{
+	auto grid = make_grid(512);
+
+	BENCHMARK("std::set")
+	{
+		return build_meshlets_with_set(grid.indices);
+	};
+
+	MeshletOptions options;
+	options.optimize_vertex_reuse = false;
+
+	BENCHMARK("remap table")
+	{
+		return build_meshlets(grid.source(), options);
+	};
+
+	options.optimize_vertex_reuse = true;
+
+	BENCHMARK("remap table with vertex reuse")
+	{
+		return build_meshlets(grid.source(), options);
+	};
+}
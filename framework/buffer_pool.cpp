@@ -131,13 +131,13 @@ BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDe
 {
 }
 
-void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
+void BufferAllocation::update(const uint8_t *data, size_t data_size, uint32_t offset)
 {
 	assert(buffer && "Invalid buffer pointer");
 
-	if (offset + data.size() <= size)
+	if (offset + data_size <= size)
 	{
-		buffer->update(data, to_u32(base_offset) + offset);
+		buffer->update(data, data_size, to_u32(base_offset) + offset);
 	}
 	else
 	{
@@ -145,6 +145,29 @@ void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
 	}
 }
 
+void BufferAllocation::update(const std::vector<uint8_t> &data, uint32_t offset)
+{
+	update(data.data(), data.size(), offset);
+}
+
+uint8_t *BufferAllocation::map()
+{
+	assert(buffer && "Invalid buffer pointer");
+	return buffer->map() + base_offset;
+}
+
+void BufferAllocation::flush(uint32_t offset, VkDeviceSize flush_size)
+{
+	assert(buffer && "Invalid buffer pointer");
+
+	if (flush_size == VK_WHOLE_SIZE)
+	{
+		flush_size = size - offset;
+	}
+
+	buffer->flush(base_offset + offset, flush_size);
+}
+
 bool BufferAllocation::empty() const
 {
 	return size == 0 || buffer == nullptr;
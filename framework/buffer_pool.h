@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <new>
+#include <utility>
+
 #include "common/helpers.h"
 #include "core/buffer.h"
 
@@ -43,14 +46,50 @@ class BufferAllocation
 
 	BufferAllocation &operator=(BufferAllocation &&) = default;
 
+	/**
+	 * @brief Copies byte data into the allocation
+	 * @param data The data to copy from
+	 * @param size The amount of bytes to copy
+	 * @param offset The offset from the start of the allocation
+	 */
+	void update(const uint8_t *data, size_t size, uint32_t offset = 0);
+
 	void update(const std::vector<uint8_t> &data, uint32_t offset = 0);
 
 	template <class T>
 	void update(const T &value, uint32_t offset = 0)
 	{
-		update(to_bytes(value), offset);
+		update(reinterpret_cast<const uint8_t *>(&value), sizeof(T), offset);
 	}
 
+	/**
+	 * @brief Returns a pointer to the start of the allocation in host visible memory
+	 *        Buffers from the buffer pools are persistently mapped, so this does not map them again.
+	 *        Call flush() once done writing, as the memory may not be coherent.
+	 */
+	uint8_t *map();
+
+	/**
+	 * @brief Constructs an object in place in the mapped memory of the allocation, without any intermediate copy
+	 *        Call flush() once done writing, as the memory may not be coherent.
+	 * @param offset The offset from the start of the allocation, must be suitably aligned for T
+	 * @param args The arguments forwarded to the constructor of T
+	 * @return A pointer to the object, valid until the buffer is reset
+	 */
+	template <class T, class... Args>
+	T *construct(uint32_t offset, Args &&...args)
+	{
+		assert(offset + sizeof(T) <= size && "Object does not fit in the allocation");
+		return new (map() + offset) T(std::forward<Args>(args)...);
+	}
+
+	/**
+	 * @brief Flushes the memory written through map() or construct() if it is not coherent
+	 * @param offset The offset from the start of the allocation
+	 * @param size The amount of bytes to flush, the whole allocation by default
+	 */
+	void flush(uint32_t offset = 0, VkDeviceSize size = VK_WHOLE_SIZE);
+
 	bool empty() const;
 
 	VkDeviceSize get_size() const;
@@ -41,6 +41,15 @@
 
 namespace vkb
 {
+/**
+ * @brief Returns the number of bytes left to read in a stream, which bounds the sizes read from it
+ */
+inline size_t stream_remaining(std::istringstream &is)
+{
+	auto remaining = is.rdbuf()->in_avail();
+	return remaining > 0 ? static_cast<size_t>(remaining) : 0;
+}
+
 template <typename T>
 inline void read(std::istringstream &is, T &value)
 {
@@ -49,8 +58,13 @@ inline void read(std::istringstream &is, T &value)
 
 inline void read(std::istringstream &is, std::string &value)
 {
-	std::size_t size;
+	std::size_t size{0};
 	read(is, size);
+	if (is.fail() || size > stream_remaining(is))
+	{
+		is.setstate(std::ios::failbit);
+		return;
+	}
 	value.resize(size);
 	is.read(const_cast<char *>(value.data()), size);
 }
@@ -58,9 +72,9 @@ inline void read(std::istringstream &is, std::string &value)
 template <class T>
 inline void read(std::istringstream &is, std::set<T> &value)
 {
-	std::size_t size;
+	std::size_t size{0};
 	read(is, size);
-	for (uint32_t i = 0; i < size; i++)
+	for (std::size_t i = 0; i < size && !is.fail(); i++)
 	{
 		T item;
 		is.read(reinterpret_cast<char *>(&item), sizeof(T));
@@ -71,8 +85,13 @@ inline void read(std::istringstream &is, std::set<T> &value)
 template <class T>
 inline void read(std::istringstream &is, std::vector<T> &value)
 {
-	std::size_t size;
+	std::size_t size{0};
 	read(is, size);
+	if (is.fail() || size > stream_remaining(is) / sizeof(T))
+	{
+		is.setstate(std::ios::failbit);
+		return;
+	}
 	value.resize(size);
 	is.read(reinterpret_cast<char *>(value.data()), value.size() * sizeof(T));
 }
@@ -80,10 +99,10 @@ inline void read(std::istringstream &is, std::vector<T> &value)
 template <class T, class S>
 inline void read(std::istringstream &is, std::map<T, S> &value)
 {
-	std::size_t size;
+	std::size_t size{0};
 	read(is, size);
 
-	for (uint32_t i = 0; i < size; i++)
+	for (std::size_t i = 0; i < size && !is.fail(); i++)
 	{
 		std::pair<T, S> item;
 		read(is, item.first);
@@ -173,6 +192,27 @@ inline void hash_combine(size_t &seed, const T &v)
 	glm::detail::hash_combine(seed, hasher(v));
 }
 
+/**
+ * @brief 64-bit FNV-1a, used instead of std::hash where keys must be stable across runs and platforms
+ *        (e.g. to address on-disk caches). Start from 0xcbf29ce484222325.
+ */
+inline void fnv1a(uint64_t &hash, const void *data, size_t size)
+{
+	auto bytes = reinterpret_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ULL;
+	}
+}
+
+inline void fnv1a(uint64_t &hash, const std::string &value)
+{
+	uint64_t size = value.size();
+	fnv1a(hash, &size, sizeof(size));
+	fnv1a(hash, value.data(), value.size());
+}
+
 /**
  * @brief Helper function to convert a data type
  *        to string using output stream operator.
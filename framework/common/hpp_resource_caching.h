@@ -274,6 +274,75 @@ struct hash<vkb::rendering::HPPRenderTarget>
 
 namespace vkb
 {
+namespace
+{
+// The full keys of the vulkan.hpp types are the ones of their layout-compatible counterparts
+template <>
+inline void key_param<vk::PipelineCache>(ResourceKey & /*key*/, const vk::PipelineCache & /*value*/)
+{
+}
+
+template <>
+inline void key_param<vkb::core::HPPShaderSource>(ResourceKey &key, const vkb::core::HPPShaderSource &value)
+{
+	key_param(key, reinterpret_cast<vkb::ShaderSource const &>(value));
+}
+
+template <>
+inline void key_param<vkb::core::HPPShaderVariant>(ResourceKey &key, const vkb::core::HPPShaderVariant &value)
+{
+	key_param(key, reinterpret_cast<vkb::ShaderVariant const &>(value));
+}
+
+template <>
+inline void key_param<std::vector<vkb::core::HPPShaderModule *>>(ResourceKey &key, const std::vector<vkb::core::HPPShaderModule *> &value)
+{
+	key_param(key, reinterpret_cast<std::vector<vkb::ShaderModule *> const &>(value));
+}
+
+template <>
+inline void key_param<std::vector<vkb::core::HPPShaderResource>>(ResourceKey &key, const std::vector<vkb::core::HPPShaderResource> &value)
+{
+	key_param(key, reinterpret_cast<std::vector<vkb::ShaderResource> const &>(value));
+}
+
+template <>
+inline void key_param<std::vector<vkb::rendering::HPPAttachment>>(ResourceKey &key, const std::vector<vkb::rendering::HPPAttachment> &value)
+{
+	key_param(key, reinterpret_cast<std::vector<vkb::Attachment> const &>(value));
+}
+
+template <>
+inline void key_param<std::vector<vkb::common::HPPLoadStoreInfo>>(ResourceKey &key, const std::vector<vkb::common::HPPLoadStoreInfo> &value)
+{
+	key_param(key, reinterpret_cast<std::vector<vkb::LoadStoreInfo> const &>(value));
+}
+
+template <>
+inline void key_param<std::vector<vkb::core::HPPSubpassInfo>>(ResourceKey &key, const std::vector<vkb::core::HPPSubpassInfo> &value)
+{
+	key_param(key, reinterpret_cast<std::vector<vkb::SubpassInfo> const &>(value));
+}
+
+template <>
+inline void key_param<vkb::rendering::HPPPipelineState>(ResourceKey &key, const vkb::rendering::HPPPipelineState &value)
+{
+	key_param(key, reinterpret_cast<vkb::PipelineState const &>(value));
+}
+
+template <>
+inline void key_param<vkb::rendering::HPPRenderTarget>(ResourceKey &key, const vkb::rendering::HPPRenderTarget &value)
+{
+	key_param(key, reinterpret_cast<vkb::RenderTarget const &>(value));
+}
+
+template <>
+inline void key_param<vkb::core::HPPRenderPass>(ResourceKey &key, const vkb::core::HPPRenderPass &value)
+{
+	key_param(key, reinterpret_cast<vkb::RenderPass const &>(value));
+}
+}        // namespace
+
 namespace common
 {
 /**
@@ -351,11 +420,24 @@ struct HPPRecordHelper<vkb::core::HPPGraphicsPipeline, A...>
 };
 }        // namespace
 
+/**
+ * @brief Registers a newly built resource with the recorder, if the resource type is recorded at all
+ */
 template <class T, class... A>
-T &request_resource(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *recorder, std::unordered_map<size_t, T> &resources, A &...args)
+void record_resource(vkb::HPPResourceRecord *recorder, T &resource, A &...args)
 {
-	HPPRecordHelper<T, A...> record_helper;
+	if (recorder)
+	{
+		HPPRecordHelper<T, A...> record_helper;
+
+		size_t index = record_helper.record(*recorder, args...);
+		record_helper.index(*recorder, index, resource);
+	}
+}
 
+template <class T, class... A>
+T &request_resource(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *recorder, std::unordered_map<size_t, T> &resources, A &...args)
+{
 	size_t hash{0U};
 	hash_param(hash, args...);
 
@@ -388,11 +470,7 @@ T &request_resource(vkb::core::HPPDevice &device, vkb::HPPResourceRecord *record
 
 		res_it = res_ins_it.first;
 
-		if (recorder)
-		{
-			size_t index = record_helper.record(*recorder, args...);
-			record_helper.index(*recorder, index, res_it->second);
-		}
+		record_resource(recorder, res_it->second, args...);
 #ifndef DEBUG
 	}
 	catch (const std::exception &e)
@@ -39,6 +39,14 @@ struct HPPBufferMemoryBarrier
 	vk::AccessFlags        dst_access_mask = {};
 };
 
+struct HPPGlobalMemoryBarrier
+{
+	vk::PipelineStageFlags src_stage_mask  = vk::PipelineStageFlagBits::eBottomOfPipe;
+	vk::PipelineStageFlags dst_stage_mask  = vk::PipelineStageFlagBits::eTopOfPipe;
+	vk::AccessFlags        src_access_mask = {};
+	vk::AccessFlags        dst_access_mask = {};
+};
+
 struct HPPImageMemoryBarrier
 {
 	vk::PipelineStageFlags src_stage_mask = vk::PipelineStageFlagBits::eBottomOfPipe;
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <cstring>
+#include <string>
+
 #include "core/descriptor_pool.h"
 #include "core/descriptor_set.h"
 #include "core/descriptor_set_layout.h"
@@ -536,6 +539,75 @@ struct hash<vkb::PipelineState>
 
 namespace vkb
 {
+/**
+ * @brief The full key of a resource, appended to by key_param
+ *        A key constructed from the key of a cached resource compares the appended bytes against it instead of storing them,
+ *        so that a cache hit checks the full key without allocating it.
+ */
+class ResourceKey
+{
+  public:
+	/**
+	 * @brief Creates a key which stores the appended bytes
+	 */
+	ResourceKey() = default;
+
+	/**
+	 * @brief Creates a key which compares the appended bytes against an existing key
+	 * @param expected The key to compare against, which must outlive this object
+	 */
+	explicit ResourceKey(const std::string &expected) :
+	    expected{&expected}
+	{}
+
+	void append(const char *data, size_t size)
+	{
+		if (!expected)
+		{
+			bytes.append(data, size);
+			return;
+		}
+
+		if (mismatch || size > expected->size() - position || std::memcmp(expected->data() + position, data, size) != 0)
+		{
+			mismatch = true;
+			return;
+		}
+
+		position += size;
+	}
+
+	void append(const std::string &value)
+	{
+		append(value.data(), value.size());
+	}
+
+	/**
+	 * @return True if the appended bytes are exactly the expected key
+	 */
+	bool matches() const
+	{
+		return expected && !mismatch && position == expected->size();
+	}
+
+	/**
+	 * @return The appended bytes of a key which stores them
+	 */
+	const std::string &get() const
+	{
+		return bytes;
+	}
+
+  private:
+	const std::string *expected{nullptr};
+
+	std::string bytes;
+
+	size_t position{0};
+
+	bool mismatch{false};
+};
+
 namespace
 {
 template <typename T>
@@ -654,6 +726,219 @@ inline void hash_param(size_t &seed, const T &first_arg, const Args &... args)
 	hash_param(seed, args...);
 }
 
+/**
+ * @brief Appends a value to the full key of a resource
+ *        Unlike its hash, the full key identifies a resource exactly, so the cache compares it on lookup
+ *        to tell apart resources whose hashes collide. Cached resources are identified by their address or handle.
+ */
+template <typename T>
+inline void key_param(ResourceKey &key, const T &value)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "key_param needs a specialization for this type");
+
+	key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <>
+inline void key_param(ResourceKey & /*key*/, const VkPipelineCache & /*value*/)
+{
+}
+
+template <>
+inline void key_param<std::string>(ResourceKey &key, const std::string &value)
+{
+	key_param(key, value.size());
+	key.append(value);
+}
+
+template <>
+inline void key_param<ShaderSource>(ResourceKey &key, const ShaderSource &value)
+{
+	key_param(key, value.get_filename());
+	key_param(key, value.get_source());
+}
+
+template <>
+inline void key_param<ShaderVariant>(ResourceKey &key, const ShaderVariant &value)
+{
+	key_param(key, value.get_preamble());
+
+	key_param(key, value.get_processes().size());
+	for (auto &process : value.get_processes())
+	{
+		key_param(key, process);
+	}
+
+	// Runtime array sizes live in an unordered map, sort them so that equal variants have equal keys
+	auto &runtime_array_sizes = value.get_runtime_array_sizes();
+	key_param(key, runtime_array_sizes.size());
+	if (runtime_array_sizes.size() <= 1)
+	{
+		// Nothing to sort, which spares the copy for the common case
+		for (auto &runtime_array_size : runtime_array_sizes)
+		{
+			key_param(key, runtime_array_size.first);
+			key_param(key, runtime_array_size.second);
+		}
+		return;
+	}
+
+	std::map<std::string, size_t> sorted_runtime_array_sizes{runtime_array_sizes.begin(), runtime_array_sizes.end()};
+	for (auto &runtime_array_size : sorted_runtime_array_sizes)
+	{
+		key_param(key, runtime_array_size.first);
+		key_param(key, runtime_array_size.second);
+	}
+}
+
+template <>
+inline void key_param<std::vector<Attachment>>(ResourceKey &key, const std::vector<Attachment> &value)
+{
+	key_param(key, value.size());
+	for (auto &attachment : value)
+	{
+		key_param(key, attachment.format);
+		key_param(key, attachment.samples);
+		key_param(key, attachment.usage);
+		key_param(key, attachment.initial_layout);
+	}
+}
+
+template <>
+inline void key_param<std::vector<LoadStoreInfo>>(ResourceKey &key, const std::vector<LoadStoreInfo> &value)
+{
+	key_param(key, value.size());
+	for (auto &load_store_info : value)
+	{
+		key_param(key, load_store_info.load_op);
+		key_param(key, load_store_info.store_op);
+	}
+}
+
+template <>
+inline void key_param<std::vector<uint32_t>>(ResourceKey &key, const std::vector<uint32_t> &value)
+{
+	key_param(key, value.size());
+	key.append(reinterpret_cast<const char *>(value.data()), value.size() * sizeof(uint32_t));
+}
+
+template <>
+inline void key_param<std::vector<SubpassInfo>>(ResourceKey &key, const std::vector<SubpassInfo> &value)
+{
+	key_param(key, value.size());
+	for (auto &subpass_info : value)
+	{
+		key_param(key, subpass_info.input_attachments);
+		key_param(key, subpass_info.output_attachments);
+		key_param(key, subpass_info.color_resolve_attachments);
+		key_param(key, subpass_info.disable_depth_stencil_attachment);
+		key_param(key, subpass_info.depth_stencil_resolve_attachment);
+		key_param(key, subpass_info.depth_stencil_resolve_mode);
+		key_param(key, subpass_info.debug_name);
+	}
+}
+
+template <>
+inline void key_param<std::vector<ShaderModule *>>(ResourceKey &key, const std::vector<ShaderModule *> &value)
+{
+	key_param(key, value.size());
+	for (auto shader_module : value)
+	{
+		key_param(key, shader_module);
+	}
+}
+
+template <>
+inline void key_param<std::vector<ShaderResource>>(ResourceKey &key, const std::vector<ShaderResource> &value)
+{
+	key_param(key, value.size());
+	for (auto &resource : value)
+	{
+		key_param(key, resource.stages);
+		key_param(key, resource.type);
+		key_param(key, resource.mode);
+		key_param(key, resource.set);
+		key_param(key, resource.binding);
+		key_param(key, resource.location);
+		key_param(key, resource.input_attachment_index);
+		key_param(key, resource.vec_size);
+		key_param(key, resource.columns);
+		key_param(key, resource.array_size);
+		key_param(key, resource.offset);
+		key_param(key, resource.size);
+		key_param(key, resource.constant_id);
+		key_param(key, resource.qualifiers);
+		key_param(key, resource.name);
+	}
+}
+
+template <>
+inline void key_param<PipelineState>(ResourceKey &key, const PipelineState &value)
+{
+	key_param(key, value.get_pipeline_layout().get_handle());
+
+	VkRenderPass render_pass = value.get_render_pass() ? value.get_render_pass()->get_handle() : VK_NULL_HANDLE;
+	key_param(key, render_pass);
+
+	key_param(key, value.get_subpass_index());
+
+	auto &specialization_constants = value.get_specialization_constant_state().get_specialization_constant_state();
+	key_param(key, specialization_constants.size());
+	for (auto &constant : specialization_constants)
+	{
+		key_param(key, constant.first);
+		key_param(key, constant.second.size());
+		key.append(reinterpret_cast<const char *>(constant.second.data()), constant.second.size());
+	}
+
+	// The vertex input bindings and attributes, as well as all the fixed-function states, are made of 32-bit fields only,
+	// so their bytes can be appended as they are
+	auto &vertex_input_state = value.get_vertex_input_state();
+	key_param(key, vertex_input_state.bindings.size());
+	key.append(reinterpret_cast<const char *>(vertex_input_state.bindings.data()), vertex_input_state.bindings.size() * sizeof(VkVertexInputBindingDescription));
+	key_param(key, vertex_input_state.attributes.size());
+	key.append(reinterpret_cast<const char *>(vertex_input_state.attributes.data()), vertex_input_state.attributes.size() * sizeof(VkVertexInputAttributeDescription));
+
+	key_param(key, value.get_input_assembly_state());
+	key_param(key, value.get_rasterization_state());
+	key_param(key, value.get_viewport_state());
+	key_param(key, value.get_multisample_state());
+	key_param(key, value.get_depth_stencil_state());
+
+	auto &color_blend_state = value.get_color_blend_state();
+	key_param(key, color_blend_state.logic_op_enable);
+	key_param(key, color_blend_state.logic_op);
+	key_param(key, color_blend_state.attachments.size());
+	key.append(reinterpret_cast<const char *>(color_blend_state.attachments.data()), color_blend_state.attachments.size() * sizeof(ColorBlendAttachmentState));
+}
+
+template <>
+inline void key_param<RenderTarget>(ResourceKey &key, const RenderTarget &value)
+{
+	key_param(key, value.get_extent());
+
+	key_param(key, value.get_views().size());
+	for (auto &view : value.get_views())
+	{
+		key_param(key, view.get_handle());
+		key_param(key, view.get_image().get_handle());
+	}
+}
+
+template <>
+inline void key_param<RenderPass>(ResourceKey &key, const RenderPass &value)
+{
+	key_param(key, value.get_handle());
+}
+
+template <typename T, typename... Args>
+inline void key_param(ResourceKey &key, const T &first_arg, const Args &... args)
+{
+	key_param(key, first_arg);
+
+	key_param(key, args...);
+}
+
 template <class T, class... A>
 struct RecordHelper
 {
@@ -724,11 +1009,24 @@ struct RecordHelper<GraphicsPipeline, A...>
 };
 }        // namespace
 
+/**
+ * @brief Registers a newly built resource with the recorder, if the resource type is recorded at all
+ */
 template <class T, class... A>
-T &request_resource(Device &device, ResourceRecord *recorder, std::unordered_map<std::size_t, T> &resources, A &... args)
+void record_resource(ResourceRecord *recorder, T &resource, A &... args)
 {
-	RecordHelper<T, A...> record_helper;
+	if (recorder)
+	{
+		RecordHelper<T, A...> record_helper;
 
+		size_t index = record_helper.record(*recorder, args...);
+		record_helper.index(*recorder, index, resource);
+	}
+}
+
+template <class T, class... A>
+T &request_resource(Device &device, ResourceRecord *recorder, std::unordered_map<std::size_t, T> &resources, A &... args)
+{
 	std::size_t hash{0U};
 	hash_param(hash, args...);
 
@@ -761,11 +1059,7 @@ T &request_resource(Device &device, ResourceRecord *recorder, std::unordered_map
 
 		res_it = res_ins_it.first;
 
-		if (recorder)
-		{
-			size_t index = record_helper.record(*recorder, args...);
-			record_helper.index(*recorder, index, res_it->second);
-		}
+		record_resource(recorder, res_it->second, args...);
 #ifndef DEBUG
 	}
 	catch (const std::exception &e)
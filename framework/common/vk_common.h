@@ -188,6 +188,21 @@ struct BufferMemoryBarrier
 	VkAccessFlags dst_access_mask{0};
 };
 
+/**
+ * @brief Global memory barrier structure used to define
+ *        memory access for all resources during command recording.
+ */
+struct GlobalMemoryBarrier
+{
+	VkPipelineStageFlags src_stage_mask{VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT};
+
+	VkPipelineStageFlags dst_stage_mask{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+
+	VkAccessFlags src_access_mask{0};
+
+	VkAccessFlags dst_access_mask{0};
+};
+
 /**
  * @brief Put an image memory barrier for a layout transition of an image, using explicitly give transition parameters.
  * @param command_buffer The VkCommandBuffer to record the barrier.
@@ -110,13 +110,13 @@ size_t AllocatedBase::update(const uint8_t *data, size_t size, size_t offset)
 	if (persistent)
 	{
 		std::copy(data, data + size, mapped_data + offset);
-		flush();
+		flush(offset, size);
 	}
 	else
 	{
 		map();
 		std::copy(data, data + size, mapped_data + offset);
-		flush();
+		flush(offset, size);
 		unmap();
 	}
 	return size;
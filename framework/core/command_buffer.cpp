@@ -19,6 +19,7 @@
 
 #include "command_pool.h"
 #include "common/error.h"
+#include "core/util/push_constants.hpp"
 #include "device.h"
 #include "rendering/render_frame.h"
 #include "rendering/subpass.h"
@@ -45,6 +46,20 @@ CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel lev
 	{
 		throw VulkanException{result, "Failed to allocate command buffer"};
 	}
+
+	// Barriers are recorded with vkCmdPipelineBarrier2KHR only if the extension and its feature were enabled
+	if (get_device().is_enabled(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+	{
+		auto *feature = static_cast<const VkBaseInStructure *>(get_device().get_gpu().get_extension_feature_chain());
+		while (feature)
+		{
+			if (feature->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR)
+			{
+				synchronization2 = reinterpret_cast<const VkPhysicalDeviceSynchronization2FeaturesKHR *>(feature)->synchronization2;
+			}
+			feature = feature->pNext;
+		}
+	}
 }
 
 CommandBuffer::~CommandBuffer()
@@ -65,11 +80,17 @@ CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    pending_barriers(std::exchange(other.pending_barriers, {})),
+    synchronization2(std::exchange(other.synchronization2, {})),
+    barrier_count(std::exchange(other.barrier_count, {})),
+    barrier_call_count(std::exchange(other.barrier_call_count, {}))
 {}
 
 void CommandBuffer::clear(VkClearAttachment attachment, VkClearRect rect)
 {
+	flush_barriers();
+
 	vkCmdClearAttachments(get_handle(), 1, &attachment, 1, &rect);
 }
 
@@ -93,6 +114,9 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
 	stored_push_constants.clear();
+	clear_barriers();
+	barrier_count      = 0;
+	barrier_call_count = 0;
 
 	VkCommandBufferBeginInfo       begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 	VkCommandBufferInheritanceInfo inheritance = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
@@ -115,20 +139,62 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, const RenderPass
 	return vkBeginCommandBuffer(get_handle(), &begin_info);
 }
 
+CommandBuffer &CommandBuffer::begin_secondary_command_buffer(size_t thread_index)
+{
+	assert(level == VK_COMMAND_BUFFER_LEVEL_PRIMARY && "Secondary command buffers can only be executed by primary ones");
+	assert(command_pool.get_render_frame() && "The command pool must be associated to a render frame");
+	assert(current_render_pass.render_pass && current_render_pass.framebuffer && "Secondary command buffers must be begun within a render pass");
+
+	auto &queue = get_device().get_queue(command_pool.get_queue_family_index(), 0);
+
+	auto &secondary_command_buffer = command_pool.get_render_frame()->request_command_buffer(queue, command_pool.get_reset_mode(), VK_COMMAND_BUFFER_LEVEL_SECONDARY, thread_index);
+
+	secondary_command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT, this);
+
+	// Nothing is bound in the secondary command buffer yet, so all the state is flushed again by its first draw
+	secondary_command_buffer.pipeline_state         = pipeline_state;
+	secondary_command_buffer.resource_binding_state = resource_binding_state;
+	secondary_command_buffer.stored_push_constants  = stored_push_constants;
+	secondary_command_buffer.pipeline_state.set_dirty();
+	secondary_command_buffer.resource_binding_state.set_dirty();
+
+	auto &extent = current_render_pass.framebuffer->get_extent();
+
+	VkViewport viewport{};
+	viewport.width    = static_cast<float>(extent.width);
+	viewport.height   = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	secondary_command_buffer.set_viewport(0, {viewport});
+
+	VkRect2D scissor{};
+	scissor.extent = extent;
+	secondary_command_buffer.set_scissor(0, {scissor});
+
+	return secondary_command_buffer;
+}
+
 VkResult CommandBuffer::end()
 {
+	flush_barriers();
+
 	vkEndCommandBuffer(get_handle());
 
 	return VK_SUCCESS;
 }
 
-void CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
+bool CommandBuffer::flush(VkPipelineBindPoint pipeline_bind_point)
 {
-	flush_pipeline_state(pipeline_bind_point);
+	if (!flush_pipeline_state(pipeline_bind_point))
+	{
+		return false;
+	}
 
 	flush_push_constants();
 
 	flush_descriptor_state(pipeline_bind_point);
+
+	return true;
 }
 
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values, const std::vector<std::unique_ptr<Subpass>> &subpasses, VkSubpassContents contents)
@@ -146,6 +212,8 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const s
 
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents)
 {
+	flush_barriers();
+
 	current_render_pass.render_pass = &render_pass;
 	current_render_pass.framebuffer = &framebuffer;
 
@@ -181,7 +249,7 @@ void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const R
 	pipeline_state.set_color_blend_state(blend_state);
 }
 
-void CommandBuffer::next_subpass()
+void CommandBuffer::next_subpass(VkSubpassContents contents)
 {
 	// Increment subpass index
 	pipeline_state.set_subpass_index(pipeline_state.get_subpass_index() + 1);
@@ -198,24 +266,41 @@ void CommandBuffer::next_subpass()
 	// Clear stored push constants
 	stored_push_constants.clear();
 
-	vkCmdNextSubpass(get_handle(), VK_SUBPASS_CONTENTS_INLINE);
+	flush_barriers();
+
+	vkCmdNextSubpass(get_handle(), contents);
 }
 
 void CommandBuffer::execute_commands(CommandBuffer &secondary_command_buffer)
 {
+	flush_barriers();
+
 	vkCmdExecuteCommands(get_handle(), 1, &secondary_command_buffer.get_handle());
+
+	barrier_count += secondary_command_buffer.barrier_count;
+	barrier_call_count += secondary_command_buffer.barrier_call_count;
 }
 
 void CommandBuffer::execute_commands(std::vector<CommandBuffer *> &secondary_command_buffers)
 {
+	flush_barriers();
+
 	std::vector<VkCommandBuffer> sec_cmd_buf_handles(secondary_command_buffers.size(), VK_NULL_HANDLE);
 	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), sec_cmd_buf_handles.begin(),
 	               [](const vkb::CommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
 	vkCmdExecuteCommands(get_handle(), to_u32(sec_cmd_buf_handles.size()), sec_cmd_buf_handles.data());
+
+	for (auto *secondary_command_buffer : secondary_command_buffers)
+	{
+		barrier_count += secondary_command_buffer->barrier_count;
+		barrier_call_count += secondary_command_buffer->barrier_call_count;
+	}
 }
 
 void CommandBuffer::end_render_pass()
 {
+	flush_barriers();
+
 	vkCmdEndRenderPass(get_handle());
 }
 
@@ -231,17 +316,12 @@ void CommandBuffer::set_specialization_constant(uint32_t constant_id, const std:
 
 void CommandBuffer::push_constants(const std::vector<uint8_t> &values)
 {
-	uint32_t push_constant_size = to_u32(stored_push_constants.size() + values.size());
+	push_constants(values.data(), values.size());
+}
 
-	if (push_constant_size > max_push_constants_size)
-	{
-		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, values.size(), push_constant_size);
-		throw std::runtime_error("Push constant limit exceeded.");
-	}
-	else
-	{
-		stored_push_constants.insert(stored_push_constants.end(), values.begin(), values.end());
-	}
+void CommandBuffer::push_constants(const uint8_t *data, size_t size)
+{
+	append_push_constants(stored_push_constants, data, size, max_push_constants_size);
 }
 
 void CommandBuffer::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
@@ -353,27 +433,47 @@ void CommandBuffer::set_depth_bounds(float min_depth_bounds, float max_depth_bou
 
 void CommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	flush_barriers();
+
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		// The pipeline of this draw is still being built
+		return;
+	}
 
 	vkCmdDraw(get_handle(), vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	flush_barriers();
+
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		// The pipeline of this draw is still being built
+		return;
+	}
 
 	vkCmdDrawIndexed(get_handle(), index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
 void CommandBuffer::draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
 {
-	flush(VK_PIPELINE_BIND_POINT_GRAPHICS);
+	flush_barriers();
+
+	if (!flush(VK_PIPELINE_BIND_POINT_GRAPHICS))
+	{
+		// The pipeline of this draw is still being built
+		return;
+	}
 
 	vkCmdDrawIndexedIndirect(get_handle(), buffer.get_handle(), offset, draw_count, stride);
 }
 
 void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
+	flush_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatch(get_handle(), group_count_x, group_count_y, group_count_z);
@@ -381,6 +481,8 @@ void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uin
 
 void CommandBuffer::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset)
 {
+	flush_barriers();
+
 	flush(VK_PIPELINE_BIND_POINT_COMPUTE);
 
 	vkCmdDispatchIndirect(get_handle(), buffer.get_handle(), offset);
@@ -388,11 +490,15 @@ void CommandBuffer::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize o
 
 void CommandBuffer::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data)
 {
+	flush_barriers();
+
 	vkCmdUpdateBuffer(get_handle(), buffer.get_handle(), offset, data.size(), data.data());
 }
 
 void CommandBuffer::blit_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageBlit> &regions)
 {
+	flush_barriers();
+
 	vkCmdBlitImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	               dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	               to_u32(regions.size()), regions.data(), VK_FILTER_NEAREST);
@@ -400,6 +506,8 @@ void CommandBuffer::blit_image(const core::Image &src_img, const core::Image &ds
 
 void CommandBuffer::resolve_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageResolve> &regions)
 {
+	flush_barriers();
+
 	vkCmdResolveImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	                  dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	                  to_u32(regions.size()), regions.data());
@@ -407,6 +515,8 @@ void CommandBuffer::resolve_image(const core::Image &src_img, const core::Image
 
 void CommandBuffer::copy_buffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, VkDeviceSize size)
 {
+	flush_barriers();
+
 	VkBufferCopy copy_region = {};
 	copy_region.size         = size;
 	vkCmdCopyBuffer(get_handle(), src_buffer.get_handle(), dst_buffer.get_handle(), 1, &copy_region);
@@ -414,6 +524,8 @@ void CommandBuffer::copy_buffer(const core::Buffer &src_buffer, const core::Buff
 
 void CommandBuffer::copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions)
 {
+	flush_barriers();
+
 	vkCmdCopyImage(get_handle(), src_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
 	               dst_img.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	               to_u32(regions.size()), regions.data());
@@ -421,6 +533,8 @@ void CommandBuffer::copy_image(const core::Image &src_img, const core::Image &ds
 
 void CommandBuffer::copy_buffer_to_image(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions)
 {
+	flush_barriers();
+
 	vkCmdCopyBufferToImage(get_handle(), buffer.get_handle(),
 	                       image.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
 	                       to_u32(regions.size()), regions.data());
@@ -428,11 +542,13 @@ void CommandBuffer::copy_buffer_to_image(const core::Buffer &buffer, const core:
 
 void CommandBuffer::copy_image_to_buffer(const core::Image &image, VkImageLayout image_layout, const core::Buffer &buffer, const std::vector<VkBufferImageCopy> &regions)
 {
+	flush_barriers();
+
 	vkCmdCopyImageToBuffer(get_handle(), image.get_handle(), image_layout,
 	                       buffer.get_handle(), to_u32(regions.size()), regions.data());
 }
 
-void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier) const
+void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier)
 {
 	// Adjust barrier's subresource range for depth images
 	auto subresource_range = image_view.get_subresource_range();
@@ -446,19 +562,60 @@ void CommandBuffer::image_memory_barrier(const core::ImageView &image_view, cons
 		subresource_range.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
 	}
 
-	vkb::image_layout_transition(get_handle(),
-	                             image_view.get_image().get_handle(),
-	                             memory_barrier.src_stage_mask,
-	                             memory_barrier.dst_stage_mask,
-	                             memory_barrier.src_access_mask,
-	                             memory_barrier.dst_access_mask,
-	                             memory_barrier.old_layout,
-	                             memory_barrier.new_layout,
-	                             subresource_range);
+	if (synchronization2)
+	{
+		VkImageMemoryBarrier2KHR image_memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR};
+		image_memory_barrier.srcStageMask        = memory_barrier.src_stage_mask;
+		image_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+		image_memory_barrier.dstStageMask        = memory_barrier.dst_stage_mask;
+		image_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+		image_memory_barrier.oldLayout           = memory_barrier.old_layout;
+		image_memory_barrier.newLayout           = memory_barrier.new_layout;
+		image_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+		image_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+		image_memory_barrier.image               = image_view.get_image().get_handle();
+		image_memory_barrier.subresourceRange    = subresource_range;
+
+		this->image_memory_barrier(image_memory_barrier);
+		return;
+	}
+
+	VkImageMemoryBarrier image_memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+	image_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	image_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	image_memory_barrier.oldLayout           = memory_barrier.old_layout;
+	image_memory_barrier.newLayout           = memory_barrier.new_layout;
+	image_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+	image_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+	image_memory_barrier.image               = image_view.get_image().get_handle();
+	image_memory_barrier.subresourceRange    = subresource_range;
+
+	flush_barriers_on(image_memory_barrier.image, VK_NULL_HANDLE);
+
+	pending_barriers.src_stage_mask |= memory_barrier.src_stage_mask;
+	pending_barriers.dst_stage_mask |= memory_barrier.dst_stage_mask;
+	pending_barriers.image_memory_barriers.push_back(image_memory_barrier);
 }
 
 void CommandBuffer::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
 {
+	if (synchronization2)
+	{
+		VkBufferMemoryBarrier2KHR buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR};
+		buffer_memory_barrier.srcStageMask        = memory_barrier.src_stage_mask;
+		buffer_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+		buffer_memory_barrier.dstStageMask        = memory_barrier.dst_stage_mask;
+		buffer_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+		buffer_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		buffer_memory_barrier.buffer              = buffer.get_handle();
+		buffer_memory_barrier.offset              = offset;
+		buffer_memory_barrier.size                = size;
+
+		this->buffer_memory_barrier(buffer_memory_barrier);
+		return;
+	}
+
 	VkBufferMemoryBarrier buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
 	buffer_memory_barrier.srcAccessMask = memory_barrier.src_access_mask;
 	buffer_memory_barrier.dstAccessMask = memory_barrier.dst_access_mask;
@@ -466,25 +623,163 @@ void CommandBuffer::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSi
 	buffer_memory_barrier.offset        = offset;
 	buffer_memory_barrier.size          = size;
 
-	VkPipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
-	VkPipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
+	flush_barriers_on(VK_NULL_HANDLE, buffer_memory_barrier.buffer);
+
+	pending_barriers.src_stage_mask |= memory_barrier.src_stage_mask;
+	pending_barriers.dst_stage_mask |= memory_barrier.dst_stage_mask;
+	pending_barriers.buffer_memory_barriers.push_back(buffer_memory_barrier);
+}
+
+void CommandBuffer::memory_barrier(const GlobalMemoryBarrier &memory_barrier)
+{
+	if (synchronization2)
+	{
+		VkMemoryBarrier2KHR global_memory_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR};
+		global_memory_barrier.srcStageMask  = memory_barrier.src_stage_mask;
+		global_memory_barrier.srcAccessMask = memory_barrier.src_access_mask;
+		global_memory_barrier.dstStageMask  = memory_barrier.dst_stage_mask;
+		global_memory_barrier.dstAccessMask = memory_barrier.dst_access_mask;
+
+		this->memory_barrier(global_memory_barrier);
+		return;
+	}
+
+	VkMemoryBarrier global_memory_barrier{VK_STRUCTURE_TYPE_MEMORY_BARRIER};
+	global_memory_barrier.srcAccessMask = memory_barrier.src_access_mask;
+	global_memory_barrier.dstAccessMask = memory_barrier.dst_access_mask;
+
+	pending_barriers.src_stage_mask |= memory_barrier.src_stage_mask;
+	pending_barriers.dst_stage_mask |= memory_barrier.dst_stage_mask;
+	pending_barriers.memory_barriers.push_back(global_memory_barrier);
+}
+
+void CommandBuffer::image_memory_barrier(const VkImageMemoryBarrier2KHR &memory_barrier)
+{
+	assert(synchronization2 && "Synchronization2 barriers require VK_KHR_synchronization2 to be enabled");
+
+	flush_barriers_on(memory_barrier.image, VK_NULL_HANDLE);
+
+	pending_barriers.image_memory_barriers2.push_back(memory_barrier);
+}
+
+void CommandBuffer::buffer_memory_barrier(const VkBufferMemoryBarrier2KHR &memory_barrier)
+{
+	assert(synchronization2 && "Synchronization2 barriers require VK_KHR_synchronization2 to be enabled");
+
+	flush_barriers_on(VK_NULL_HANDLE, memory_barrier.buffer);
+
+	pending_barriers.buffer_memory_barriers2.push_back(memory_barrier);
+}
+
+void CommandBuffer::memory_barrier(const VkMemoryBarrier2KHR &memory_barrier)
+{
+	assert(synchronization2 && "Synchronization2 barriers require VK_KHR_synchronization2 to be enabled");
 
-	vkCmdPipelineBarrier(
-	    get_handle(),
-	    src_stage_mask,
-	    dst_stage_mask,
-	    0,
-	    0, nullptr,
-	    1, &buffer_memory_barrier,
-	    0, nullptr);
+	pending_barriers.memory_barriers2.push_back(memory_barrier);
 }
 
-void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
+void CommandBuffer::flush_barriers()
+{
+	uint32_t flushed_count = 0;
+
+	if (synchronization2)
+	{
+		VkDependencyInfoKHR dependency_info{VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR};
+		dependency_info.memoryBarrierCount       = to_u32(pending_barriers.memory_barriers2.size());
+		dependency_info.pMemoryBarriers          = pending_barriers.memory_barriers2.data();
+		dependency_info.bufferMemoryBarrierCount = to_u32(pending_barriers.buffer_memory_barriers2.size());
+		dependency_info.pBufferMemoryBarriers    = pending_barriers.buffer_memory_barriers2.data();
+		dependency_info.imageMemoryBarrierCount  = to_u32(pending_barriers.image_memory_barriers2.size());
+		dependency_info.pImageMemoryBarriers     = pending_barriers.image_memory_barriers2.data();
+
+		flushed_count = dependency_info.memoryBarrierCount + dependency_info.bufferMemoryBarrierCount + dependency_info.imageMemoryBarrierCount;
+		if (flushed_count == 0)
+		{
+			return;
+		}
+
+		vkCmdPipelineBarrier2KHR(get_handle(), &dependency_info);
+	}
+	else
+	{
+		flushed_count = to_u32(pending_barriers.memory_barriers.size() + pending_barriers.buffer_memory_barriers.size() + pending_barriers.image_memory_barriers.size());
+		if (flushed_count == 0)
+		{
+			return;
+		}
+
+		vkCmdPipelineBarrier(get_handle(), pending_barriers.src_stage_mask, pending_barriers.dst_stage_mask, 0,
+		                     to_u32(pending_barriers.memory_barriers.size()), pending_barriers.memory_barriers.data(),
+		                     to_u32(pending_barriers.buffer_memory_barriers.size()), pending_barriers.buffer_memory_barriers.data(),
+		                     to_u32(pending_barriers.image_memory_barriers.size()), pending_barriers.image_memory_barriers.data());
+	}
+
+	barrier_count += flushed_count;
+	barrier_call_count++;
+
+	clear_barriers();
+}
+
+bool CommandBuffer::is_synchronization2_enabled() const
+{
+	return synchronization2;
+}
+
+uint32_t CommandBuffer::get_barrier_count() const
+{
+	return barrier_count;
+}
+
+uint32_t CommandBuffer::get_barrier_call_count() const
+{
+	return barrier_call_count;
+}
+
+void CommandBuffer::flush_barriers_on(VkImage image, VkBuffer buffer)
+{
+	bool pending{false};
+
+	if (image != VK_NULL_HANDLE)
+	{
+		pending = std::any_of(pending_barriers.image_memory_barriers.begin(), pending_barriers.image_memory_barriers.end(),
+		                      [image](const VkImageMemoryBarrier &barrier) { return barrier.image == image; }) ||
+		          std::any_of(pending_barriers.image_memory_barriers2.begin(), pending_barriers.image_memory_barriers2.end(),
+		                      [image](const VkImageMemoryBarrier2KHR &barrier) { return barrier.image == image; });
+	}
+
+	if (buffer != VK_NULL_HANDLE)
+	{
+		pending = std::any_of(pending_barriers.buffer_memory_barriers.begin(), pending_barriers.buffer_memory_barriers.end(),
+		                      [buffer](const VkBufferMemoryBarrier &barrier) { return barrier.buffer == buffer; }) ||
+		          std::any_of(pending_barriers.buffer_memory_barriers2.begin(), pending_barriers.buffer_memory_barriers2.end(),
+		                      [buffer](const VkBufferMemoryBarrier2KHR &barrier) { return barrier.buffer == buffer; });
+	}
+
+	if (pending)
+	{
+		flush_barriers();
+	}
+}
+
+void CommandBuffer::clear_barriers()
+{
+	// Keep the capacity of the vectors, the command buffer records as many barriers in the next frames
+	pending_barriers.src_stage_mask = 0;
+	pending_barriers.dst_stage_mask = 0;
+	pending_barriers.memory_barriers.clear();
+	pending_barriers.buffer_memory_barriers.clear();
+	pending_barriers.image_memory_barriers.clear();
+	pending_barriers.memory_barriers2.clear();
+	pending_barriers.buffer_memory_barriers2.clear();
+	pending_barriers.image_memory_barriers2.clear();
+}
+
+bool CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point)
 {
 	// Create a new pipeline only if the graphics state changed
 	if (!pipeline_state.is_dirty())
 	{
-		return;
+		return true;
 	}
 
 	pipeline_state.clear_dirty();
@@ -493,11 +788,37 @@ void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point
 	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
 	{
 		pipeline_state.set_render_pass(*current_render_pass.render_pass);
-		auto &pipeline = get_device().get_resource_cache().request_graphics_pipeline(pipeline_state);
 
-		vkCmdBindPipeline(get_handle(),
-		                  pipeline_bind_point,
-		                  pipeline.get_handle());
+		auto &resource_cache = get_device().get_resource_cache();
+
+		if (resource_cache.is_async_pipeline_compilation_enabled())
+		{
+			bool  fallback{false};
+			auto *pipeline = resource_cache.request_graphics_pipeline_async(pipeline_state, fallback);
+
+			// Keep the state dirty until the requested pipeline is bound, so that the next draws check whether it is ready
+			if (!pipeline || fallback)
+			{
+				pipeline_state.set_dirty();
+			}
+
+			if (!pipeline)
+			{
+				return false;
+			}
+
+			vkCmdBindPipeline(get_handle(),
+			                  pipeline_bind_point,
+			                  pipeline->get_handle());
+		}
+		else
+		{
+			auto &pipeline = resource_cache.request_graphics_pipeline(pipeline_state);
+
+			vkCmdBindPipeline(get_handle(),
+			                  pipeline_bind_point,
+			                  pipeline.get_handle());
+		}
 	}
 	else if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
 	{
@@ -511,6 +832,8 @@ void CommandBuffer::flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point
 	{
 		throw "Only graphics and compute pipeline bind points are supported now";
 	}
+
+	return true;
 }
 
 void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_point)
@@ -519,7 +842,12 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 
 	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-	std::unordered_set<uint32_t> update_descriptor_sets;
+	// Set indices are bounded by maxBoundDescriptorSets, which is small, so a bit mask is enough to track them.
+	// Sets beyond the mask are conservatively always updated.
+	uint64_t update_descriptor_sets = 0;
+	auto     needs_update           = [&update_descriptor_sets](uint32_t descriptor_set_id) {
+		return descriptor_set_id >= 64 || (update_descriptor_sets & (uint64_t{1} << descriptor_set_id)) != 0;
+	};
 
 	// Iterate over the shader sets to check if they have already been bound
 	// If they have, add the set so that the command buffer later updates it
@@ -533,7 +861,7 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 		{
 			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
 			{
-				update_descriptor_sets.emplace(descriptor_set_id);
+				update_descriptor_sets |= descriptor_set_id < 64 ? uint64_t{1} << descriptor_set_id : 0;
 			}
 		}
 	}
@@ -552,7 +880,7 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 	}
 
 	// Check if a descriptor set needs to be created
-	if (resource_binding_state.is_dirty() || !update_descriptor_sets.empty())
+	if (resource_binding_state.is_dirty() || update_descriptor_sets != 0)
 	{
 		resource_binding_state.clear_dirty();
 
@@ -563,7 +891,7 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 			auto    &resource_set      = resource_set_it.second;
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
-			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
+			if (!resource_set.is_dirty() && !needs_update(descriptor_set_id))
 			{
 				continue;
 			}
@@ -582,11 +910,51 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 			// Make descriptor set layout bound for current set
 			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
 
+			std::vector<uint32_t> dynamic_offsets;
+
+			// If only the offsets of dynamic buffers changed, bind the previous descriptor set again with the new offsets
+			if (auto descriptor_set_handle = resource_set.get_reusable_descriptor_set();
+			    descriptor_set_handle != VK_NULL_HANDLE && !needs_update(descriptor_set_id))
+			{
+				bool reusable = true;
+
+				for (auto &binding_it : resource_set.get_resource_bindings())
+				{
+					auto binding_info = descriptor_set_layout.get_layout_binding(binding_it.first);
+
+					for (auto &element_it : binding_it.second)
+					{
+						auto &resource_info = element_it.second;
+
+						if (binding_info && resource_info.buffer != nullptr && is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+						{
+							dynamic_offsets.push_back(to_u32(resource_info.offset));
+						}
+						else if (resource_info.dirty)
+						{
+							reusable = false;
+						}
+					}
+				}
+
+				if (reusable)
+				{
+					vkCmdBindDescriptorSets(get_handle(),
+					                        pipeline_bind_point,
+					                        pipeline_layout.get_handle(),
+					                        descriptor_set_id,
+					                        1, &descriptor_set_handle,
+					                        to_u32(dynamic_offsets.size()),
+					                        dynamic_offsets.data());
+					continue;
+				}
+
+				dynamic_offsets.clear();
+			}
+
 			BindingMap<VkDescriptorBufferInfo> buffer_infos;
 			BindingMap<VkDescriptorImageInfo>  image_infos;
 
-			std::vector<uint32_t> dynamic_offsets;
-
 			// Iterate over all resource bindings
 			for (auto &binding_it : resource_set.get_resource_bindings())
 			{
@@ -678,6 +1046,8 @@ void CommandBuffer::flush_descriptor_state(VkPipelineBindPoint pipeline_bind_poi
 			                                                            update_after_bind,
 			                                                            command_pool.get_thread_index());
 
+			resource_binding_state.set_descriptor_set(descriptor_set_id, descriptor_set_handle);
+
 			// Bind descriptor set
 			vkCmdBindDescriptorSets(get_handle(),
 			                        pipeline_bind_point,
@@ -739,22 +1109,30 @@ const bool CommandBuffer::is_render_size_optimal(const VkExtent2D &framebuffer_e
 
 void CommandBuffer::reset_query_pool(const QueryPool &query_pool, uint32_t first_query, uint32_t query_count)
 {
+	flush_barriers();
+
 	vkCmdResetQueryPool(get_handle(), query_pool.get_handle(), first_query, query_count);
 }
 
 void CommandBuffer::begin_query(const QueryPool &query_pool, uint32_t query, VkQueryControlFlags flags)
 {
+	flush_barriers();
+
 	vkCmdBeginQuery(get_handle(), query_pool.get_handle(), query, flags);
 }
 
 void CommandBuffer::end_query(const QueryPool &query_pool, uint32_t query)
 {
+	flush_barriers();
+
 	vkCmdEndQuery(get_handle(), query_pool.get_handle(), query);
 }
 
 void CommandBuffer::write_timestamp(VkPipelineStageFlagBits pipeline_stage,
                                     const QueryPool &query_pool, uint32_t query)
 {
+	flush_barriers();
+
 	vkCmdWriteTimestamp(get_handle(), pipeline_stage, query_pool.get_handle(), query);
 }
 
@@ -764,6 +1142,8 @@ VkResult CommandBuffer::reset(ResetMode reset_mode)
 
 	assert(reset_mode == command_pool.get_reset_mode() && "Command buffer reset mode must match the one used by the pool to allocate it");
 
+	clear_barriers();
+
 	if (reset_mode == ResetMode::ResetIndividually)
 	{
 		result = vkResetCommandBuffer(get_handle(), VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT);
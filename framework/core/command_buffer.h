@@ -82,8 +82,9 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 	/**
 	 * @brief Flushes the command buffer, pushing the new changes
 	 * @param pipeline_bind_point The type of pipeline we want to flush
+	 * @return False if no pipeline could be bound, as its asynchronous build is still in progress
 	 */
-	void flush(VkPipelineBindPoint pipeline_bind_point);
+	bool flush(VkPipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Sets the command buffer so that it is ready for recording
@@ -107,6 +108,16 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 	 */
 	VkResult begin(VkCommandBufferUsageFlags flags, const RenderPass *render_pass, const Framebuffer *framebuffer, uint32_t subpass_index);
 
+	/**
+	 * @brief Requests a secondary command buffer from the render frame of this one, and begins it for the current subpass
+	 *        The secondary command buffer starts with the pipeline state, resource bindings and push constants recorded so far,
+	 *        and with a viewport and scissor covering the framebuffer, as dynamic state is not inherited.
+	 *        It uses the reset mode of this command buffer, so that requesting it never recreates the command pools.
+	 * @param thread_index Selects the thread's command pool, a different index is needed for each thread recording concurrently
+	 * @return The secondary command buffer, to be ended and then executed by this one
+	 */
+	CommandBuffer &begin_secondary_command_buffer(size_t thread_index = 0);
+
 	VkResult end();
 
 	void clear(VkClearAttachment info, VkClearRect rect);
@@ -115,7 +126,7 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	void begin_render_pass(const RenderTarget &render_target, const RenderPass &render_pass, const Framebuffer &framebuffer, const std::vector<VkClearValue> &clear_values, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
-	void next_subpass();
+	void next_subpass(VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
 	void execute_commands(CommandBuffer &secondary_command_buffer);
 
@@ -136,20 +147,17 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 	 */
 	void push_constants(const std::vector<uint8_t> &values);
 
+	/**
+	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
+	 * @param data The byte data to store
+	 * @param size The amount of bytes to store
+	 */
+	void push_constants(const uint8_t *data, size_t size);
+
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
 	}
 
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
@@ -216,10 +224,61 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	void copy_image_to_buffer(const core::Image &image, VkImageLayout image_layout, const core::Buffer &buffer, const std::vector<VkBufferImageCopy> &regions);
 
-	void image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier) const;
+	/**
+	 * @brief Queues an image memory barrier, recorded with the other pending barriers by flush_barriers()
+	 */
+	void image_memory_barrier(const core::ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
 
+	/**
+	 * @brief Queues a buffer memory barrier, recorded with the other pending barriers by flush_barriers()
+	 */
 	void buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
 
+	/**
+	 * @brief Queues a global memory barrier, recorded with the other pending barriers by flush_barriers()
+	 */
+	void memory_barrier(const GlobalMemoryBarrier &memory_barrier);
+
+	/**
+	 * @brief Queues a synchronization2 image memory barrier, the device must have enabled VK_KHR_synchronization2
+	 */
+	void image_memory_barrier(const VkImageMemoryBarrier2KHR &memory_barrier);
+
+	/**
+	 * @brief Queues a synchronization2 buffer memory barrier, the device must have enabled VK_KHR_synchronization2
+	 */
+	void buffer_memory_barrier(const VkBufferMemoryBarrier2KHR &memory_barrier);
+
+	/**
+	 * @brief Queues a synchronization2 global memory barrier, the device must have enabled VK_KHR_synchronization2
+	 */
+	void memory_barrier(const VkMemoryBarrier2KHR &memory_barrier);
+
+	/**
+	 * @brief Records the pending barriers in a single pipeline barrier command
+	 *        The commands of this class call it before recording anything the barriers must be ordered with:
+	 *        it only has to be called before recording commands directly on the handle.
+	 *        With VK_KHR_synchronization2 each barrier keeps its own stage masks, otherwise the stage masks
+	 *        of all the barriers are merged, which can only widen the dependencies.
+	 */
+	void flush_barriers();
+
+	/**
+	 * @return Whether the barriers are recorded with vkCmdPipelineBarrier2KHR
+	 */
+	bool is_synchronization2_enabled() const;
+
+	/**
+	 * @return The number of barriers recorded since the command buffer began,
+	 *         including the ones of the secondary command buffers it executes
+	 */
+	uint32_t get_barrier_count() const;
+
+	/**
+	 * @return The number of pipeline barrier commands the barriers were recorded in
+	 */
+	uint32_t get_barrier_call_count() const;
+
 	void set_update_after_bind(bool update_after_bind_);
 
 	void reset_query_pool(const QueryPool &query_pool, uint32_t first_query, uint32_t query_count);
@@ -263,6 +322,37 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_binding_state;
 
+	/**
+	 * @brief Barriers queued since the last command, recorded together by flush_barriers()
+	 */
+	struct PendingBarriers
+	{
+		/// Union of the stage masks of the barriers, used without synchronization2
+		VkPipelineStageFlags src_stage_mask{0};
+
+		VkPipelineStageFlags dst_stage_mask{0};
+
+		std::vector<VkMemoryBarrier> memory_barriers;
+
+		std::vector<VkBufferMemoryBarrier> buffer_memory_barriers;
+
+		std::vector<VkImageMemoryBarrier> image_memory_barriers;
+
+		std::vector<VkMemoryBarrier2KHR> memory_barriers2;
+
+		std::vector<VkBufferMemoryBarrier2KHR> buffer_memory_barriers2;
+
+		std::vector<VkImageMemoryBarrier2KHR> image_memory_barriers2;
+	};
+
+	PendingBarriers pending_barriers;
+
+	bool synchronization2{false};
+
+	uint32_t barrier_count{0};
+
+	uint32_t barrier_call_count{0};
+
 	const RenderPassBinding &get_current_render_pass() const;
 
 	const uint32_t get_current_subpass_index() const;
@@ -274,8 +364,11 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 
 	/**
 	 * @brief Flush the pipeline state
+	 *        With asynchronous pipeline compilation enabled in the resource cache, a graphics pipeline which is not built yet
+	 *        is replaced by a compatible fallback pipeline, or no pipeline is bound at all.
+	 * @return False if no pipeline was bound
 	 */
-	void flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
+	bool flush_pipeline_state(VkPipelineBindPoint pipeline_bind_point);
 
 	/**
 	 * @brief Flush the descriptor set state
@@ -286,6 +379,17 @@ class CommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::C, VkCo
 	 * @brief Flush the push constant state
 	 */
 	void flush_push_constants();
+
+	/**
+	 * @brief Flushes the pending barriers if one of them already applies to the image or buffer,
+	 *        as the barriers of a single command are not ordered with each other
+	 */
+	void flush_barriers_on(VkImage image, VkBuffer buffer);
+
+	/**
+	 * @brief Drops the pending barriers, when the recorded commands are reset
+	 */
+	void clear_barriers();
 };
 
 template <class T>
@@ -17,6 +17,8 @@
 
 #include "descriptor_pool.h"
 
+#include "common/strings.h"
+#include "core/util/logging.hpp"
 #include "descriptor_set_layout.h"
 #include "device.h"
 
@@ -39,21 +41,21 @@ DescriptorPool::DescriptorPool(Device &                   device,
 	}
 
 	// Allocate pool sizes array
-	pool_sizes.resize(descriptor_type_counts.size());
+	set_pool_sizes.resize(descriptor_type_counts.size());
 
-	auto pool_size_it = pool_sizes.begin();
+	auto pool_size_it = set_pool_sizes.begin();
 
-	// Fill pool size for each descriptor type count multiplied by the pool size
+	// Fill pool size for each descriptor type count, pools multiply it by their number of sets
 	for (auto &it : descriptor_type_counts)
 	{
 		pool_size_it->type = it.first;
 
-		pool_size_it->descriptorCount = it.second * pool_size;
+		pool_size_it->descriptorCount = it.second;
 
 		++pool_size_it;
 	}
 
-	pool_max_sets = pool_size;
+	next_pool_max_sets = std::max(1u, std::min(pool_size, MAX_POOL_SIZE));
 }
 
 DescriptorPool::~DescriptorPool()
@@ -67,15 +69,25 @@ DescriptorPool::~DescriptorPool()
 
 void DescriptorPool::reset()
 {
-	// Reset all descriptor pools
-	for (auto pool : pools)
+	// Several pools means that the frame needed more sets than the first pool could hold,
+	// replace them with a single one that is big enough for the peak usage
+	if (pools.size() > 1)
 	{
-		vkResetDescriptorPool(device.get_handle(), pool, 0);
+		merge_pools();
 	}
+	else
+	{
+		// Reset all descriptor pools
+		for (auto pool : pools)
+		{
+			vkResetDescriptorPool(device.get_handle(), pool, 0);
+		}
 
-	// Clear internal tracking of descriptor set allocations
-	std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
-	set_pool_mapping.clear();
+		// Clear internal tracking of descriptor set allocations
+		std::fill(pool_sets_count.begin(), pool_sets_count.end(), 0);
+	}
+
+	stats.allocated_sets = 0;
 
 	// Reset the pool index from which descriptor sets are allocated
 	pool_index = 0;
@@ -94,62 +106,54 @@ void DescriptorPool::set_descriptor_set_layout(const DescriptorSetLayout &set_la
 
 VkDescriptorSet DescriptorPool::allocate()
 {
-	pool_index = find_available_pool(pool_index);
-
-	// Increment allocated set count for the current pool
-	++pool_sets_count[pool_index];
-
 	VkDescriptorSetLayout set_layout = get_descriptor_set_layout().get_handle();
 
 	VkDescriptorSetAllocateInfo alloc_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
-	alloc_info.descriptorPool     = pools[pool_index];
 	alloc_info.descriptorSetCount = 1;
 	alloc_info.pSetLayouts        = &set_layout;
 
 	VkDescriptorSet handle = VK_NULL_HANDLE;
 
-	// Allocate a new descriptor set from the current pool
-	auto result = vkAllocateDescriptorSets(device.get_handle(), &alloc_info, &handle);
+	VkResult result = VK_ERROR_OUT_OF_POOL_MEMORY;
 
-	if (result != VK_SUCCESS)
+	// A pool may run out of memory before reaching its number of sets (e.g. when fragmented),
+	// in which case it is considered full and the set is allocated from the next one
+	for (uint32_t attempt = 0; attempt < 2 && (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL); ++attempt)
 	{
-		// Decrement allocated set count for the current pool
-		--pool_sets_count[pool_index];
+		pool_index = find_available_pool(pool_index);
 
-		return VK_NULL_HANDLE;
-	}
-
-	// Store mapping between the descriptor set and the pool
-	set_pool_mapping.emplace(handle, pool_index);
+		if (pool_index >= pools.size())
+		{
+			return VK_NULL_HANDLE;
+		}
 
-	return handle;
-}
+		// Allocate a new descriptor set from the current pool
+		alloc_info.descriptorPool = pools[pool_index];
+		result                    = vkAllocateDescriptorSets(device.get_handle(), &alloc_info, &handle);
 
-VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
-{
-	// Get the pool index of the descriptor set
-	auto it = set_pool_mapping.find(descriptor_set);
+		if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+		{
+			pool_sets_count[pool_index] = pool_max_sets[pool_index];
+		}
+	}
 
-	if (it == set_pool_mapping.end())
+	if (result != VK_SUCCESS)
 	{
-		return VK_INCOMPLETE;
+		return VK_NULL_HANDLE;
 	}
 
-	auto desc_pool_index = it->second;
-
-	// Free descriptor set from the pool
-	vkFreeDescriptorSets(device.get_handle(), pools[desc_pool_index], 1, &descriptor_set);
-
-	// Remove descriptor set mapping to the pool
-	set_pool_mapping.erase(it);
+	// Increment allocated set count for the current pool
+	++pool_sets_count[pool_index];
 
-	// Decrement allocated set count for the pool
-	--pool_sets_count[desc_pool_index];
+	++stats.allocated_sets;
+	stats.peak_allocated_sets = std::max(stats.peak_allocated_sets, stats.allocated_sets);
 
-	// Change the current pool index to use the available pool
-	pool_index = desc_pool_index;
+	return handle;
+}
 
-	return VK_SUCCESS;
+const DescriptorPool::Stats &DescriptorPool::get_stats() const
+{
+	return stats;
 }
 
 std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
@@ -157,11 +161,17 @@ std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
 	// Create a new pool
 	if (pools.size() <= search_index)
 	{
+		std::vector<VkDescriptorPoolSize> pool_sizes{set_pool_sizes};
+		for (auto &pool_size : pool_sizes)
+		{
+			pool_size.descriptorCount *= next_pool_max_sets;
+		}
+
 		VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
 
 		create_info.poolSizeCount = to_u32(pool_sizes.size());
 		create_info.pPoolSizes    = pool_sizes.data();
-		create_info.maxSets       = pool_max_sets;
+		create_info.maxSets       = next_pool_max_sets;
 
 		// We do not set FREE_DESCRIPTOR_SET_BIT as we do not need to free individual descriptor sets
 		create_info.flags = 0;
@@ -183,18 +193,27 @@ std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
 
 		if (result != VK_SUCCESS)
 		{
-			return 0;
+			LOGE("Failed to create a descriptor pool of {} sets: {}", next_pool_max_sets, to_string(result));
+			return to_u32(pools.size());
 		}
 
 		// Store internally the Vulkan handle
 		pools.push_back(handle);
 
 		// Add set count for the descriptor pool
+		pool_max_sets.push_back(next_pool_max_sets);
 		pool_sets_count.push_back(0);
 
-		return search_index;
+		stats.pool_count = to_u32(pools.size());
+		stats.capacity += next_pool_max_sets;
+		++stats.pool_creations;
+
+		// Grow geometrically so that the number of pools stays logarithmic in the number of sets
+		next_pool_max_sets = std::min(next_pool_max_sets * 2, MAX_POOL_SIZE);
+
+		return to_u32(pools.size() - 1);
 	}
-	else if (pool_sets_count[search_index] < pool_max_sets)
+	else if (pool_sets_count[search_index] < pool_max_sets[search_index])
 	{
 		return search_index;
 	}
@@ -202,4 +221,28 @@ std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
 	// Increment pool index
 	return find_available_pool(++search_index);
 }
+
+void DescriptorPool::merge_pools()
+{
+	for (auto pool : pools)
+	{
+		vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+	}
+
+	pools.clear();
+	pool_max_sets.clear();
+	pool_sets_count.clear();
+
+	// Round up to a power of two to leave some headroom for the next frames
+	uint32_t max_sets = 1;
+	while (max_sets < stats.allocated_sets && max_sets < MAX_POOL_SIZE)
+	{
+		max_sets *= 2;
+	}
+
+	next_pool_max_sets = max_sets;
+
+	stats.pool_count = 0;
+	stats.capacity   = 0;
+}
 }        // namespace vkb
@@ -17,8 +17,6 @@
 
 #pragma once
 
-#include <unordered_map>
-
 #include "common/helpers.h"
 #include "common/vk_common.h"
 
@@ -28,13 +26,40 @@ class Device;
 class DescriptorSetLayout;
 
 /**
- * @brief Manages an array of fixed size VkDescriptorPool and is able to allocate descriptor sets
+ * @brief Manages an array of VkDescriptorPool and is able to allocate descriptor sets
+ *        Each new VkDescriptorPool holds twice as many sets as the previous one (up to MAX_POOL_SIZE),
+ *        and when the pools are reset they are merged into a single one big enough for the peak usage
  */
 class DescriptorPool
 {
   public:
+	/// Number of sets of the first VkDescriptorPool
 	static const uint32_t MAX_SETS_PER_POOL = 16;
 
+	/// Maximum number of sets of a single VkDescriptorPool
+	static const uint32_t MAX_POOL_SIZE = 4096;
+
+	/**
+	 * @brief Allocation statistics of the descriptor pool (i.e. of a descriptor set layout)
+	 */
+	struct Stats
+	{
+		/// Number of VkDescriptorPool currently created
+		uint32_t pool_count{0};
+
+		/// Number of sets that can be allocated from the current pools
+		uint32_t capacity{0};
+
+		/// Number of sets currently allocated
+		uint32_t allocated_sets{0};
+
+		/// Highest number of sets allocated at once
+		uint32_t peak_allocated_sets{0};
+
+		/// Number of VkDescriptorPool created since the creation of the descriptor pool
+		uint32_t pool_creations{0};
+	};
+
 	DescriptorPool(Device &                   device,
 	               const DescriptorSetLayout &descriptor_set_layout,
 	               uint32_t                   pool_size = MAX_SETS_PER_POOL);
@@ -57,32 +82,37 @@ class DescriptorPool
 
 	VkDescriptorSet allocate();
 
-	VkResult free(VkDescriptorSet descriptor_set);
+	const Stats &get_stats() const;
 
   private:
 	Device &device;
 
 	const DescriptorSetLayout *descriptor_set_layout{nullptr};
 
-	// Descriptor pool size
-	std::vector<VkDescriptorPoolSize> pool_sizes;
+	// Descriptor count of each type needed by a single set
+	std::vector<VkDescriptorPoolSize> set_pool_sizes;
 
-	// Number of sets to allocate for each pool
-	uint32_t pool_max_sets{0};
+	// Number of sets to allocate for the next pool
+	uint32_t next_pool_max_sets{0};
 
 	// Total descriptor pools created
 	std::vector<VkDescriptorPool> pools;
 
+	// Number of sets to allocate for each pool
+	std::vector<uint32_t> pool_max_sets;
+
 	// Count sets for each pool
 	std::vector<uint32_t> pool_sets_count;
 
 	// Current pool index to allocate descriptor set
 	uint32_t pool_index{0};
 
-	// Map between descriptor set and pool index
-	std::unordered_map<VkDescriptorSet, uint32_t> set_pool_mapping;
+	Stats stats;
 
 	// Find next pool index or create new pool
 	uint32_t find_available_pool(uint32_t pool_index);
+
+	// Destroys all pools, the next one will be sized to hold the peak usage
+	void merge_pools();
 };
 }        // namespace vkb
@@ -223,6 +223,222 @@ void DescriptorSet::apply_writes() const
 	                       nullptr);
 }
 
+namespace
+{
+/**
+ * @brief Fills the data read by the update template of a layout
+ * @return False if the infos do not cover exactly the descriptors of the template
+ */
+bool fill_update_data(Device                                                 &device,
+                      const DescriptorSetLayout                              &descriptor_set_layout,
+                      const BindingMap<VkDescriptorBufferInfo>               &buffer_infos,
+                      const BindingMap<VkDescriptorImageInfo>                &image_infos,
+                      std::vector<DescriptorSetLayout::DescriptorUpdateData> &update_data)
+{
+	update_data.resize(descriptor_set_layout.get_update_template_size());
+
+	// The template writes all the descriptors of the layout, so each of them needs to be provided
+	uint32_t written_count = 0;
+
+	auto get_element = [&descriptor_set_layout, &update_data](uint32_t binding_index, uint32_t array_element) -> DescriptorSetLayout::DescriptorUpdateData * {
+		auto offset = descriptor_set_layout.get_update_template_offset(binding_index);
+		if (offset == ~0U || offset + array_element >= update_data.size())
+		{
+			return nullptr;
+		}
+		return &update_data[offset + array_element];
+	};
+
+	const auto &limits   = device.get_gpu().get_properties().limits;
+	const auto &bindings = descriptor_set_layout.get_bindings();
+
+	for (auto &binding_it : buffer_infos)
+	{
+		auto binding_info = std::find_if(bindings.begin(), bindings.end(),
+		                                 [&binding_it](const VkDescriptorSetLayoutBinding &binding) { return binding.binding == binding_it.first; });
+		if (binding_info == bindings.end())
+		{
+			return false;
+		}
+
+		for (auto &element_it : binding_it.second)
+		{
+			auto element = get_element(binding_it.first, element_it.first);
+			if (!element)
+			{
+				return false;
+			}
+
+			element->buffer_info = element_it.second;
+
+			// Clip the buffers range to the limit as DescriptorSet::prepare() does
+			if (binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+			{
+				element->buffer_info.range = std::min<VkDeviceSize>(element->buffer_info.range, limits.maxUniformBufferRange);
+			}
+			else if (binding_info->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || binding_info->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)
+			{
+				element->buffer_info.range = std::min<VkDeviceSize>(element->buffer_info.range, limits.maxStorageBufferRange);
+			}
+
+			++written_count;
+		}
+	}
+
+	for (auto &binding_it : image_infos)
+	{
+		for (auto &element_it : binding_it.second)
+		{
+			auto element = get_element(binding_it.first, element_it.first);
+			if (!element)
+			{
+				return false;
+			}
+
+			element->image_info = element_it.second;
+
+			++written_count;
+		}
+	}
+
+	return written_count == update_data.size();
+}
+}        // namespace
+
+VkDescriptorSet DescriptorSet::create_with_template(Device                                   &device,
+                                                    const DescriptorSetLayout                &descriptor_set_layout,
+                                                    DescriptorPool                           &descriptor_pool,
+                                                    const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                                    const BindingMap<VkDescriptorImageInfo>  &image_infos)
+{
+	auto update_template = descriptor_set_layout.get_update_template();
+	if (update_template == VK_NULL_HANDLE)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	// Reuse the storage of previous calls from the same thread
+	thread_local std::vector<DescriptorSetLayout::DescriptorUpdateData> update_data;
+	if (!fill_update_data(device, descriptor_set_layout, buffer_infos, image_infos, update_data))
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	VkDescriptorSet handle = descriptor_pool.allocate();
+	if (handle != VK_NULL_HANDLE)
+	{
+		vkUpdateDescriptorSetWithTemplateKHR(device.get_handle(), handle, update_template, update_data.data());
+	}
+
+	return handle;
+}
+
+void DescriptorSet::write(Device                                   &device,
+                          const DescriptorSetLayout                &descriptor_set_layout,
+                          VkDescriptorSet                           handle,
+                          const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                          const BindingMap<VkDescriptorImageInfo>  &image_infos)
+{
+	// Reuse the storage of previous calls from the same thread
+	thread_local std::vector<DescriptorSetLayout::DescriptorUpdateData> update_data;
+
+	auto update_template = descriptor_set_layout.get_update_template();
+	if (update_template != VK_NULL_HANDLE && fill_update_data(device, descriptor_set_layout, buffer_infos, image_infos, update_data))
+	{
+		vkUpdateDescriptorSetWithTemplateKHR(device.get_handle(), handle, update_template, update_data.data());
+		return;
+	}
+
+	thread_local std::vector<VkWriteDescriptorSet>   write_operations;
+	thread_local std::vector<VkDescriptorBufferInfo> clipped_buffer_infos;
+	write_operations.clear();
+	clipped_buffer_infos.clear();
+
+	size_t buffer_count = 0;
+	for (auto &binding_it : buffer_infos)
+	{
+		buffer_count += binding_it.second.size();
+	}
+
+	// Reserve up-front as the write operations point into the vector
+	clipped_buffer_infos.reserve(buffer_count);
+
+	const auto &limits   = device.get_gpu().get_properties().limits;
+	const auto &bindings = descriptor_set_layout.get_bindings();
+
+	auto find_binding = [&bindings](uint32_t binding_index) {
+		return std::find_if(bindings.begin(), bindings.end(),
+		                    [binding_index](const VkDescriptorSetLayoutBinding &binding) { return binding.binding == binding_index; });
+	};
+
+	for (auto &binding_it : buffer_infos)
+	{
+		auto binding_info = find_binding(binding_it.first);
+		if (binding_info == bindings.end())
+		{
+			LOGE("Shader layout set does not use buffer binding at #{}", binding_it.first);
+			continue;
+		}
+
+		for (auto &element_it : binding_it.second)
+		{
+			auto buffer_info = element_it.second;
+
+			// Clip the buffers range to the limit as DescriptorSet::prepare() does
+			if (binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || binding_info->descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+			{
+				buffer_info.range = std::min<VkDeviceSize>(buffer_info.range, limits.maxUniformBufferRange);
+			}
+			else if (binding_info->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || binding_info->descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC)
+			{
+				buffer_info.range = std::min<VkDeviceSize>(buffer_info.range, limits.maxStorageBufferRange);
+			}
+
+			clipped_buffer_infos.push_back(buffer_info);
+
+			VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+
+			write_descriptor_set.dstBinding      = binding_it.first;
+			write_descriptor_set.descriptorType  = binding_info->descriptorType;
+			write_descriptor_set.pBufferInfo     = &clipped_buffer_infos.back();
+			write_descriptor_set.dstSet          = handle;
+			write_descriptor_set.dstArrayElement = element_it.first;
+			write_descriptor_set.descriptorCount = 1;
+
+			write_operations.push_back(write_descriptor_set);
+		}
+	}
+
+	for (auto &binding_it : image_infos)
+	{
+		auto binding_info = find_binding(binding_it.first);
+		if (binding_info == bindings.end())
+		{
+			LOGE("Shader layout set does not use image binding at #{}", binding_it.first);
+			continue;
+		}
+
+		for (auto &element_it : binding_it.second)
+		{
+			VkWriteDescriptorSet write_descriptor_set{VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+
+			write_descriptor_set.dstBinding      = binding_it.first;
+			write_descriptor_set.descriptorType  = binding_info->descriptorType;
+			write_descriptor_set.pImageInfo      = &element_it.second;
+			write_descriptor_set.dstSet          = handle;
+			write_descriptor_set.dstArrayElement = element_it.first;
+			write_descriptor_set.descriptorCount = 1;
+
+			write_operations.push_back(write_descriptor_set);
+		}
+	}
+
+	if (!write_operations.empty())
+	{
+		vkUpdateDescriptorSets(device.get_handle(), to_u32(write_operations.size()), write_operations.data(), 0, nullptr);
+	}
+}
+
 DescriptorSet::DescriptorSet(DescriptorSet &&other) :
     device{other.device},
     descriptor_set_layout{other.descriptor_set_layout},
@@ -81,6 +81,38 @@ class DescriptorSet
 	 */
 	void apply_writes() const;
 
+	/**
+	 * @brief Allocates a descriptor set and writes it in a single vkUpdateDescriptorSetWithTemplateKHR call,
+	 *        using the update template of its layout
+	 *        Unlike constructing a DescriptorSet and applying its writes, this does not build any write operation
+	 * @param device A valid Vulkan device
+	 * @param descriptor_set_layout The layout of the descriptor set
+	 * @param descriptor_pool The descriptor pool the descriptor set is allocated from
+	 * @param buffer_infos The descriptors that describe buffer data
+	 * @param image_infos The descriptors that describe image data
+	 * @return The descriptor set, or VK_NULL_HANDLE if the layout has no update template or the infos do not cover all of its descriptors
+	 */
+	static VkDescriptorSet create_with_template(Device                                   &device,
+	                                            const DescriptorSetLayout                &descriptor_set_layout,
+	                                            DescriptorPool                           &descriptor_pool,
+	                                            const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                                            const BindingMap<VkDescriptorImageInfo>  &image_infos);
+
+	/**
+	 * @brief Writes the descriptors of an allocated descriptor set, with the update template of its layout if possible
+	 *        Unlike constructing a DescriptorSet, this does not allocate the set nor keep track of its bindings
+	 * @param device A valid Vulkan device
+	 * @param descriptor_set_layout The layout of the descriptor set
+	 * @param handle The descriptor set to write, it must not be in use by the device
+	 * @param buffer_infos The descriptors that describe buffer data
+	 * @param image_infos The descriptors that describe image data
+	 */
+	static void write(Device                                   &device,
+	                  const DescriptorSetLayout                &descriptor_set_layout,
+	                  VkDescriptorSet                           handle,
+	                  const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                  const BindingMap<VkDescriptorImageInfo>  &image_infos);
+
 	const DescriptorSetLayout &get_layout() const;
 
 	VkDescriptorSet get_handle() const;
@@ -186,6 +186,73 @@ DescriptorSetLayout::DescriptorSetLayout(Device &                           devi
 	{
 		throw VulkanException{result, "Cannot create DescriptorSetLayout"};
 	}
+
+	if (device.is_enabled(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME))
+	{
+		create_update_template();
+	}
+}
+
+void DescriptorSetLayout::create_update_template()
+{
+	// Update-after-bind bindings are updated one by one when they change, which a template can not do
+	if (std::find_if(binding_flags.begin(), binding_flags.end(), [](VkDescriptorBindingFlagsEXT flags) { return flags != 0; }) != binding_flags.end())
+	{
+		return;
+	}
+
+	std::vector<VkDescriptorUpdateTemplateEntryKHR> entries;
+
+	uint32_t offset = 0;
+	for (auto &binding : bindings)
+	{
+		if (binding.descriptorCount == 0)
+		{
+			continue;
+		}
+
+		VkDescriptorUpdateTemplateEntryKHR entry{};
+		entry.dstBinding      = binding.binding;
+		entry.dstArrayElement = 0;
+		entry.descriptorCount = binding.descriptorCount;
+		entry.descriptorType  = binding.descriptorType;
+		entry.offset          = offset * sizeof(DescriptorUpdateData);
+		entry.stride          = sizeof(DescriptorUpdateData);
+
+		entries.push_back(entry);
+
+		if (update_template_offsets.size() <= binding.binding)
+		{
+			update_template_offsets.resize(binding.binding + 1, ~0U);
+		}
+		update_template_offsets[binding.binding] = offset;
+
+		offset += binding.descriptorCount;
+	}
+
+	if (entries.empty())
+	{
+		update_template_offsets.clear();
+		return;
+	}
+
+	VkDescriptorUpdateTemplateCreateInfoKHR create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR};
+	create_info.descriptorUpdateEntryCount = to_u32(entries.size());
+	create_info.pDescriptorUpdateEntries   = entries.data();
+	create_info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+	create_info.descriptorSetLayout        = handle;
+
+	VkResult result = vkCreateDescriptorUpdateTemplateKHR(device.get_handle(), &create_info, nullptr, &update_template);
+
+	if (result != VK_SUCCESS)
+	{
+		// Descriptor sets will be written with vkUpdateDescriptorSets instead
+		update_template = VK_NULL_HANDLE;
+		update_template_offsets.clear();
+		return;
+	}
+
+	update_template_size = offset;
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
@@ -197,13 +264,22 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
     binding_flags{std::move(other.binding_flags)},
     bindings_lookup{std::move(other.bindings_lookup)},
     binding_flags_lookup{std::move(other.binding_flags_lookup)},
-    resources_lookup{std::move(other.resources_lookup)}
+    resources_lookup{std::move(other.resources_lookup)},
+    update_template{other.update_template},
+    update_template_offsets{std::move(other.update_template_offsets)},
+    update_template_size{other.update_template_size}
 {
-	other.handle = VK_NULL_HANDLE;
+	other.handle          = VK_NULL_HANDLE;
+	other.update_template = VK_NULL_HANDLE;
 }
 
 DescriptorSetLayout::~DescriptorSetLayout()
 {
+	if (update_template != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorUpdateTemplateKHR(device.get_handle(), update_template, nullptr);
+	}
+
 	// Destroy descriptor set layout
 	if (handle != VK_NULL_HANDLE)
 	{
@@ -272,4 +348,18 @@ const std::vector<ShaderModule *> &DescriptorSetLayout::get_shader_modules() con
 	return shader_modules;
 }
 
+VkDescriptorUpdateTemplateKHR DescriptorSetLayout::get_update_template() const
+{
+	return update_template;
+}
+
+uint32_t DescriptorSetLayout::get_update_template_offset(uint32_t binding_index) const
+{
+	return binding_index < update_template_offsets.size() ? update_template_offsets[binding_index] : ~0U;
+}
+
+uint32_t DescriptorSetLayout::get_update_template_size() const
+{
+	return update_template_size;
+}
 }        // namespace vkb
@@ -35,6 +35,16 @@ struct ShaderResource;
 class DescriptorSetLayout
 {
   public:
+	/**
+	 * @brief Element of the data written with the update template, see get_update_template()
+	 */
+	union DescriptorUpdateData
+	{
+		VkDescriptorImageInfo image_info;
+
+		VkDescriptorBufferInfo buffer_info;
+	};
+
 	/**
 	 * @brief Creates a descriptor set layout from a set of resources
 	 * @param device A valid Vulkan device
@@ -73,6 +83,24 @@ class DescriptorSetLayout
 
 	const std::vector<ShaderModule *> &get_shader_modules() const;
 
+	/**
+	 * @brief Returns the descriptor update template of the layout, if VK_KHR_descriptor_update_template is enabled
+	 *        It writes every descriptor of every binding from an array of DescriptorUpdateData,
+	 *        where binding N starts at element get_update_template_offset(N)
+	 * @return The template handle, or VK_NULL_HANDLE if templates are not supported for this layout
+	 */
+	VkDescriptorUpdateTemplateKHR get_update_template() const;
+
+	/**
+	 * @return The index of the first DescriptorUpdateData element of a binding, or ~0U if the binding is not in the template
+	 */
+	uint32_t get_update_template_offset(uint32_t binding_index) const;
+
+	/**
+	 * @return The number of DescriptorUpdateData elements read by the update template
+	 */
+	uint32_t get_update_template_size() const;
+
   private:
 	Device &device;
 
@@ -91,5 +119,14 @@ class DescriptorSetLayout
 	std::unordered_map<std::string, uint32_t> resources_lookup;
 
 	std::vector<ShaderModule *> shader_modules;
+
+	VkDescriptorUpdateTemplateKHR update_template{VK_NULL_HANDLE};
+
+	// First DescriptorUpdateData element of each binding number
+	std::vector<uint32_t> update_template_offsets;
+
+	uint32_t update_template_size{0};
+
+	void create_update_template();
 };
 }        // namespace vkb
@@ -16,9 +16,11 @@
  */
 
 #include "core/hpp_command_buffer.h"
+#include <core/command_buffer.h>
 #include <core/hpp_command_pool.h>
 #include <core/hpp_device.h>
 #include <core/hpp_pipeline.h>
+#include <core/util/push_constants.hpp>
 #include <rendering/hpp_render_frame.h>
 
 namespace vkb
@@ -34,6 +36,20 @@ HPPCommandBuffer::HPPCommandBuffer(vkb::core::HPPCommandPool &command_pool, vk::
 	vk::CommandBufferAllocateInfo allocate_info(command_pool.get_handle(), level, 1);
 
 	set_handle(get_device().get_handle().allocateCommandBuffers(allocate_info).front());
+
+	// Barriers are recorded with vkCmdPipelineBarrier2KHR only if the extension and its feature were enabled
+	if (get_device().is_enabled(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME))
+	{
+		auto *feature = static_cast<const vk::BaseInStructure *>(get_device().get_gpu().get_extension_feature_chain());
+		while (feature)
+		{
+			if (feature->sType == vk::StructureType::ePhysicalDeviceSynchronization2FeaturesKHR)
+			{
+				synchronization2 = reinterpret_cast<const vk::PhysicalDeviceSynchronization2FeaturesKHR *>(feature)->synchronization2;
+			}
+			feature = feature->pNext;
+		}
+	}
 }
 
 HPPCommandBuffer::HPPCommandBuffer(HPPCommandBuffer &&other) :
@@ -48,7 +64,11 @@ HPPCommandBuffer::HPPCommandBuffer(HPPCommandBuffer &&other) :
     last_framebuffer_extent(std::exchange(other.last_framebuffer_extent, {})),
     last_render_area_extent(std::exchange(other.last_render_area_extent, {})),
     update_after_bind(std::exchange(other.update_after_bind, {})),
-    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {}))
+    descriptor_set_layout_binding_state(std::exchange(other.descriptor_set_layout_binding_state, {})),
+    pending_barriers(std::exchange(other.pending_barriers, {})),
+    synchronization2(std::exchange(other.synchronization2, {})),
+    barrier_count(std::exchange(other.barrier_count, {})),
+    barrier_call_count(std::exchange(other.barrier_call_count, {}))
 {
 }
 
@@ -81,6 +101,9 @@ vk::Result HPPCommandBuffer::begin(vk::CommandBufferUsageFlags flags, const vkb:
 	resource_binding_state.reset();
 	descriptor_set_layout_binding_state.clear();
 	stored_push_constants.clear();
+	clear_barriers();
+	barrier_count      = 0;
+	barrier_call_count = 0;
 
 	vk::CommandBufferBeginInfo       begin_info(flags);
 	vk::CommandBufferInheritanceInfo inheritance;
@@ -105,6 +128,7 @@ vk::Result HPPCommandBuffer::begin(vk::CommandBufferUsageFlags flags, const vkb:
 
 void HPPCommandBuffer::begin_query(const vkb::core::HPPQueryPool &query_pool, uint32_t query, vk::QueryControlFlags flags)
 {
+	flush_barriers();
 	get_handle().beginQuery(query_pool.get_handle(), query, flags);
 }
 
@@ -131,6 +155,8 @@ void HPPCommandBuffer::begin_render_pass(const vkb::rendering::HPPRenderTarget &
                                          const std::vector<vk::ClearValue>     &clear_values,
                                          vk::SubpassContents                    contents)
 {
+	flush_barriers();
+
 	current_render_pass.render_pass = &render_pass;
 	current_render_pass.framebuffer = &framebuffer;
 
@@ -213,6 +239,7 @@ void HPPCommandBuffer::bind_vertex_buffers(uint32_t
 
 void HPPCommandBuffer::blit_image(const vkb::core::HPPImage &src_img, const vkb::core::HPPImage &dst_img, const std::vector<vk::ImageBlit> &regions)
 {
+	flush_barriers();
 	get_handle().blitImage(
 	    src_img.get_handle(), vk::ImageLayout::eTransferSrcOptimal, dst_img.get_handle(), vk::ImageLayout::eTransferDstOptimal, regions, vk::Filter::eNearest);
 }
@@ -222,21 +249,22 @@ void HPPCommandBuffer::buffer_memory_barrier(const vkb::core::HPPBuffer
                                              vk::DeviceSize                             size,
                                              const vkb::common::HPPBufferMemoryBarrier &memory_barrier)
 {
-	vk::BufferMemoryBarrier buffer_memory_barrier(memory_barrier.src_access_mask, memory_barrier.dst_access_mask, {}, {}, buffer.get_handle(), offset, size);
-
-	vk::PipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
-	vk::PipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
-
-	get_handle().pipelineBarrier(src_stage_mask, dst_stage_mask, {}, {}, buffer_memory_barrier, {});
+	// The barrier is queued by vkb::CommandBuffer, so that barriers from both interfaces are batched together
+	reinterpret_cast<vkb::CommandBuffer *>(this)->buffer_memory_barrier(reinterpret_cast<vkb::core::Buffer const &>(buffer),
+	                                                                    offset,
+	                                                                    size,
+	                                                                    reinterpret_cast<vkb::BufferMemoryBarrier const &>(memory_barrier));
 }
 
 void HPPCommandBuffer::clear(vk::ClearAttachment attachment, vk::ClearRect rect)
 {
+	flush_barriers();
 	get_handle().clearAttachments(attachment, rect);
 }
 
 void HPPCommandBuffer::copy_buffer(const vkb::core::HPPBuffer &src_buffer, const vkb::core::HPPBuffer &dst_buffer, vk::DeviceSize size)
 {
+	flush_barriers();
 	vk::BufferCopy copy_region({}, {}, size);
 	get_handle().copyBuffer(src_buffer.get_handle(), dst_buffer.get_handle(), copy_region);
 }
@@ -245,11 +273,13 @@ void HPPCommandBuffer::copy_buffer_to_image(const vkb::core::HPPBuffer
                                             const vkb::core::HPPImage              &image,
                                             const std::vector<vk::BufferImageCopy> &regions)
 {
+	flush_barriers();
 	get_handle().copyBufferToImage(buffer.get_handle(), image.get_handle(), vk::ImageLayout::eTransferDstOptimal, regions);
 }
 
 void HPPCommandBuffer::copy_image(const vkb::core::HPPImage &src_img, const vkb::core::HPPImage &dst_img, const std::vector<vk::ImageCopy> &regions)
 {
+	flush_barriers();
 	get_handle().copyImage(src_img.get_handle(), vk::ImageLayout::eTransferSrcOptimal, dst_img.get_handle(), vk::ImageLayout::eTransferDstOptimal, regions);
 }
 
@@ -258,41 +288,48 @@ void HPPCommandBuffer::copy_image_to_buffer(const vkb::core::HPPImage
                                             const vkb::core::HPPBuffer             &buffer,
                                             const std::vector<vk::BufferImageCopy> &regions)
 {
+	flush_barriers();
 	get_handle().copyImageToBuffer(image.get_handle(), image_layout, buffer.get_handle(), regions);
 }
 
 void HPPCommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
 {
+	flush_barriers();
 	flush(vk::PipelineBindPoint::eCompute);
 	get_handle().dispatch(group_count_x, group_count_y, group_count_z);
 }
 
 void HPPCommandBuffer::dispatch_indirect(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset)
 {
+	flush_barriers();
 	flush(vk::PipelineBindPoint::eCompute);
 	get_handle().dispatchIndirect(buffer.get_handle(), offset);
 }
 
 void HPPCommandBuffer::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
 {
+	flush_barriers();
 	flush(vk::PipelineBindPoint::eGraphics);
 	get_handle().draw(vertex_count, instance_count, first_vertex, first_instance);
 }
 
 void HPPCommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
 {
+	flush_barriers();
 	flush(vk::PipelineBindPoint::eGraphics);
 	get_handle().drawIndexed(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
 void HPPCommandBuffer::draw_indexed_indirect(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset, uint32_t draw_count, uint32_t stride)
 {
+	flush_barriers();
 	flush(vk::PipelineBindPoint::eGraphics);
 	get_handle().drawIndexedIndirect(buffer.get_handle(), offset, draw_count, stride);
 }
 
 vk::Result HPPCommandBuffer::end()
 {
+	flush_barriers();
 	get_handle().end();
 
 	return vk::Result::eSuccess;
@@ -300,27 +337,40 @@ vk::Result HPPCommandBuffer::end()
 
 void HPPCommandBuffer::end_query(const vkb::core::HPPQueryPool &query_pool, uint32_t query)
 {
+	flush_barriers();
 	get_handle().endQuery(query_pool.get_handle(), query);
 }
 
 void HPPCommandBuffer::end_render_pass()
 {
+	flush_barriers();
 	get_handle().endRenderPass();
 }
 
 void HPPCommandBuffer::execute_commands(HPPCommandBuffer &secondary_command_buffer)
 {
+	flush_barriers();
 	get_handle().executeCommands(secondary_command_buffer.get_handle());
+
+	barrier_count += secondary_command_buffer.barrier_count;
+	barrier_call_count += secondary_command_buffer.barrier_call_count;
 }
 
 void HPPCommandBuffer::execute_commands(std::vector<HPPCommandBuffer *> &secondary_command_buffers)
 {
+	flush_barriers();
 	std::vector<vk::CommandBuffer> sec_cmd_buf_handles(secondary_command_buffers.size(), nullptr);
 	std::transform(secondary_command_buffers.begin(),
 	               secondary_command_buffers.end(),
 	               sec_cmd_buf_handles.begin(),
 	               [](const vkb::core::HPPCommandBuffer *sec_cmd_buf) { return sec_cmd_buf->get_handle(); });
 	get_handle().executeCommands(sec_cmd_buf_handles);
+
+	for (auto *secondary_command_buffer : secondary_command_buffers)
+	{
+		barrier_count += secondary_command_buffer->barrier_count;
+		barrier_call_count += secondary_command_buffer->barrier_call_count;
+	}
 }
 
 vkb::core::HPPRenderPass &HPPCommandBuffer::get_render_pass(const vkb::rendering::HPPRenderTarget                          &render_target,
@@ -348,33 +398,30 @@ vkb::core::HPPRenderPass &HPPCommandBuffer::get_render_pass(const vkb::rendering
 	return get_device().get_resource_cache().request_render_pass(render_target.get_attachments(), load_store_infos, subpass_infos);
 }
 
-void HPPCommandBuffer::image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier) const
+void HPPCommandBuffer::flush_barriers()
 {
-	// Adjust barrier's subresource range for depth images
-	auto subresource_range = image_view.get_subresource_range();
-	auto format            = image_view.get_format();
-	if (vkb::common::is_depth_only_format(format))
-	{
-		subresource_range.aspectMask = vk::ImageAspectFlagBits::eDepth;
-	}
-	else if (vkb::common::is_depth_stencil_format(format))
-	{
-		subresource_range.aspectMask = vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
-	}
+	reinterpret_cast<vkb::CommandBuffer *>(this)->flush_barriers();
+}
+
+uint32_t HPPCommandBuffer::get_barrier_count() const
+{
+	return barrier_count;
+}
 
-	vk::ImageMemoryBarrier image_memory_barrier(memory_barrier.src_access_mask,
-	                                            memory_barrier.dst_access_mask,
-	                                            memory_barrier.old_layout,
-	                                            memory_barrier.new_layout,
-	                                            memory_barrier.old_queue_family,
-	                                            memory_barrier.new_queue_family,
-	                                            image_view.get_image().get_handle(),
-	                                            subresource_range);
+uint32_t HPPCommandBuffer::get_barrier_call_count() const
+{
+	return barrier_call_count;
+}
 
-	vk::PipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
-	vk::PipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
+void HPPCommandBuffer::image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier)
+{
+	reinterpret_cast<vkb::CommandBuffer *>(this)->image_memory_barrier(reinterpret_cast<vkb::core::ImageView const &>(image_view),
+	                                                                   reinterpret_cast<vkb::ImageMemoryBarrier const &>(memory_barrier));
+}
 
-	get_handle().pipelineBarrier(src_stage_mask, dst_stage_mask, {}, {}, {}, image_memory_barrier);
+void HPPCommandBuffer::memory_barrier(const vkb::common::HPPGlobalMemoryBarrier &memory_barrier)
+{
+	reinterpret_cast<vkb::CommandBuffer *>(this)->memory_barrier(reinterpret_cast<vkb::GlobalMemoryBarrier const &>(memory_barrier));
 }
 
 void HPPCommandBuffer::next_subpass()
@@ -394,28 +441,27 @@ void HPPCommandBuffer::next_subpass()
 	// Clear stored push constants
 	stored_push_constants.clear();
 
+	flush_barriers();
+
 	get_handle().nextSubpass(vk::SubpassContents::eInline);
 }
 
 void HPPCommandBuffer::push_constants(const std::vector<uint8_t> &values)
 {
-	uint32_t push_constant_size = to_u32(stored_push_constants.size() + values.size());
+	push_constants(values.data(), values.size());
+}
 
-	if (push_constant_size > max_push_constants_size)
-	{
-		LOGE("Push constant limit of {} exceeded (pushing {} bytes for a total of {} bytes)", max_push_constants_size, values.size(), push_constant_size);
-		throw std::runtime_error("Push constant limit exceeded.");
-	}
-	else
-	{
-		stored_push_constants.insert(stored_push_constants.end(), values.begin(), values.end());
-	}
+void HPPCommandBuffer::push_constants(const uint8_t *data, size_t size)
+{
+	append_push_constants(stored_push_constants, data, size, max_push_constants_size);
 }
 
 vk::Result HPPCommandBuffer::reset(ResetMode reset_mode)
 {
 	assert(reset_mode == command_pool.get_reset_mode() && "Command buffer reset mode must match the one used by the pool to allocate it");
 
+	clear_barriers();
+
 	if (reset_mode == ResetMode::ResetIndividually)
 	{
 		get_handle().reset(vk::CommandBufferResetFlagBits::eReleaseResources);
@@ -426,11 +472,13 @@ vk::Result HPPCommandBuffer::reset(ResetMode reset_mode)
 
 void HPPCommandBuffer::reset_query_pool(const vkb::core::HPPQueryPool &query_pool, uint32_t first_query, uint32_t query_count)
 {
+	flush_barriers();
 	get_handle().resetQueryPool(query_pool.get_handle(), first_query, query_count);
 }
 
 void HPPCommandBuffer::resolve_image(const vkb::core::HPPImage &src_img, const vkb::core::HPPImage &dst_img, const std::vector<vk::ImageResolve> &regions)
 {
+	flush_barriers();
 	get_handle().resolveImage(src_img.get_handle(), vk::ImageLayout::eTransferSrcOptimal, dst_img.get_handle(), vk::ImageLayout::eTransferDstOptimal, regions);
 }
 
@@ -511,11 +559,13 @@ void HPPCommandBuffer::set_viewport_state(const vkb::rendering::HPPViewportState
 
 void HPPCommandBuffer::update_buffer(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset, const std::vector<uint8_t> &data)
 {
+	flush_barriers();
 	get_handle().updateBuffer<uint8_t>(buffer.get_handle(), offset, data);
 }
 
 void HPPCommandBuffer::write_timestamp(vk::PipelineStageFlagBits pipeline_stage, const vkb::core::HPPQueryPool &query_pool, uint32_t query)
 {
+	flush_barriers();
 	get_handle().writeTimestamp(pipeline_stage, query_pool.get_handle(), query);
 }
 
@@ -532,7 +582,12 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 
 	const auto &pipeline_layout = pipeline_state.get_pipeline_layout();
 
-	std::unordered_set<uint32_t> update_descriptor_sets;
+	// Set indices are bounded by maxBoundDescriptorSets, which is small, so a bit mask is enough to track them.
+	// Sets beyond the mask are conservatively always updated.
+	uint64_t update_descriptor_sets = 0;
+	auto     needs_update           = [&update_descriptor_sets](uint32_t descriptor_set_id) {
+		return descriptor_set_id >= 64 || (update_descriptor_sets & (uint64_t{1} << descriptor_set_id)) != 0;
+	};
 
 	// Iterate over the shader sets to check if they have already been bound
 	// If they have, add the set so that the command buffer later updates it
@@ -546,7 +601,7 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 		{
 			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_descriptor_set_layout(descriptor_set_id).get_handle())
 			{
-				update_descriptor_sets.emplace(descriptor_set_id);
+				update_descriptor_sets |= descriptor_set_id < 64 ? uint64_t{1} << descriptor_set_id : 0;
 			}
 		}
 	}
@@ -565,7 +620,7 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 	}
 
 	// Check if a descriptor set needs to be created
-	if (resource_binding_state.is_dirty() || !update_descriptor_sets.empty())
+	if (resource_binding_state.is_dirty() || update_descriptor_sets != 0)
 	{
 		resource_binding_state.clear_dirty();
 
@@ -576,7 +631,7 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 			auto    &resource_set      = resource_set_it.second;
 
 			// Don't update resource set if it's not in the update list OR its state hasn't changed
-			if (!resource_set.is_dirty() && (update_descriptor_sets.find(descriptor_set_id) == update_descriptor_sets.end()))
+			if (!resource_set.is_dirty() && !needs_update(descriptor_set_id))
 			{
 				continue;
 			}
@@ -595,11 +650,45 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 			// Make descriptor set layout bound for current set
 			descriptor_set_layout_binding_state[descriptor_set_id] = &descriptor_set_layout;
 
+			std::vector<uint32_t> dynamic_offsets;
+
+			// If only the offsets of dynamic buffers changed, bind the previous descriptor set again with the new offsets
+			if (auto descriptor_set_handle = resource_set.get_reusable_descriptor_set();
+			    descriptor_set_handle && !needs_update(descriptor_set_id))
+			{
+				bool reusable = true;
+
+				for (auto &binding_it : resource_set.get_resource_bindings())
+				{
+					auto binding_info = descriptor_set_layout.get_layout_binding(binding_it.first);
+
+					for (auto &element_it : binding_it.second)
+					{
+						auto &resource_info = element_it.second;
+
+						if (binding_info && resource_info.buffer != nullptr && vkb::common::is_dynamic_buffer_descriptor_type(binding_info->descriptorType))
+						{
+							dynamic_offsets.push_back(to_u32(resource_info.offset));
+						}
+						else if (resource_info.dirty)
+						{
+							reusable = false;
+						}
+					}
+				}
+
+				if (reusable)
+				{
+					get_handle().bindDescriptorSets(pipeline_bind_point, pipeline_layout.get_handle(), descriptor_set_id, descriptor_set_handle, dynamic_offsets);
+					continue;
+				}
+
+				dynamic_offsets.clear();
+			}
+
 			BindingMap<vk::DescriptorBufferInfo> buffer_infos;
 			BindingMap<vk::DescriptorImageInfo>  image_infos;
 
-			std::vector<uint32_t> dynamic_offsets;
-
 			// Iterate over all resource bindings
 			for (auto &binding_it : resource_set.get_resource_bindings())
 			{
@@ -673,6 +762,8 @@ void HPPCommandBuffer::flush_descriptor_state(vk::PipelineBindPoint pipeline_bin
 			vk::DescriptorSet descriptor_set_handle = command_pool.get_render_frame()->request_descriptor_set(
 			    descriptor_set_layout, buffer_infos, image_infos, update_after_bind, command_pool.get_thread_index());
 
+			resource_binding_state.set_descriptor_set(descriptor_set_id, descriptor_set_handle);
+
 			// Bind descriptor set
 			get_handle().bindDescriptorSets(pipeline_bind_point, pipeline_layout.get_handle(), descriptor_set_id, descriptor_set_handle, dynamic_offsets);
 		}
@@ -732,6 +823,18 @@ void HPPCommandBuffer::flush_push_constants()
 	stored_push_constants.clear();
 }
 
+void HPPCommandBuffer::clear_barriers()
+{
+	pending_barriers.src_stage_mask = {};
+	pending_barriers.dst_stage_mask = {};
+	pending_barriers.memory_barriers.clear();
+	pending_barriers.buffer_memory_barriers.clear();
+	pending_barriers.image_memory_barriers.clear();
+	pending_barriers.memory_barriers2.clear();
+	pending_barriers.buffer_memory_barriers2.clear();
+	pending_barriers.image_memory_barriers2.clear();
+}
+
 const HPPCommandBuffer::RenderPassBinding &HPPCommandBuffer::get_current_render_pass() const
 {
 	return current_render_pass;
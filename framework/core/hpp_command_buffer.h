@@ -123,14 +123,18 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	void                      draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
 	void                      draw_indexed_indirect(const vkb::core::HPPBuffer &buffer, vk::DeviceSize offset, uint32_t draw_count, uint32_t stride);
 	vk::Result                end();
+	void                      flush_barriers();
 	void                      end_query(const vkb::core::HPPQueryPool &query_pool, uint32_t query);
 	void                      end_render_pass();
 	void                      execute_commands(HPPCommandBuffer &secondary_command_buffer);
 	void                      execute_commands(std::vector<HPPCommandBuffer *> &secondary_command_buffers);
+	uint32_t                  get_barrier_count() const;
+	uint32_t                  get_barrier_call_count() const;
 	vkb::core::HPPRenderPass &get_render_pass(const vkb::rendering::HPPRenderTarget                          &render_target,
 	                                          const std::vector<vkb::common::HPPLoadStoreInfo>               &load_store_infos,
 	                                          const std::vector<std::unique_ptr<vkb::rendering::HPPSubpass>> &subpasses);
-	void                      image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier) const;
+	void                      image_memory_barrier(const vkb::core::HPPImageView &image_view, const vkb::common::HPPImageMemoryBarrier &memory_barrier);
+	void                      memory_barrier(const vkb::common::HPPGlobalMemoryBarrier &memory_barrier);
 	void                      next_subpass();
 
 	/**
@@ -138,20 +142,18 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	 * @param values The byte data to store
 	 */
 	void push_constants(const std::vector<uint8_t> &values);
+
+	/**
+	 * @brief Records byte data into the command buffer to be pushed as push constants to each draw call
+	 * @param data The byte data to store
+	 * @param size The amount of bytes to store
+	 */
+	void push_constants(const uint8_t *data, size_t size);
+
 	template <typename T>
 	void push_constants(const T &value)
 	{
-		auto data = to_bytes(value);
-
-		uint32_t size = to_u32(stored_push_constants.size() + data.size());
-
-		if (size > max_push_constants_size)
-		{
-			LOGE("Push constant limit exceeded ({} / {} bytes)", size, max_push_constants_size);
-			throw std::runtime_error("Cannot overflow push constant limit");
-		}
-
-		stored_push_constants.insert(stored_push_constants.end(), data.begin(), data.end());
+		push_constants(reinterpret_cast<const uint8_t *>(&value), sizeof(T));
 	}
 
 	/**
@@ -207,6 +209,11 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	 */
 	void flush_push_constants();
 
+	/**
+	 * @brief Drops the pending barriers, when the recorded commands are reset
+	 */
+	void clear_barriers();
+
 	const RenderPassBinding &get_current_render_pass() const;
 	const uint32_t           get_current_subpass_index() const;
 
@@ -231,6 +238,24 @@ class HPPCommandBuffer : public vkb::core::VulkanResource<vkb::BindingType::Cpp,
 	bool update_after_bind = false;
 
 	std::unordered_map<uint32_t, vkb::core::HPPDescriptorSetLayout const *> descriptor_set_layout_binding_state;
+
+	// Barriers queued since the last command, shared with vkb::CommandBuffer which records them
+	struct PendingBarriers
+	{
+		vk::PipelineStageFlags                   src_stage_mask = {};
+		vk::PipelineStageFlags                   dst_stage_mask = {};
+		std::vector<vk::MemoryBarrier>           memory_barriers;
+		std::vector<vk::BufferMemoryBarrier>     buffer_memory_barriers;
+		std::vector<vk::ImageMemoryBarrier>      image_memory_barriers;
+		std::vector<vk::MemoryBarrier2KHR>       memory_barriers2;
+		std::vector<vk::BufferMemoryBarrier2KHR> buffer_memory_barriers2;
+		std::vector<vk::ImageMemoryBarrier2KHR>  image_memory_barriers2;
+	};
+
+	PendingBarriers pending_barriers   = {};
+	bool            synchronization2   = false;
+	uint32_t        barrier_count      = 0;
+	uint32_t        barrier_call_count = 0;
 };
 
 template <class T>
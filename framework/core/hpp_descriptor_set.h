@@ -48,6 +48,20 @@ class HPPDescriptorSet : private vkb::DescriptorSet
 	                       reinterpret_cast<BindingMap<VkDescriptorImageInfo> const &>(image_infos))
 	{}
 
+	static vk::DescriptorSet create_with_template(vkb::core::HPPDevice                       &device,
+	                                              const vkb::core::HPPDescriptorSetLayout    &descriptor_set_layout,
+	                                              vkb::core::HPPDescriptorPool               &descriptor_pool,
+	                                              const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
+	                                              const BindingMap<vk::DescriptorImageInfo>  &image_infos)
+	{
+		return static_cast<vk::DescriptorSet>(
+		    vkb::DescriptorSet::create_with_template(reinterpret_cast<vkb::Device &>(device),
+		                                             reinterpret_cast<vkb::DescriptorSetLayout const &>(descriptor_set_layout),
+		                                             reinterpret_cast<vkb::DescriptorPool &>(descriptor_pool),
+		                                             reinterpret_cast<BindingMap<VkDescriptorBufferInfo> const &>(buffer_infos),
+		                                             reinterpret_cast<BindingMap<VkDescriptorImageInfo> const &>(image_infos)));
+	}
+
 	BindingMap<vk::DescriptorBufferInfo> &get_buffer_infos()
 	{
 		return reinterpret_cast<BindingMap<vk::DescriptorBufferInfo> &>(vkb::DescriptorSet::get_buffer_infos());
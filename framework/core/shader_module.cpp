@@ -21,7 +21,9 @@
 #include "device.h"
 #include "filesystem/legacy.h"
 #include "glsl_compiler.h"
+#include "shader_cache.h"
 #include "spirv_reflection.h"
+#include "timer.h"
 
 namespace vkb
 {
@@ -101,23 +103,42 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const Sh
 
 	// Precompile source into the final spirv bytecode
 	auto glsl_final_source = precompile_shader(source);
+	auto glsl_bytes        = convert_to_bytes(glsl_final_source);
 
-	// Compile the GLSL source
-	GLSLCompiler glsl_compiler;
-
-	if (!glsl_compiler.compile_to_spirv(stage, convert_to_bytes(glsl_final_source), entry_point, shader_variant, spirv, info_log))
+	// Reuse the SPIR-V and reflection data of a previous compilation if available
+	std::string cache_key;
+	if (ShaderCache::is_enabled())
 	{
-		LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
-		LOGE("{}", info_log);
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		cache_key = ShaderCache::compute_key(stage, glsl_bytes, entry_point, shader_variant);
 	}
 
-	SPIRVReflection spirv_reflection;
-
-	// Reflect all shader resources
-	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
+	if (!ShaderCache::is_enabled() || !ShaderCache::load(cache_key, spirv, resources, info_log))
 	{
-		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		Timer timer;
+		timer.start();
+
+		// Compile the GLSL source
+		GLSLCompiler glsl_compiler;
+
+		if (!glsl_compiler.compile_to_spirv(stage, glsl_bytes, entry_point, shader_variant, spirv, info_log))
+		{
+			LOGE("Shader compilation failed for shader \"{}\"", glsl_source.get_filename());
+			LOGE("{}", info_log);
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		SPIRVReflection spirv_reflection;
+
+		// Reflect all shader resources
+		if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources, shader_variant))
+		{
+			throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+		}
+
+		if (ShaderCache::is_enabled())
+		{
+			ShaderCache::store(cache_key, spirv, resources, info_log, timer.stop<Timer::Milliseconds>());
+		}
 	}
 
 	// Generate a unique id, determined by source and variant
@@ -0,0 +1,176 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "disk_cache.h"
+
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
+#include "filesystem/filesystem.hpp"
+
+namespace vkb
+{
+DiskCache::DiskCache(const std::string &name, const std::string &extension, uint32_t magic, uint32_t version) :
+    name{name},
+    extension{extension},
+    magic{magic},
+    version{version}
+{
+}
+
+void DiskCache::enable(const std::string &directory_)
+{
+	std::lock_guard<std::mutex> guard(mutex);
+
+	directory = directory_;
+	enabled   = true;
+
+	LOGI("{} cache enabled in {}", name, directory);
+}
+
+void DiskCache::disable()
+{
+	enabled = false;
+}
+
+bool DiskCache::is_enabled() const
+{
+	return enabled;
+}
+
+const std::string &DiskCache::get_name() const
+{
+	return name;
+}
+
+bool DiskCache::load(uint64_t key, const std::function<bool(std::istringstream &)> &read_payload)
+{
+	if (!enabled)
+	{
+		return false;
+	}
+
+	filesystem::Path path;
+	{
+		std::lock_guard<std::mutex> guard(mutex);
+		path = get_entry_path(key);
+	}
+
+	auto fs = filesystem::get();
+
+	std::vector<uint8_t> data;
+	if (fs->is_file(path))
+	{
+		try
+		{
+			data = fs->read_file_binary(path);
+		}
+		catch (const std::exception &e)
+		{
+			LOGW("Failed to read {} cache entry {}: {}", name, path.string(), e.what());
+		}
+	}
+
+	uint32_t entry_magic{0};
+	uint32_t entry_version{0};
+	uint64_t entry_key{0};
+	double   cost_ms{0.0};
+	bool     valid{false};
+
+	if (!data.empty())
+	{
+		std::istringstream is{std::string{data.begin(), data.end()}};
+
+		read(is, entry_magic, entry_version, entry_key);
+
+		if (is.good() && entry_magic == magic && entry_version == version && entry_key == key)
+		{
+			read(is, cost_ms);
+
+			// A corrupted payload may make the reader throw, which is a miss like any other invalid entry
+			try
+			{
+				valid = !is.fail() && read_payload(is) && !is.fail();
+			}
+			catch (const std::exception &e)
+			{
+				LOGW("Failed to read {} cache entry {}: {}", name, path.string(), e.what());
+			}
+		}
+
+		if (!valid)
+		{
+			LOGW("Discarding invalid {} cache entry {}", name, path.string());
+		}
+	}
+
+	std::lock_guard<std::mutex> guard(mutex);
+
+	if (!valid)
+	{
+		stats.misses++;
+		return false;
+	}
+
+	stats.hits++;
+	stats.time_saved_ms += cost_ms;
+
+	return true;
+}
+
+void DiskCache::store(uint64_t key, const std::function<void(std::ostringstream &)> &write_payload, double cost_ms)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	std::ostringstream os;
+	write(os, magic, version, key, cost_ms);
+	write_payload(os);
+
+	auto str = os.str();
+
+	// Serialize writes so that two threads producing the same entry do not interleave their output
+	std::lock_guard<std::mutex> guard(mutex);
+
+	try
+	{
+		filesystem::get()->write_file(get_entry_path(key), std::vector<uint8_t>{str.begin(), str.end()});
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Failed to write {} cache entry: {}", name, e.what());
+	}
+}
+
+DiskCache::Stats DiskCache::get_stats()
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	return stats;
+}
+
+void DiskCache::reset_stats()
+{
+	std::lock_guard<std::mutex> guard(mutex);
+	stats = {};
+}
+
+std::string DiskCache::get_entry_path(uint64_t key)
+{
+	return (filesystem::Path{directory} / fmt::format("{:016x}.{}", key, extension)).string();
+}
+}        // namespace vkb
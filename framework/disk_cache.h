@@ -0,0 +1,109 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace vkb
+{
+/**
+ * @brief Persistent cache of blobs keyed by a 64-bit hash of whatever produced them
+ *
+ * Each entry is stored in its own file, named after its key, and starts with a header holding a magic
+ * number, a version, the key and the time it took to produce the blob, which cache hits add to the time saved.
+ * Entries whose header does not match or whose payload is rejected by the reader are discarded.
+ *
+ * The cache is disabled by default, call DiskCache::enable() to start using it.
+ */
+class DiskCache
+{
+  public:
+	struct Stats
+	{
+		uint32_t hits{0};
+
+		uint32_t misses{0};
+
+		/// Time that was avoided by cache hits, in milliseconds
+		double time_saved_ms{0.0};
+	};
+
+	/**
+	 * @param name The name of the cache, used in logs
+	 * @param extension The extension of the entry files
+	 * @param magic The magic number at the start of every entry
+	 * @param version The version of the entry layout, entries with another version are discarded
+	 */
+	DiskCache(const std::string &name, const std::string &extension, uint32_t magic, uint32_t version);
+
+	/**
+	 * @brief Enables the cache
+	 * @param directory The directory where the cache entries are stored
+	 */
+	void enable(const std::string &directory);
+
+	void disable();
+
+	bool is_enabled() const;
+
+	const std::string &get_name() const;
+
+	/**
+	 * @brief Looks up a cache entry
+	 * @param key The key of the entry
+	 * @param read_payload Reads the payload of the entry, returns false if it is invalid
+	 * @return True if the entry was found and is valid
+	 */
+	bool load(uint64_t key, const std::function<bool(std::istringstream &)> &read_payload);
+
+	/**
+	 * @brief Stores a cache entry
+	 * @param key The key of the entry
+	 * @param write_payload Writes the payload of the entry
+	 * @param cost_ms The time it took to produce the payload, used to compute the time saved by future hits
+	 */
+	void store(uint64_t key, const std::function<void(std::ostringstream &)> &write_payload, double cost_ms);
+
+	Stats get_stats();
+
+	void reset_stats();
+
+  private:
+	std::string get_entry_path(uint64_t key);
+
+	std::string name;
+
+	std::string extension;
+
+	uint32_t magic;
+
+	uint32_t version;
+
+	std::mutex mutex;
+
+	std::string directory;
+
+	std::atomic<bool> enabled{false};
+
+	Stats stats;
+};
+}        // namespace vkb
@@ -58,7 +58,7 @@ void Frustum::update(const glm::mat4 &matrix)
 	}
 }
 
-bool Frustum::check_sphere(glm::vec3 pos, float radius)
+bool Frustum::check_sphere(glm::vec3 pos, float radius) const
 {
 	for (size_t i = 0; i < planes.size(); i++)
 	{
@@ -69,6 +69,24 @@ bool Frustum::check_sphere(glm::vec3 pos, float radius)
 	}
 	return true;
 }
+
+bool Frustum::check_box(const glm::vec3 &min, const glm::vec3 &max) const
+{
+	for (auto &plane : planes)
+	{
+		// The box is outside if even its corner furthest along the plane normal is behind the plane
+		glm::vec3 corner{plane.x > 0.0f ? max.x : min.x,
+		                 plane.y > 0.0f ? max.y : min.y,
+		                 plane.z > 0.0f ? max.z : min.z};
+
+		if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
 const std::array<glm::vec4, 6> &Frustum::get_planes() const
 {
 	return planes;
@@ -53,7 +53,15 @@ class Frustum
 	 * @param pos The center of the sphere
 	 * @param radius The radius of the sphere
 	 */
-	bool check_sphere(glm::vec3 pos, float radius);
+	bool check_sphere(glm::vec3 pos, float radius) const;
+
+	/**
+	 * @brief Checks if an axis-aligned bounding box is inside the Frustum
+	 *        The test is conservative, a box outside of the Frustum near one of its corners may still pass it.
+	 * @param min The minimum corner of the box
+	 * @param max The maximum corner of the box
+	 */
+	bool check_box(const glm::vec3 &min, const glm::vec3 &max) const;
 
 	const std::array<glm::vec4, 6> &get_planes() const;
 
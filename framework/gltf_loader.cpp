@@ -16,11 +16,12 @@
  * limitations under the License.
  */
 
-#define TINYGLTF_IMPLEMENTATION
 #include "gltf_loader.h"
 
 #include <limits>
+#include <numeric>
 #include <queue>
+#include <tuple>
 
 #include "common/error.h"
 
@@ -34,6 +35,7 @@
 #include "core/image.h"
 #include "core/util/logging.hpp"
 #include "filesystem/legacy.h"
+#include "geometry/meshlets.hpp"
 #include "scene_graph/components/camera.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/image/astc.h"
@@ -283,115 +285,283 @@ inline std::vector<uint8_t> convert_underlying_data_stride(const std::vector<uin
 	return result;
 }
 
-inline void upload_image_to_gpu(CommandBuffer &command_buffer, core::Buffer &staging_buffer, sg::Image &image)
+inline void prepare_meshlets(std::vector<Meshlet> &meshlets, std::unique_ptr<vkb::sg::SubMesh> &submesh, std::vector<unsigned char> &index_data)
 {
-	// Clean up the image data, as they are copied in the staging buffer
-	image.clear_data();
+	geometry::MeshletSource source;
+	// index_data is unsigned char type, casting to uint32_t* will give proper value
+	source.indices      = reinterpret_cast<const uint32_t *>(index_data.data());
+	source.index_count  = submesh->vertex_indices;
+	source.vertex_count = submesh->vertices_count;
+
+	// 32 because for each triangle we draw a line in a mesh shader sample, 32 triangles/lines per meshlet = 64 vertices on output
+	geometry::MeshletOptions options;
+	options.max_vertices  = 64;
+	options.max_triangles = 32;
+
+	auto built = geometry::build_meshlets(source, options);
 
+	meshlets.resize(built.meshlets.size());
+
+	for (size_t i = 0; i < built.meshlets.size(); ++i)
 	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.src_access_mask = 0;
-		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		auto &range   = built.meshlets[i];
+		auto &meshlet = meshlets[i];
+
+		meshlet.vertex_count = range.vertex_count;
+		meshlet.index_count  = range.triangle_count * 3;
+
+		std::copy_n(built.vertices.begin() + range.vertex_offset, range.vertex_count, meshlet.vertices);
 
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+		// The mesh shaders index the vertex buffer directly
+		for (uint32_t j = 0; j < meshlet.index_count; ++j)
+		{
+			meshlet.indices[j] = built.vertices[range.vertex_offset + built.triangles[range.triangle_offset + j]];
+		}
 	}
+}
 
-	// Create a buffer image copy for every mip level
-	auto &mipmaps = image.get_mipmaps();
+static inline bool texture_needs_srgb_colorspace(const std::string &name)
+{
+	// The gltf spec states that the base and emissive textures MUST be encoded with the sRGB
+	// transfer function. All other texture types are linear.
+	if (name == "baseColorTexture" || name == "emissiveTexture")
+	{
+		return true;
+	}
 
-	std::vector<VkBufferImageCopy> buffer_copy_regions(mipmaps.size());
+	// metallicRoughnessTexture, normalTexture & occlusionTexture must be linear
+	assert(name == "metallicRoughnessTexture" || name == "normalTexture" || name == "occlusionTexture");
+	return false;
+}
 
-	for (size_t i = 0; i < mipmaps.size(); ++i)
+/**
+ * @brief Reads the external buffers of a glTF file from a mapping of the file
+ *        tinygltf keeps buffers in its own vectors, so the mapped contents are copied once, instead of being read
+ *        through a stream into a temporary buffer first
+ */
+bool read_whole_gltf_file(std::vector<unsigned char> *out, std::string *err, const std::string &path, void *)
+{
+	auto fs = vkb::filesystem::get();
+
+	if (!fs->is_file(path))
 	{
-		auto &mipmap      = mipmaps[i];
-		auto &copy_region = buffer_copy_regions[i];
+		if (err)
+		{
+			*err += "File not found: " + path + "\n";
+		}
+		return false;
+	}
+
+	auto file = fs->map_file(path);
+	out->assign(file->begin(), file->end());
+
+	return true;
+}
+
+bool gltf_file_exists(const std::string &path, void *)
+{
+	return vkb::filesystem::get()->is_file(path);
+}
 
-		copy_region.bufferOffset     = mipmap.offset;
-		copy_region.imageSubresource = image.get_vk_image_view().get_subresource_layers();
-		// Update miplevel
-		copy_region.imageSubresource.mipLevel = mipmap.level;
-		copy_region.imageExtent               = mipmap.extent;
+bool get_gltf_file_size(size_t *size, std::string *err, const std::string &path, void *)
+{
+	auto fs = vkb::filesystem::get();
+
+	if (!fs->is_file(path))
+	{
+		if (err)
+		{
+			*err += "File not found: " + path + "\n";
+		}
+		return false;
 	}
 
-	command_buffer.copy_buffer_to_image(staging_buffer, image.get_vk_image(), buffer_copy_regions);
+	*size = fs->stat_file(path).size;
+
+	return true;
+}
+
+// Versions of tinygltf which check the size of external files before reading them need a callback for it
+template <typename Callbacks>
+auto set_file_size_callback(Callbacks &callbacks, int) -> decltype(callbacks.GetFileSizeInBytes = &get_gltf_file_size, void())
+{
+	callbacks.GetFileSizeInBytes = &get_gltf_file_size;
+}
 
+template <typename Callbacks>
+void set_file_size_callback(Callbacks &, long)
+{}
+
+/**
+ * @brief Parses a glTF file straight from its mapped contents, external buffers are resolved relative to it
+ *        and read through the same filesystem
+ */
+inline bool load_gltf_file(tinygltf::TinyGLTF &gltf_loader, tinygltf::Model &model, std::string &err, std::string &warn, const std::string &gltf_file)
+{
+	auto fs = vkb::filesystem::get();
+
+	tinygltf::FsCallbacks callbacks{};
+	callbacks.FileExists     = &gltf_file_exists;
+	callbacks.ExpandFilePath = &tinygltf::ExpandFilePath;
+	callbacks.ReadWholeFile  = &read_whole_gltf_file;
+	callbacks.WriteWholeFile = &tinygltf::WriteWholeFile;
+	set_file_size_callback(callbacks, 0);
+	gltf_loader.SetFsCallbacks(callbacks);
+
+	if (!fs->is_file(gltf_file))
 	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		err = "File not found: " + gltf_file;
+		return false;
+	}
+
+	auto file = fs->map_file(gltf_file);
+
+	std::string base_dir = vkb::filesystem::Path(gltf_file).parent_path().string();
 
-		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+	if (vkb::filesystem::Path(gltf_file).extension() == ".glb")
+	{
+		return gltf_loader.LoadBinaryFromMemory(&model, &err, &warn, file->data(), to_u32(file->size()), base_dir);
 	}
+
+	return gltf_loader.LoadASCIIFromString(&model, &err, &warn, reinterpret_cast<const char *>(file->data()), to_u32(file->size()), base_dir);
 }
 
-inline void prepare_meshlets(std::vector<Meshlet> &meshlets, std::unique_ptr<vkb::sg::SubMesh> &submesh, std::vector<unsigned char> &index_data)
+
+/**
+ * @brief Packs the vertex or index data of many submeshes into a few large device-local buffers
+ *
+ * Data is appended to the current arena until it reaches MESH_ARENA_SIZE, so that the offsets stay small
+ * and the allocations stay reasonable. build() uploads each arena with a single copy from a staging buffer
+ * which mirrors its layout.
+ */
+class MeshArenaBuilder
 {
-	Meshlet meshlet;
-	meshlet.vertex_count = 0;
-	meshlet.index_count  = 0;
+  public:
+	/// Size after which a new arena is started, larger data gets an arena of its own
+	static constexpr VkDeviceSize MESH_ARENA_SIZE = 256 * 1024 * 1024;
+
+	/// Alignment of the data in an arena, enough for any vertex attribute or index type
+	static constexpr VkDeviceSize MESH_ARENA_ALIGNMENT = 16;
+
+	MeshArenaBuilder(VkBufferUsageFlags usage, const std::string &name) :
+	    usage{usage}, name{name}
+	{}
+
+	/**
+	 * @brief Reserves space for the data in an arena
+	 * @return A handle to pass to get_buffer() and get_offset() once the arenas are built
+	 */
+	size_t add(std::vector<uint8_t> &&data)
+	{
+		VkDeviceSize size = data.size();
 
-	std::set<uint32_t> vertices;                  // set for unique vertices
-	uint32_t           triangle_check = 0;        // each meshlet needs to contain full primitives
+		if (arenas.empty() || (arenas.back().size > 0 && arenas.back().size + size > MESH_ARENA_SIZE))
+		{
+			arenas.emplace_back();
+		}
 
-	for (uint32_t i = 0; i < submesh->vertex_indices; i++)
-	{
-		// index_data is unsigned char type, casting to uint32_t* will give proper value
-		meshlet.indices[meshlet.index_count] = *(reinterpret_cast<uint32_t *>(index_data.data()) + i);
+		auto &arena = arenas.back();
+
+		Piece piece;
+		piece.arena  = arenas.size() - 1;
+		piece.offset = arena.size;
+		piece.data   = std::move(data);
 
-		if (vertices.insert(meshlet.indices[meshlet.index_count]).second)
-			++meshlet.vertex_count;
+		arena.size = (arena.size + size + MESH_ARENA_ALIGNMENT - 1) & ~(MESH_ARENA_ALIGNMENT - 1);
 
-		meshlet.index_count++;
-		triangle_check = triangle_check < 3 ? ++triangle_check : 1;
+		pieces.push_back(std::move(piece));
+
+		return pieces.size() - 1;
+	}
 
-		// 96 because for each traingle we draw a line in a mesh shader sample, 32 triangles/lines per meshlet = 64 vertices on output
-		if (meshlet.vertex_count == 64 || meshlet.index_count == 96 || i == submesh->vertex_indices - 1)
+	/**
+	 * @brief Creates the arenas and records their upload
+	 * @param transient_buffers Receives the staging buffers, which must be kept until the command buffer has completed
+	 */
+	void build(Device &device, CommandBuffer &command_buffer, std::vector<core::Buffer> &transient_buffers)
+	{
+		for (size_t arena_index = 0; arena_index < arenas.size(); ++arena_index)
 		{
-			if (i == submesh->vertex_indices - 1)
-				assert(triangle_check == 3);
+			auto &arena = arenas[arena_index];
 
-			uint32_t counter = 0;
-			for (auto v : vertices)
+			if (arena.size == 0)
 			{
-				meshlet.vertices[counter++] = v;
+				continue;
 			}
-			if (triangle_check != 3)
+
+			core::Buffer stage_buffer = core::Buffer::create_staging_buffer(device, arena.size, nullptr);
+
+			for (auto &piece : pieces)
 			{
-				meshlet.index_count -= triangle_check;
-				i -= triangle_check;
-				triangle_check = 0;
+				if (piece.arena == arena_index)
+				{
+					stage_buffer.update(piece.data, piece.offset);
+
+					// The data is not needed anymore once staged
+					piece.data = {};
+				}
 			}
 
-			meshlets.push_back(meshlet);
-			meshlet.vertex_count = 0;
-			meshlet.index_count  = 0;
-			vertices.clear();
+			arena.buffer = std::make_shared<core::Buffer>(device,
+			                                              arena.size,
+			                                              usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			                                              VMA_MEMORY_USAGE_GPU_ONLY);
+			arena.buffer->set_debug_name(fmt::format("{} arena #{}", name, arena_index));
+
+			command_buffer.copy_buffer(stage_buffer, *arena.buffer, arena.size);
+
+			BufferMemoryBarrier memory_barrier{};
+			memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			memory_barrier.dst_access_mask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+
+			command_buffer.buffer_memory_barrier(*arena.buffer, 0, arena.size, memory_barrier);
+
+			transient_buffers.push_back(std::move(stage_buffer));
 		}
 	}
-}
 
-static inline bool texture_needs_srgb_colorspace(const std::string &name)
-{
-	// The gltf spec states that the base and emissive textures MUST be encoded with the sRGB
-	// transfer function. All other texture types are linear.
-	if (name == "baseColorTexture" || name == "emissiveTexture")
+	const std::shared_ptr<core::Buffer> &get_buffer(size_t handle) const
 	{
-		return true;
+		return arenas[pieces[handle].arena].buffer;
 	}
 
-	// metallicRoughnessTexture, normalTexture & occlusionTexture must be linear
-	assert(name == "metallicRoughnessTexture" || name == "normalTexture" || name == "occlusionTexture");
-	return false;
-}
+	VkDeviceSize get_offset(size_t handle) const
+	{
+		return pieces[handle].offset;
+	}
+
+	size_t get_arena_count() const
+	{
+		return arenas.size();
+	}
+
+  private:
+	struct Arena
+	{
+		VkDeviceSize size{0};
+
+		std::shared_ptr<core::Buffer> buffer;
+	};
+
+	struct Piece
+	{
+		size_t arena{0};
 
+		VkDeviceSize offset{0};
+
+		std::vector<uint8_t> data;
+	};
+
+	VkBufferUsageFlags usage;
+
+	std::string name;
+
+	std::vector<Arena> arenas;
+
+	std::vector<Piece> pieces;
+};
 }        // namespace
 
 std::unordered_map<std::string, bool> GLTFLoader::supported_extensions = {
@@ -411,7 +581,7 @@ std::unique_ptr<sg::Scene> GLTFLoader::read_scene_from_file(const std::string &f
 
 	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+	bool importResult = load_gltf_file(gltf_loader, model, err, warn, gltf_file);
 
 	if (!importResult)
 	{
@@ -453,7 +623,7 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string
 
 	std::string gltf_file = vkb::fs::path::get(vkb::fs::path::Type::Assets) + file_name;
 
-	bool importResult = gltf_loader.LoadASCIIFromFile(&model, &err, &warn, gltf_file.c_str());
+	bool importResult = load_gltf_file(gltf_loader, model, err, warn, gltf_file);
 
 	if (!importResult)
 	{
@@ -486,6 +656,16 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::read_model_from_file(const std::string
 	return std::move(load_model(index, storage_buffer));
 }
 
+void GLTFLoader::set_upload_memory_budget(VkDeviceSize memory_budget)
+{
+	upload_memory_budget = memory_budget;
+}
+
+void GLTFLoader::set_mesh_arenas_enabled(bool enabled)
+{
+	mesh_arenas_enabled = enabled;
+}
+
 sg::Scene GLTFLoader::load_scene(int scene_index)
 {
 	auto scene = sg::Scene();
@@ -542,6 +722,11 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 	// Load images
 	auto thread_count = std::thread::hardware_concurrency();
 	thread_count      = thread_count == 0 ? 1 : thread_count;
+
+	// Time spent decoding each image, written by the thread which decodes it.
+	// Declared before the thread pool so that it outlives the tasks.
+	std::vector<double> decode_times(model.images.size(), 0.0);
+
 	ctpl::thread_pool thread_pool(thread_count);
 
 	auto image_count = to_u32(model.images.size());
@@ -550,9 +735,14 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 	for (size_t image_index = 0; image_index < image_count; image_index++)
 	{
 		auto fut = thread_pool.push(
-		    [this, image_index](size_t) {
+		    [this, image_index, &decode_times](size_t) {
+			    Timer decode_timer;
+			    decode_timer.start();
+
 			    auto image = parse_image(model.images[image_index]);
 
+			    decode_times[image_index] = decode_timer.stop();
+
 			    LOGI("Loaded gltf image #{} ({})", image_index, model.images[image_index].uri.c_str());
 
 			    return image;
@@ -563,59 +753,41 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 
 	std::vector<std::unique_ptr<sg::Image>> image_components;
 
-	// Upload images to GPU. We do this in batches of 64MB of data to avoid needing
-	// double the amount of memory (all the images and all the corresponding buffers).
+	// Stream images to the GPU in decoding order through a ring of staging buffers, so that decoding,
+	// staging and the copies on the GPU overlap while the staging memory stays within the budget.
 	// This helps keep memory footprint lower which is helpful on smaller devices.
-	size_t image_index = 0;
-	while (image_index < image_count)
-	{
-		std::vector<core::Buffer> transient_buffers;
-
-		auto &command_buffer = device.request_command_buffer();
-
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
-
-		size_t batch_size = 0;
+	ImageUploader image_uploader{device, upload_memory_budget};
 
-		// Deal with 64MB of image data at a time to keep memory footprint low
-		while (image_index < image_count && batch_size < 64 * 1024 * 1024)
-		{
-			// Wait for this image to complete loading, then stage for upload
-			image_components.push_back(image_component_futures[image_index].get());
-
-			auto &image = image_components[image_index];
-
-			core::Buffer stage_buffer = vkb::core::Buffer::create_staging_buffer(device, image->get_data());
-
-			batch_size += image->get_data().size();
-
-			upload_image_to_gpu(command_buffer, stage_buffer, *image);
-
-			transient_buffers.push_back(std::move(stage_buffer));
-
-			image_index++;
-		}
-
-		command_buffer.end();
+	double decode_wait_time = 0.0;
 
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+	for (size_t image_index = 0; image_index < image_count; image_index++)
+	{
+		// Wait for this image to complete loading, then stage for upload
+		Timer decode_wait_timer;
+		decode_wait_timer.start();
 
-		queue.submit(command_buffer, device.request_fence());
+		image_components.push_back(image_component_futures[image_index].get());
 
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset_pool();
-		device.wait_idle();
+		decode_wait_time += decode_wait_timer.stop();
 
-		// Remove the staging buffers for the batch we just processed
-		transient_buffers.clear();
+		image_uploader.upload(*image_components[image_index]);
 	}
 
+	image_uploader.flush();
+
 	scene.set_components(std::move(image_components));
 
 	auto elapsed_time = timer.stop();
 
+	auto &upload_stats = image_uploader.get_stats();
+
 	LOGI("Time spent loading images: {} seconds across {} threads.", vkb::to_string(elapsed_time), thread_count);
+	LOGI("  Decoding:         {} seconds of CPU time, {} seconds waited for by the upload",
+	     vkb::to_string(std::accumulate(decode_times.begin(), decode_times.end(), 0.0)), vkb::to_string(decode_wait_time));
+	LOGI("  Staging:          {} seconds for {} images ({} MB)",
+	     vkb::to_string(upload_stats.staging_time), upload_stats.image_count, upload_stats.uploaded_bytes / (1024 * 1024));
+	LOGI("  Waiting for GPU:  {} seconds over {} submissions to the {} queue",
+	     vkb::to_string(upload_stats.wait_time), upload_stats.submission_count, upload_stats.dedicated_transfer_queue ? "transfer" : "graphics");
 
 	// Load textures
 	auto images                  = scene.get_components<sg::Image>();
@@ -719,6 +891,13 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 	// Load meshes
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
+	// When enabled, vertex and index data are packed into arenas which are uploaded once all meshes are parsed
+	MeshArenaBuilder vertex_arena{VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, "Vertex"};
+	MeshArenaBuilder index_arena{VK_BUFFER_USAGE_INDEX_BUFFER_BIT, "Index"};
+
+	std::vector<std::tuple<sg::SubMesh *, std::string, size_t>> vertex_arena_ranges;
+	std::vector<std::pair<sg::SubMesh *, size_t>>              index_arena_ranges;
+
 	for (auto &gltf_mesh : model.meshes)
 	{
 		auto mesh = parse_mesh(gltf_mesh);
@@ -740,18 +919,33 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 				if (attrib_name == "position")
 				{
 					assert(attribute.second < model.accessors.size());
-					submesh->vertices_count = to_u32(model.accessors[attribute.second].count);
-				}
+					auto &accessor          = model.accessors[attribute.second];
+					submesh->vertices_count = to_u32(accessor.count);
 
-				core::Buffer buffer{device,
-				                    vertex_data.size(),
-				                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-				                    VMA_MEMORY_USAGE_CPU_TO_GPU};
-				buffer.update(vertex_data);
-				buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
-				                                  gltf_mesh.name, i_primitive, attrib_name));
+					// glTF requires the bounds of the positions, meshes without them are simply never culled
+					if (accessor.minValues.size() == 3 && accessor.maxValues.size() == 3)
+					{
+						mesh->update_bounds({glm::vec3(accessor.minValues[0], accessor.minValues[1], accessor.minValues[2]),
+						                     glm::vec3(accessor.maxValues[0], accessor.maxValues[1], accessor.maxValues[2])});
+					}
+				}
 
-				submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+				if (mesh_arenas_enabled)
+				{
+					vertex_arena_ranges.emplace_back(submesh.get(), attrib_name, vertex_arena.add(std::move(vertex_data)));
+				}
+				else
+				{
+					core::Buffer buffer{device,
+					                    vertex_data.size(),
+					                    VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+					                    VMA_MEMORY_USAGE_CPU_TO_GPU};
+					buffer.update(vertex_data);
+					buffer.set_debug_name(fmt::format("'{}' mesh, primitive #{}: '{}' vertex buffer",
+					                                  gltf_mesh.name, i_primitive, attrib_name));
+
+					submesh->vertex_buffers.insert(std::make_pair(attrib_name, std::move(buffer)));
+				}
 
 				sg::VertexAttribute attrib;
 				attrib.format = get_attribute_format(&model, attribute.second);
@@ -786,14 +980,21 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 						break;
 				}
 
-				submesh->index_buffer = std::make_unique<core::Buffer>(device,
-				                                                       index_data.size(),
-				                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-				                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
-				submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
-				                                                  gltf_mesh.name, i_primitive));
-
-				submesh->index_buffer->update(index_data);
+				if (mesh_arenas_enabled)
+				{
+					index_arena_ranges.emplace_back(submesh.get(), index_arena.add(std::move(index_data)));
+				}
+				else
+				{
+					submesh->index_buffer = std::make_unique<core::Buffer>(device,
+					                                                       index_data.size(),
+					                                                       VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+					                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
+					submesh->index_buffer->set_debug_name(fmt::format("'{}' mesh, primitive #{}: index buffer",
+					                                                  gltf_mesh.name, i_primitive));
+
+					submesh->index_buffer->update(index_data);
+				}
 			}
 			else
 			{
@@ -818,10 +1019,46 @@ sg::Scene GLTFLoader::load_scene(int scene_index)
 		scene.add_component(std::move(mesh));
 	}
 
+	// Staging buffers of the arenas, kept until the copies have completed
+	std::vector<core::Buffer> arena_staging_buffers;
+
+	if (!vertex_arena_ranges.empty() || !index_arena_ranges.empty())
+	{
+		// Upload all the geometry of the scene with a single submission
+		auto &command_buffer = device.request_command_buffer();
+
+		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+		vertex_arena.build(device, command_buffer, arena_staging_buffers);
+		index_arena.build(device, command_buffer, arena_staging_buffers);
+
+		command_buffer.end();
+
+		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+
+		queue.submit(command_buffer, device.request_fence());
+
+		for (auto &range : vertex_arena_ranges)
+		{
+			std::get<0>(range)->set_shared_vertex_buffer(std::get<1>(range),
+			                                             vertex_arena.get_buffer(std::get<2>(range)),
+			                                             vertex_arena.get_offset(std::get<2>(range)));
+		}
+
+		for (auto &range : index_arena_ranges)
+		{
+			range.first->set_shared_index_buffer(index_arena.get_buffer(range.second), index_arena.get_offset(range.second));
+		}
+
+		LOGI("Packed the geometry into {} vertex and {} index arenas", vertex_arena.get_arena_count(), index_arena.get_arena_count());
+	}
+
 	device.get_fence_pool().wait();
 	device.get_fence_pool().reset();
 	device.get_command_pool().reset_pool();
 
+	arena_staging_buffers.clear();
+
 	scene.add_component(std::move(default_material));
 
 	// Load cameras
@@ -1112,6 +1349,8 @@ std::unique_ptr<sg::SubMesh> GLTFLoader::load_model(uint32_t index, bool storage
 	auto  &buffer_view  = model.bufferViews[accessor.bufferView];
 	pos                 = reinterpret_cast<const float *>(&(model.buffers[buffer_view.buffer].data[accessor.byteOffset + buffer_view.byteOffset]));
 
+	submesh->vertices_count = to_u32(vertex_count);
+
 	if (gltf_primitive.attributes.find("NORMAL") != gltf_primitive.attributes.end())
 	{
 		accessor    = model.accessors[gltf_primitive.attributes.find("NORMAL")->second];
@@ -1436,7 +1675,6 @@ std::unique_ptr<sg::Image> GLTFLoader::parse_image(tinygltf::Image &gltf_image)
 		{
 			LOGW("ASTC not supported: decoding {}", image->get_name());
 			image = std::make_unique<sg::Astc>(*image);
-			image->generate_mipmaps();
 		}
 	}
 
@@ -26,6 +26,7 @@
 #define TINYGLTF_NO_EXTERNAL_IMAGE
 #include <tiny_gltf.h>
 
+#include "image_uploader.h"
 #include "timer.h"
 
 #define KHR_LIGHTS_PUNCTUAL_EXTENSION "KHR_lights_punctual"
@@ -81,6 +82,20 @@ class GLTFLoader
 	 */
 	std::unique_ptr<sg::SubMesh> read_model_from_file(const std::string &file_name, uint32_t index, bool storage_buffer = false);
 
+	/**
+	 * @brief Sets the amount of staging memory used to stream images to the GPU while they are being decoded
+	 * @param memory_budget Total size of the staging buffers, see ImageUploader
+	 */
+	void set_upload_memory_budget(VkDeviceSize memory_budget);
+
+	/**
+	 * @brief Packs the vertex and index data of the scenes loaded afterwards into a few large device-local buffers
+	 *        instead of a host-visible buffer per attribute. Submeshes then reference ranges of those buffers,
+	 *        see sg::SubMesh::get_vertex_buffer_range() and sg::SubMesh::get_index_buffer_range().
+	 *        Disabled by default, as some samples read the geometry back from sg::SubMesh::vertex_buffers.
+	 */
+	void set_mesh_arenas_enabled(bool enabled);
+
   protected:
 	virtual std::unique_ptr<sg::Node> parse_node(const tinygltf::Node &gltf_node, size_t index) const;
 
@@ -132,6 +147,10 @@ class GLTFLoader
 	static std::unordered_map<std::string, bool> supported_extensions;
 
   private:
+	VkDeviceSize upload_memory_budget{ImageUploader::DEFAULT_MEMORY_BUDGET};
+
+	bool mesh_arenas_enabled{false};
+
 	sg::Scene load_scene(int scene_index = -1);
 
 	std::unique_ptr<sg::SubMesh> load_model(uint32_t index, bool storage_buffer = false);
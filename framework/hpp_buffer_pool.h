@@ -30,6 +30,9 @@ namespace vkb
 class HPPBufferAllocation : private vkb::BufferAllocation
 {
   public:
+	using vkb::BufferAllocation::construct;
+	using vkb::BufferAllocation::flush;
+	using vkb::BufferAllocation::map;
 	using vkb::BufferAllocation::update;
 
   public:
@@ -33,6 +33,8 @@ class HPPGLTFLoader : private vkb::GLTFLoader
 {
   public:
 	using vkb::GLTFLoader::read_scene_from_file;
+	using vkb::GLTFLoader::set_mesh_arenas_enabled;
+	using vkb::GLTFLoader::set_upload_memory_budget;
 
 	HPPGLTFLoader(vkb::core::HPPDevice &device) :
 	    GLTFLoader(reinterpret_cast<vkb::Device &>(device))
@@ -49,6 +49,11 @@ class HPPResourceSet : private vkb::ResourceSet
 	{
 		return reinterpret_cast<BindingMap<HPPResourceInfo> const &>(vkb::ResourceSet::get_resource_bindings());
 	}
+
+	vk::DescriptorSet get_reusable_descriptor_set() const
+	{
+		return static_cast<vk::DescriptorSet>(vkb::ResourceSet::get_reusable_descriptor_set());
+	}
 };
 
 class HPPResourceBindingState : private vkb::ResourceBindingState
@@ -89,5 +94,10 @@ class HPPResourceBindingState : private vkb::ResourceBindingState
 	{
 		return reinterpret_cast<std::unordered_map<uint32_t, vkb::HPPResourceSet> const &>(vkb::ResourceBindingState::get_resource_sets());
 	}
+
+	void set_descriptor_set(uint32_t set, vk::DescriptorSet descriptor_set)
+	{
+		vkb::ResourceBindingState::set_descriptor_set(set, static_cast<VkDescriptorSet>(descriptor_set));
+	}
 };
 }        // namespace vkb
@@ -17,6 +17,7 @@
 
 #include "hpp_resource_cache.h"
 #include <common/hpp_resource_caching.h>
+#include <ctpl_stl.h>
 #include <core/hpp_descriptor_set.h>
 #include <core/hpp_device.h>
 #include <core/hpp_image_view.h>
@@ -27,14 +28,48 @@ namespace vkb
 namespace
 {
 template <class T, class... A>
-T &request_resource(
-    vkb::core::HPPDevice &device, vkb::HPPResourceRecord &recorder, std::mutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &...args)
+T &request_resource(vkb::core::HPPDevice               &device,
+                    vkb::HPPResourceRecord             &recorder,
+                    std::mutex                         &recorder_mutex,
+                    ResourceCacheLock                  &resource_lock,
+                    std::unordered_map<std::size_t, T> &resources,
+                    uint64_t                            frame,
+                    A &...args)
 {
-	std::lock_guard<std::mutex> guard(resource_mutex);
+	size_t hash{0U};
+	hash_param(hash, args...);
+
+	// Compare the full key in place on a hash hit, so that hits never build it
+	auto matches = [&](const std::string &stored_key) {
+		ResourceKey key{stored_key};
+		key_param(key, args...);
+		return key.matches();
+	};
+
+	auto make_key = [&]() {
+		ResourceKey key;
+		key_param(key, args...);
+		return key.get();
+	};
+
+	std::size_t slot;
+	return resource_lock.request(
+	    resources, hash, matches, make_key, frame,
+	    [&]() { return T(device, args...); },
+	    [&](T &resource) {
+		    std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+		    vkb::common::record_resource(&recorder, resource, args...);
+	    },
+	    slot);
+}
 
-	auto &res = vkb::common::request_resource(device, &recorder, resources, args...);
+template <class T, class... A>
+T &request_locked_resource(vkb::core::HPPDevice &device, ResourceCacheLock &resource_lock, std::unordered_map<std::size_t, T> &resources, A &...args)
+{
+	std::lock_guard<std::shared_mutex> guard(resource_lock.mutex);
 
-	return res;
+	// Descriptor pools and sets are not recorded
+	return vkb::common::request_resource(device, nullptr, resources, args...);
 }
 }        // namespace
 
@@ -42,6 +77,12 @@ HPPResourceCache::HPPResourceCache(vkb::core::HPPDevice &device) :
     device{device}
 {}
 
+HPPResourceCache::~HPPResourceCache()
+{
+	// Wait for the pipelines a replay may still be building, as they are inserted into the cache
+	pipeline_compilation_queue.thread_pool.reset();
+}
+
 void HPPResourceCache::clear()
 {
 	state.shader_modules.clear();
@@ -49,6 +90,12 @@ void HPPResourceCache::clear()
 	state.descriptor_sets.clear();
 	state.descriptor_set_layouts.clear();
 	state.render_passes.clear();
+
+	shader_module_lock.clear();
+	pipeline_layout_lock.clear();
+	descriptor_set_layout_lock.clear();
+	render_pass_lock.clear();
+
 	clear_pipelines();
 	clear_framebuffers();
 }
@@ -56,12 +103,17 @@ void HPPResourceCache::clear()
 void HPPResourceCache::clear_framebuffers()
 {
 	state.framebuffers.clear();
+
+	framebuffer_lock.clear();
 }
 
 void HPPResourceCache::clear_pipelines()
 {
 	state.graphics_pipelines.clear();
 	state.compute_pipelines.clear();
+
+	graphics_pipeline_lock.clear();
+	compute_pipeline_lock.clear();
 }
 
 const HPPResourceCacheState &HPPResourceCache::get_internal_state() const
@@ -71,45 +123,45 @@ const HPPResourceCacheState &HPPResourceCache::get_internal_state() const
 
 vkb::core::HPPComputePipeline &HPPResourceCache::request_compute_pipeline(vkb::rendering::HPPPipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
+	return request_resource(device, recorder, recorder_mutex, compute_pipeline_lock, state.compute_pipelines, frame_index, pipeline_cache, pipeline_state);
 }
 
 vkb::core::HPPDescriptorSet &HPPResourceCache::request_descriptor_set(vkb::core::HPPDescriptorSetLayout          &descriptor_set_layout,
                                                                       const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
                                                                       const BindingMap<vk::DescriptorImageInfo>  &image_infos)
 {
-	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, state.descriptor_pools, descriptor_set_layout);
-	return request_resource(device, recorder, descriptor_set_mutex, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	auto &descriptor_pool = request_locked_resource(device, descriptor_set_lock, state.descriptor_pools, descriptor_set_layout);
+	return request_locked_resource(device, descriptor_set_lock, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
 }
 
 vkb::core::HPPDescriptorSetLayout &HPPResourceCache::request_descriptor_set_layout(const uint32_t                                   set_index,
                                                                                    const std::vector<vkb::core::HPPShaderModule *> &shader_modules,
                                                                                    const std::vector<vkb::core::HPPShaderResource> &set_resources)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	return request_resource(device, recorder, recorder_mutex, descriptor_set_layout_lock, state.descriptor_set_layouts, frame_index, set_index, shader_modules, set_resources);
 }
 
 vkb::core::HPPFramebuffer &HPPResourceCache::request_framebuffer(const vkb::rendering::HPPRenderTarget &render_target,
                                                                  const vkb::core::HPPRenderPass        &render_pass)
 {
-	return request_resource(device, recorder, framebuffer_mutex, state.framebuffers, render_target, render_pass);
+	return request_resource(device, recorder, recorder_mutex, framebuffer_lock, state.framebuffers, frame_index, render_target, render_pass);
 }
 
 vkb::core::HPPGraphicsPipeline &HPPResourceCache::request_graphics_pipeline(vkb::rendering::HPPPipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	return request_resource(device, recorder, recorder_mutex, graphics_pipeline_lock, state.graphics_pipelines, frame_index, pipeline_cache, pipeline_state);
 }
 
 vkb::core::HPPPipelineLayout &HPPResourceCache::request_pipeline_layout(const std::vector<vkb::core::HPPShaderModule *> &shader_modules)
 {
-	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
+	return request_resource(device, recorder, recorder_mutex, pipeline_layout_lock, state.pipeline_layouts, frame_index, shader_modules);
 }
 
 vkb::core::HPPRenderPass &HPPResourceCache::request_render_pass(const std::vector<vkb::rendering::HPPAttachment> &attachments,
                                                                 const std::vector<vkb::common::HPPLoadStoreInfo> &load_store_infos,
                                                                 const std::vector<vkb::core::HPPSubpassInfo>     &subpasses)
 {
-	return request_resource(device, recorder, render_pass_mutex, state.render_passes, attachments, load_store_infos, subpasses);
+	return request_resource(device, recorder, recorder_mutex, render_pass_lock, state.render_passes, frame_index, attachments, load_store_infos, subpasses);
 }
 
 vkb::core::HPPShaderModule &HPPResourceCache::request_shader_module(vk::ShaderStageFlagBits            stage,
@@ -117,7 +169,7 @@ vkb::core::HPPShaderModule &HPPResourceCache::request_shader_module(vk::ShaderSt
                                                                     const vkb::core::HPPShaderVariant &shader_variant)
 {
 	std::string entry_point{"main"};
-	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
+	return request_resource(device, recorder, recorder_mutex, shader_module_lock, state.shader_modules, frame_index, stage, glsl_source, entry_point, shader_variant);
 }
 
 std::vector<uint8_t> HPPResourceCache::serialize()
@@ -209,4 +261,33 @@ void HPPResourceCache::warmup(const std::vector<uint8_t> &data)
 
 	replayer.play(*this, recorder);
 }
+
+void HPPResourceCache::set_budget(const ResourceCacheBudget &budget)
+{
+	graphics_pipeline_lock.budget = budget.graphics_pipelines;
+	compute_pipeline_lock.budget  = budget.compute_pipelines;
+	framebuffer_lock.budget       = budget.framebuffers;
+}
+
+void HPPResourceCache::begin_frame(uint32_t frames_in_flight)
+{
+	auto frame = ++frame_index;
+
+	graphics_pipeline_lock.evict(state.graphics_pipelines, frame, frames_in_flight);
+	compute_pipeline_lock.evict(state.compute_pipelines, frame, frames_in_flight);
+	framebuffer_lock.evict(state.framebuffers, frame, frames_in_flight);
+}
+
+ResourceCacheStats HPPResourceCache::get_stats()
+{
+	ResourceCacheStats stats;
+	stats.shader_modules         = shader_module_lock.get_stats();
+	stats.pipeline_layouts       = pipeline_layout_lock.get_stats();
+	stats.descriptor_set_layouts = descriptor_set_layout_lock.get_stats();
+	stats.render_passes          = render_pass_lock.get_stats();
+	stats.graphics_pipelines     = graphics_pipeline_lock.get_stats();
+	stats.compute_pipelines      = compute_pipeline_lock.get_stats();
+	stats.framebuffers           = framebuffer_lock.get_stats();
+	return stats;
+}
 }        // namespace vkb
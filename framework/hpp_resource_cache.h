@@ -23,6 +23,7 @@
 #include <core/hpp_render_pass.h>
 #include <hpp_resource_record.h>
 #include <hpp_resource_replay.h>
+#include <resource_cache.h>
 #include <vulkan/vulkan.hpp>
 
 namespace vkb
@@ -66,6 +67,8 @@ class HPPResourceCache
   public:
 	HPPResourceCache(vkb::core::HPPDevice &device);
 
+	~HPPResourceCache();
+
 	HPPResourceCache(const HPPResourceCache &)            = delete;
 	HPPResourceCache(HPPResourceCache &&)                 = delete;
 	HPPResourceCache &operator=(const HPPResourceCache &) = delete;
@@ -100,19 +103,30 @@ class HPPResourceCache
 
 	void warmup(const std::vector<uint8_t> &data);
 
+	void               set_budget(const ResourceCacheBudget &budget);
+	void               begin_frame(uint32_t frames_in_flight);
+	ResourceCacheStats get_stats();
+
   private:
 	vkb::core::HPPDevice  &device;
 	vkb::HPPResourceRecord recorder                    = {};
 	vkb::HPPResourceReplay replayer                    = {};
 	vk::PipelineCache      pipeline_cache              = nullptr;
 	HPPResourceCacheState  state                       = {};
-	std::mutex             descriptor_set_mutex        = {};
-	std::mutex             pipeline_layout_mutex       = {};
-	std::mutex             shader_module_mutex         = {};
-	std::mutex             descriptor_set_layout_mutex = {};
-	std::mutex             graphics_pipeline_mutex     = {};
-	std::mutex             render_pass_mutex           = {};
-	std::mutex             compute_pipeline_mutex      = {};
-	std::mutex             framebuffer_mutex           = {};
+	std::mutex             recorder_mutex              = {};
+	ResourceCacheLock      descriptor_set_lock         = {};
+	ResourceCacheLock      pipeline_layout_lock        = {};
+	ResourceCacheLock      shader_module_lock          = {};
+	ResourceCacheLock      descriptor_set_layout_lock  = {};
+	ResourceCacheLock      graphics_pipeline_lock      = {};
+	ResourceCacheLock      render_pass_lock            = {};
+	ResourceCacheLock      compute_pipeline_lock       = {};
+	ResourceCacheLock      framebuffer_lock            = {};
+	std::atomic<uint64_t>  frame_index                 = {};
+
+	// The members below are only used through vkb::ResourceCache, while replaying, but are needed for the layouts to match
+	PipelineCompilationQueue           pipeline_compilation_queue      = {};
+	std::unique_ptr<ctpl::thread_pool> shader_module_thread_pool       = {};
+	std::mutex                         shader_module_thread_pool_mutex = {};
 };
 }        // namespace vkb
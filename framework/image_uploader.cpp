@@ -0,0 +1,272 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "image_uploader.h"
+
+#include "core/command_buffer.h"
+#include "core/command_pool.h"
+#include "core/device.h"
+#include "fence_pool.h"
+#include "scene_graph/components/image.h"
+#include "timer.h"
+
+namespace vkb
+{
+namespace
+{
+/// Offsets of the images in a staging buffer, a multiple of every texel block size used by the loaders
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+inline VkDeviceSize align_offset(VkDeviceSize offset)
+{
+	return (offset + STAGING_ALIGNMENT - 1) & ~(STAGING_ALIGNMENT - 1);
+}
+}        // namespace
+
+ImageUploader::ImageUploader(Device &device, VkDeviceSize memory_budget, uint32_t slot_count) :
+    device{device},
+    transfer_queue{device.get_queue(device.get_queue_family_index(VK_QUEUE_TRANSFER_BIT), 0)},
+    graphics_queue{device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0)},
+    slot_size{align_offset(std::max<VkDeviceSize>(memory_budget / std::max(slot_count, 1U), STAGING_ALIGNMENT))},
+    slots(std::max(slot_count, 1U))
+{
+	for (auto &slot : slots)
+	{
+		slot.staging_buffer = std::make_unique<core::Buffer>(core::Buffer::create_staging_buffer(device, slot_size, nullptr));
+		slot.command_pool   = std::make_unique<CommandPool>(device, transfer_queue.get_family_index());
+		slot.fence_pool     = std::make_unique<FencePool>(device);
+	}
+
+	stats.dedicated_transfer_queue = needs_ownership_transfer();
+}
+
+ImageUploader::~ImageUploader()
+{
+	flush();
+}
+
+void ImageUploader::upload(sg::Image &image)
+{
+	Timer timer;
+	timer.start();
+
+	// Waiting for a slot is accounted separately
+	double previous_wait_time = stats.wait_time;
+
+	auto        &data = image.get_data();
+	VkDeviceSize size = data.size();
+
+	// Move on to the next slot if the image does not fit in what is left of the current one
+	if (slots[current_slot].offset > 0 && slots[current_slot].offset + size > slot_size)
+	{
+		submit(slots[current_slot]);
+
+		current_slot = (current_slot + 1) % slots.size();
+		wait(slots[current_slot]);
+	}
+
+	auto &slot = slots[current_slot];
+
+	if (!slot.command_buffer)
+	{
+		slot.command_buffer = &slot.command_pool->request_command_buffer();
+		slot.command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+	}
+
+	if (size > slot_size)
+	{
+		// The image alone exceeds a slot, give it a buffer which lives until the slot is reused
+		slot.dedicated_buffers.push_back(core::Buffer::create_staging_buffer(device, data));
+		record_copy(*slot.command_buffer, slot.dedicated_buffers.back(), 0, image);
+		slot.offset = slot_size;
+	}
+	else
+	{
+		slot.staging_buffer->update(data.data(), size, slot.offset);
+		record_copy(*slot.command_buffer, *slot.staging_buffer, slot.offset, image);
+		slot.offset = align_offset(slot.offset + size);
+	}
+
+	// Clean up the image data, as they are copied in the staging buffer
+	image.clear_data();
+
+	stats.uploaded_bytes += size;
+	stats.image_count++;
+	stats.staging_time += timer.stop() - (stats.wait_time - previous_wait_time);
+}
+
+void ImageUploader::flush()
+{
+	if (slots[current_slot].command_buffer)
+	{
+		submit(slots[current_slot]);
+	}
+
+	for (auto &slot : slots)
+	{
+		wait(slot);
+	}
+
+	current_slot = 0;
+
+	acquire_ownership();
+}
+
+const ImageUploader::Stats &ImageUploader::get_stats() const
+{
+	return stats;
+}
+
+bool ImageUploader::needs_ownership_transfer() const
+{
+	return transfer_queue.get_family_index() != graphics_queue.get_family_index();
+}
+
+void ImageUploader::record_copy(CommandBuffer &command_buffer, const core::Buffer &staging_buffer, VkDeviceSize offset, sg::Image &image)
+{
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		memory_barrier.src_access_mask = 0;
+		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+		command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+	}
+
+	// Create a buffer image copy for every mip level
+	auto &mipmaps = image.get_mipmaps();
+
+	std::vector<VkBufferImageCopy> buffer_copy_regions(mipmaps.size());
+
+	for (size_t i = 0; i < mipmaps.size(); ++i)
+	{
+		auto &mipmap      = mipmaps[i];
+		auto &copy_region = buffer_copy_regions[i];
+
+		copy_region.bufferOffset     = offset + mipmap.offset;
+		copy_region.imageSubresource = image.get_vk_image_view().get_subresource_layers();
+		// Update miplevel
+		copy_region.imageSubresource.mipLevel = mipmap.level;
+		copy_region.imageExtent               = mipmap.extent;
+	}
+
+	command_buffer.copy_buffer_to_image(staging_buffer, image.get_vk_image(), buffer_copy_regions);
+
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+	if (needs_ownership_transfer())
+	{
+		// Release the image to the graphics queue, the matching acquire is recorded in flush()
+		memory_barrier.dst_access_mask  = 0;
+		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		memory_barrier.old_queue_family = transfer_queue.get_family_index();
+		memory_barrier.new_queue_family = graphics_queue.get_family_index();
+
+		pending_acquires.push_back(&image);
+	}
+	else
+	{
+		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+
+	command_buffer.image_memory_barrier(image.get_vk_image_view(), memory_barrier);
+}
+
+void ImageUploader::submit(Slot &slot)
+{
+	slot.command_buffer->end();
+
+	transfer_queue.submit(*slot.command_buffer, slot.fence_pool->request_fence());
+
+	slot.submitted = true;
+
+	stats.submission_count++;
+}
+
+void ImageUploader::wait(Slot &slot)
+{
+	if (!slot.submitted)
+	{
+		return;
+	}
+
+	Timer timer;
+	timer.start();
+
+	slot.fence_pool->wait();
+	slot.fence_pool->reset();
+	slot.command_pool->reset_pool();
+
+	stats.wait_time += timer.stop();
+
+	slot.dedicated_buffers.clear();
+	slot.command_buffer = nullptr;
+	slot.offset         = 0;
+	slot.submitted      = false;
+}
+
+void ImageUploader::acquire_ownership()
+{
+	if (pending_acquires.empty())
+	{
+		return;
+	}
+
+	// The transfer queue has completed all the copies, so the acquire does not need a semaphore
+	auto &command_buffer = device.request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, 0);
+
+	for (auto image : pending_acquires)
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		memory_barrier.new_layout       = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		memory_barrier.src_access_mask  = 0;
+		memory_barrier.dst_access_mask  = VK_ACCESS_SHADER_READ_BIT;
+		memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+		memory_barrier.old_queue_family = transfer_queue.get_family_index();
+		memory_barrier.new_queue_family = graphics_queue.get_family_index();
+
+		command_buffer.image_memory_barrier(image->get_vk_image_view(), memory_barrier);
+	}
+
+	command_buffer.end();
+
+	Timer timer;
+	timer.start();
+
+	graphics_queue.submit(command_buffer, device.request_fence());
+
+	device.get_fence_pool().wait();
+	device.get_fence_pool().reset();
+	device.get_command_pool().reset_pool();
+
+	stats.wait_time += timer.stop();
+
+	pending_acquires.clear();
+}
+}        // namespace vkb
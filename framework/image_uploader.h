@@ -0,0 +1,159 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/buffer.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class CommandPool;
+class Device;
+class FencePool;
+class Queue;
+
+namespace sg
+{
+class Image;
+}
+
+/**
+ * @brief Streams images to the GPU through a ring of staging buffers
+ *
+ * The memory budget is split into slots, each with its own staging buffer, command pool and fence.
+ * Images are copied into the current slot until it is full, then the slot is submitted and the next one is used,
+ * so that the CPU keeps staging images while the GPU copies the previous slots.
+ * The CPU only waits when it wraps around to a slot the GPU is still copying from.
+ *
+ * Copies are submitted to a dedicated transfer queue when the device has one. Ownership of the images is then
+ * released by the transfer queue and acquired by the graphics queue in flush().
+ */
+class ImageUploader
+{
+  public:
+	/// Default staging memory budget, shared by all the slots
+	static constexpr VkDeviceSize DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+
+	static constexpr uint32_t DEFAULT_SLOT_COUNT = 3;
+
+	struct Stats
+	{
+		/// Time spent copying image data into staging buffers and recording commands, in seconds
+		double staging_time{0.0};
+
+		/// Time spent waiting for the GPU to release a slot or to finish the copies, in seconds
+		double wait_time{0.0};
+
+		VkDeviceSize uploaded_bytes{0};
+
+		uint32_t image_count{0};
+
+		uint32_t submission_count{0};
+
+		/// Whether copies were submitted to a dedicated transfer queue
+		bool dedicated_transfer_queue{false};
+	};
+
+	/**
+	 * @brief Creates an ImageUploader
+	 * @param device A valid Vulkan device
+	 * @param memory_budget Total size of the staging buffers, images larger than a slot get a temporary buffer of their own
+	 * @param slot_count Number of staging buffers the CPU and the GPU cycle through
+	 */
+	ImageUploader(Device &device, VkDeviceSize memory_budget = DEFAULT_MEMORY_BUDGET, uint32_t slot_count = DEFAULT_SLOT_COUNT);
+
+	ImageUploader(const ImageUploader &) = delete;
+
+	ImageUploader(ImageUploader &&) = delete;
+
+	~ImageUploader();
+
+	ImageUploader &operator=(const ImageUploader &) = delete;
+
+	ImageUploader &operator=(ImageUploader &&) = delete;
+
+	/**
+	 * @brief Stages the data of an image and records its copy, the data of the image is cleared afterwards
+	 *        The image is ready to be sampled after flush() returns.
+	 * @param image An image with a Vulkan image and its data
+	 */
+	void upload(sg::Image &image);
+
+	/**
+	 * @brief Submits the pending copies and waits for all of them to complete
+	 */
+	void flush();
+
+	const Stats &get_stats() const;
+
+  private:
+	struct Slot
+	{
+		std::unique_ptr<core::Buffer> staging_buffer;
+
+		/// Offset of the free space in the staging buffer
+		VkDeviceSize offset{0};
+
+		std::unique_ptr<CommandPool> command_pool;
+
+		std::unique_ptr<FencePool> fence_pool;
+
+		/// Command buffer being recorded, nullptr until the first image is staged in the slot
+		CommandBuffer *command_buffer{nullptr};
+
+		/// Staging buffers of the images which do not fit in a slot
+		std::vector<core::Buffer> dedicated_buffers;
+
+		bool submitted{false};
+	};
+
+	Device &device;
+
+	const Queue &transfer_queue;
+
+	const Queue &graphics_queue;
+
+	VkDeviceSize slot_size;
+
+	std::vector<Slot> slots;
+
+	size_t current_slot{0};
+
+	/// Images waiting for the graphics queue to acquire their ownership
+	std::vector<sg::Image *> pending_acquires;
+
+	Stats stats;
+
+	bool needs_ownership_transfer() const;
+
+	void record_copy(CommandBuffer &command_buffer, const core::Buffer &staging_buffer, VkDeviceSize offset, sg::Image &image);
+
+	void submit(Slot &slot);
+
+	/**
+	 * @brief Waits for the GPU to complete the copies of a submitted slot, so that it can be reused
+	 */
+	void wait(Slot &slot);
+
+	void acquire_ownership();
+};
+}        // namespace vkb
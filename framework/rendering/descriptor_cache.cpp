@@ -0,0 +1,299 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/descriptor_cache.h"
+
+#include <algorithm>
+
+#include "common/resource_caching.h"
+#include "core/descriptor_set.h"
+#include "core/descriptor_set_layout.h"
+#include "core/device.h"
+#include "core/util/logging.hpp"
+
+namespace vkb
+{
+namespace
+{
+constexpr size_t INITIAL_TABLE_SIZE = 64;
+
+bool equal(const VkDescriptorBufferInfo &lhs, const VkDescriptorBufferInfo &rhs)
+{
+	return lhs.buffer == rhs.buffer && lhs.offset == rhs.offset && lhs.range == rhs.range;
+}
+
+bool equal(const VkDescriptorImageInfo &lhs, const VkDescriptorImageInfo &rhs)
+{
+	return lhs.sampler == rhs.sampler && lhs.imageView == rhs.imageView && lhs.imageLayout == rhs.imageLayout;
+}
+
+template <class T>
+bool equal(const BindingMap<T> &lhs, const BindingMap<T> &rhs)
+{
+	return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](auto &lhs_binding, auto &rhs_binding) {
+		return lhs_binding.first == rhs_binding.first &&
+		       std::equal(lhs_binding.second.begin(), lhs_binding.second.end(), rhs_binding.second.begin(), rhs_binding.second.end(), [](auto &lhs_element, auto &rhs_element) {
+			       return lhs_element.first == rhs_element.first && equal(lhs_element.second, rhs_element.second);
+		       });
+	});
+}
+}        // namespace
+
+DescriptorCache::DescriptorCache(Device &device, size_t thread_count) :
+    device{device},
+    thread_caches(std::max<size_t>(thread_count, 1))
+{
+}
+
+VkDescriptorSet DescriptorCache::request_descriptor_set(const DescriptorSetLayout                &descriptor_set_layout,
+                                                        const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                                        const BindingMap<VkDescriptorImageInfo>  &image_infos,
+                                                        size_t                                    thread_index)
+{
+	assert(thread_index < thread_caches.size() && "Thread index is out of bounds");
+	auto &thread_cache = thread_caches[thread_index];
+
+	size_t key = 0;
+	hash_param(key, descriptor_set_layout, buffer_infos, image_infos);
+
+	// 0 marks the empty slots of the table
+	key = key == 0 ? 1 : key;
+
+	if (!thread_cache.entries.empty())
+	{
+		auto &entry = thread_cache.entries[find_slot(thread_cache, key, descriptor_set_layout, buffer_infos, image_infos)];
+		if (entry.key != 0)
+		{
+			entry.last_used_frame = frame_index;
+			thread_cache.stats.reused++;
+			return entry.handle;
+		}
+	}
+
+	auto  layout_index = find_layout(thread_cache, descriptor_set_layout);
+	auto &layout_sets  = thread_cache.layouts[layout_index];
+
+	// Rewrite a retired set if there is one, no frame in flight uses it anymore
+	VkDescriptorSet handle = VK_NULL_HANDLE;
+	if (!layout_sets.retired_sets.empty())
+	{
+		handle = layout_sets.retired_sets.back();
+		layout_sets.retired_sets.pop_back();
+	}
+	else
+	{
+		handle = layout_sets.pool->allocate();
+
+		if (handle == VK_NULL_HANDLE)
+		{
+			LOGE("Failed to allocate a descriptor set for set {}", descriptor_set_layout.get_index());
+			return VK_NULL_HANDLE;
+		}
+	}
+
+	DescriptorSet::write(device, descriptor_set_layout, handle, buffer_infos, image_infos);
+
+	// Keep the load factor under 1/2 so that probe sequences stay short
+	if ((thread_cache.entry_count + 1) * 2 > thread_cache.entries.size())
+	{
+		grow(thread_cache);
+	}
+
+	auto &entry           = thread_cache.entries[find_free_slot(thread_cache.entries, key)];
+	entry.key             = key;
+	entry.handle          = handle;
+	entry.layout_index    = layout_index;
+	entry.buffer_infos    = buffer_infos;
+	entry.image_infos     = image_infos;
+	entry.last_used_frame = frame_index;
+
+	thread_cache.entry_count++;
+	thread_cache.stats.created++;
+	thread_cache.stats.cached_sets = thread_cache.entry_count;
+
+	return handle;
+}
+
+void DescriptorCache::begin_frame(uint32_t frames_in_flight)
+{
+	++frame_index;
+
+	// Frames are submitted in order, so once the fence of the frame about to be recorded has been waited on,
+	// no frame older than frame_index - frames_in_flight is in flight anymore
+	uint64_t retire_delay = std::max(RETIRE_AFTER_FRAMES, frames_in_flight);
+	if (frame_index < retire_delay)
+	{
+		return;
+	}
+
+	uint64_t last_retired_frame = frame_index - retire_delay;
+
+	for (auto &thread_cache : thread_caches)
+	{
+		for (size_t slot = 0; slot < thread_cache.entries.size();)
+		{
+			auto &entry = thread_cache.entries[slot];
+
+			if (entry.key != 0 && entry.last_used_frame <= last_retired_frame)
+			{
+				thread_cache.layouts[entry.layout_index].retired_sets.push_back(entry.handle);
+				thread_cache.stats.retired++;
+
+				// Erasing shifts the following entries back, so the same slot has to be checked again
+				erase(thread_cache, slot);
+			}
+			else
+			{
+				++slot;
+			}
+		}
+
+		thread_cache.stats.cached_sets = thread_cache.entry_count;
+	}
+}
+
+void DescriptorCache::clear()
+{
+	for (auto &thread_cache : thread_caches)
+	{
+		thread_cache.entries.clear();
+		thread_cache.entry_count = 0;
+
+		// Destroying the pools frees all their sets
+		thread_cache.layouts.clear();
+
+		thread_cache.stats.cached_sets = 0;
+	}
+}
+
+DescriptorCacheStats DescriptorCache::get_stats() const
+{
+	DescriptorCacheStats stats;
+
+	for (auto &thread_cache : thread_caches)
+	{
+		stats.created += thread_cache.stats.created;
+		stats.reused += thread_cache.stats.reused;
+		stats.retired += thread_cache.stats.retired;
+		stats.cached_sets += thread_cache.stats.cached_sets;
+	}
+
+	return stats;
+}
+
+size_t DescriptorCache::find_slot(const ThreadCache                        &thread_cache,
+                                  size_t                                    key,
+                                  const DescriptorSetLayout                &descriptor_set_layout,
+                                  const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                  const BindingMap<VkDescriptorImageInfo>  &image_infos)
+{
+	auto  &entries = thread_cache.entries;
+	size_t mask    = entries.size() - 1;
+	size_t slot    = key & mask;
+
+	// Linear probing, the table is never full so an empty slot ends the search.
+	// Only the entries with the same hash have their layout and contents compared.
+	while (entries[slot].key != 0)
+	{
+		auto &entry = entries[slot];
+		if (entry.key == key &&
+		    thread_cache.layouts[entry.layout_index].layout == &descriptor_set_layout &&
+		    equal(entry.buffer_infos, buffer_infos) &&
+		    equal(entry.image_infos, image_infos))
+		{
+			break;
+		}
+
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+size_t DescriptorCache::find_free_slot(const std::vector<Entry> &entries, size_t key)
+{
+	size_t mask = entries.size() - 1;
+	size_t slot = key & mask;
+
+	while (entries[slot].key != 0)
+	{
+		slot = (slot + 1) & mask;
+	}
+
+	return slot;
+}
+
+void DescriptorCache::grow(ThreadCache &thread_cache)
+{
+	std::vector<Entry> entries(std::max(INITIAL_TABLE_SIZE, thread_cache.entries.size() * 2));
+
+	for (auto &entry : thread_cache.entries)
+	{
+		if (entry.key != 0)
+		{
+			entries[find_free_slot(entries, entry.key)] = std::move(entry);
+		}
+	}
+
+	thread_cache.entries = std::move(entries);
+}
+
+void DescriptorCache::erase(ThreadCache &thread_cache, size_t slot)
+{
+	auto  &entries = thread_cache.entries;
+	size_t mask    = entries.size() - 1;
+
+	// Backward shift deletion: move back the entries of the probe sequence that can be found from the hole,
+	// so that lookups never need tombstones
+	size_t hole = slot;
+	for (size_t next = (hole + 1) & mask; entries[next].key != 0; next = (next + 1) & mask)
+	{
+		size_t home = entries[next].key & mask;
+
+		if (((next - home) & mask) >= ((next - hole) & mask))
+		{
+			entries[hole] = std::move(entries[next]);
+			hole          = next;
+		}
+	}
+
+	entries[hole] = Entry{};
+	thread_cache.entry_count--;
+}
+
+uint32_t DescriptorCache::find_layout(ThreadCache &thread_cache, const DescriptorSetLayout &descriptor_set_layout)
+{
+	auto &layouts = thread_cache.layouts;
+
+	// There are few layouts compared to descriptor sets, a linear search is enough
+	for (size_t i = 0; i < layouts.size(); ++i)
+	{
+		if (layouts[i].layout == &descriptor_set_layout)
+		{
+			return to_u32(i);
+		}
+	}
+
+	LayoutSets layout_sets;
+	layout_sets.layout = &descriptor_set_layout;
+	layout_sets.pool   = std::make_unique<DescriptorPool>(device, descriptor_set_layout);
+
+	layouts.push_back(std::move(layout_sets));
+
+	return to_u32(layouts.size() - 1);
+}
+}        // namespace vkb
@@ -0,0 +1,178 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/helpers.h"
+#include "common/vk_common.h"
+#include "core/descriptor_pool.h"
+
+namespace vkb
+{
+class Device;
+class DescriptorSetLayout;
+
+/**
+ * @brief Statistics of a DescriptorCache
+ */
+struct DescriptorCacheStats
+{
+	/// Number of descriptor sets written because no cached set had the same content
+	uint64_t created{0};
+
+	/// Number of requests served by a cached descriptor set
+	uint64_t reused{0};
+
+	/// Number of descriptor sets retired after being unused for DescriptorCache::RETIRE_AFTER_FRAMES frames
+	uint64_t retired{0};
+
+	/// Number of descriptor sets currently in the cache
+	uint32_t cached_sets{0};
+};
+
+/**
+ * @brief Cache of descriptor sets shared by all the frames of a RenderContext, used by DescriptorManagementStrategy::CacheAcrossFrames
+ *
+ * Descriptor sets are looked up by a hash of their layout and contents in a flat open-addressing table (one per thread),
+ * and the layout and contents are compared on a hash hit, so colliding sets are told apart.
+ * so a set written in one frame is bound again by the next frames as long as its contents do not change.
+ * Sets unused for RETIRE_AFTER_FRAMES frames are retired once the last frame using them has signalled its fence:
+ * they are kept by their layout and rewritten for new contents, so pools never need FREE_DESCRIPTOR_SET_BIT.
+ */
+class DescriptorCache
+{
+  public:
+	/// Number of frames a descriptor set has to be unused for before it is retired
+	static constexpr uint32_t RETIRE_AFTER_FRAMES = 8;
+
+	DescriptorCache(Device &device, size_t thread_count = 1);
+
+	DescriptorCache(const DescriptorCache &) = delete;
+
+	DescriptorCache(DescriptorCache &&) = delete;
+
+	~DescriptorCache() = default;
+
+	DescriptorCache &operator=(const DescriptorCache &) = delete;
+
+	DescriptorCache &operator=(DescriptorCache &&) = delete;
+
+	/**
+	 * @brief Returns a descriptor set with the given contents, writing a new one only if none is cached
+	 * @param descriptor_set_layout The layout of the descriptor set
+	 * @param buffer_infos The descriptors that describe buffer data
+	 * @param image_infos The descriptors that describe image data
+	 * @param thread_index Selects the thread's table, so that threads do not need to synchronize
+	 */
+	VkDescriptorSet request_descriptor_set(const DescriptorSetLayout                &descriptor_set_layout,
+	                                       const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                                       const BindingMap<VkDescriptorImageInfo>  &image_infos,
+	                                       size_t                                    thread_index = 0);
+
+	/**
+	 * @brief Starts a new frame, retiring the descriptor sets which have been unused for a while and which no frame in flight uses anymore
+	 *        Must be called once per frame, after waiting for the fence of the frame which is about to be recorded,
+	 *        and not while other threads request descriptor sets.
+	 * @param frames_in_flight The number of frames of the render context
+	 */
+	void begin_frame(uint32_t frames_in_flight);
+
+	/**
+	 * @brief Drops all the descriptor sets
+	 *        Must only be called when the device does not use any of them
+	 */
+	void clear();
+
+	/**
+	 * @return The statistics of the cache, summed over all threads
+	 */
+	DescriptorCacheStats get_stats() const;
+
+  private:
+	struct Entry
+	{
+		/// Hash of the layout and contents of the set, 0 for an empty slot
+		size_t key{0};
+
+		VkDescriptorSet handle{VK_NULL_HANDLE};
+
+		uint32_t layout_index{0};
+
+		/// Contents of the set, compared on a hash hit so that sets whose hashes collide are never mixed up
+		BindingMap<VkDescriptorBufferInfo> buffer_infos;
+
+		BindingMap<VkDescriptorImageInfo> image_infos;
+
+		/// Frame which last requested the set
+		uint64_t last_used_frame{0};
+	};
+
+	/**
+	 * @brief Descriptor sets of a layout that are not in the table anymore and can be rewritten
+	 */
+	struct LayoutSets
+	{
+		const DescriptorSetLayout *layout{nullptr};
+
+		std::unique_ptr<DescriptorPool> pool;
+
+		std::vector<VkDescriptorSet> retired_sets;
+	};
+
+	struct ThreadCache
+	{
+		/// Open-addressing table with linear probing, its size is always a power of two
+		std::vector<Entry> entries;
+
+		uint32_t entry_count{0};
+
+		std::vector<LayoutSets> layouts;
+
+		DescriptorCacheStats stats;
+	};
+
+	Device &device;
+
+	std::vector<ThreadCache> thread_caches;
+
+	uint64_t frame_index{0};
+
+	/**
+	 * @brief Finds the slot of a cached set with the given layout and contents
+	 * @return The slot of the set, or the empty slot which ends its probe sequence if it is not cached
+	 */
+	static size_t find_slot(const ThreadCache                        &thread_cache,
+	                        size_t                                    key,
+	                        const DescriptorSetLayout                &descriptor_set_layout,
+	                        const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                        const BindingMap<VkDescriptorImageInfo>  &image_infos);
+
+	/**
+	 * @brief Finds the first empty slot of the probe sequence of a key
+	 */
+	static size_t find_free_slot(const std::vector<Entry> &entries, size_t key);
+
+	static void grow(ThreadCache &thread_cache);
+
+	static void erase(ThreadCache &thread_cache, size_t slot);
+
+	uint32_t find_layout(ThreadCache &thread_cache, const DescriptorSetLayout &descriptor_set_layout);
+};
+}        // namespace vkb
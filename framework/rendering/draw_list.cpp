@@ -0,0 +1,91 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/draw_list.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <core/util/radix_sort.hpp>
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief The bits of a positive float compare in the same order as the float itself
+ */
+inline uint32_t distance_bits(float distance)
+{
+	distance = std::max(distance, 0.0f);
+
+	uint32_t bits;
+	std::memcpy(&bits, &distance, sizeof(bits));
+	return bits;
+}
+}        // namespace
+
+uint64_t DrawList::opaque_key(uint16_t pipeline_bits, uint16_t material_bits, float distance)
+{
+	return (static_cast<uint64_t>(pipeline_bits) << 48) | (static_cast<uint64_t>(material_bits) << 32) | distance_bits(distance);
+}
+
+uint64_t DrawList::transparent_key(float distance)
+{
+	return ~distance_bits(distance);
+}
+
+void DrawList::clear()
+{
+	items.clear();
+}
+
+void DrawList::add(uint64_t key, sg::Node &node, sg::SubMesh &sub_mesh)
+{
+	items.push_back({key, &node, &sub_mesh});
+}
+
+void DrawList::sort()
+{
+	radix_sort(items, scratch, [](const DrawItem &item) { return item.key; });
+}
+
+const std::vector<DrawItem> &DrawList::get_items() const
+{
+	return items;
+}
+
+size_t DrawList::size() const
+{
+	return items.size();
+}
+
+bool DrawList::empty() const
+{
+	return items.empty();
+}
+
+std::vector<DrawItem>::const_iterator DrawList::begin() const
+{
+	return items.begin();
+}
+
+std::vector<DrawItem>::const_iterator DrawList::end() const
+{
+	return items.end();
+}
+}        // namespace vkb
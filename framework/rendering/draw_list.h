@@ -0,0 +1,94 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+class SubMesh;
+}        // namespace sg
+
+/**
+ * @brief A submesh to draw with the node that places it in the scene
+ */
+struct DrawItem
+{
+	/// Draws are recorded in increasing key order
+	uint64_t key{0};
+
+	sg::Node *node{nullptr};
+
+	sg::SubMesh *sub_mesh{nullptr};
+};
+
+/**
+ * @brief Flat list of draws sorted by a 64-bit key
+ *
+ * The list is meant to be kept alive across frames and cleared at the start of each one,
+ * so that its storage is reused and building and sorting it do not allocate in steady state.
+ */
+class DrawList
+{
+  public:
+	/**
+	 * @brief Builds a key that groups draws by pipeline state, then by material,
+	 *        and orders the draws of each group front-to-back
+	 * @param pipeline_bits Bits identifying the pipeline state of the draw
+	 * @param material_bits Bits identifying the material of the draw
+	 * @param distance Distance from the camera, must be positive
+	 */
+	static uint64_t opaque_key(uint16_t pipeline_bits, uint16_t material_bits, float distance);
+
+	/**
+	 * @brief Builds a key that orders draws back-to-front
+	 * @param distance Distance from the camera, must be positive
+	 */
+	static uint64_t transparent_key(float distance);
+
+	void clear();
+
+	void add(uint64_t key, sg::Node &node, sg::SubMesh &sub_mesh);
+
+	/**
+	 * @brief Sorts the draws by key, draws with the same key keep the order they were added in
+	 */
+	void sort();
+
+	const std::vector<DrawItem> &get_items() const;
+
+	size_t size() const;
+
+	bool empty() const;
+
+	std::vector<DrawItem>::const_iterator begin() const;
+
+	std::vector<DrawItem>::const_iterator end() const;
+
+  private:
+	std::vector<DrawItem> items;
+
+	/// Storage used while sorting
+	std::vector<DrawItem> scratch;
+};
+}        // namespace vkb
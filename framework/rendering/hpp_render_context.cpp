@@ -18,6 +18,7 @@
 #include "hpp_render_context.h"
 
 #include <core/hpp_image.h>
+#include <timer.h>
 
 namespace vkb
 {
@@ -81,6 +82,13 @@ void HPPRenderContext::prepare(size_t thread_count, vkb::rendering::HPPRenderTar
 		frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
 	}
 
+	// All the frames share a single descriptor cache, so that descriptor sets are reused across frames
+	descriptor_cache = std::make_shared<vkb::DescriptorCache>(reinterpret_cast<vkb::Device &>(device), thread_count);
+	for (auto &frame : frames)
+	{
+		frame->set_descriptor_cache(descriptor_cache);
+	}
+
 	this->create_render_target_func = create_render_target_func;
 	this->thread_count              = thread_count;
 	this->prepared                  = true;
@@ -187,6 +195,7 @@ void HPPRenderContext::recreate()
 		{
 			// Create a new frame if the new swapchain has more images than current frames
 			frames.emplace_back(std::make_unique<vkb::rendering::HPPRenderFrame>(device, std::move(render_target), thread_count));
+			frames.back()->set_descriptor_cache(descriptor_cache);
 		}
 
 		++frame_it;
@@ -322,6 +331,14 @@ void HPPRenderContext::begin_frame()
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	// Cached resources which no frame in flight uses anymore can now be evicted
+	device.get_resource_cache().begin_frame(to_u32(frames.size()));
+
+	if (descriptor_cache)
+	{
+		descriptor_cache->begin_frame(to_u32(frames.size()));
+	}
 }
 
 vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue                        &queue,
@@ -347,6 +364,8 @@ vk::Semaphore HPPRenderContext::submit(const vkb::core::HPPQueue
 
 	queue.get_handle().submit(submit_info, fence);
 
+	count_barriers(command_buffers);
+
 	return signal_semaphore;
 }
 
@@ -362,6 +381,8 @@ void HPPRenderContext::submit(const vkb::core::HPPQueue &queue, const std::vecto
 	vk::Fence fence = frame.request_fence();
 
 	queue.get_handle().submit(submit_info, fence);
+
+	count_barriers(command_buffers);
 }
 
 void HPPRenderContext::wait_frame()
@@ -386,6 +407,9 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 			present_info.pNext = &disp_present_info;
 		}
 
+		vkb::Timer present_timer;
+		present_timer.start();
+
 		vk::Result result;
 		try
 		{
@@ -396,6 +420,8 @@ void HPPRenderContext::end_frame(vk::Semaphore semaphore)
 			result = vk::Result::eErrorOutOfDateKHR;
 		}
 
+		frame_phase_timings.present = static_cast<float>(present_timer.stop<vkb::Timer::Milliseconds>());
+
 		if (result == vk::Result::eSuboptimalKHR || result == vk::Result::eErrorOutOfDateKHR)
 		{
 			handle_surface_changes();
@@ -417,6 +443,36 @@ vk::Semaphore HPPRenderContext::consume_acquired_semaphore()
 	return std::exchange(acquired_semaphore, nullptr);
 }
 
+vkb::CullingCounters &HPPRenderContext::get_culling_counters()
+{
+	return culling_counters;
+}
+
+vkb::FramePhaseTimings &HPPRenderContext::get_frame_phase_timings()
+{
+	return frame_phase_timings;
+}
+
+vkb::RenderGraphCounters &HPPRenderContext::get_render_graph_counters()
+{
+	return render_graph_counters;
+}
+
+vkb::BarrierCounters &HPPRenderContext::get_barrier_counters()
+{
+	return barrier_counters;
+}
+
+void HPPRenderContext::count_barriers(const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers)
+{
+	// The primary command buffers already include the barriers of the secondary ones they execute
+	for (auto *command_buffer : command_buffers)
+	{
+		barrier_counters.barriers += command_buffer->get_barrier_count();
+		barrier_counters.barrier_calls += command_buffer->get_barrier_call_count();
+	}
+}
+
 vkb::rendering::HPPRenderFrame &HPPRenderContext::get_active_frame()
 {
 	assert(frame_active && "Frame is not active, please call begin_frame");
@@ -21,6 +21,7 @@
 #include <core/hpp_swapchain.h>
 #include <platform/window.h>
 #include <rendering/hpp_render_frame.h>
+#include <stats/stats_common.h>
 
 namespace vkb
 {
@@ -204,6 +205,26 @@ class HPPRenderContext
 	 */
 	vk::Semaphore consume_acquired_semaphore();
 
+	/**
+	 * @brief Returns the counters the subpasses update with the number of drawn and culled submeshes
+	 */
+	vkb::CullingCounters &get_culling_counters();
+
+	/**
+	 * @brief Returns the durations of the phases of the last frame, the sample writes the ones it measures
+	 */
+	vkb::FramePhaseTimings &get_frame_phase_timings();
+
+	/**
+	 * @brief Returns the counters the render graph updates with the memory of its attachments
+	 */
+	vkb::RenderGraphCounters &get_render_graph_counters();
+
+	/**
+	 * @brief Returns the counters of the barriers in the command buffers submitted by the render context
+	 */
+	vkb::BarrierCounters &get_barrier_counters();
+
   protected:
 	vk::Extent2D surface_extent;
 
@@ -236,6 +257,19 @@ class HPPRenderContext
 	vk::SurfaceTransformFlagBitsKHR pre_transform{vk::SurfaceTransformFlagBitsKHR::eIdentity};
 
 	size_t thread_count{1};
+
+	vkb::CullingCounters culling_counters = {};
+
+	vkb::FramePhaseTimings frame_phase_timings = {};
+
+	vkb::RenderGraphCounters render_graph_counters = {};
+
+	vkb::BarrierCounters barrier_counters = {};
+
+	void count_barriers(const std::vector<vkb::core::HPPCommandBuffer *> &command_buffers);
+
+	/// Descriptor cache shared by all the frames, used by DescriptorManagementStrategy::CacheAcrossFrames
+	std::shared_ptr<vkb::DescriptorCache> descriptor_cache;
 };
 
 }        // namespace rendering
@@ -81,6 +81,16 @@ vkb::HPPBufferAllocation HPPRenderFrame::allocate_buffer(const vk::BufferUsageFl
 }
 
 void HPPRenderFrame::clear_descriptors()
+{
+	clear_frame_descriptors();
+
+	if (descriptor_cache)
+	{
+		descriptor_cache->clear();
+	}
+}
+
+void HPPRenderFrame::clear_frame_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
 	{
@@ -209,9 +219,20 @@ vk::DescriptorSet HPPRenderFrame::request_descriptor_set(const vkb::core::HPPDes
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
 
+	// Sets which are updated after being bound can not be shared, those are cached by the frame instead
+	if (descriptor_management_strategy == DescriptorManagementStrategy::CacheAcrossFrames && descriptor_cache && !update_after_bind)
+	{
+		return static_cast<vk::DescriptorSet>(
+		    descriptor_cache->request_descriptor_set(reinterpret_cast<vkb::DescriptorSetLayout const &>(descriptor_set_layout),
+		                                             reinterpret_cast<BindingMap<VkDescriptorBufferInfo> const &>(buffer_infos),
+		                                             reinterpret_cast<BindingMap<VkDescriptorImageInfo> const &>(image_infos),
+		                                             thread_index));
+	}
+
 	assert(thread_index < descriptor_pools.size());
 	auto &descriptor_pool = vkb::common::request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
-	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache)
+	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache ||
+	    descriptor_management_strategy == DescriptorManagementStrategy::CacheAcrossFrames)
 	{
 		// The bindings we want to update before binding, if empty we update all bindings
 		std::vector<uint32_t> bindings_to_update;
@@ -230,6 +251,19 @@ vk::DescriptorSet HPPRenderFrame::request_descriptor_set(const vkb::core::HPPDes
 	}
 	else
 	{
+		if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectlyWithTemplate)
+		{
+			// Allocate a descriptor set and write all of its descriptors at once
+			vk::DescriptorSet handle =
+			    vkb::core::HPPDescriptorSet::create_with_template(device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+			if (handle)
+			{
+				return handle;
+			}
+
+			// Otherwise the layout has no update template, or some of its descriptors were not provided
+		}
+
 		// Request a descriptor pool, allocate a descriptor set, write buffer and image data to it
 		vkb::core::HPPDescriptorSet descriptor_set{device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos};
 		descriptor_set.apply_writes();
@@ -277,12 +311,24 @@ void HPPRenderFrame::reset()
 
 	semaphore_pool.reset();
 
-	if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectly)
+	if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectly ||
+	    descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectlyWithTemplate)
 	{
-		clear_descriptors();
+		// Other frames in flight may still use the sets of the descriptor cache
+		clear_frame_descriptors();
 	}
 }
 
+void HPPRenderFrame::set_descriptor_cache(std::shared_ptr<vkb::DescriptorCache> descriptor_cache_)
+{
+	descriptor_cache = std::move(descriptor_cache_);
+}
+
+vkb::DescriptorCache *HPPRenderFrame::get_descriptor_cache()
+{
+	return descriptor_cache.get();
+}
+
 void HPPRenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_strategy)
 {
 	buffer_allocation_strategy = new_strategy;
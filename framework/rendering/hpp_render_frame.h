@@ -19,6 +19,7 @@
 
 #include <core/hpp_device.h>
 #include <hpp_semaphore_pool.h>
+#include <rendering/descriptor_cache.h>
 #include <vulkan/vulkan_hash.hpp>
 
 namespace vkb
@@ -34,7 +35,9 @@ enum class BufferAllocationStrategy
 enum class DescriptorManagementStrategy
 {
 	StoreInCache,
-	CreateDirectly
+	CreateDirectly,
+	CreateDirectlyWithTemplate,
+	CacheAcrossFrames
 };
 
 /**
@@ -71,6 +74,7 @@ class HPPRenderFrame
 	vkb::rendering::HPPRenderTarget       &get_render_target();
 	vkb::rendering::HPPRenderTarget const &get_render_target() const;
 	const vkb::HPPSemaphorePool           &get_semaphore_pool() const;
+	vkb::DescriptorCache                  *get_descriptor_cache();
 	void                                   release_owned_semaphore(vk::Semaphore semaphore);
 	vk::DescriptorSet                      request_descriptor_set(const vkb::core::HPPDescriptorSetLayout    &descriptor_set_layout,
 	                                                              const BindingMap<vk::DescriptorBufferInfo> &buffer_infos,
@@ -81,6 +85,7 @@ class HPPRenderFrame
 	vk::Semaphore                          request_semaphore();
 	vk::Semaphore                          request_semaphore_with_ownership();
 	void                                   reset();
+	void                                   set_descriptor_cache(std::shared_ptr<vkb::DescriptorCache> descriptor_cache);
 
 	/**
 	 * @param usage Usage of the buffer
@@ -162,6 +167,9 @@ class HPPRenderFrame
 	/// Descriptor sets for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, vkb::core::HPPDescriptorSet>>> descriptor_sets;
 
+	/// Descriptor sets shared with the other frames
+	std::shared_ptr<vkb::DescriptorCache> descriptor_cache;
+
 	vkb::HPPFencePool fence_pool;
 
 	vkb::HPPSemaphorePool semaphore_pool;
@@ -175,6 +183,8 @@ class HPPRenderFrame
 	DescriptorManagementStrategy descriptor_management_strategy{DescriptorManagementStrategy::StoreInCache};
 
 	std::map<vk::BufferUsageFlags, std::vector<std::pair<vkb::HPPBufferPool, vkb::HPPBufferBlock *>>> buffer_pools;
+
+	void clear_frame_descriptors();
 };
 }        // namespace rendering
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2021-2023, NVIDIA CORPORATION. All rights reserved.
+/* Copyright (c) 2021-2024, NVIDIA CORPORATION. All rights reserved.
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -46,6 +46,11 @@ class HPPRenderPipeline : private vkb::RenderPipeline
 		                          reinterpret_cast<vkb::RenderTarget &>(render_target),
 		                          static_cast<VkSubpassContents>(contents));
 	}
+
+	vk::SubpassContents get_last_subpass_contents() const
+	{
+		return static_cast<vk::SubpassContents>(vkb::RenderPipeline::get_last_subpass_contents());
+	}
 };
 }        // namespace rendering
 }        // namespace vkb
@@ -347,4 +347,9 @@ void PipelineState::clear_dirty()
 	dirty = false;
 	specialization_constant_state.clear_dirty();
 }
+
+void PipelineState::set_dirty()
+{
+	dirty = true;
+}
 }        // namespace vkb
@@ -223,6 +223,11 @@ class PipelineState
 
 	void clear_dirty();
 
+	/**
+	 * @brief Forces the pipeline to be requested again on the next flush, even though the state did not change
+	 */
+	void set_dirty();
+
   private:
 	bool dirty{false};
 
@@ -18,6 +18,7 @@
 #include "render_context.h"
 
 #include "platform/window.h"
+#include "timer.h"
 
 namespace vkb
 {
@@ -85,6 +86,13 @@ void RenderContext::prepare(size_t thread_count, RenderTarget::CreateFunc create
 		frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
 	}
 
+	// All the frames share a single descriptor cache, so that descriptor sets are reused across frames
+	descriptor_cache = std::make_shared<DescriptorCache>(device, thread_count);
+	for (auto &frame : frames)
+	{
+		frame->set_descriptor_cache(descriptor_cache);
+	}
+
 	this->create_render_target_func = create_render_target_func;
 	this->thread_count              = thread_count;
 	this->prepared                  = true;
@@ -216,6 +224,7 @@ void RenderContext::recreate()
 		{
 			// Create a new frame if the new swapchain has more images than current frames
 			frames.emplace_back(std::make_unique<RenderFrame>(device, std::move(render_target), thread_count));
+			frames.back()->set_descriptor_cache(descriptor_cache);
 		}
 
 		++frame_it;
@@ -347,6 +356,14 @@ void RenderContext::begin_frame()
 
 	// Wait on all resource to be freed from the previous render to this frame
 	wait_frame();
+
+	// Cached resources which no frame in flight uses anymore can now be evicted
+	device.get_resource_cache().begin_frame(to_u32(frames.size()));
+
+	if (descriptor_cache)
+	{
+		descriptor_cache->begin_frame(to_u32(frames.size()));
+	}
 }
 
 VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *> &command_buffers, VkSemaphore wait_semaphore, VkPipelineStageFlags wait_pipeline_stage)
@@ -377,6 +394,8 @@ VkSemaphore RenderContext::submit(const Queue &queue, const std::vector<CommandB
 
 	queue.submit({submit_info}, fence);
 
+	count_barriers(command_buffers);
+
 	return signal_semaphore;
 }
 
@@ -395,6 +414,8 @@ void RenderContext::submit(const Queue &queue, const std::vector<CommandBuffer *
 	VkFence fence = frame.request_fence();
 
 	queue.submit({submit_info}, fence);
+
+	count_barriers(command_buffers);
 }
 
 void RenderContext::wait_frame()
@@ -427,8 +448,13 @@ void RenderContext::end_frame(VkSemaphore semaphore)
 			present_info.pNext = &disp_present_info;
 		}
 
+		Timer present_timer;
+		present_timer.start();
+
 		VkResult result = queue.present(present_info);
 
+		frame_phase_timings.present = static_cast<float>(present_timer.stop<Timer::Milliseconds>());
+
 		if (result == VK_SUBOPTIMAL_KHR || result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
 			handle_surface_changes();
@@ -452,6 +478,36 @@ VkSemaphore RenderContext::consume_acquired_semaphore()
 	return sem;
 }
 
+CullingCounters &RenderContext::get_culling_counters()
+{
+	return culling_counters;
+}
+
+FramePhaseTimings &RenderContext::get_frame_phase_timings()
+{
+	return frame_phase_timings;
+}
+
+RenderGraphCounters &RenderContext::get_render_graph_counters()
+{
+	return render_graph_counters;
+}
+
+BarrierCounters &RenderContext::get_barrier_counters()
+{
+	return barrier_counters;
+}
+
+void RenderContext::count_barriers(const std::vector<CommandBuffer *> &command_buffers)
+{
+	// The primary command buffers already include the barriers of the secondary ones they execute
+	for (auto *command_buffer : command_buffers)
+	{
+		barrier_counters.barriers += command_buffer->get_barrier_count();
+		barrier_counters.barrier_calls += command_buffer->get_barrier_call_count();
+	}
+}
+
 RenderFrame &RenderContext::get_active_frame()
 {
 	assert(frame_active && "Frame is not active, please call begin_frame");
@@ -34,6 +34,7 @@
 #include "rendering/render_frame.h"
 #include "rendering/render_target.h"
 #include "resource_cache.h"
+#include "stats/stats_common.h"
 
 namespace vkb
 {
@@ -232,6 +233,26 @@ class RenderContext
 	 */
 	VkSemaphore consume_acquired_semaphore();
 
+	/**
+	 * @brief Returns the counters the subpasses update with the number of drawn and culled submeshes
+	 */
+	CullingCounters &get_culling_counters();
+
+	/**
+	 * @brief Returns the durations of the phases of the last frame, the sample writes the ones it measures
+	 */
+	FramePhaseTimings &get_frame_phase_timings();
+
+	/**
+	 * @brief Returns the counters the render graph updates with the memory of its attachments
+	 */
+	RenderGraphCounters &get_render_graph_counters();
+
+	/**
+	 * @brief Returns the counters of the barriers in the command buffers submitted by the render context
+	 */
+	BarrierCounters &get_barrier_counters();
+
   protected:
 	VkExtent2D surface_extent;
 
@@ -264,6 +285,19 @@ class RenderContext
 	VkSurfaceTransformFlagBitsKHR pre_transform{VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR};
 
 	size_t thread_count{1};
+
+	CullingCounters culling_counters{};
+
+	FramePhaseTimings frame_phase_timings{};
+
+	RenderGraphCounters render_graph_counters{};
+
+	BarrierCounters barrier_counters{};
+
+	void count_barriers(const std::vector<CommandBuffer *> &command_buffers);
+
+	/// Descriptor cache shared by all the frames, used by DescriptorManagementStrategy::CacheAcrossFrames
+	std::shared_ptr<DescriptorCache> descriptor_cache;
 };
 
 }        // namespace vkb
@@ -87,9 +87,11 @@ void RenderFrame::reset()
 
 	semaphore_pool.reset();
 
-	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly)
+	if (descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectly ||
+	    descriptor_management_strategy == vkb::DescriptorManagementStrategy::CreateDirectlyWithTemplate)
 	{
-		clear_descriptors();
+		// Other frames in flight may still use the sets of the descriptor cache
+		clear_frame_descriptors();
 	}
 }
 
@@ -208,9 +210,16 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 {
 	assert(thread_index < thread_count && "Thread index is out of bounds");
 
+	// Sets which are updated after being bound can not be shared, those are cached by the frame instead
+	if (descriptor_management_strategy == DescriptorManagementStrategy::CacheAcrossFrames && descriptor_cache && !update_after_bind)
+	{
+		return descriptor_cache->request_descriptor_set(descriptor_set_layout, buffer_infos, image_infos, thread_index);
+	}
+
 	assert(thread_index < descriptor_pools.size());
 	auto &descriptor_pool = request_resource(device, nullptr, *descriptor_pools[thread_index], descriptor_set_layout);
-	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache)
+	if (descriptor_management_strategy == DescriptorManagementStrategy::StoreInCache ||
+	    descriptor_management_strategy == DescriptorManagementStrategy::CacheAcrossFrames)
 	{
 		// The bindings we want to update before binding, if empty we update all bindings
 		std::vector<uint32_t> bindings_to_update;
@@ -228,6 +237,18 @@ VkDescriptorSet RenderFrame::request_descriptor_set(const DescriptorSetLayout &d
 	}
 	else
 	{
+		if (descriptor_management_strategy == DescriptorManagementStrategy::CreateDirectlyWithTemplate)
+		{
+			// Allocate a descriptor set and write all of its descriptors at once
+			VkDescriptorSet handle = DescriptorSet::create_with_template(device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+			if (handle != VK_NULL_HANDLE)
+			{
+				return handle;
+			}
+
+			// Otherwise the layout has no update template, or some of its descriptors were not provided
+		}
+
 		// Request a descriptor pool, allocate a descriptor set, write buffer and image data to it
 		DescriptorSet descriptor_set{device, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos};
 		descriptor_set.apply_writes();
@@ -246,6 +267,16 @@ void RenderFrame::update_descriptor_sets(size_t thread_index)
 }
 
 void RenderFrame::clear_descriptors()
+{
+	clear_frame_descriptors();
+
+	if (descriptor_cache)
+	{
+		descriptor_cache->clear();
+	}
+}
+
+void RenderFrame::clear_frame_descriptors()
 {
 	for (auto &desc_sets_per_thread : descriptor_sets)
 	{
@@ -261,6 +292,38 @@ void RenderFrame::clear_descriptors()
 	}
 }
 
+std::unordered_map<VkDescriptorSetLayout, DescriptorPool::Stats> RenderFrame::get_descriptor_pool_stats() const
+{
+	std::unordered_map<VkDescriptorSetLayout, DescriptorPool::Stats> layout_stats;
+
+	for (auto &desc_pools_per_thread : descriptor_pools)
+	{
+		for (auto &desc_pool : *desc_pools_per_thread)
+		{
+			auto &pool_stats = desc_pool.second.get_stats();
+			auto &stats      = layout_stats[desc_pool.second.get_descriptor_set_layout().get_handle()];
+
+			stats.pool_count += pool_stats.pool_count;
+			stats.capacity += pool_stats.capacity;
+			stats.allocated_sets += pool_stats.allocated_sets;
+			stats.peak_allocated_sets += pool_stats.peak_allocated_sets;
+			stats.pool_creations += pool_stats.pool_creations;
+		}
+	}
+
+	return layout_stats;
+}
+
+void RenderFrame::set_descriptor_cache(std::shared_ptr<DescriptorCache> descriptor_cache_)
+{
+	descriptor_cache = std::move(descriptor_cache_);
+}
+
+DescriptorCache *RenderFrame::get_descriptor_cache()
+{
+	return descriptor_cache.get();
+}
+
 void RenderFrame::set_buffer_allocation_strategy(BufferAllocationStrategy new_strategy)
 {
 	buffer_allocation_strategy = new_strategy;
@@ -29,6 +29,7 @@
 #include "core/query_pool.h"
 #include "core/queue.h"
 #include "fence_pool.h"
+#include "rendering/descriptor_cache.h"
 #include "rendering/render_target.h"
 #include "semaphore_pool.h"
 
@@ -43,7 +44,11 @@ enum BufferAllocationStrategy
 enum DescriptorManagementStrategy
 {
 	StoreInCache,
-	CreateDirectly
+	CreateDirectly,
+	// Same as CreateDirectly, but descriptor sets are written with descriptor update templates when the layout has one
+	CreateDirectlyWithTemplate,
+	// Descriptor sets are looked up by content in a DescriptorCache shared by all the frames of the render context
+	CacheAcrossFrames
 };
 
 /**
@@ -129,8 +134,25 @@ class RenderFrame
 	                                       bool                                      update_after_bind,
 	                                       size_t                                    thread_index = 0);
 
+	/**
+	 * @brief Drops the descriptor sets of the frame, and those of the descriptor cache shared with other frames
+	 *        The device must not use any of them, e.g. call it after Device::wait_idle
+	 */
 	void clear_descriptors();
 
+	/**
+	 * @brief Sets the descriptor cache used by DescriptorManagementStrategy::CacheAcrossFrames,
+	 *        the render context shares a single one between all of its frames
+	 */
+	void set_descriptor_cache(std::shared_ptr<DescriptorCache> descriptor_cache);
+
+	DescriptorCache *get_descriptor_cache();
+
+	/**
+	 * @return The allocation statistics of the descriptor pools of the frame, summed over all threads, for each descriptor set layout
+	 */
+	std::unordered_map<VkDescriptorSetLayout, DescriptorPool::Stats> get_descriptor_pool_stats() const;
+
 	/**
 	 * @brief Sets a new buffer allocation strategy
 	 * @param new_strategy The new buffer allocation strategy
@@ -177,6 +199,9 @@ class RenderFrame
 	/// Descriptor sets for the frame
 	std::vector<std::unique_ptr<std::unordered_map<std::size_t, DescriptorSet>>> descriptor_sets;
 
+	/// Descriptor sets shared with the other frames
+	std::shared_ptr<DescriptorCache> descriptor_cache;
+
 	FencePool fence_pool;
 
 	SemaphorePool semaphore_pool;
@@ -190,6 +215,11 @@ class RenderFrame
 
 	std::map<VkBufferUsageFlags, std::vector<std::pair<BufferPool, BufferBlock *>>> buffer_pools;
 
+	/**
+	 * @brief Drops the descriptor sets of the frame only
+	 */
+	void clear_frame_descriptors();
+
 	static std::vector<uint32_t> collect_bindings_to_update(const DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos);
 };
 }        // namespace vkb
@@ -0,0 +1,751 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rendering/render_graph.h"
+
+#include <algorithm>
+
+#include "common/error.h"
+#include "common/helpers.h"
+#include "core/allocated.h"
+#include "core/command_buffer.h"
+#include "core/debug.h"
+#include "core/device.h"
+#include "rendering/render_context.h"
+#include "rendering/render_frame.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr VkAccessFlags WRITE_ACCESS = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                       VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+
+struct UsageInfo
+{
+	VkImageLayout layout;
+
+	VkPipelineStageFlags stages;
+
+	VkAccessFlags access;
+
+	VkImageUsageFlags image_usage;
+};
+
+UsageInfo get_usage_info(RenderGraph::ImageUsage usage, bool write, VkFormat format)
+{
+	// Depth images read by shaders stay in a depth layout, which keeps them usable as read-only attachments
+	VkImageLayout read_layout = is_depth_format(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	switch (usage)
+	{
+		case RenderGraph::ImageUsage::ColorAttachment:
+			return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | (write ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : 0u),
+			        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT};
+		case RenderGraph::ImageUsage::DepthStencilAttachment:
+			return {write ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
+			        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | (write ? VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT : 0u),
+			        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT};
+		case RenderGraph::ImageUsage::InputAttachment:
+			return {read_layout,
+			        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			        VK_ACCESS_INPUT_ATTACHMENT_READ_BIT,
+			        VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT};
+		case RenderGraph::ImageUsage::Sampled:
+			return {read_layout,
+			        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			        VK_ACCESS_SHADER_READ_BIT,
+			        VK_IMAGE_USAGE_SAMPLED_BIT};
+		case RenderGraph::ImageUsage::Storage:
+			return {VK_IMAGE_LAYOUT_GENERAL,
+			        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			        VK_ACCESS_SHADER_READ_BIT | (write ? VK_ACCESS_SHADER_WRITE_BIT : 0u),
+			        VK_IMAGE_USAGE_STORAGE_BIT};
+		case RenderGraph::ImageUsage::TransferSrc:
+			return {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			        VK_PIPELINE_STAGE_TRANSFER_BIT,
+			        VK_ACCESS_TRANSFER_READ_BIT,
+			        VK_IMAGE_USAGE_TRANSFER_SRC_BIT};
+		case RenderGraph::ImageUsage::TransferDst:
+			return {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			        VK_PIPELINE_STAGE_TRANSFER_BIT,
+			        VK_ACCESS_TRANSFER_WRITE_BIT,
+			        VK_IMAGE_USAGE_TRANSFER_DST_BIT};
+	}
+
+	throw std::runtime_error("Unknown render graph image usage");
+}
+
+bool is_attachment(RenderGraph::ImageUsage usage)
+{
+	return usage == RenderGraph::ImageUsage::ColorAttachment ||
+	       usage == RenderGraph::ImageUsage::DepthStencilAttachment ||
+	       usage == RenderGraph::ImageUsage::InputAttachment;
+}
+}        // namespace
+
+RenderGraph::Pass::Pass(const std::string &name) :
+    name{name}
+{
+}
+
+RenderGraph::Pass &RenderGraph::Pass::read(ImageHandle image, ImageUsage usage)
+{
+	assert(std::none_of(accesses.begin(), accesses.end(), [image](const Access &access) { return access.image == image; }) &&
+	       "A pass can only access an image once");
+
+	accesses.push_back({image, usage, false});
+
+	return *this;
+}
+
+RenderGraph::Pass &RenderGraph::Pass::write(ImageHandle image, ImageUsage usage)
+{
+	assert(std::none_of(accesses.begin(), accesses.end(), [image](const Access &access) { return access.image == image; }) &&
+	       "A pass can only access an image once");
+	assert(usage != ImageUsage::InputAttachment && usage != ImageUsage::Sampled && usage != ImageUsage::TransferSrc &&
+	       "Usage cannot write the image");
+
+	accesses.push_back({image, usage, true});
+
+	return *this;
+}
+
+RenderGraph::Pass &RenderGraph::Pass::set_execute(ExecuteFunc &&execute_)
+{
+	execute = std::move(execute_);
+
+	return *this;
+}
+
+const std::string &RenderGraph::Pass::get_name() const
+{
+	return name;
+}
+
+bool RenderGraph::Pass::is_culled() const
+{
+	return culled;
+}
+
+RenderGraph::RenderGraph(RenderContext &render_context) :
+    render_context{render_context}
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+	destroy_transient_images();
+}
+
+RenderGraph::ImageHandle RenderGraph::create_image(const std::string &name, VkFormat format, VkSampleCountFlagBits samples)
+{
+	ImageResource image;
+	image.name    = name;
+	image.format  = format;
+	image.samples = samples;
+
+	images.push_back(std::move(image));
+
+	return to_u32(images.size() - 1);
+}
+
+RenderGraph::ImageHandle RenderGraph::import_image(const std::string &name, VkImageLayout final_layout)
+{
+	ImageResource image;
+	image.name         = name;
+	image.imported     = true;
+	image.final_layout = final_layout;
+
+	images.push_back(std::move(image));
+
+	return to_u32(images.size() - 1);
+}
+
+RenderGraph::Pass &RenderGraph::add_pass(const std::string &name)
+{
+	passes.push_back(std::make_unique<Pass>(name));
+
+	return *passes.back();
+}
+
+void RenderGraph::clear()
+{
+	if (compiled)
+	{
+		render_context.get_device().wait_idle();
+	}
+
+	destroy_transient_images();
+
+	images.clear();
+	passes.clear();
+}
+
+void RenderGraph::set_aliasing(bool enable)
+{
+	aliasing = enable;
+}
+
+void RenderGraph::compile(const VkExtent2D &extent_)
+{
+	if (compiled)
+	{
+		render_context.get_device().wait_idle();
+		destroy_transient_images();
+	}
+
+	extent = extent_;
+
+	cull_passes();
+
+	create_transient_images();
+
+	compiled = true;
+
+	auto &counters = render_context.get_render_graph_counters();
+	counters.attachment_memory.store(attachment_memory);
+	counters.allocated_memory.store(allocated_memory);
+}
+
+bool RenderGraph::is_compiled() const
+{
+	return compiled;
+}
+
+const VkExtent2D &RenderGraph::get_extent() const
+{
+	return extent;
+}
+
+void RenderGraph::bind_imported_image(ImageHandle handle, const core::ImageView &view, VkImageLayout layout, VkPipelineStageFlags stages)
+{
+	auto &image = images[handle];
+	assert(image.imported && "Only imported images can be bound");
+
+	image.view               = &view;
+	image.state              = {};
+	image.state.layout       = layout;
+	image.state.write_stages = stages;
+}
+
+void RenderGraph::execute(CommandBuffer &command_buffer)
+{
+	assert(compiled && "Render graph must be compiled before being executed");
+
+	for (size_t p = 0; p < passes.size(); ++p)
+	{
+		auto &pass = *passes[p];
+
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		for (auto &access : pass.accesses)
+		{
+			auto &image = images[access.image];
+			assert(image.view && "Imported image must be bound before executing the render graph");
+
+			add_barrier(command_buffer, access.image, access.usage, access.write, !image.imported && image.first_pass == p);
+		}
+
+		// The pass may record commands directly, so its barriers are recorded before it, with any queued by the previous pass
+		command_buffer.flush_barriers();
+
+		auto render_target = get_render_target(pass);
+
+		if (render_target)
+		{
+			// Render passes created for the target keep the attachments in these layouts, the barriers handle the transitions
+			for (uint32_t i = 0; i < pass.attachments.size(); ++i)
+			{
+				auto &access = pass.accesses[pass.attachments[i]];
+				render_target->set_layout(i, get_usage_info(access.usage, access.write, images[access.image].format).layout);
+			}
+		}
+
+		if (pass.execute)
+		{
+			ScopedDebugLabel label{command_buffer, pass.name.c_str()};
+
+			pass.execute(command_buffer, render_target);
+		}
+	}
+
+	for (auto &image : images)
+	{
+		if (!image.imported || !image.view)
+		{
+			continue;
+		}
+
+		if (image.state.layout != image.final_layout)
+		{
+			VkPipelineStageFlags src_stages = image.state.write_stages | image.state.read_stages;
+
+			ImageMemoryBarrier barrier;
+			barrier.src_stage_mask  = src_stages == 0 ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : src_stages;
+			barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+			barrier.src_access_mask = image.state.write_access;
+			barrier.old_layout      = image.state.layout;
+			barrier.new_layout      = image.final_layout;
+
+			command_buffer.image_memory_barrier(*image.view, barrier);
+		}
+
+		image.view = nullptr;
+	}
+
+	command_buffer.flush_barriers();
+}
+
+const core::ImageView &RenderGraph::get_view(ImageHandle handle) const
+{
+	assert(images[handle].view && "Image is not bound or not created");
+
+	return *images[handle].view;
+}
+
+uint32_t RenderGraph::get_culled_pass_count() const
+{
+	return culled_pass_count;
+}
+
+VkDeviceSize RenderGraph::get_attachment_memory() const
+{
+	return attachment_memory;
+}
+
+VkDeviceSize RenderGraph::get_allocated_memory() const
+{
+	return allocated_memory;
+}
+
+void RenderGraph::cull_passes()
+{
+	// Walk the passes backwards from the imported images, a pass is kept if it writes an image a later pass needs
+	std::vector<bool> needed(images.size(), false);
+	for (size_t i = 0; i < images.size(); ++i)
+	{
+		needed[i] = images[i].imported;
+	}
+
+	culled_pass_count = 0;
+
+	for (auto it = passes.rbegin(); it != passes.rend(); ++it)
+	{
+		auto &pass = **it;
+
+		pass.culled = std::none_of(pass.accesses.begin(), pass.accesses.end(),
+		                           [&needed](const Pass::Access &access) { return access.write && needed[access.image]; });
+
+		if (pass.culled)
+		{
+			++culled_pass_count;
+			continue;
+		}
+
+		for (auto &access : pass.accesses)
+		{
+			needed[access.image] = true;
+		}
+	}
+}
+
+void RenderGraph::create_transient_images()
+{
+	// Lifetimes and usages of the images, over the passes which are kept
+	for (auto &image : images)
+	{
+		image.used  = false;
+		image.usage = 0;
+	}
+
+	for (size_t p = 0; p < passes.size(); ++p)
+	{
+		auto &pass = *passes[p];
+		pass.attachments.clear();
+
+		if (pass.culled)
+		{
+			continue;
+		}
+
+		for (size_t a = 0; a < pass.accesses.size(); ++a)
+		{
+			auto &access = pass.accesses[a];
+			auto &image  = images[access.image];
+
+			if (!image.used)
+			{
+				image.first_pass = p;
+				image.used       = true;
+			}
+			image.last_pass = p;
+			image.usage |= get_usage_info(access.usage, access.write, image.format).image_usage;
+
+			if (is_attachment(access.usage))
+			{
+				pass.attachments.push_back(a);
+			}
+		}
+	}
+
+	auto &device = render_context.get_device();
+
+	std::vector<ImageHandle> transient_images;
+	for (ImageHandle i = 0; i < images.size(); ++i)
+	{
+		auto &image = images[i];
+
+		if (image.imported || !image.used)
+		{
+			continue;
+		}
+
+		VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+		image_info.imageType     = VK_IMAGE_TYPE_2D;
+		image_info.format        = image.format;
+		image_info.extent        = {extent.width, extent.height, 1};
+		image_info.mipLevels     = 1;
+		image_info.arrayLayers   = 1;
+		image_info.samples       = image.samples;
+		image_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+		image_info.usage         = image.usage;
+		image_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+		image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+		VK_CHECK(vkCreateImage(device.get_handle(), &image_info, nullptr, &image.handle));
+
+		image.state = {};
+
+		transient_images.push_back(i);
+	}
+
+	std::stable_sort(transient_images.begin(), transient_images.end(),
+	                 [this](ImageHandle lhs, ImageHandle rhs) { return images[lhs].first_pass < images[rhs].first_pass; });
+
+	// Give each image, in the order they are first used, the slot which grows the least among those free by then
+	std::vector<size_t> slot_last_passes;
+	attachment_memory = 0;
+
+	for (auto i : transient_images)
+	{
+		auto &image = images[i];
+
+		VkMemoryRequirements requirements;
+		vkGetImageMemoryRequirements(device.get_handle(), image.handle, &requirements);
+
+		attachment_memory += requirements.size;
+
+		size_t       best_slot   = slots.size();
+		VkDeviceSize best_growth = 0;
+
+		for (size_t s = 0; aliasing && s < slots.size(); ++s)
+		{
+			auto &slot = slots[s];
+
+			if (slot_last_passes[s] >= image.first_pass || (slot.requirements.memoryTypeBits & requirements.memoryTypeBits) == 0)
+			{
+				continue;
+			}
+
+			VkDeviceSize growth = requirements.size > slot.requirements.size ? requirements.size - slot.requirements.size : 0;
+
+			if (best_slot == slots.size() || growth < best_growth ||
+			    (growth == best_growth && slot.requirements.size < slots[best_slot].requirements.size))
+			{
+				best_slot   = s;
+				best_growth = growth;
+			}
+		}
+
+		if (best_slot == slots.size())
+		{
+			MemorySlot slot;
+			slot.requirements = requirements;
+
+			slots.push_back(slot);
+			slot_last_passes.push_back(image.last_pass);
+		}
+		else
+		{
+			auto &slot_requirements = slots[best_slot].requirements;
+			slot_requirements.size           = std::max(slot_requirements.size, requirements.size);
+			slot_requirements.alignment      = std::max(slot_requirements.alignment, requirements.alignment);
+			slot_requirements.memoryTypeBits = slot_requirements.memoryTypeBits & requirements.memoryTypeBits;
+
+			slot_last_passes[best_slot] = image.last_pass;
+		}
+
+		image.slot = best_slot;
+	}
+
+	VmaAllocationCreateInfo allocation_info{};
+	allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	allocated_memory = 0;
+
+	for (auto &slot : slots)
+	{
+		VK_CHECK(vmaAllocateMemory(allocated::get_memory_allocator(), &slot.requirements, &allocation_info, &slot.allocation, nullptr));
+
+		allocated_memory += slot.requirements.size;
+	}
+
+	for (auto i : transient_images)
+	{
+		auto &image = images[i];
+
+		VK_CHECK(vmaBindImageMemory(allocated::get_memory_allocator(), slots[image.slot].allocation, image.handle));
+
+		image.image = std::make_unique<core::Image>(device, image.handle, VkExtent3D{extent.width, extent.height, 1},
+		                                            image.format, image.usage, image.samples);
+		image.image->set_debug_name(image.name);
+
+		image.own_view = std::make_unique<core::ImageView>(*image.image, VK_IMAGE_VIEW_TYPE_2D);
+		image.view     = image.own_view.get();
+	}
+}
+
+void RenderGraph::destroy_transient_images()
+{
+	// Framebuffers and descriptor sets may refer to the views about to be destroyed
+	if (compiled)
+	{
+		render_context.get_device().get_resource_cache().clear_framebuffers();
+
+		for (auto &frame : render_context.get_render_frames())
+		{
+			frame->clear_descriptors();
+		}
+	}
+
+	for (auto &pass : passes)
+	{
+		pass->render_target.reset();
+		pass->imported_render_targets.clear();
+	}
+
+	for (auto &image : images)
+	{
+		if (image.imported)
+		{
+			image.view = nullptr;
+			continue;
+		}
+
+		image.view = nullptr;
+		image.own_view.reset();
+		image.image.reset();
+
+		if (image.handle != VK_NULL_HANDLE)
+		{
+			vkDestroyImage(render_context.get_device().get_handle(), image.handle, nullptr);
+			image.handle = VK_NULL_HANDLE;
+		}
+	}
+
+	for (auto &slot : slots)
+	{
+		vmaFreeMemory(allocated::get_memory_allocator(), slot.allocation);
+	}
+	slots.clear();
+
+	attachment_memory = 0;
+	allocated_memory  = 0;
+	compiled          = false;
+}
+
+std::unique_ptr<RenderTarget> RenderGraph::create_render_target(const Pass &pass)
+{
+	std::vector<core::ImageView> views;
+	views.reserve(pass.attachments.size());
+
+	for (auto index : pass.attachments)
+	{
+		auto &image = images[pass.accesses[index].image];
+
+		// Imported images are owned by the application, the render target only gets its own view of them
+		auto &target_image = image.imported ? const_cast<core::Image &>(image.view->get_image()) : *image.image;
+		views.emplace_back(target_image, VK_IMAGE_VIEW_TYPE_2D, image.view->get_format());
+	}
+
+	return std::make_unique<RenderTarget>(std::move(views));
+}
+
+RenderTarget *RenderGraph::get_render_target(Pass &pass)
+{
+	if (pass.attachments.empty())
+	{
+		return nullptr;
+	}
+
+	std::vector<VkImageView> imported_views;
+	for (auto index : pass.attachments)
+	{
+		auto &image = images[pass.accesses[index].image];
+
+		if (image.imported)
+		{
+			imported_views.push_back(image.view->get_handle());
+		}
+	}
+
+	if (imported_views.empty())
+	{
+		if (!pass.render_target)
+		{
+			pass.render_target = create_render_target(pass);
+		}
+
+		return pass.render_target.get();
+	}
+
+	// A pass drawing to the swapchain gets a render target per swapchain image
+	auto it = pass.imported_render_targets.find(imported_views);
+	if (it == pass.imported_render_targets.end())
+	{
+		it = pass.imported_render_targets.emplace(std::move(imported_views), create_render_target(pass)).first;
+	}
+
+	return it->second.get();
+}
+
+void RenderGraph::add_barrier(CommandBuffer &command_buffer, ImageHandle handle, ImageUsage usage, bool write, bool first_use)
+{
+	auto &image = images[handle];
+	auto &state = image.state;
+	auto  info  = get_usage_info(usage, write, image.format);
+
+	VkImageLayout        old_layout = state.layout;
+	VkPipelineStageFlags src_stages = state.write_stages | state.read_stages;
+	VkAccessFlags        src_access = state.write_access;
+
+	bool image_barrier = false;
+
+	if (first_use)
+	{
+		// The contents are discarded, but the accesses of the image previously in the same memory must complete first
+		auto &slot = slots[image.slot];
+
+		old_layout    = VK_IMAGE_LAYOUT_UNDEFINED;
+		src_stages    = 0;
+		src_access    = 0;
+		image_barrier = true;
+
+		if (slot.occupied)
+		{
+			auto &occupant = images[slot.occupant].state;
+			src_stages     = occupant.write_stages | occupant.read_stages;
+			src_access     = occupant.write_access;
+		}
+
+		slot.occupant = handle;
+		slot.occupied = true;
+	}
+	else if (old_layout != info.layout)
+	{
+		image_barrier = true;
+	}
+	else if (write)
+	{
+		// Write after read only needs an execution dependency
+		image_barrier = src_access != 0;
+	}
+	else
+	{
+		bool visible = (info.stages & ~state.visible_stages) == 0 && (info.access & ~state.visible_access) == 0;
+
+		if (state.write_stages == 0 || visible)
+		{
+			state.read_stages |= info.stages;
+			return;
+		}
+
+		// The write must be made visible to the access of this read, even when the barrier of a previous read
+		// already made it available, in which case the source access is empty and only the destination access counts
+		src_stages    = state.write_stages;
+		image_barrier = true;
+	}
+
+	if (src_stages == 0 && !image_barrier)
+	{
+		return;
+	}
+
+	if (src_stages == 0)
+	{
+		src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	}
+
+	if (image_barrier)
+	{
+		ImageMemoryBarrier barrier;
+		barrier.src_stage_mask  = src_stages;
+		barrier.dst_stage_mask  = info.stages;
+		barrier.src_access_mask = src_access;
+		barrier.dst_access_mask = info.access;
+		barrier.old_layout      = old_layout;
+		barrier.new_layout      = info.layout;
+
+		command_buffer.image_memory_barrier(*image.view, barrier);
+	}
+	else
+	{
+		// An execution dependency is carried by a global barrier without any access
+		GlobalMemoryBarrier barrier;
+		barrier.src_stage_mask = src_stages;
+		barrier.dst_stage_mask = info.stages;
+
+		command_buffer.memory_barrier(barrier);
+	}
+
+	bool transition = old_layout != info.layout;
+
+	if (write)
+	{
+		state.write_stages   = info.stages;
+		state.write_access   = info.access & WRITE_ACCESS;
+		state.read_stages    = 0;
+		state.visible_stages = 0;
+		state.visible_access = 0;
+	}
+	else if (transition)
+	{
+		// The transition is a write, already visible to the stages of this read
+		// The barrier made the previous writes available, so later reads only need them made visible to their access
+		state.write_stages   = info.stages;
+		state.write_access   = 0;
+		state.read_stages    = info.stages;
+		state.visible_stages = info.stages;
+		state.visible_access = info.access;
+	}
+	else
+	{
+		state.read_stages |= info.stages;
+		state.visible_stages |= info.stages;
+		state.visible_access |= info.access;
+	}
+
+	state.layout = info.layout;
+}
+}        // namespace vkb
@@ -0,0 +1,328 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/image.h"
+#include "core/image_view.h"
+#include "rendering/render_target.h"
+
+namespace vkb
+{
+class CommandBuffer;
+class RenderContext;
+
+/**
+ * @brief A frame described as a list of passes declaring which images they read and write
+ *
+ * Passes are recorded in the order they were added. From the declared accesses, compile():
+ * - culls the passes whose results are never read, directly or indirectly, by an imported image
+ * - creates the transient images, the ones the graph owns, with the union of the usages declared for them
+ * - aliases transient images whose lifetimes do not overlap in the same memory
+ *
+ * and execute() records, before each pass, the layout transitions and memory dependencies it needs
+ * in a single pipeline barrier command, then transitions the imported images to their final layout.
+ * The barriers are queued on the command buffer, so they are batched and counted with its own.
+ *
+ * Transient images are shared by all the frames in flight: they are only used on one queue,
+ * so the barriers also order the accesses of a frame after those of the previous one.
+ * Their contents are discarded at the start of each frame.
+ */
+class RenderGraph
+{
+  public:
+	using ImageHandle = uint32_t;
+
+	/**
+	 * @brief How a pass accesses an image, which determines its layout and the stages and access types to synchronize
+	 */
+	enum class ImageUsage
+	{
+		ColorAttachment,
+		DepthStencilAttachment,
+		InputAttachment,
+		Sampled,
+		Storage,
+		TransferSrc,
+		TransferDst
+	};
+
+	/**
+	 * @brief Records the commands of a pass
+	 * @param command_buffer The command buffer the graph records into
+	 * @param render_target The attachments of the pass in the order they were declared,
+	 *        already in the layouts of their usage, or nullptr if the pass has no attachment
+	 */
+	using ExecuteFunc = std::function<void(CommandBuffer &command_buffer, RenderTarget *render_target)>;
+
+	class Pass
+	{
+	  public:
+		Pass(const std::string &name);
+
+		/**
+		 * @brief Declares that the pass reads an image, which must have been written by a previous pass or be imported
+		 */
+		Pass &read(ImageHandle image, ImageUsage usage);
+
+		/**
+		 * @brief Declares that the pass writes an image
+		 *        The previous contents of the image are kept, unless it is the first pass to use a transient image.
+		 */
+		Pass &write(ImageHandle image, ImageUsage usage);
+
+		Pass &set_execute(ExecuteFunc &&execute);
+
+		const std::string &get_name() const;
+
+		bool is_culled() const;
+
+	  private:
+		friend class RenderGraph;
+
+		struct Access
+		{
+			ImageHandle image;
+
+			ImageUsage usage;
+
+			bool write;
+		};
+
+		std::string name;
+
+		std::vector<Access> accesses;
+
+		ExecuteFunc execute;
+
+		bool culled{false};
+
+		/// Indices in accesses of the attachments, in the order of the render target
+		std::vector<size_t> attachments;
+
+		/// Render target of a pass whose attachments are all transient
+		std::unique_ptr<RenderTarget> render_target;
+
+		/// Render targets of a pass with imported attachments, by the views bound to them
+		std::map<std::vector<VkImageView>, std::unique_ptr<RenderTarget>> imported_render_targets;
+	};
+
+	RenderGraph(RenderContext &render_context);
+
+	RenderGraph(const RenderGraph &) = delete;
+
+	RenderGraph(RenderGraph &&) = delete;
+
+	/**
+	 * @brief Destroys the transient images, which the device must not be using anymore
+	 */
+	~RenderGraph();
+
+	RenderGraph &operator=(const RenderGraph &) = delete;
+
+	RenderGraph &operator=(RenderGraph &&) = delete;
+
+	/**
+	 * @brief Declares an image owned by the graph, created by compile() with the extent given to it
+	 */
+	ImageHandle create_image(const std::string &name, VkFormat format, VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT);
+
+	/**
+	 * @brief Declares an image owned by the application, e.g. a swapchain image, which must be bound before each execute()
+	 *        Imported images are the outputs of the graph: the passes which do not contribute to them are culled.
+	 * @param final_layout The layout execute() leaves the image in
+	 */
+	ImageHandle import_image(const std::string &name, VkImageLayout final_layout);
+
+	/**
+	 * @brief Adds a pass, recorded after the passes added before it
+	 */
+	Pass &add_pass(const std::string &name);
+
+	/**
+	 * @brief Removes all the images and passes, to declare a new graph and compile it
+	 */
+	void clear();
+
+	/**
+	 * @brief Lets transient images share memory, enabled by default
+	 *        Disabling it gives each transient image a dedicated allocation. Takes effect on the next compile().
+	 */
+	void set_aliasing(bool enable);
+
+	/**
+	 * @brief Culls the passes, then creates and aliases the transient images
+	 *        Waits for the device to be idle if the graph was already compiled.
+	 *        Must be called again whenever the imported images are recreated, e.g. after the swapchain was.
+	 * @param extent The extent of the transient images
+	 */
+	void compile(const VkExtent2D &extent);
+
+	bool is_compiled() const;
+
+	const VkExtent2D &get_extent() const;
+
+	/**
+	 * @brief Binds the view of an imported image for the next execute()
+	 * @param layout The current layout of the image, undefined to discard its contents
+	 * @param stages The stages which last accessed the image, or which a semaphore wait waits on before the graph uses it
+	 */
+	void bind_imported_image(ImageHandle image, const core::ImageView &view,
+	                         VkImageLayout        layout = VK_IMAGE_LAYOUT_UNDEFINED,
+	                         VkPipelineStageFlags stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+	/**
+	 * @brief Records the passes which were not culled, with the barriers they need
+	 */
+	void execute(CommandBuffer &command_buffer);
+
+	/**
+	 * @brief Returns the view of an image, to bind it to a pass which does not get it as an attachment
+	 */
+	const core::ImageView &get_view(ImageHandle image) const;
+
+	/**
+	 * @return The number of passes culled by the last compile()
+	 */
+	uint32_t get_culled_pass_count() const;
+
+	/**
+	 * @return The memory the transient images would need if each had its own allocation, in bytes
+	 */
+	VkDeviceSize get_attachment_memory() const;
+
+	/**
+	 * @return The memory allocated for the transient images, in bytes
+	 */
+	VkDeviceSize get_allocated_memory() const;
+
+  private:
+	/**
+	 * @brief Synchronization state of an image, carried from one pass, and one frame, to the next
+	 */
+	struct ImageState
+	{
+		VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		/// Stages of the last write, or of the last layout transition
+		VkPipelineStageFlags write_stages{0};
+
+		VkAccessFlags write_access{0};
+
+		/// Stages which read the image since the last write
+		VkPipelineStageFlags read_stages{0};
+
+		/// Stages and access types the last write was made visible to
+		VkPipelineStageFlags visible_stages{0};
+
+		VkAccessFlags visible_access{0};
+	};
+
+	struct ImageResource
+	{
+		std::string name;
+
+		VkFormat format{VK_FORMAT_UNDEFINED};
+
+		VkSampleCountFlagBits samples{VK_SAMPLE_COUNT_1_BIT};
+
+		bool imported{false};
+
+		VkImageLayout final_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+		/// View bound by bind_imported_image(), or created by compile() for transient images
+		const core::ImageView *view{nullptr};
+
+		ImageState state;
+
+		/// Indices of the first and last passes using a transient image, after culling
+		size_t first_pass{0};
+
+		size_t last_pass{0};
+
+		bool used{false};
+
+		VkImageUsageFlags usage{0};
+
+		/// Index of the memory slot of a transient image
+		size_t slot{0};
+
+		VkImage handle{VK_NULL_HANDLE};
+
+		std::unique_ptr<core::Image> image;
+
+		std::unique_ptr<core::ImageView> own_view;
+	};
+
+	/**
+	 * @brief An allocation shared by transient images whose lifetimes do not overlap
+	 */
+	struct MemorySlot
+	{
+		VkMemoryRequirements requirements{};
+
+		VmaAllocation allocation{VK_NULL_HANDLE};
+
+		/// Transient image which used the slot last, whose accesses the next image must wait for
+		ImageHandle occupant{0};
+
+		bool occupied{false};
+	};
+
+	RenderContext &render_context;
+
+	std::vector<ImageResource> images;
+
+	std::vector<std::unique_ptr<Pass>> passes;
+
+	std::vector<MemorySlot> slots;
+
+	bool aliasing{true};
+
+	bool compiled{false};
+
+	VkExtent2D extent{};
+
+	uint32_t culled_pass_count{0};
+
+	VkDeviceSize attachment_memory{0};
+
+	VkDeviceSize allocated_memory{0};
+
+	void cull_passes();
+
+	void create_transient_images();
+
+	void destroy_transient_images();
+
+	std::unique_ptr<RenderTarget> create_render_target(const Pass &pass);
+
+	RenderTarget *get_render_target(Pass &pass);
+
+	/**
+	 * @brief Queues on the command buffer the barrier an access of a pass needs, if any
+	 */
+	void add_barrier(CommandBuffer &command_buffer, ImageHandle image, ImageUsage usage, bool write, bool first_use);
+};
+}        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -96,15 +96,24 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 
 		subpass->update_render_target_attachments(render_target);
 
+		VkSubpassContents subpass_contents = subpass->get_subpass_contents();
+
 		if (i == 0)
 		{
-			command_buffer.begin_render_pass(render_target, load_store, clear_value, subpasses, contents);
+			if (contents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+			{
+				subpass_contents = contents;
+			}
+
+			command_buffer.begin_render_pass(render_target, load_store, clear_value, subpasses, subpass_contents);
 		}
 		else
 		{
-			command_buffer.next_subpass();
+			command_buffer.next_subpass(subpass_contents);
 		}
 
+		last_subpass_contents = subpass_contents;
+
 		if (subpass->get_debug_name().empty())
 		{
 			subpass->set_debug_name(fmt::format("RP subpass #{}", i));
@@ -117,6 +126,11 @@ void RenderPipeline::draw(CommandBuffer &command_buffer, RenderTarget &render_ta
 	active_subpass_index = 0;
 }
 
+VkSubpassContents RenderPipeline::get_last_subpass_contents() const
+{
+	return last_subpass_contents;
+}
+
 std::unique_ptr<Subpass> &RenderPipeline::get_active_subpass()
 {
 	return subpasses[active_subpass_index];
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -86,9 +86,16 @@ class RenderPipeline
 
 	/**
 	 * @brief Record draw commands for each Subpass
+	 *        Each subpass is begun with the contents it asks for, see Subpass::get_subpass_contents().
+	 * @param contents Contents of the first subpass, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS overrides the one of the subpass
 	 */
 	void draw(CommandBuffer &command_buffer, RenderTarget &render_target, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
 
+	/**
+	 * @return Contents of the last subpass recorded by draw(), commands recorded after it must match them
+	 */
+	VkSubpassContents get_last_subpass_contents() const;
+
 	/**
 	 * @return Subpass currently being recorded, or the first one
 	 *         if drawing has not started
@@ -105,5 +112,7 @@ class RenderPipeline
 	std::vector<VkClearValue> clear_value = std::vector<VkClearValue>(2);
 
 	size_t active_subpass_index{0};
+
+	VkSubpassContents last_subpass_contents{VK_SUBPASS_CONTENTS_INLINE};
 };
 }        // namespace vkb
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2021, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -42,10 +42,12 @@ Subpass::Subpass(RenderContext &render_context, ShaderSource &&vertex_source, Sh
 {
 }
 
-void Subpass::update_render_target_attachments(RenderTarget &render_target)
+void Subpass::update_render_target_attachments(RenderTarget &render_target_)
 {
-	render_target.set_input_attachments(input_attachments);
-	render_target.set_output_attachments(output_attachments);
+	render_target = &render_target_;
+
+	render_target->set_input_attachments(input_attachments);
+	render_target->set_output_attachments(output_attachments);
 }
 
 RenderContext &Subpass::get_render_context()
@@ -53,6 +55,11 @@ RenderContext &Subpass::get_render_context()
 	return render_context;
 }
 
+RenderTarget *Subpass::get_render_target()
+{
+	return render_target;
+}
+
 const ShaderSource &Subpass::get_vertex_shader() const
 {
 	return vertex_shader;
@@ -138,6 +145,11 @@ LightingState &Subpass::get_lighting_state()
 	return lighting_state;
 }
 
+VkSubpassContents Subpass::get_subpass_contents() const
+{
+	return VK_SUBPASS_CONTENTS_INLINE;
+}
+
 const std::string &Subpass::get_debug_name() const
 {
 	return debug_name;
@@ -147,4 +159,9 @@ void Subpass::set_debug_name(const std::string &name)
 {
 	debug_name = name;
 }
+
+void Subpass::set_light_culling(bool enabled)
+{
+	light_culling = enabled;
+}
 }        // namespace vkb
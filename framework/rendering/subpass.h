@@ -20,6 +20,7 @@
 #include "buffer_pool.h"
 #include "common/helpers.h"
 #include "core/shader_module.h"
+#include "geometry/frustum.h"
 #include "rendering/pipeline_state.h"
 #include "rendering/render_context.h"
 #include "rendering/render_frame.h"
@@ -98,8 +99,19 @@ class Subpass
 	 */
 	virtual void draw(CommandBuffer &command_buffer) = 0;
 
+	/**
+	 * @brief Returns how the draw commands of the subpass are recorded, which the RenderPipeline passes to the command buffer
+	 * @return VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS if draw() only executes secondary command buffers
+	 */
+	virtual VkSubpassContents get_subpass_contents() const;
+
 	RenderContext &get_render_context();
 
+	/**
+	 * @brief Returns the render target the subpass draws into, set by update_render_target_attachments()
+	 */
+	RenderTarget *get_render_target();
+
 	const ShaderSource &get_vertex_shader() const;
 
 	const ShaderSource &get_fragment_shader() const;
@@ -138,16 +150,25 @@ class Subpass
 
 	void set_debug_name(const std::string &name);
 
+	/**
+	 * @brief Skips the point and spot lights outside of the camera frustum, disabled by default.
+	 *        The light counts are specialization constants, so a change in the number of visible
+	 *        lights selects another pipeline variant, which may have to be built while recording.
+	 */
+	void set_light_culling(bool enabled);
+
 	/**
 	 * @brief Prepares the lighting state to have its lights
 	 *
 	 * @tparam A light structure that has 'directional_lights', 'point_lights' and 'spot_light' array fields defined.
-	 * @param scene_lights All of the light components from the scene graph
+	 * @param scene_lights All of the light components from the scene graph, a vector or a view of sg::Light pointers
 	 * @param light_count The maximum amount of lights allowed for any given type of light.
+	 * @param frustum If not null, point and spot lights whose range does not reach into it are skipped
 	 */
-	template <typename T>
-	void allocate_lights(const std::vector<sg::Light *> &scene_lights,
-	                     size_t                          light_count)
+	template <typename T, typename Lights>
+	void allocate_lights(const Lights  &scene_lights,
+	                     size_t         light_count,
+	                     const Frustum *frustum = nullptr)
 	{
 		assert(scene_lights.size() <= (light_count * sg::LightType::Max) && "Exceeding Max Light Capacity");
 
@@ -158,11 +179,27 @@ class Subpass
 		for (auto &scene_light : scene_lights)
 		{
 			const auto &properties = scene_light->get_properties();
-			auto       &transform  = scene_light->get_node()->get_transform();
 
-			Light light{{transform.get_translation(), static_cast<float>(scene_light->get_light_type())},
+			// Read from the world matrix, which stays consistent while a pipelined frame updates the local transforms
+			glm::mat4 world_matrix = scene_light->get_node()->get_transform().get_world_matrix();
+			glm::vec3 position     = glm::vec3(world_matrix[3]);
+			glm::vec3 direction    = glm::mat3(world_matrix) * properties.direction;
+
+			if (glm::length(direction) > 0.0f)
+			{
+				direction = glm::normalize(direction);
+			}
+
+			// Lights without a range have an infinite one, so they can never be culled
+			if (frustum && scene_light->get_light_type() != sg::LightType::Directional && properties.range > 0.0f &&
+			    !frustum->check_sphere(position, properties.range))
+			{
+				continue;
+			}
+
+			Light light{{position, static_cast<float>(scene_light->get_light_type())},
 			            {properties.color, properties.intensity},
-			            {transform.get_rotation() * properties.direction, properties.range},
+			            {direction, properties.range},
 			            {properties.inner_cone_angle, properties.outer_cone_angle}};
 
 			switch (scene_light->get_light_type())
@@ -218,6 +255,9 @@ class Subpass
 	/// The structure containing all the requested render-ready lights for the scene
 	LightingState lighting_state{};
 
+	/// Whether lights outside of the camera frustum are skipped when allocating the lights
+	bool light_culling{false};
+
   private:
 	std::string debug_name{};
 
@@ -251,6 +291,8 @@ class Subpass
 
 	/// Default to no depth stencil resolve attachment
 	uint32_t depth_stencil_resolve_attachment{VK_ATTACHMENT_UNUSED};
+
+	RenderTarget *render_target{nullptr};
 };
 
 }        // namespace vkb
@@ -53,13 +53,16 @@ void ForwardSubpass::prepare()
 
 			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
 			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+
+			set_resource_modes(vert_module);
+			set_resource_modes(frag_module);
 		}
 	}
 }
 
 void ForwardSubpass::draw(CommandBuffer &command_buffer)
 {
-	allocate_lights<ForwardLights>(scene.get_components<sg::Light>(), MAX_FORWARD_LIGHT_COUNT);
+	allocate_lights<ForwardLights>(scene.get_component_view<sg::Light>(), MAX_FORWARD_LIGHT_COUNT, light_culling ? update_frustum() : nullptr);
 	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
 
 	GeometrySubpass::draw(command_buffer);
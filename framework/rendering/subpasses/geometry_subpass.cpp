@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2023, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -16,6 +16,11 @@
  */
 
 #include "rendering/subpasses/geometry_subpass.h"
+
+#include <future>
+
+#include <ctpl_stl.h>
+
 #include "common/utils.h"
 #include "common/vk_common.h"
 #include "rendering/render_context.h"
@@ -27,6 +32,7 @@
 #include "scene_graph/components/texture.h"
 #include "scene_graph/node.h"
 #include "scene_graph/scene.h"
+#include "timer.h"
 
 namespace vkb
 {
@@ -38,77 +44,199 @@ GeometrySubpass::GeometrySubpass(RenderContext &render_context, ShaderSource &&v
 {
 }
 
+GeometrySubpass::~GeometrySubpass() = default;
+
 void GeometrySubpass::prepare()
 {
+	Timer timer;
+	timer.start();
+
 	// Build all shader variance upfront
-	auto &device = render_context.get_device();
+	std::vector<ShaderModuleRequest> requests;
 	for (auto &mesh : meshes)
 	{
 		for (auto &sub_mesh : mesh->get_submeshes())
 		{
-			auto &variant     = sub_mesh->get_shader_variant();
-			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
-			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+			auto &variant = sub_mesh->get_shader_variant();
+			requests.push_back({VK_SHADER_STAGE_VERTEX_BIT, &get_vertex_shader(), &variant});
+			requests.push_back({VK_SHADER_STAGE_FRAGMENT_BIT, &get_fragment_shader(), &variant});
 		}
 	}
+
+	auto &resource_cache = render_context.get_device().get_resource_cache();
+	resource_cache.request_shader_modules(requests);
+
+	for (auto &request : requests)
+	{
+		set_resource_modes(resource_cache.request_shader_module(request.stage, *request.glsl_source, *request.shader_variant));
+	}
+
+	LOGI("Time spent preparing {} shader variants: {:.3f} seconds", requests.size(), timer.stop());
+}
+
+const GeometrySubpass::InstanceBounds &GeometrySubpass::get_instance_bounds(size_t index, sg::Node &node, sg::Mesh &mesh)
+{
+	if (index >= instance_bounds.size())
+	{
+		instance_bounds.resize(index + 1);
+	}
+
+	auto &bounds       = instance_bounds[index];
+	auto  world_matrix = node.get_transform().get_world_matrix();
+
+	// Static instances keep their bounds, saving the transformation of the box every frame
+	if (bounds.node == &node && bounds.mesh == &mesh && bounds.world_matrix == world_matrix)
+	{
+		return bounds;
+	}
+
+	bounds.node         = &node;
+	bounds.mesh         = &mesh;
+	bounds.world_matrix = world_matrix;
+
+	const sg::AABB &mesh_bounds = mesh.get_bounds();
+
+	bounds.valid = glm::all(glm::lessThanEqual(mesh_bounds.get_min(), mesh_bounds.get_max()));
+
+	if (bounds.valid)
+	{
+		sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
+		world_bounds.transform(world_matrix);
+
+		bounds.min = world_bounds.get_min();
+		bounds.max = world_bounds.get_max();
+	}
+	else
+	{
+		bounds.min = bounds.max = glm::vec3(world_matrix[3]);
+	}
+
+	return bounds;
+}
+
+const Frustum *GeometrySubpass::update_frustum()
+{
+	if (!frustum_culling)
+	{
+		return nullptr;
+	}
+
+	frustum.update(camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view());
+
+	return &frustum;
 }
 
-void GeometrySubpass::get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes, std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes)
+void GeometrySubpass::get_sorted_nodes(DrawList &opaque_nodes, DrawList &transparent_nodes)
 {
+	opaque_nodes.clear();
+	transparent_nodes.clear();
+
 	auto camera_transform = camera.get_node()->get_transform().get_world_matrix();
 
+	update_frustum();
+
+	uint32_t drawn_submeshes  = 0;
+	uint32_t culled_submeshes = 0;
+
+	size_t instance_index = 0;
+
 	for (auto &mesh : meshes)
 	{
 		for (auto &node : mesh->get_nodes())
 		{
-			auto node_transform = node->get_transform().get_world_matrix();
+			auto &bounds = get_instance_bounds(instance_index++, *node, *mesh);
 
-			const sg::AABB &mesh_bounds = mesh->get_bounds();
+			if (frustum_culling && bounds.valid && !frustum.check_box(bounds.min, bounds.max))
+			{
+				culled_submeshes += to_u32(mesh->get_submeshes().size());
+				continue;
+			}
 
-			sg::AABB world_bounds{mesh_bounds.get_min(), mesh_bounds.get_max()};
-			world_bounds.transform(node_transform);
+			float distance = glm::length(glm::vec3(camera_transform[3]) - (bounds.min + bounds.max) * 0.5f);
 
-			float distance = glm::length(glm::vec3(camera_transform[3]) - world_bounds.get_center());
+			// Mirrored nodes are drawn with the opposite front face, hence a different pipeline
+			bool flipped = glm::determinant(glm::mat3(node->get_transform().get_world_matrix())) < 0;
 
 			for (auto &sub_mesh : mesh->get_submeshes())
 			{
-				if (sub_mesh->get_material()->alpha_mode == sg::AlphaMode::Blend)
+				auto material = sub_mesh->get_material();
+
+				if (material->alpha_mode == sg::AlphaMode::Blend)
 				{
-					transparent_nodes.emplace(distance, std::make_pair(node, sub_mesh));
+					transparent_nodes.add(DrawList::transparent_key(distance), *node, *sub_mesh);
 				}
 				else
 				{
-					opaque_nodes.emplace(distance, std::make_pair(node, sub_mesh));
+					size_t pipeline_hash = sub_mesh->get_shader_variant().get_id();
+					hash_combine(pipeline_hash, material->double_sided);
+					hash_combine(pipeline_hash, flipped);
+
+					auto material_hash = std::hash<const sg::Material *>{}(material);
+
+					opaque_nodes.add(DrawList::opaque_key(static_cast<uint16_t>(pipeline_hash), static_cast<uint16_t>(material_hash), distance), *node, *sub_mesh);
 				}
 			}
+
+			drawn_submeshes += to_u32(mesh->get_submeshes().size());
 		}
 	}
+
+	opaque_nodes.sort();
+	transparent_nodes.sort();
+
+	auto &culling_counters = get_render_context().get_culling_counters();
+	culling_counters.drawn_submeshes += drawn_submeshes;
+	culling_counters.culled_submeshes += culled_submeshes;
 }
 
 void GeometrySubpass::draw(CommandBuffer &command_buffer)
 {
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> opaque_nodes;
-	std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> transparent_nodes;
+	get_sorted_nodes(opaque_draws, transparent_draws);
 
-	get_sorted_nodes(opaque_nodes, transparent_nodes);
+	size_t thread_count = recording_thread_pool ? recording_thread_pool->size() + 1 : 1;
+	if (uniform_batches.size() < thread_index + thread_count)
+	{
+		uniform_batches.resize(thread_index + thread_count);
+	}
 
-	// Draw opaque objects in front-to-back order
+	if (secondary_command_buffer_count > 0)
 	{
-		ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
+		draw_secondary(command_buffer);
+		return;
+	}
 
-		for (auto node_it = opaque_nodes.begin(); node_it != opaque_nodes.end(); node_it++)
-		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+	begin_uniform_batch(opaque_draws.size() + transparent_draws.size(), thread_index);
 
-			// Invert the front face if the mesh was flipped
-			const auto &scale      = node_it->second.first->get_transform().get_scale();
-			bool        flipped    = scale.x * scale.y * scale.z < 0;
-			VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	record_opaque_draws(command_buffer, 0, opaque_draws.size(), thread_index);
 
-			draw_submesh(command_buffer, *node_it->second.second, front_face);
-		}
+	record_transparent_draws(command_buffer, thread_index);
+
+	end_uniform_batch(thread_index);
+}
+
+void GeometrySubpass::record_opaque_draws(CommandBuffer &command_buffer, size_t begin, size_t end, size_t thread_index)
+{
+	ScopedDebugLabel opaque_debug_label{command_buffer, "Opaque objects"};
+
+	auto &draws = opaque_draws.get_items();
+
+	// Draw opaque objects grouped by state, in front-to-back order within each group
+	for (size_t i = begin; i < end; ++i)
+	{
+		auto &draw = draws[i];
+
+		update_uniform(command_buffer, *draw.node, thread_index);
+
+		// Invert the front face if the mesh was flipped, the world matrix also accounts for mirrored parents
+		bool        flipped    = glm::determinant(glm::mat3(draw.node->get_transform().get_world_matrix())) < 0;
+		VkFrontFace front_face = flipped ? VK_FRONT_FACE_CLOCKWISE : VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+		draw_submesh(command_buffer, *draw.sub_mesh, front_face);
 	}
+}
 
+void GeometrySubpass::record_transparent_draws(CommandBuffer &command_buffer, size_t thread_index)
+{
 	// Enable alpha blending
 	ColorBlendAttachmentState color_blend_attachment{};
 	color_blend_attachment.blend_enable           = VK_TRUE;
@@ -127,20 +255,158 @@ void GeometrySubpass::draw(CommandBuffer &command_buffer)
 	command_buffer.set_depth_stencil_state(get_depth_stencil_state());
 
 	// Draw transparent objects in back-to-front order
+	ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
+
+	for (auto &draw : transparent_draws)
 	{
-		ScopedDebugLabel transparent_debug_label{command_buffer, "Transparent objects"};
+		update_uniform(command_buffer, *draw.node, thread_index);
 
-		for (auto node_it = transparent_nodes.rbegin(); node_it != transparent_nodes.rend(); node_it++)
-		{
-			update_uniform(command_buffer, *node_it->second.first, thread_index);
+		draw_submesh(command_buffer, *draw.sub_mesh);
+	}
+}
 
-			draw_submesh(command_buffer, *node_it->second.second);
+void GeometrySubpass::draw_secondary(CommandBuffer &primary_command_buffer)
+{
+	// Each secondary command buffer starts from the state of the primary, e.g. the lights bound by a subclass
+	auto record_opaque_chunk = [this, &primary_command_buffer](size_t begin, size_t end, size_t chunk_thread_index) {
+		auto &secondary_command_buffer = primary_command_buffer.begin_secondary_command_buffer(chunk_thread_index);
+
+		begin_uniform_batch(end - begin, chunk_thread_index);
+		record_opaque_draws(secondary_command_buffer, begin, end, chunk_thread_index);
+		end_uniform_batch(chunk_thread_index);
+
+		secondary_command_buffer.end();
+
+		return &secondary_command_buffer;
+	};
+
+	std::vector<CommandBuffer *>              secondary_command_buffers;
+	std::vector<std::future<CommandBuffer *>> secondary_command_buffer_futures;
+
+	size_t draw_count  = opaque_draws.size();
+	size_t chunk_count = std::min<size_t>(secondary_command_buffer_count, draw_count);
+
+	for (size_t chunk = 0; chunk < chunk_count; ++chunk)
+	{
+		size_t begin = chunk * draw_count / chunk_count;
+		size_t end   = (chunk + 1) * draw_count / chunk_count;
+
+		if (recording_thread_pool)
+		{
+			secondary_command_buffer_futures.push_back(recording_thread_pool->push([this, record_opaque_chunk, begin, end](size_t worker_index) {
+				return record_opaque_chunk(begin, end, thread_index + 1 + worker_index);
+			}));
 		}
+		else
+		{
+			secondary_command_buffers.push_back(record_opaque_chunk(begin, end, thread_index));
+		}
+	}
+
+	// The calling thread records the transparent draws while the workers record the opaque ones
+	CommandBuffer *transparent_command_buffer = nullptr;
+
+	if (!transparent_draws.empty())
+	{
+		auto &secondary_command_buffer = primary_command_buffer.begin_secondary_command_buffer(thread_index);
+
+		begin_uniform_batch(transparent_draws.size(), thread_index);
+		record_transparent_draws(secondary_command_buffer, thread_index);
+		end_uniform_batch(thread_index);
+
+		secondary_command_buffer.end();
+
+		transparent_command_buffer = &secondary_command_buffer;
+	}
+
+	// Executed in the order they were split, which keeps the draws sorted
+	for (auto &future : secondary_command_buffer_futures)
+	{
+		secondary_command_buffers.push_back(future.get());
+	}
+
+	if (transparent_command_buffer)
+	{
+		secondary_command_buffers.push_back(transparent_command_buffer);
+	}
+
+	if (!secondary_command_buffers.empty())
+	{
+		primary_command_buffer.execute_commands(secondary_command_buffers);
+	}
+}
+
+void GeometrySubpass::begin_uniform_batch(size_t draw_count, size_t thread_index)
+{
+	assert(thread_index < uniform_batches.size() && "Uniform batches must be sized before recording");
+
+	// The allocation is only made by the first call to update_uniform, as subclasses may not use the batch
+	auto &uniform_batch      = uniform_batches[thread_index];
+	uniform_batch.allocation = {};
+	uniform_batch.count      = 0;
+	uniform_batch.capacity   = draw_count;
+}
+
+bool GeometrySubpass::allocate_uniform_batch(size_t thread_index)
+{
+	auto &uniform_batch = uniform_batches[thread_index];
+
+	auto alignment       = render_context.get_device().get_gpu().get_properties().limits.minUniformBufferOffsetAlignment;
+	uniform_batch.stride = to_u32((sizeof(GlobalUniform) + alignment - 1) & ~(alignment - 1));
+
+	auto &render_frame       = get_render_context().get_active_frame();
+	uniform_batch.allocation = render_frame.allocate_buffer(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, uniform_batch.stride * uniform_batch.capacity, thread_index);
+
+	if (uniform_batch.allocation.empty())
+	{
+		uniform_batch.capacity = 0;
+		return false;
 	}
+
+	// The camera is the same for all draws
+	uniform_batch.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
+	uniform_batch.camera_position  = glm::vec3(glm::inverse(camera.get_view())[3]);
+
+	return true;
+}
+
+void GeometrySubpass::end_uniform_batch(size_t thread_index)
+{
+	auto &uniform_batch = uniform_batches[thread_index];
+
+	if (uniform_batch.count > 0)
+	{
+		uniform_batch.allocation.flush(0, uniform_batch.stride * uniform_batch.count);
+	}
+
+	uniform_batch.allocation = {};
+	uniform_batch.count      = 0;
+	uniform_batch.capacity   = 0;
 }
 
 void GeometrySubpass::update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index)
 {
+	// Subclasses recording outside of draw() may use thread indices without a batch
+	if (thread_index < uniform_batches.size())
+	{
+		auto &uniform_batch = uniform_batches[thread_index];
+
+		if (uniform_batch.count < uniform_batch.capacity && (!uniform_batch.allocation.empty() || allocate_uniform_batch(thread_index)))
+		{
+			auto offset = to_u32(uniform_batch.stride * uniform_batch.count++);
+
+			// Written straight into the mapped buffer, the batch is flushed once all the draws are recorded
+			auto global_uniform              = uniform_batch.allocation.construct<GlobalUniform>(offset);
+			global_uniform->model            = node.get_transform().get_world_matrix();
+			global_uniform->camera_view_proj = uniform_batch.camera_view_proj;
+			global_uniform->camera_position  = uniform_batch.camera_position;
+
+			// Only the offset changes from one draw to the next, which a dynamic uniform buffer binds without a new descriptor set
+			command_buffer.bind_buffer(uniform_batch.allocation.get_buffer(), uniform_batch.allocation.get_offset() + offset, sizeof(GlobalUniform), 0, 1, 0);
+			return;
+		}
+	}
+
 	GlobalUniform global_uniform;
 
 	global_uniform.camera_view_proj = camera.get_pre_rotation() * vkb::vulkan_style_projection(camera.get_projection()) * camera.get_view();
@@ -231,15 +497,15 @@ void GeometrySubpass::draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &s
 	// Find submesh vertex buffers matching the shader input attribute names
 	for (auto &input_resource : vertex_input_resources)
 	{
-		const auto &buffer_iter = sub_mesh.vertex_buffers.find(input_resource.name);
+		auto buffer_range = sub_mesh.get_vertex_buffer_range(input_resource.name);
 
-		if (buffer_iter != sub_mesh.vertex_buffers.end())
+		if (buffer_range.buffer)
 		{
 			std::vector<std::reference_wrapper<const core::Buffer>> buffers;
-			buffers.emplace_back(std::ref(buffer_iter->second));
+			buffers.emplace_back(std::ref(*buffer_range.buffer));
 
 			// Bind vertex buffers only for the attribute locations defined
-			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
+			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {buffer_range.offset});
 		}
 	}
 
@@ -263,17 +529,24 @@ void GeometrySubpass::prepare_pipeline_state(CommandBuffer &command_buffer, VkFr
 	command_buffer.set_multisample_state(multisample_state);
 }
 
-PipelineLayout &GeometrySubpass::prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules)
+void GeometrySubpass::set_resource_modes(ShaderModule &shader_module)
 {
+	// Batched uniforms are bound with dynamic offsets
+	auto &resources = shader_module.get_resources();
+	if (std::any_of(resources.begin(), resources.end(), [](const ShaderResource &resource) { return resource.name == "GlobalUniform"; }))
+	{
+		shader_module.set_resource_mode("GlobalUniform", ShaderResourceMode::Dynamic);
+	}
+
 	// Sets any specified resource modes
-	for (auto &shader_module : shader_modules)
+	for (auto &resource_mode : resource_mode_map)
 	{
-		for (auto &resource_mode : resource_mode_map)
-		{
-			shader_module->set_resource_mode(resource_mode.first, resource_mode.second);
-		}
+		shader_module.set_resource_mode(resource_mode.first, resource_mode.second);
 	}
+}
 
+PipelineLayout &GeometrySubpass::prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules)
+{
 	return command_buffer.get_device().get_resource_cache().request_pipeline_layout(shader_modules);
 }
 
@@ -286,12 +559,7 @@ void GeometrySubpass::prepare_push_constants(CommandBuffer &command_buffer, sg::
 	pbr_material_uniform.metallic_factor   = pbr_material->metallic_factor;
 	pbr_material_uniform.roughness_factor  = pbr_material->roughness_factor;
 
-	auto data = to_bytes(pbr_material_uniform);
-
-	if (!data.empty())
-	{
-		command_buffer.push_constants(data);
-	}
+	command_buffer.push_constants(pbr_material_uniform);
 }
 
 void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh)
@@ -300,7 +568,8 @@ void GeometrySubpass::draw_submesh_command(CommandBuffer &command_buffer, sg::Su
 	if (sub_mesh.vertex_indices != 0)
 	{
 		// Bind index buffer of submesh
-		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+		auto buffer_range = sub_mesh.get_index_buffer_range();
+		command_buffer.bind_index_buffer(*buffer_range.buffer, buffer_range.offset, sub_mesh.index_type);
 
 		// Draw submesh using indexed data
 		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, 0);
@@ -316,4 +585,36 @@ void GeometrySubpass::set_thread_index(uint32_t index)
 {
 	thread_index = index;
 }
+
+void GeometrySubpass::set_frustum_culling(bool enabled)
+{
+	frustum_culling = enabled;
+}
+
+VkSubpassContents GeometrySubpass::get_subpass_contents() const
+{
+	return secondary_command_buffer_count > 0 ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+}
+
+void GeometrySubpass::set_secondary_command_buffer_count(uint32_t count)
+{
+	secondary_command_buffer_count = count;
+}
+
+void GeometrySubpass::set_recording_thread_count(uint32_t count)
+{
+	if (count > 1)
+	{
+		recording_thread_pool = std::make_unique<ctpl::thread_pool>(count - 1);
+	}
+	else
+	{
+		recording_thread_pool.reset();
+	}
+}
+
+uint32_t GeometrySubpass::get_thread_index() const
+{
+	return thread_index;
+}
 }        // namespace vkb
@@ -21,8 +21,16 @@
 
 #include "common/glm_common.h"
 
+#include "buffer_pool.h"
+#include "geometry/frustum.h"
+#include "rendering/draw_list.h"
 #include "rendering/subpass.h"
 
+namespace ctpl
+{
+class thread_pool;
+}
+
 namespace vkb
 {
 namespace sg
@@ -74,27 +82,136 @@ class GeometrySubpass : public Subpass
 	 */
 	GeometrySubpass(RenderContext &render_context, ShaderSource &&vertex_shader, ShaderSource &&fragment_shader, sg::Scene &scene, sg::Camera &camera);
 
-	virtual ~GeometrySubpass() = default;
+	virtual ~GeometrySubpass();
 
 	virtual void prepare() override;
 
 	/**
 	 * @brief Record draw commands
+	 *        With secondary command buffers, the opaque draws are split evenly between them and the transparent draws get one more.
+	 *        The primary command buffer then only executes them.
 	 */
 	virtual void draw(CommandBuffer &command_buffer) override;
 
+	virtual VkSubpassContents get_subpass_contents() const override;
+
 	/**
 	 * @brief Thread index to use for allocating resources
 	 */
 	void set_thread_index(uint32_t index);
 
+	/**
+	 * @brief Enables or disables culling submeshes against the camera frustum, enabled by default
+	 */
+	void set_frustum_culling(bool enabled);
+
+	/**
+	 * @brief Records the draws in secondary command buffers instead of the command buffer passed to draw()
+	 * @param count Number of secondary command buffers for the opaque draws, 0 to record inline
+	 */
+	void set_secondary_command_buffer_count(uint32_t count);
+
+	/**
+	 * @brief Records the secondary command buffers on several threads
+	 *        The calling thread records the transparent draws with the thread index of the subpass,
+	 *        worker i records opaque draws with thread index get_thread_index() + 1 + i,
+	 *        so the render context must be prepared with enough threads.
+	 * @param count Number of recording threads, 1 to record on the calling thread only
+	 */
+	void set_recording_thread_count(uint32_t count);
+
+	uint32_t get_thread_index() const;
+
   protected:
+	/**
+	 * @brief The GlobalUniform of all the draws of a frame, uploaded at once to a single allocation
+	 */
+	struct UniformBatch
+	{
+		BufferAllocation allocation;
+
+		/// Size of each uniform, aligned to the minimum uniform buffer offset alignment
+		size_t stride{0};
+
+		size_t count{0};
+
+		size_t capacity{0};
+
+		glm::mat4 camera_view_proj{};
+
+		glm::vec3 camera_position{};
+	};
+
+	/**
+	 * @brief World space bounds of a mesh instance, cached until the world matrix of its node changes
+	 */
+	struct InstanceBounds
+	{
+		sg::Node *node{nullptr};
+
+		sg::Mesh *mesh{nullptr};
+
+		glm::mat4 world_matrix{};
+
+		glm::vec3 min{};
+
+		glm::vec3 max{};
+
+		/// False if the mesh has no bounds, in which case it can't be culled
+		bool valid{false};
+	};
+
+	/**
+	 * @brief Sets the GlobalUniform of a draw
+	 *        Within a uniform batch, the uniform is written to the batch and bound with a dynamic offset,
+	 *        otherwise it gets its own allocation.
+	 */
 	virtual void update_uniform(CommandBuffer &command_buffer, sg::Node &node, size_t thread_index);
 
+	/**
+	 * @brief Allocates the uniforms of the next draws in a single allocation
+	 *        Each thread index has its own batch, so that threads recording draws concurrently can each use one.
+	 * @param draw_count The maximum number of draws in the batch
+	 * @param thread_index Thread index to use for allocating resources
+	 */
+	void begin_uniform_batch(size_t draw_count, size_t thread_index);
+
+	/**
+	 * @brief Flushes the uniforms of the batch, must be called before the command buffer is submitted
+	 */
+	void end_uniform_batch(size_t thread_index);
+
+	/**
+	 * @brief Allocates the buffer of the uniform batch and computes the uniforms shared by all draws
+	 * @return False if the buffer could not be allocated, in which case the batch is disabled
+	 */
+	bool allocate_uniform_batch(size_t thread_index);
+
+	/**
+	 * @brief Records the opaque draws in [begin, end)
+	 */
+	void record_opaque_draws(CommandBuffer &command_buffer, size_t begin, size_t end, size_t thread_index);
+
+	/**
+	 * @brief Records the transparent draws, with alpha blending
+	 */
+	void record_transparent_draws(CommandBuffer &command_buffer, size_t thread_index);
+
+	/**
+	 * @brief Records the draws in secondary command buffers, on the recording threads if any, and executes them
+	 */
+	void draw_secondary(CommandBuffer &primary_command_buffer);
+
 	void draw_submesh(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh, VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE);
 
 	virtual void prepare_pipeline_state(CommandBuffer &command_buffer, VkFrontFace front_face, bool double_sided_material);
 
+	/**
+	 * @brief Sets the modes of the resources of a shader module, called by prepare() for the modules of all the submeshes
+	 *        The modules are shared by the recording threads, which must only read them.
+	 */
+	virtual void set_resource_modes(ShaderModule &shader_module);
+
 	virtual PipelineLayout &prepare_pipeline_layout(CommandBuffer &command_buffer, const std::vector<ShaderModule *> &shader_modules);
 
 	virtual void prepare_push_constants(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
@@ -102,11 +219,25 @@ class GeometrySubpass : public Subpass
 	virtual void draw_submesh_command(CommandBuffer &command_buffer, sg::SubMesh &sub_mesh);
 
 	/**
-	 * @brief Sorts objects based on distance from camera and classifies them
-	 *        into opaque and transparent in the arrays provided
+	 * @brief Returns the world space bounds of a mesh instance
+	 * @param index Index of the instance in the order meshes and their nodes are iterated
+	 * @param node The node instancing the mesh
+	 * @param mesh The mesh
+	 */
+	const InstanceBounds &get_instance_bounds(size_t index, sg::Node &node, sg::Mesh &mesh);
+
+	/**
+	 * @brief Updates the frustum planes from the camera
+	 * @return The frustum, or null if frustum culling is disabled
+	 */
+	const Frustum *update_frustum();
+
+	/**
+	 * @brief Culls objects outside of the camera frustum and classifies the remaining ones into the lists provided
+	 *        Opaque draws are grouped by pipeline and material then sorted front-to-back,
+	 *        transparent ones are sorted back-to-front.
 	 */
-	void get_sorted_nodes(std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &opaque_nodes,
-	                      std::multimap<float, std::pair<sg::Node *, sg::SubMesh *>> &transparent_nodes);
+	void get_sorted_nodes(DrawList &opaque_nodes, DrawList &transparent_nodes);
 
 	sg::Camera &camera;
 
@@ -117,6 +248,25 @@ class GeometrySubpass : public Subpass
 	uint32_t thread_index{0};
 
 	vkb::RasterizationState base_rasterization_state{};
+
+	bool frustum_culling{true};
+
+	Frustum frustum;
+
+	std::vector<InstanceBounds> instance_bounds;
+
+	/// Draw lists reused every frame
+	DrawList opaque_draws;
+
+	DrawList transparent_draws;
+
+	/// Uniform batch of each thread index, sized by draw() before any thread records
+	std::vector<UniformBatch> uniform_batches;
+
+	uint32_t secondary_command_buffer_count{0};
+
+	/// Workers recording secondary command buffers along with the calling thread
+	std::unique_ptr<ctpl::thread_pool> recording_thread_pool;
 };
 
 }        // namespace vkb
@@ -44,7 +44,14 @@ void LightingSubpass::prepare()
 
 void LightingSubpass::draw(CommandBuffer &command_buffer)
 {
-	allocate_lights<DeferredLights>(scene.get_components<sg::Light>(), MAX_DEFERRED_LIGHT_COUNT);
+	// Skip the lights that can't affect anything visible by the camera
+	Frustum frustum;
+	if (light_culling)
+	{
+		frustum.update(camera.get_pre_rotation() * vulkan_style_projection(camera.get_projection()) * camera.get_view());
+	}
+
+	allocate_lights<DeferredLights>(scene.get_component_view<sg::Light>(), MAX_DEFERRED_LIGHT_COUNT, light_culling ? &frustum : nullptr);
 	command_buffer.bind_lighting(get_lighting_state(), 0, 4);
 
 	// Get shaders from cache
@@ -62,9 +69,9 @@ void LightingSubpass::draw(CommandBuffer &command_buffer)
 	assert(pipeline_layout.get_resources(ShaderResourceType::Input, VK_SHADER_STAGE_VERTEX_BIT).empty());
 	command_buffer.set_vertex_input_state({});
 
-	// Get image views of the attachments
-	auto &render_target = get_render_context().get_active_frame().get_render_target();
-	auto &target_views  = render_target.get_views();
+	// Get image views of the attachments of the render target the pipeline draws into
+	assert(get_render_target() && "Render target must be set by the render pipeline");
+	auto &target_views = get_render_target()->get_views();
 	assert(3 < target_views.size());
 
 	// Bind depth, albedo, and normal as input attachments
@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -41,6 +41,16 @@ void ResourceBindingState::clear_dirty(uint32_t set)
 	resource_sets[set].clear_dirty();
 }
 
+void ResourceBindingState::set_dirty()
+{
+	for (auto &resource_set_it : resource_sets)
+	{
+		resource_set_it.second.set_dirty();
+	}
+
+	dirty = !resource_sets.empty();
+}
+
 void ResourceBindingState::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
 	resource_sets[set].bind_buffer(buffer, offset, range, binding, array_element);
@@ -74,11 +84,19 @@ const std::unordered_map<uint32_t, ResourceSet> &ResourceBindingState::get_resou
 	return resource_sets;
 }
 
+void ResourceBindingState::set_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set)
+{
+	resource_sets[set].set_descriptor_set(descriptor_set);
+}
+
 void ResourceSet::reset()
 {
 	clear_dirty();
 
 	resource_bindings.clear();
+
+	descriptors_dirty = true;
+	descriptor_set    = VK_NULL_HANDLE;
 }
 
 bool ResourceSet::is_dirty() const
@@ -91,6 +109,11 @@ void ResourceSet::clear_dirty()
 	dirty = false;
 }
 
+void ResourceSet::set_dirty()
+{
+	dirty = true;
+}
+
 void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 {
 	resource_bindings[binding][array_element].dirty = false;
@@ -98,36 +121,70 @@ void ResourceSet::clear_dirty(uint32_t binding, uint32_t array_element)
 
 void ResourceSet::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty  = true;
-	resource_bindings[binding][array_element].buffer = &buffer;
-	resource_bindings[binding][array_element].offset = offset;
-	resource_bindings[binding][array_element].range  = range;
+	auto &resource_info = resource_bindings[binding][array_element];
+
+	// Binding the same buffer at another offset can be handled with a dynamic offset
+	if (resource_info.buffer != &buffer || resource_info.range != range)
+	{
+		descriptors_dirty = true;
+	}
+
+	if (resource_info.buffer != &buffer || resource_info.offset != offset || resource_info.range != range)
+	{
+		resource_info.dirty = true;
+	}
+
+	resource_info.buffer = &buffer;
+	resource_info.offset = offset;
+	resource_info.range  = range;
 
 	dirty = true;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = &sampler;
+	auto &resource_info = resource_bindings[binding][array_element];
+
+	// Rebinding the same view and sampler keeps the descriptor set
+	if (resource_info.image_view != &image_view || resource_info.sampler != &sampler)
+	{
+		resource_info.dirty      = true;
+		resource_info.image_view = &image_view;
+		resource_info.sampler    = &sampler;
+
+		descriptors_dirty = true;
+	}
 
 	dirty = true;
 }
 
 void ResourceSet::bind_image(const core::ImageView &image_view, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
-	resource_bindings[binding][array_element].sampler    = nullptr;
+	auto &resource_info = resource_bindings[binding][array_element];
+
+	if (resource_info.image_view != &image_view || resource_info.sampler != nullptr)
+	{
+		resource_info.dirty      = true;
+		resource_info.image_view = &image_view;
+		resource_info.sampler    = nullptr;
+
+		descriptors_dirty = true;
+	}
 
 	dirty = true;
 }
 
 void ResourceSet::bind_input(const core::ImageView &image_view, const uint32_t binding, const uint32_t array_element)
 {
-	resource_bindings[binding][array_element].dirty      = true;
-	resource_bindings[binding][array_element].image_view = &image_view;
+	auto &resource_info = resource_bindings[binding][array_element];
+
+	if (resource_info.image_view != &image_view)
+	{
+		resource_info.dirty      = true;
+		resource_info.image_view = &image_view;
+
+		descriptors_dirty = true;
+	}
 
 	dirty = true;
 }
@@ -137,4 +194,24 @@ const BindingMap<ResourceInfo> &ResourceSet::get_resource_bindings() const
 	return resource_bindings;
 }
 
+VkDescriptorSet ResourceSet::get_reusable_descriptor_set() const
+{
+	return descriptors_dirty ? VK_NULL_HANDLE : descriptor_set;
+}
+
+void ResourceSet::set_descriptor_set(VkDescriptorSet descriptor_set_)
+{
+	descriptor_set    = descriptor_set_;
+	descriptors_dirty = false;
+
+	// All the resources are now part of the descriptor set
+	for (auto &binding_it : resource_bindings)
+	{
+		for (auto &element_it : binding_it.second)
+		{
+			element_it.second.dirty = false;
+		}
+	}
+}
+
 }        // namespace vkb
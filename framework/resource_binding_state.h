@@ -1,4 +1,4 @@
-/* Copyright (c) 2019-2020, Arm Limited and Contributors
+/* Copyright (c) 2019-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -61,6 +61,11 @@ class ResourceSet
 
 	void clear_dirty(uint32_t binding, uint32_t array_element);
 
+	/**
+	 * @brief Marks the set dirty, so that its descriptor set is bound again
+	 */
+	void set_dirty();
+
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element);
 
 	void bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t binding, uint32_t array_element);
@@ -71,10 +76,27 @@ class ResourceSet
 
 	const BindingMap<ResourceInfo> &get_resource_bindings() const;
 
+	/**
+	 * @brief Returns the descriptor set last built for the bindings, as long as only buffer offsets changed since then
+	 *        If these buffers are dynamic, the descriptor set can be bound again with the new offsets.
+	 * @return The descriptor set, or a null handle if it can't be reused
+	 */
+	VkDescriptorSet get_reusable_descriptor_set() const;
+
+	/**
+	 * @brief Records the descriptor set built for the current bindings
+	 */
+	void set_descriptor_set(VkDescriptorSet descriptor_set);
+
   private:
 	bool dirty{false};
 
 	BindingMap<ResourceInfo> resource_bindings;
+
+	/// Whether a resource other than a buffer offset changed since the descriptor set was built
+	bool descriptors_dirty{true};
+
+	VkDescriptorSet descriptor_set{VK_NULL_HANDLE};
 };
 
 /**
@@ -94,6 +116,11 @@ class ResourceBindingState
 
 	void clear_dirty(uint32_t set);
 
+	/**
+	 * @brief Marks all the sets dirty, so that they are bound again, e.g. in another command buffer
+	 */
+	void set_dirty();
+
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
 
 	void bind_image(const core::ImageView &image_view, const core::Sampler &sampler, uint32_t set, uint32_t binding, uint32_t array_element);
@@ -104,6 +131,8 @@ class ResourceBindingState
 
 	const std::unordered_map<uint32_t, ResourceSet> &get_resource_sets();
 
+	void set_descriptor_set(uint32_t set, VkDescriptorSet descriptor_set);
+
   private:
 	bool dirty{false};
 
@@ -17,21 +17,110 @@
 
 #include "resource_cache.h"
 
+#include <ctpl_stl.h>
+
 #include "common/resource_caching.h"
 #include "core/device.h"
+#include "timer.h"
 
 namespace vkb
 {
 namespace
 {
+/**
+ * @brief Requests a resource, building it if it is not cached yet
+ * @param[out] slot The slot the resource is stored in
+ */
+template <class T, class... A>
+T &request_resource_in_slot(Device &device, ResourceRecord &recorder, std::mutex &recorder_mutex, ResourceCacheLock &resource_lock, std::unordered_map<std::size_t, T> &resources, uint64_t frame, std::size_t &slot, A &... args)
+{
+	std::size_t hash{0U};
+	hash_param(hash, args...);
+
+	// Compare the full key in place on a hash hit, so that hits never build it
+	auto matches = [&](const std::string &stored_key) {
+		ResourceKey key{stored_key};
+		key_param(key, args...);
+		return key.matches();
+	};
+
+	auto make_key = [&]() {
+		ResourceKey key;
+		key_param(key, args...);
+		return key.get();
+	};
+
+	return resource_lock.request(
+	    resources, hash, matches, make_key, frame,
+	    [&]() { return T(device, args...); },
+	    [&](T &resource) {
+		    std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+		    record_resource(&recorder, resource, args...);
+	    },
+	    slot);
+}
+
 template <class T, class... A>
-T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &resource_mutex, std::unordered_map<std::size_t, T> &resources, A &... args)
+T &request_resource(Device &device, ResourceRecord &recorder, std::mutex &recorder_mutex, ResourceCacheLock &resource_lock, std::unordered_map<std::size_t, T> &resources, uint64_t frame, A &... args)
 {
-	std::lock_guard<std::mutex> guard(resource_mutex);
+	std::size_t slot;
+	return request_resource_in_slot(device, recorder, recorder_mutex, resource_lock, resources, frame, slot, args...);
+}
 
-	auto &res = request_resource(device, &recorder, resources, args...);
+/**
+ * @brief Checks whether a pipeline can stand in for another one while the latter is being built
+ *        Pipelines with the same layout, render pass, subpass and vertex input run the same shaders on the same resources,
+ *        so they can draw the same geometry, only with different fixed-function states or specialization constants.
+ */
+bool is_fallback_compatible(const PipelineState &pipeline_state, const PipelineState &fallback_state)
+{
+	auto &bindings          = pipeline_state.get_vertex_input_state().bindings;
+	auto &fallback_bindings = fallback_state.get_vertex_input_state().bindings;
+
+	auto &attributes          = pipeline_state.get_vertex_input_state().attributes;
+	auto &fallback_attributes = fallback_state.get_vertex_input_state().attributes;
+
+	return pipeline_state.get_pipeline_layout().get_handle() == fallback_state.get_pipeline_layout().get_handle() &&
+	       pipeline_state.get_render_pass() && fallback_state.get_render_pass() &&
+	       pipeline_state.get_render_pass()->get_handle() == fallback_state.get_render_pass()->get_handle() &&
+	       pipeline_state.get_subpass_index() == fallback_state.get_subpass_index() &&
+	       pipeline_state.get_input_assembly_state().topology == fallback_state.get_input_assembly_state().topology &&
+	       std::equal(bindings.begin(), bindings.end(), fallback_bindings.begin(), fallback_bindings.end(),
+	                  [](const VkVertexInputBindingDescription &lhs, const VkVertexInputBindingDescription &rhs) {
+		                  return lhs.binding == rhs.binding && lhs.stride == rhs.stride && lhs.inputRate == rhs.inputRate;
+	                  }) &&
+	       std::equal(attributes.begin(), attributes.end(), fallback_attributes.begin(), fallback_attributes.end(),
+	                  [](const VkVertexInputAttributeDescription &lhs, const VkVertexInputAttributeDescription &rhs) {
+		                  return lhs.location == rhs.location && lhs.binding == rhs.binding && lhs.format == rhs.format && lhs.offset == rhs.offset;
+	                  });
+}
+
+/**
+ * @brief Groups the pipelines with the same layout, render pass and subpass, among which fallbacks are looked up
+ */
+std::size_t get_fallback_key(const PipelineState &pipeline_state)
+{
+	VkRenderPass render_pass = pipeline_state.get_render_pass() ? pipeline_state.get_render_pass()->get_handle() : VK_NULL_HANDLE;
+
+	std::size_t key{0U};
+	hash_combine(key, pipeline_state.get_pipeline_layout().get_handle());
+	hash_combine(key, render_pass);
+	hash_combine(key, pipeline_state.get_subpass_index());
+
+	return key;
+}
+
+/**
+ * @brief Requests a resource while holding the lock for the whole build
+ *        Used for descriptor pools and sets, as allocating from a descriptor pool is not thread-safe
+ */
+template <class T, class... A>
+T &request_locked_resource(Device &device, ResourceCacheLock &resource_lock, std::unordered_map<std::size_t, T> &resources, A &... args)
+{
+	std::lock_guard<std::shared_mutex> guard(resource_lock.mutex);
 
-	return res;
+	// Descriptor pools and sets are not recorded
+	return request_resource(device, nullptr, resources, args...);
 }
 }        // namespace
 
@@ -40,6 +129,12 @@ ResourceCache::ResourceCache(Device &device) :
 {
 }
 
+ResourceCache::~ResourceCache()
+{
+	// Wait for the pipelines which are still building, as they are inserted into the cache
+	pipeline_compilation_queue.thread_pool.reset();
+}
+
 void ResourceCache::warmup(const std::vector<uint8_t> &data)
 {
 	recorder.set_data(data);
@@ -60,51 +155,253 @@ void ResourceCache::set_pipeline_cache(VkPipelineCache new_pipeline_cache)
 ShaderModule &ResourceCache::request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant)
 {
 	std::string entry_point{"main"};
-	return request_resource(device, recorder, shader_module_mutex, state.shader_modules, stage, glsl_source, entry_point, shader_variant);
+	return request_resource(device, recorder, recorder_mutex, shader_module_lock, state.shader_modules, frame_index, stage, glsl_source, entry_point, shader_variant);
+}
+
+std::vector<ShaderModule *> ResourceCache::request_shader_modules(const std::vector<ShaderModuleRequest> &requests)
+{
+	std::string entry_point{"main"};
+
+	// Hash and key the requests like request_resource does, so that request_shader_module finds the batched modules
+	std::vector<std::size_t> hashes(requests.size(), 0U);
+	std::vector<std::string> keys(requests.size());
+	for (size_t i = 0; i < requests.size(); ++i)
+	{
+		hash_param(hashes[i], requests[i].stage, *requests[i].glsl_source, entry_point, *requests[i].shader_variant);
+
+		ResourceKey key;
+		key_param(key, requests[i].stage, *requests[i].glsl_source, entry_point, *requests[i].shader_variant);
+		keys[i] = key.get();
+	}
+
+	auto get_thread_pool = [this]() -> ctpl::thread_pool & {
+		std::lock_guard<std::mutex> guard(shader_module_thread_pool_mutex);
+
+		if (!shader_module_thread_pool)
+		{
+			auto thread_count = std::thread::hardware_concurrency();
+			thread_count      = thread_count == 0 ? 1 : thread_count;
+
+			shader_module_thread_pool = std::make_unique<ctpl::thread_pool>(thread_count);
+		}
+
+		return *shader_module_thread_pool;
+	};
+
+	shader_module_lock.build_batch(
+	    state.shader_modules, hashes, keys, frame_index.load(), get_thread_pool,
+	    [this, &requests, &entry_point](size_t index) {
+		    auto &request = requests[index];
+		    return ShaderModule(device, request.stage, *request.glsl_source, entry_point, *request.shader_variant);
+	    },
+	    [this, &requests, &entry_point](size_t index, ShaderModule &shader_module) {
+		    auto &request = requests[index];
+
+		    std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+
+		    size_t recorder_index = recorder.register_shader_module(request.stage, *request.glsl_source, entry_point, *request.shader_variant);
+		    recorder.set_shader_module(recorder_index, shader_module);
+	    });
+
+	// All the modules are cached now, or being built by another thread which request_shader_module waits for
+	std::vector<ShaderModule *> result;
+	result.reserve(requests.size());
+	for (auto &request : requests)
+	{
+		result.push_back(&request_shader_module(request.stage, *request.glsl_source, *request.shader_variant));
+	}
+
+	return result;
 }
 
 PipelineLayout &ResourceCache::request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules)
 {
-	return request_resource(device, recorder, pipeline_layout_mutex, state.pipeline_layouts, shader_modules);
+	return request_resource(device, recorder, recorder_mutex, pipeline_layout_lock, state.pipeline_layouts, frame_index, shader_modules);
 }
 
 DescriptorSetLayout &ResourceCache::request_descriptor_set_layout(const uint32_t                     set_index,
                                                                   const std::vector<ShaderModule *> &shader_modules,
                                                                   const std::vector<ShaderResource> &set_resources)
 {
-	return request_resource(device, recorder, descriptor_set_layout_mutex, state.descriptor_set_layouts, set_index, shader_modules, set_resources);
+	return request_resource(device, recorder, recorder_mutex, descriptor_set_layout_lock, state.descriptor_set_layouts, frame_index, set_index, shader_modules, set_resources);
 }
 
 GraphicsPipeline &ResourceCache::request_graphics_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, graphics_pipeline_mutex, state.graphics_pipelines, pipeline_cache, pipeline_state);
+	std::size_t slot;
+	auto       &pipeline = request_resource_in_slot(device, recorder, recorder_mutex, graphics_pipeline_lock, state.graphics_pipelines, frame_index, slot, pipeline_cache, pipeline_state);
+
+	// Pipelines built synchronously can also stand in for the ones being built asynchronously
+	if (pipeline_compilation_queue.enabled)
+	{
+		std::lock_guard<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+		add_fallback_pipeline(slot, pipeline);
+	}
+
+	return pipeline;
+}
+
+GraphicsPipeline *ResourceCache::request_graphics_pipeline_async(PipelineState &pipeline_state, bool &fallback)
+{
+	fallback = false;
+
+	std::size_t hash{0U};
+	hash_param(hash, pipeline_cache, pipeline_state);
+
+	auto matches = [&](const std::string &stored_key) {
+		ResourceKey key{stored_key};
+		key_param(key, pipeline_cache, pipeline_state);
+		return key.matches();
+	};
+
+	std::size_t slot{hash};
+
+	{
+		std::shared_lock<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+
+		if (graphics_pipeline_lock.find_slot(hash, matches, slot))
+		{
+			auto res_it = state.graphics_pipelines.find(slot);
+			if (res_it != state.graphics_pipelines.end())
+			{
+				graphics_pipeline_lock.entries.at(slot).last_used_frame = frame_index.load();
+				graphics_pipeline_lock.hits++;
+				return &res_it->second;
+			}
+		}
+	}
+
+	{
+		std::lock_guard<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+
+		if (!graphics_pipeline_lock.find_slot(hash, matches, slot))
+		{
+			if (slot != hash)
+			{
+				graphics_pipeline_lock.collisions++;
+			}
+			graphics_pipeline_lock.misses++;
+
+			ResourceKey key;
+			key_param(key, pipeline_cache, pipeline_state);
+			graphics_pipeline_lock.insert(slot, hash, key.get(), frame_index.load());
+
+			auto build_promise = std::make_shared<std::promise<void>>();
+			graphics_pipeline_lock.in_flight.emplace(slot, build_promise->get_future().share());
+
+			if (!pipeline_compilation_queue.thread_pool)
+			{
+				// Leave a core to the threads recording the frame
+				auto thread_count = std::thread::hardware_concurrency();
+				thread_count      = thread_count > 1 ? thread_count - 1 : 1;
+
+				pipeline_compilation_queue.thread_pool = std::make_unique<ctpl::thread_pool>(thread_count);
+			}
+
+			// The pipeline state of the command buffer changes with the next draws, so the worker builds from a copy
+			pipeline_compilation_queue.thread_pool->push([this, slot, build_promise, pipeline_state](size_t) mutable {
+				Timer timer;
+				timer.start();
+
+				try
+				{
+					GraphicsPipeline pipeline(device, pipeline_cache, pipeline_state);
+
+					std::unique_lock<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+
+					auto &res = state.graphics_pipelines.emplace(slot, std::move(pipeline)).first->second;
+					graphics_pipeline_lock.in_flight.erase(slot);
+					add_fallback_pipeline(slot, res);
+
+					guard.unlock();
+
+					{
+						std::lock_guard<std::mutex> recorder_guard(recorder_mutex);
+						record_resource(&recorder, res, pipeline_cache, pipeline_state);
+					}
+
+					pipeline_compilation_queue.compiled_pipelines++;
+
+					build_promise->set_value();
+				}
+				catch (const std::exception &e)
+				{
+					LOGE("Failed to build graphics pipeline asynchronously: {}", e.what());
+
+					{
+						std::lock_guard<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+						graphics_pipeline_lock.in_flight.erase(slot);
+						graphics_pipeline_lock.remove(slot);
+					}
+
+					build_promise->set_exception(std::current_exception());
+				}
+
+				// Failed builds took time on the worker too
+				pipeline_compilation_queue.compile_time_us += static_cast<uint64_t>(timer.stop<Timer::Microseconds>());
+			});
+		}
+	}
+
+	// The pipeline is not ready yet, look for another one to draw with in the meantime
+	{
+		std::shared_lock<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+
+		auto slots_it = pipeline_compilation_queue.fallback_slots.find(get_fallback_key(pipeline_state));
+		if (slots_it != pipeline_compilation_queue.fallback_slots.end())
+		{
+			for (auto fallback_slot : slots_it->second)
+			{
+				auto &pipeline = state.graphics_pipelines.at(fallback_slot);
+				if (is_fallback_compatible(pipeline_state, pipeline.get_state()))
+				{
+					graphics_pipeline_lock.entries.at(fallback_slot).last_used_frame = frame_index.load();
+					pipeline_compilation_queue.fallback_draws++;
+
+					fallback = true;
+					return &pipeline;
+				}
+			}
+		}
+	}
+
+	pipeline_compilation_queue.deferred_draws++;
+
+	return nullptr;
 }
 
 ComputePipeline &ResourceCache::request_compute_pipeline(PipelineState &pipeline_state)
 {
-	return request_resource(device, recorder, compute_pipeline_mutex, state.compute_pipelines, pipeline_cache, pipeline_state);
+	return request_resource(device, recorder, recorder_mutex, compute_pipeline_lock, state.compute_pipelines, frame_index, pipeline_cache, pipeline_state);
 }
 
 DescriptorSet &ResourceCache::request_descriptor_set(DescriptorSetLayout &descriptor_set_layout, const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
 {
-	auto &descriptor_pool = request_resource(device, recorder, descriptor_set_mutex, state.descriptor_pools, descriptor_set_layout);
-	return request_resource(device, recorder, descriptor_set_mutex, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
+	auto &descriptor_pool = request_locked_resource(device, descriptor_set_lock, state.descriptor_pools, descriptor_set_layout);
+	return request_locked_resource(device, descriptor_set_lock, state.descriptor_sets, descriptor_set_layout, descriptor_pool, buffer_infos, image_infos);
 }
 
 RenderPass &ResourceCache::request_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses)
 {
-	return request_resource(device, recorder, render_pass_mutex, state.render_passes, attachments, load_store_infos, subpasses);
+	return request_resource(device, recorder, recorder_mutex, render_pass_lock, state.render_passes, frame_index, attachments, load_store_infos, subpasses);
 }
 
 Framebuffer &ResourceCache::request_framebuffer(const RenderTarget &render_target, const RenderPass &render_pass)
 {
-	return request_resource(device, recorder, framebuffer_mutex, state.framebuffers, render_target, render_pass);
+	return request_resource(device, recorder, recorder_mutex, framebuffer_lock, state.framebuffers, frame_index, render_target, render_pass);
 }
 
 void ResourceCache::clear_pipelines()
 {
+	// Wait for the pipelines which are still building before clearing them
+	pipeline_compilation_queue.thread_pool.reset();
+
 	state.graphics_pipelines.clear();
 	state.compute_pipelines.clear();
+	pipeline_compilation_queue.fallback_slots.clear();
+
+	graphics_pipeline_lock.clear();
+	compute_pipeline_lock.clear();
 }
 
 void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &old_views, const std::vector<core::ImageView> &new_views)
@@ -195,15 +492,26 @@ void ResourceCache::update_descriptor_sets(const std::vector<core::ImageView> &o
 void ResourceCache::clear_framebuffers()
 {
 	state.framebuffers.clear();
+
+	framebuffer_lock.clear();
 }
 
 void ResourceCache::clear()
 {
+	// Wait for the pipelines which are still building, as they use the shader modules, layouts and render passes
+	pipeline_compilation_queue.thread_pool.reset();
+
 	state.shader_modules.clear();
 	state.pipeline_layouts.clear();
 	state.descriptor_sets.clear();
 	state.descriptor_set_layouts.clear();
 	state.render_passes.clear();
+
+	shader_module_lock.clear();
+	pipeline_layout_lock.clear();
+	descriptor_set_layout_lock.clear();
+	render_pass_lock.clear();
+
 	clear_pipelines();
 	clear_framebuffers();
 }
@@ -212,4 +520,91 @@ const ResourceCacheState &ResourceCache::get_internal_state() const
 {
 	return state;
 }
+
+void ResourceCache::set_budget(const ResourceCacheBudget &budget)
+{
+	graphics_pipeline_lock.budget = budget.graphics_pipelines;
+	compute_pipeline_lock.budget  = budget.compute_pipelines;
+	framebuffer_lock.budget       = budget.framebuffers;
+}
+
+void ResourceCache::begin_frame(uint32_t frames_in_flight)
+{
+	auto frame = ++frame_index;
+
+	auto &stats              = pipeline_compilation_queue.stats;
+	stats.deferred_draws     = pipeline_compilation_queue.deferred_draws.exchange(0);
+	stats.fallback_draws     = pipeline_compilation_queue.fallback_draws.exchange(0);
+	stats.compiled_pipelines = pipeline_compilation_queue.compiled_pipelines.exchange(0);
+	stats.compile_time_ms    = pipeline_compilation_queue.compile_time_us.exchange(0) / 1000.0;
+
+	// Other cached resources may be referred to by pipelines and framebuffers, so only those are evicted
+	auto graphics_pipeline_evictions = graphics_pipeline_lock.evictions.load();
+	graphics_pipeline_lock.evict(state.graphics_pipelines, frame, frames_in_flight);
+
+	if (graphics_pipeline_lock.evictions.load() != graphics_pipeline_evictions)
+	{
+		// Evicted pipelines can no longer stand in for others, asynchronous builds add fallbacks under the same lock
+		std::lock_guard<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+
+		for (auto &fallback_slots : pipeline_compilation_queue.fallback_slots)
+		{
+			auto &slots = fallback_slots.second;
+			slots.erase(std::remove_if(slots.begin(), slots.end(),
+			                           [this](std::size_t slot) { return state.graphics_pipelines.find(slot) == state.graphics_pipelines.end(); }),
+			            slots.end());
+		}
+	}
+	compute_pipeline_lock.evict(state.compute_pipelines, frame, frames_in_flight);
+	framebuffer_lock.evict(state.framebuffers, frame, frames_in_flight);
+}
+
+ResourceCacheStats ResourceCache::get_stats()
+{
+	ResourceCacheStats stats;
+	stats.shader_modules         = shader_module_lock.get_stats();
+	stats.pipeline_layouts       = pipeline_layout_lock.get_stats();
+	stats.descriptor_set_layouts = descriptor_set_layout_lock.get_stats();
+	stats.render_passes          = render_pass_lock.get_stats();
+	stats.graphics_pipelines     = graphics_pipeline_lock.get_stats();
+	stats.compute_pipelines      = compute_pipeline_lock.get_stats();
+	stats.framebuffers           = framebuffer_lock.get_stats();
+
+	return stats;
+}
+
+void ResourceCache::set_async_pipeline_compilation(bool enable)
+{
+	if (enable && !pipeline_compilation_queue.enabled)
+	{
+		// The pipelines built so far are fallbacks too
+		std::lock_guard<std::shared_mutex> guard(graphics_pipeline_lock.mutex);
+
+		for (auto &pipeline : state.graphics_pipelines)
+		{
+			add_fallback_pipeline(pipeline.first, pipeline.second);
+		}
+	}
+
+	pipeline_compilation_queue.enabled = enable;
+}
+
+void ResourceCache::add_fallback_pipeline(std::size_t slot, const GraphicsPipeline &pipeline)
+{
+	auto &slots = pipeline_compilation_queue.fallback_slots[get_fallback_key(pipeline.get_state())];
+	if (std::find(slots.begin(), slots.end(), slot) == slots.end())
+	{
+		slots.push_back(slot);
+	}
+}
+
+bool ResourceCache::is_async_pipeline_compilation_enabled() const
+{
+	return pipeline_compilation_queue.enabled;
+}
+
+PipelineCompilationStats ResourceCache::get_pipeline_compilation_stats() const
+{
+	return pipeline_compilation_queue.stats;
+}
 }        // namespace vkb
@@ -17,6 +17,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -27,9 +33,15 @@
 #include "core/descriptor_set_layout.h"
 #include "core/framebuffer.h"
 #include "core/pipeline.h"
+#include "core/util/resource_cache_lock.hpp"
 #include "resource_record.h"
 #include "resource_replay.h"
 
+namespace ctpl
+{
+class thread_pool;
+}
+
 namespace vkb
 {
 class Device;
@@ -64,6 +76,95 @@ struct ResourceCacheState
 	std::unordered_map<std::size_t, Framebuffer> framebuffers;
 };
 
+/**
+ * @brief Usage statistics of the resource cache, see ResourceCache::get_stats
+ */
+struct ResourceCacheStats
+{
+	ResourceCacheTypeStats shader_modules;
+
+	ResourceCacheTypeStats pipeline_layouts;
+
+	ResourceCacheTypeStats descriptor_set_layouts;
+
+	ResourceCacheTypeStats render_passes;
+
+	ResourceCacheTypeStats graphics_pipelines;
+
+	ResourceCacheTypeStats compute_pipelines;
+
+	ResourceCacheTypeStats framebuffers;
+};
+
+/**
+ * @brief Maximum number of resources kept in the cache, per type. A budget of 0 means no limit.
+ *        Only resources which no other cached resource refers to can be evicted.
+ */
+struct ResourceCacheBudget
+{
+	size_t graphics_pipelines{0};
+
+	size_t compute_pipelines{0};
+
+	size_t framebuffers{0};
+};
+
+/**
+ * @brief Statistics of the asynchronous graphics pipeline compilation over one frame
+ */
+struct PipelineCompilationStats
+{
+	/// Number of draws skipped as their pipeline was not built yet and there was no fallback for it
+	uint32_t deferred_draws{0};
+
+	/// Number of draws which used a fallback pipeline as their pipeline was not built yet
+	uint32_t fallback_draws{0};
+
+	/// Number of pipelines built on worker threads
+	uint32_t compiled_pipelines{0};
+
+	/// Time spent building pipelines on worker threads, summed over all threads
+	double compile_time_ms{0.0};
+};
+
+/**
+ * @brief State of the asynchronous graphics pipeline compilation, see ResourceCache::request_graphics_pipeline_async
+ */
+struct PipelineCompilationQueue
+{
+	std::atomic<bool> enabled{false};
+
+	/// Worker threads building the pipelines, created on the first asynchronous request
+	std::unique_ptr<ctpl::thread_pool> thread_pool;
+
+	std::atomic<uint32_t> deferred_draws{0};
+
+	std::atomic<uint32_t> fallback_draws{0};
+
+	std::atomic<uint32_t> compiled_pipelines{0};
+
+	std::atomic<uint64_t> compile_time_us{0};
+
+	/// Statistics of the previous frame
+	PipelineCompilationStats stats;
+
+	/// Slots of the graphics pipelines which can be fallbacks, by layout, render pass and subpass.
+	/// Guarded by the lock of the graphics pipelines.
+	std::unordered_map<std::size_t, std::vector<std::size_t>> fallback_slots;
+};
+
+/**
+ * @brief Describes a shader module to be built by ResourceCache::request_shader_modules
+ */
+struct ShaderModuleRequest
+{
+	VkShaderStageFlagBits stage;
+
+	const ShaderSource *glsl_source;
+
+	const ShaderVariant *shader_variant;
+};
+
 /**
  * @brief Cache all sorts of Vulkan objects specific to a Vulkan device.
  * Supports serialization and deserialization of cached resources.
@@ -74,13 +175,16 @@ struct ResourceCacheState
  * The resource cache is also linked with ResourceRecord and ResourceReplay. Replay can warm-up
  * the cache on app startup by creating all necessary objects.
  * The cache holds pointers to objects and has a mapping from such pointers to hashes.
- * It can only be destroyed in bulk, single elements cannot be removed.
+ * Graphics pipelines, compute pipelines and framebuffers can be evicted once they exceed their budget,
+ * other objects can only be destroyed in bulk.
  */
 class ResourceCache
 {
   public:
 	ResourceCache(Device &device);
 
+	~ResourceCache();
+
 	ResourceCache(const ResourceCache &) = delete;
 
 	ResourceCache(ResourceCache &&) = delete;
@@ -97,6 +201,15 @@ class ResourceCache
 
 	ShaderModule &request_shader_module(VkShaderStageFlagBits stage, const ShaderSource &glsl_source, const ShaderVariant &shader_variant = {});
 
+	/**
+	 * @brief Builds a batch of shader modules across a thread pool
+	 *        Duplicate requests and modules which are already cached are only built once.
+	 *        The shader module lock is not held while compiling, so other threads can keep using the cache.
+	 * @param requests The shader modules to build
+	 * @return The shader modules, in the same order as the requests
+	 */
+	std::vector<ShaderModule *> request_shader_modules(const std::vector<ShaderModuleRequest> &requests);
+
 	PipelineLayout &request_pipeline_layout(const std::vector<ShaderModule *> &shader_modules);
 
 	DescriptorSetLayout &request_descriptor_set_layout(const uint32_t                     set_index,
@@ -105,6 +218,16 @@ class ResourceCache
 
 	GraphicsPipeline &request_graphics_pipeline(PipelineState &pipeline_state);
 
+	/**
+	 * @brief Requests a graphics pipeline without waiting for it to be built
+	 *        A missing pipeline is built on a worker thread. Until it is ready, a cached pipeline with the same layout,
+	 *        render pass, subpass and vertex input is returned as a fallback if there is one.
+	 * @param pipeline_state The state of the requested pipeline
+	 * @param[out] fallback Set to true if the returned pipeline is a fallback for the requested one
+	 * @return The requested pipeline, a fallback pipeline, or nullptr if the draw has to be skipped
+	 */
+	GraphicsPipeline *request_graphics_pipeline_async(PipelineState &pipeline_state, bool &fallback);
+
 	ComputePipeline &request_compute_pipeline(PipelineState &pipeline_state);
 
 	DescriptorSet &request_descriptor_set(DescriptorSetLayout &                     descriptor_set_layout,
@@ -131,6 +254,34 @@ class ResourceCache
 
 	const ResourceCacheState &get_internal_state() const;
 
+	/**
+	 * @brief Sets how many graphics pipelines, compute pipelines and framebuffers the cache keeps
+	 *        Least recently used resources over budget are evicted by begin_frame.
+	 */
+	void set_budget(const ResourceCacheBudget &budget);
+
+	/**
+	 * @brief Starts a new frame, evicting the resources over budget which no frame in flight uses anymore
+	 *        Must not be called while other threads request resources.
+	 * @param frames_in_flight The number of frames which may still be executing on the GPU
+	 */
+	void begin_frame(uint32_t frames_in_flight);
+
+	ResourceCacheStats get_stats();
+
+	/**
+	 * @brief Enables building missing graphics pipelines on worker threads, instead of stalling the draw which requests them
+	 *        See CommandBuffer::flush_pipeline_state.
+	 */
+	void set_async_pipeline_compilation(bool enable);
+
+	bool is_async_pipeline_compilation_enabled() const;
+
+	/**
+	 * @return The statistics of the asynchronous pipeline compilation during the previous frame
+	 */
+	PipelineCompilationStats get_pipeline_compilation_stats() const;
+
   private:
 	Device &device;
 
@@ -142,20 +293,39 @@ class ResourceCache
 
 	ResourceCacheState state;
 
-	std::mutex descriptor_set_mutex;
+	std::mutex recorder_mutex;
+
+	ResourceCacheLock descriptor_set_lock;
+
+	ResourceCacheLock pipeline_layout_lock;
+
+	ResourceCacheLock shader_module_lock;
+
+	ResourceCacheLock descriptor_set_layout_lock;
+
+	ResourceCacheLock graphics_pipeline_lock;
+
+	ResourceCacheLock render_pass_lock;
+
+	ResourceCacheLock compute_pipeline_lock;
 
-	std::mutex pipeline_layout_mutex;
+	ResourceCacheLock framebuffer_lock;
 
-	std::mutex shader_module_mutex;
+	std::atomic<uint64_t> frame_index{0};
 
-	std::mutex descriptor_set_layout_mutex;
+	PipelineCompilationQueue pipeline_compilation_queue;
 
-	std::mutex graphics_pipeline_mutex;
+	/// Worker threads building the shader modules of request_shader_modules, created on the first batch with modules to build
+	std::unique_ptr<ctpl::thread_pool> shader_module_thread_pool;
 
-	std::mutex render_pass_mutex;
+	/// Guards the creation of the shader module worker threads
+	std::mutex shader_module_thread_pool_mutex;
 
-	std::mutex compute_pipeline_mutex;
+	// The data members above mirror vkb::HPPResourceCache, which HPPResourceReplay plays into through this class.
 
-	std::mutex framebuffer_mutex;
+	/**
+	 * @brief Indexes a graphics pipeline to be looked up as a fallback, the graphics pipeline lock must be held exclusively
+	 */
+	void add_fallback_pipeline(std::size_t slot, const GraphicsPipeline &pipeline);
 };
 }        // namespace vkb
@@ -49,7 +49,7 @@ std::unique_ptr<vkb::scene_graph::components::HPPImage> HPPImage::load(const std
 {
 	std::unique_ptr<vkb::scene_graph::components::HPPImage> image{nullptr};
 
-	auto data = fs::read_asset(uri);
+	auto file = fs::map_asset(uri);
 
 	// Get extension
 	auto extension = get_extension(uri);
@@ -58,17 +58,17 @@ std::unique_ptr<vkb::scene_graph::components::HPPImage> HPPImage::load(const std
 	if (extension == "png" || extension == "jpg")
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(reinterpret_cast<vkb::scene_graph::components::HPPImage *>(
-		    std::make_unique<vkb::sg::Stb>(name, data, static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
+		    std::make_unique<vkb::sg::Stb>(name, file->data(), file->size(), static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
 	}
 	else if (extension == "astc")
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(
-		    reinterpret_cast<vkb::scene_graph::components::HPPImage *>(std::make_unique<vkb::sg::Astc>(name, data).release()));
+		    reinterpret_cast<vkb::scene_graph::components::HPPImage *>(std::make_unique<vkb::sg::Astc>(name, file->data(), file->size()).release()));
 	}
 	else if ((extension == "ktx") || (extension == "ktx2"))
 	{
 		image = std::unique_ptr<vkb::scene_graph::components::HPPImage>(reinterpret_cast<vkb::scene_graph::components::HPPImage *>(
-		    std::make_unique<vkb::sg::Ktx>(name, data, static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
+		    std::make_unique<vkb::sg::Ktx>(name, file->data(), file->size(), static_cast<vkb::sg::Image::ContentType>(content_type)).release()));
 	}
 
 	return image;
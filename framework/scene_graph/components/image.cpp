@@ -361,26 +361,27 @@ std::unique_ptr<Image> Image::load(const std::string &name, const std::string &u
 {
 	std::unique_ptr<Image> image{nullptr};
 
-	auto data = fs::read_asset(uri);
+	// Decode straight from the mapped file, without copying it first
+	auto file = fs::map_asset(uri);
 
 	// Get extension
 	auto extension = get_extension(uri);
 
 	if (extension == "png" || extension == "jpg")
 	{
-		image = std::make_unique<Stb>(name, data, content_type);
+		image = std::make_unique<Stb>(name, file->data(), file->size(), content_type);
 	}
 	else if (extension == "astc")
 	{
-		image = std::make_unique<Astc>(name, data);
+		image = std::make_unique<Astc>(name, file->data(), file->size());
 	}
 	else if (extension == "ktx")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = std::make_unique<Ktx>(name, file->data(), file->size(), content_type);
 	}
 	else if (extension == "ktx2")
 	{
-		image = std::make_unique<Ktx>(name, data, content_type);
+		image = std::make_unique<Ktx>(name, file->data(), file->size(), content_type);
 	}
 
 	return image;
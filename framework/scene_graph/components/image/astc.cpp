@@ -17,9 +17,15 @@
 
 #include "scene_graph/components/image/astc.h"
 
-#include <mutex>
+#include <future>
+#include <thread>
+
+#include <ctpl_stl.h>
 
 #include "common/error.h"
+#include "common/helpers.h"
+#include "scene_graph/components/image/astc_cache.h"
+#include "timer.h"
 
 #include "common/glm_common.h"
 #if defined(_WIN32) || defined(_WIN64)
@@ -30,10 +36,26 @@
 
 #define MAGIC_FILE_CONSTANT 0x5CA1AB13
 
+// Minimum number of blocks decoded by each thread
+#define MIN_BLOCKS_PER_THREAD 4096
+
 namespace vkb
 {
 namespace sg
 {
+namespace
+{
+/**
+ * @brief Returns the worker threads which help the calling thread decode large images
+ *        The pool is shared by all images, so that loaders decoding several images at once do not multiply the threads.
+ */
+ctpl::thread_pool &get_decode_thread_pool()
+{
+	static ctpl::thread_pool thread_pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+	return thread_pool;
+}
+}        // namespace
+
 BlockDim to_blockdim(const VkFormat format)
 {
 	switch (format)
@@ -125,9 +147,21 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compresse
 		throw std::runtime_error{"Error reading astc: invalid size"};
 	}
 
-	// Allocate working state given config and thread_count
+	// astcenc splits the blocks of an image between all the threads that call astcenc_decompress_image
+	// on the same context, keep enough blocks per thread to amortize handing them over
+	const uint32_t block_count = ((extent.width + blockdim.x - 1) / blockdim.x) *
+	                             ((extent.height + blockdim.y - 1) / blockdim.y) *
+	                             ((extent.depth + blockdim.z - 1) / blockdim.z);
+
+	auto    &thread_pool  = get_decode_thread_pool();
+	uint32_t thread_count = std::max(1u, std::min(to_u32(thread_pool.size()) + 1, block_count / MIN_BLOCKS_PER_THREAD));
+
 	astcenc_context *astc_context;
-	astcenc_context_alloc(&astc_config, 1, &astc_context);
+	atscresult = astcenc_context_alloc(&astc_config, thread_count, &astc_context);
+	if (atscresult != ASTCENC_SUCCESS)
+	{
+		throw std::runtime_error{"Error allocating astc context"};
+	}
 
 	astcenc_image decoded{};
 	decoded.dim_x     = extent.width;
@@ -143,12 +177,35 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compresse
 	void *data_ptr = static_cast<void *>(decoded_data.data());
 	decoded.data   = &data_ptr;
 
-	atscresult = astcenc_decompress_image(astc_context, compressed_data, compressed_size, &decoded, &swizzle, 0);
+	auto decompress = [&](uint32_t thread_index) {
+		return astcenc_decompress_image(astc_context, compressed_data, compressed_size, &decoded, &swizzle, thread_index);
+	};
+
+	// The calling thread takes part as thread #0, and decodes all the blocks itself if the pool is busy with other images.
+	// Workers which start late find no blocks left and return at once.
+	std::vector<std::future<astcenc_error>> workers;
+	for (uint32_t thread_index = 1; thread_index < thread_count; ++thread_index)
+	{
+		workers.push_back(thread_pool.push([&decompress, thread_index](size_t) { return decompress(thread_index); }));
+	}
+
+	atscresult = decompress(0);
+
+	for (auto &worker : workers)
+	{
+		auto result = worker.get();
+		if (result != ASTCENC_SUCCESS)
+		{
+			atscresult = result;
+		}
+	}
+
+	astcenc_context_free(astc_context);
+
 	if (atscresult != ASTCENC_SUCCESS)
 	{
 		throw std::runtime_error("Error decoding astc");
 	}
-	astcenc_context_free(astc_context);
 
 	set_format(VK_FORMAT_R8G8B8A8_SRGB);
 	set_width(decoded.dim_x);
@@ -156,6 +213,31 @@ void Astc::decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *compresse
 	set_depth(decoded.dim_z);
 }
 
+bool Astc::load_from_cache(uint64_t key)
+{
+	AstcCache::Entry entry;
+	if (!AstcCache::load(key, entry))
+	{
+		return false;
+	}
+
+	get_mut_data()    = std::move(entry.data);
+	get_mut_mipmaps() = std::move(entry.mipmaps);
+	set_format(entry.format);
+
+	return true;
+}
+
+void Astc::store_to_cache(uint64_t key, double decode_time_ms) const
+{
+	AstcCache::Entry entry;
+	entry.format  = get_format();
+	entry.data    = get_data();
+	entry.mipmaps = get_mipmaps();
+
+	AstcCache::store(key, entry, decode_time_ms);
+}
+
 Astc::Astc(const Image &image) :
     Image{image.get_name()}
 {
@@ -167,26 +249,51 @@ Astc::Astc(const Image &image) :
 	assert(mip_it != image.get_mipmaps().end() && "Mip #0 not found");
 
 	// When decoding ASTC on CPU (as it is the case in here), we don't decode all mips in the mip chain.
-	// Instead, we just decode mip #0 and re-generate the other LODs later (via image->generate_mipmaps()).
+	// Instead, we just decode mip #0 and re-generate the other LODs from it.
 	const auto     blockdim = to_blockdim(image.get_format());
 	const auto    &extent   = mip_it->extent;
-	auto           size     = extent.width * extent.height * extent.depth * 4;
 	const uint8_t *data_ptr = image.get_data().data() + mip_it->offset;
-	decode(blockdim, mip_it->extent, data_ptr, size);
+
+	// Each ASTC block is 128 bits, whatever its dimensions
+	uint32_t size = ((extent.width + blockdim.x - 1) / blockdim.x) *
+	                ((extent.height + blockdim.y - 1) / blockdim.y) *
+	                ((extent.depth + blockdim.z - 1) / blockdim.z) * 16;
+
+	uint64_t cache_key{0};
+	if (AstcCache::is_enabled())
+	{
+		cache_key = AstcCache::compute_key(blockdim.x, blockdim.y, blockdim.z, extent, data_ptr, size, true);
+
+		if (load_from_cache(cache_key))
+		{
+			return;
+		}
+	}
+
+	Timer timer;
+	timer.start();
+
+	decode(blockdim, extent, data_ptr, size);
+	generate_mipmaps();
+
+	if (AstcCache::is_enabled())
+	{
+		store_to_cache(cache_key, timer.stop<Timer::Milliseconds>());
+	}
 }
 
-Astc::Astc(const std::string &name, const std::vector<uint8_t> &data) :
+Astc::Astc(const std::string &name, const uint8_t *data, size_t size) :
     Image{name}
 {
 	init();
 
 	// Read header
-	if (data.size() < sizeof(AstcHeader))
+	if (size < sizeof(AstcHeader))
 	{
 		throw std::runtime_error{"Error reading astc: invalid memory"};
 	}
 	AstcHeader header{};
-	std::memcpy(&header, data.data(), sizeof(AstcHeader));
+	std::memcpy(&header, data, sizeof(AstcHeader));
 	uint32_t magicval = header.magic[0] + 256 * static_cast<uint32_t>(header.magic[1]) + 65536 * static_cast<uint32_t>(header.magic[2]) + 16777216 * static_cast<uint32_t>(header.magic[3]);
 	if (magicval != MAGIC_FILE_CONSTANT)
 	{
@@ -203,7 +310,29 @@ Astc::Astc(const std::string &name, const std::vector<uint8_t> &data) :
 	    /* height = */ static_cast<uint32_t>(header.ysize[0] + 256 * header.ysize[1] + 65536 * header.ysize[2]),
 	    /* depth  = */ static_cast<uint32_t>(header.zsize[0] + 256 * header.zsize[1] + 65536 * header.zsize[2])};
 
-	decode(blockdim, extent, data.data() + sizeof(AstcHeader), to_u32(data.size() - sizeof(AstcHeader)));
+	const uint8_t *data_ptr  = data + sizeof(AstcHeader);
+	auto           data_size = to_u32(size - sizeof(AstcHeader));
+
+	uint64_t cache_key{0};
+	if (AstcCache::is_enabled())
+	{
+		cache_key = AstcCache::compute_key(blockdim.x, blockdim.y, blockdim.z, extent, data_ptr, data_size, false);
+
+		if (load_from_cache(cache_key))
+		{
+			return;
+		}
+	}
+
+	Timer timer;
+	timer.start();
+
+	decode(blockdim, extent, data_ptr, data_size);
+
+	if (AstcCache::is_enabled())
+	{
+		store_to_cache(cache_key, timer.stop<Timer::Milliseconds>());
+	}
 }
 
 }        // namespace sg
@@ -35,29 +35,41 @@ class Astc : public Image
 {
   public:
 	/**
-	 * @brief Decodes an ASTC image
+	 * @brief Decodes an ASTC image and generates its mip chain
+	 *        The result is reused from the AstcCache if it is enabled
 	 * @param image Image to decode
 	 */
 	Astc(const Image &image);
 
 	/**
 	 * @brief Decodes ASTC data with an ASTC header
+	 *        The result is reused from the AstcCache if it is enabled
 	 * @param name Name of the component
 	 * @param data ASTC data with header
+	 * @param size Size of the ASTC data, including the header
 	 */
-	Astc(const std::string &name, const std::vector<uint8_t> &data);
+	Astc(const std::string &name, const uint8_t *data, size_t size);
 
 	virtual ~Astc() = default;
 
   private:
 	/**
-	 * @brief Decodes ASTC data
+	 * @brief Decodes ASTC data, splitting the blocks of large images between the calling thread and a pool shared by all images
 	 * @param blockdim Dimensions of the block
 	 * @param extent Extent of the image
 	 * @param data Pointer to ASTC image data
+	 * @param size Size of the ASTC image data
 	 */
 	void decode(BlockDim blockdim, VkExtent3D extent, const uint8_t *data, uint32_t size);
 
+	/**
+	 * @brief Replaces the image with a decoded image from the AstcCache
+	 * @return True if the cache contained an entry for the key
+	 */
+	bool load_from_cache(uint64_t key);
+
+	void store_to_cache(uint64_t key, double decode_time_ms) const;
+
 	/**
 	 * @brief Initializes ASTC library
 	 */
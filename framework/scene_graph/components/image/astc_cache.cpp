@@ -0,0 +1,116 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "scene_graph/components/image/astc_cache.h"
+
+#include "common/helpers.h"
+
+namespace vkb
+{
+namespace sg
+{
+namespace
+{
+constexpr uint32_t CACHE_ENTRY_MAGIC   = 0x43545341;        // "ASTC"
+constexpr uint32_t CACHE_ENTRY_VERSION = 1;
+
+/**
+ * @brief Checks that every mip level of an entry lies within its data
+ */
+inline bool is_valid(const AstcCache::Entry &entry)
+{
+	if (entry.data.empty() || entry.mipmaps.empty())
+	{
+		return false;
+	}
+
+	for (auto &mipmap : entry.mipmaps)
+	{
+		size_t mip_size = static_cast<size_t>(mipmap.extent.width) * mipmap.extent.height * mipmap.extent.depth * 4;
+		if (mip_size == 0 || mipmap.offset + mip_size > entry.data.size())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+}        // namespace
+
+DiskCache AstcCache::disk_cache{"ASTC decode", "astccache", CACHE_ENTRY_MAGIC, CACHE_ENTRY_VERSION};
+
+DiskCache &AstcCache::get_disk_cache()
+{
+	return disk_cache;
+}
+
+bool AstcCache::is_enabled()
+{
+	return disk_cache.is_enabled();
+}
+
+uint64_t AstcCache::compute_key(uint8_t block_dim_x, uint8_t block_dim_y, uint8_t block_dim_z,
+                                VkExtent3D extent, const uint8_t *data, size_t size, bool with_mipmaps)
+{
+	uint64_t key = 0xcbf29ce484222325ULL;
+
+	fnv1a(key, &CACHE_ENTRY_VERSION, sizeof(CACHE_ENTRY_VERSION));
+	fnv1a(key, &block_dim_x, sizeof(block_dim_x));
+	fnv1a(key, &block_dim_y, sizeof(block_dim_y));
+	fnv1a(key, &block_dim_z, sizeof(block_dim_z));
+	fnv1a(key, &extent.width, sizeof(extent.width));
+	fnv1a(key, &extent.height, sizeof(extent.height));
+	fnv1a(key, &extent.depth, sizeof(extent.depth));
+	fnv1a(key, &with_mipmaps, sizeof(with_mipmaps));
+
+	uint64_t data_size = size;
+	fnv1a(key, &data_size, sizeof(data_size));
+	fnv1a(key, data, size);
+
+	return key;
+}
+
+bool AstcCache::load(uint64_t key, Entry &entry)
+{
+	Entry cached_entry;
+
+	bool found = disk_cache.load(key, [&](std::istringstream &is) {
+		read(is, cached_entry.format, cached_entry.mipmaps, cached_entry.data);
+
+		return !is.fail() && is_valid(cached_entry);
+	});
+
+	if (!found)
+	{
+		return false;
+	}
+
+	entry = std::move(cached_entry);
+
+	return true;
+}
+
+void AstcCache::store(uint64_t key, const Entry &entry, double decode_time_ms)
+{
+	disk_cache.store(
+	    key, [&](std::ostringstream &os) {
+		    write(os, entry.format, entry.mipmaps, entry.data);
+	    },
+	    decode_time_ms);
+}
+}        // namespace sg
+}        // namespace vkb
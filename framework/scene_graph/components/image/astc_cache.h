@@ -0,0 +1,94 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "disk_cache.h"
+#include "scene_graph/components/image.h"
+
+namespace vkb
+{
+namespace sg
+{
+/**
+ * @brief Persistent, content-addressed cache of ASTC images decoded on the CPU
+ *
+ * Decoding ASTC in software is slow, so on devices without ASTC support the decoded RGBA8 data
+ * (including the generated mip chain) can be stored on disk and reused by subsequent runs.
+ * Entries are keyed by a hash of the compressed data, the block dimensions and the extent,
+ * so editing an asset yields a new key and stale entries are never returned.
+ *
+ * The cache is disabled by default, call enable() on get_disk_cache() to start using it.
+ */
+class AstcCache
+{
+  public:
+	/**
+	 * @brief Decoded image stored in a cache entry
+	 */
+	struct Entry
+	{
+		VkFormat format{VK_FORMAT_UNDEFINED};
+
+		std::vector<uint8_t> data;
+
+		std::vector<Mipmap> mipmaps;
+	};
+
+	/**
+	 * @brief Returns the disk cache that stores the entries, which controls whether the cache is enabled and keeps its stats
+	 */
+	static DiskCache &get_disk_cache();
+
+	static bool is_enabled();
+
+	/**
+	 * @brief Computes the cache key of an ASTC image
+	 * @param block_dim_x, block_dim_y, block_dim_z Dimensions of the ASTC blocks
+	 * @param extent Extent of the image
+	 * @param data Pointer to the compressed data
+	 * @param size Size of the compressed data
+	 * @param with_mipmaps Whether the decoded image includes a generated mip chain
+	 */
+	static uint64_t compute_key(uint8_t block_dim_x, uint8_t block_dim_y, uint8_t block_dim_z,
+	                            VkExtent3D extent, const uint8_t *data, size_t size, bool with_mipmaps);
+
+	/**
+	 * @brief Looks up a cache entry
+	 * @param key The key of the entry
+	 * @param[out] entry The decoded image
+	 * @return True if the entry was found and is valid
+	 */
+	static bool load(uint64_t key, Entry &entry);
+
+	/**
+	 * @brief Stores a cache entry
+	 * @param key The key of the entry
+	 * @param entry The decoded image
+	 * @param decode_time_ms The time it took to decode the image, used to compute the time saved by future hits
+	 */
+	static void store(uint64_t key, const Entry &entry, double decode_time_ms);
+
+  private:
+	static DiskCache disk_cache;
+};
+}        // namespace sg
+}        // namespace vkb
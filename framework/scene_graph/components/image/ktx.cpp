@@ -65,11 +65,11 @@ static ktx_error_code_e KTX_APIENTRY optimal_tiling_callback(int          mip_le
 	return KTX_SUCCESS;
 }
 
-Ktx::Ktx(const std::string &name, const std::vector<uint8_t> &data, ContentType content_type) :
+Ktx::Ktx(const std::string &name, const uint8_t *data, size_t size, ContentType content_type) :
     Image{name}
 {
-	auto data_buffer = reinterpret_cast<const ktx_uint8_t *>(data.data());
-	auto data_size   = static_cast<ktx_size_t>(data.size());
+	auto data_buffer = reinterpret_cast<const ktx_uint8_t *>(data);
+	auto data_size   = static_cast<ktx_size_t>(size);
 
 	ktxTexture *texture;
 	auto        load_ktx_result = ktxTexture_CreateFromMemory(data_buffer,
@@ -33,6 +33,49 @@ std::type_index SubMesh::get_type()
 	return typeid(SubMesh);
 }
 
+void SubMesh::set_shared_vertex_buffer(const std::string &name, std::shared_ptr<core::Buffer> buffer, VkDeviceSize offset)
+{
+	shared_vertex_buffers[name] = std::make_pair(std::move(buffer), offset);
+}
+
+void SubMesh::set_shared_index_buffer(std::shared_ptr<core::Buffer> buffer, VkDeviceSize offset)
+{
+	shared_index_buffer = std::move(buffer);
+	shared_index_offset = offset;
+}
+
+BufferRange SubMesh::get_vertex_buffer_range(const std::string &name) const
+{
+	auto buffer_it = vertex_buffers.find(name);
+	if (buffer_it != vertex_buffers.end())
+	{
+		return {&buffer_it->second, 0};
+	}
+
+	auto shared_buffer_it = shared_vertex_buffers.find(name);
+	if (shared_buffer_it != shared_vertex_buffers.end())
+	{
+		return {shared_buffer_it->second.first.get(), shared_buffer_it->second.second};
+	}
+
+	return {};
+}
+
+BufferRange SubMesh::get_index_buffer_range() const
+{
+	if (index_buffer)
+	{
+		return {index_buffer.get(), index_offset};
+	}
+
+	if (shared_index_buffer)
+	{
+		return {shared_index_buffer.get(), shared_index_offset + index_offset};
+	}
+
+	return {};
+}
+
 void SubMesh::set_attribute(const std::string &attribute_name, const VertexAttribute &attribute)
 {
 	vertex_attributes[attribute_name] = attribute;
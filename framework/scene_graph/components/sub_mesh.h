@@ -43,6 +43,16 @@ struct VertexAttribute
 	std::uint32_t offset = 0;
 };
 
+/**
+ * @brief Range of a buffer holding the vertex or index data of a submesh
+ */
+struct BufferRange
+{
+	const core::Buffer *buffer{nullptr};
+
+	VkDeviceSize offset{0};
+};
+
 class SubMesh : public Component
 {
   public:
@@ -64,6 +74,27 @@ class SubMesh : public Component
 
 	std::unique_ptr<core::Buffer> index_buffer;
 
+	/**
+	 * @brief Sets the range of a buffer shared with other submeshes which holds the data of a vertex attribute,
+	 *        used instead of vertex_buffers when the loader packs geometry into arenas
+	 */
+	void set_shared_vertex_buffer(const std::string &name, std::shared_ptr<core::Buffer> buffer, VkDeviceSize offset);
+
+	/**
+	 * @brief Sets the range of a buffer shared with other submeshes which holds the indices, used instead of index_buffer
+	 */
+	void set_shared_index_buffer(std::shared_ptr<core::Buffer> buffer, VkDeviceSize offset);
+
+	/**
+	 * @return Where the data of a vertex attribute lives, with a null buffer if the submesh has no such attribute
+	 */
+	BufferRange get_vertex_buffer_range(const std::string &name) const;
+
+	/**
+	 * @return Where the indices live, index_offset included, with a null buffer if the submesh is not indexed
+	 */
+	BufferRange get_index_buffer_range() const;
+
 	void set_attribute(const std::string &name, const VertexAttribute &attribute);
 
 	bool get_attribute(const std::string &name, VertexAttribute &attribute) const;
@@ -79,6 +110,12 @@ class SubMesh : public Component
   private:
 	std::unordered_map<std::string, VertexAttribute> vertex_attributes;
 
+	std::unordered_map<std::string, std::pair<std::shared_ptr<core::Buffer>, VkDeviceSize>> shared_vertex_buffers;
+
+	std::shared_ptr<core::Buffer> shared_index_buffer;
+
+	VkDeviceSize shared_index_offset{0};
+
 	const Material *material{nullptr};
 
 	ShaderVariant shader_variant;
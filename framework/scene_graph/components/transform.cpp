@@ -21,6 +21,7 @@
 #include <glm/gtx/matrix_decompose.hpp>
 
 #include "scene_graph/node.h"
+#include "scene_graph/transform_hierarchy.h"
 
 namespace vkb
 {
@@ -95,34 +96,40 @@ glm::mat4 Transform::get_matrix() const
 
 glm::mat4 Transform::get_world_matrix()
 {
-	update_world_transform();
-
-	return world_matrix;
-}
-
-void Transform::invalidate_world_matrix()
-{
-	update_world_matrix = true;
-}
-
-void Transform::update_world_transform()
-{
-	if (!update_world_matrix)
+	if (hierarchy && hierarchy->is_double_buffered())
 	{
-		return;
+		return hierarchy->get_published_world_matrix(hierarchy_index);
 	}
 
-	world_matrix = get_matrix();
+	if (hierarchy && !hierarchy->is_outdated())
+	{
+		return hierarchy->get_world_matrix(hierarchy_index);
+	}
 
 	auto parent = node.get_parent();
 
 	if (parent)
 	{
-		auto &transform = parent->get_component<Transform>();
-		world_matrix    = transform.get_world_matrix() * world_matrix;
+		return parent->get_transform().get_world_matrix() * get_matrix();
 	}
 
-	update_world_matrix = false;
+	return get_matrix();
+}
+
+void Transform::invalidate_world_matrix()
+{
+	if (hierarchy)
+	{
+		hierarchy->invalidate(hierarchy_index);
+	}
+}
+
+void Transform::invalidate_hierarchy()
+{
+	if (hierarchy)
+	{
+		hierarchy->invalidate_structure();
+	}
 }
 
 }        // namespace sg
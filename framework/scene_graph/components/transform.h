@@ -34,6 +34,7 @@ namespace vkb
 namespace sg
 {
 class Node;
+class TransformHierarchy;
 
 class Transform : public Component
 {
@@ -62,15 +63,26 @@ class Transform : public Component
 
 	glm::mat4 get_matrix() const;
 
+	/**
+	 * @brief Returns the world matrix computed by the transform hierarchy of the scene,
+	 *        or computes it from the parents if the transform is not part of an up to date hierarchy
+	 *        If the hierarchy is double buffered, this is the world matrix of the last published frame.
+	 */
 	glm::mat4 get_world_matrix();
 
 	/**
 	 * @brief Marks the world transform invalid if any of
 	 *        the local transform are changed or the parent
 	 *        world transform has changed.
+	 *        The hierarchy propagates it to the children.
 	 */
 	void invalidate_world_matrix();
 
+	/**
+	 * @brief Marks the hierarchy the transform belongs to for a rebuild, after nodes are attached to it
+	 */
+	void invalidate_hierarchy();
+
   private:
 	Node &node;
 
@@ -80,11 +92,12 @@ class Transform : public Component
 
 	glm::vec3 scale = glm::vec3(1.0, 1.0, 1.0);
 
-	glm::mat4 world_matrix = glm::mat4(1.0);
+	/// Set by the hierarchy which stores the world matrix
+	TransformHierarchy *hierarchy{nullptr};
 
-	bool update_world_matrix = false;
+	uint32_t hierarchy_index{0};
 
-	void update_world_transform();
+	friend class TransformHierarchy;
 };
 
 }        // namespace sg
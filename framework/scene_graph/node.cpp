@@ -17,6 +17,9 @@
 
 #include "node.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 #include "component.h"
 #include "components/transform.h"
 
@@ -47,6 +50,10 @@ void Node::set_parent(Node &p)
 	parent = &p;
 
 	transform.invalidate_world_matrix();
+
+	// Both transforms may belong to a hierarchy which has to be laid out again
+	transform.invalidate_hierarchy();
+	p.get_transform().invalidate_hierarchy();
 }
 
 Node *Node::get_parent() const
@@ -57,6 +64,8 @@ Node *Node::get_parent() const
 void Node::add_child(Node &child)
 {
 	children.push_back(&child);
+
+	transform.invalidate_hierarchy();
 }
 
 const std::vector<Node *> &Node::get_children() const
@@ -66,7 +75,9 @@ const std::vector<Node *> &Node::get_children() const
 
 void Node::set_component(Component &component)
 {
-	auto it = components.find(component.get_type());
+	auto type = component.get_type();
+
+	auto it = std::find_if(components.begin(), components.end(), [&type](const auto &entry) { return entry.first == type; });
 
 	if (it != components.end())
 	{
@@ -74,18 +85,26 @@ void Node::set_component(Component &component)
 	}
 	else
 	{
-		components.insert(std::make_pair(component.get_type(), &component));
+		components.emplace_back(type, &component);
 	}
 }
 
 Component &Node::get_component(const std::type_index index)
 {
-	return *components.at(index);
+	for (auto &entry : components)
+	{
+		if (entry.first == index)
+		{
+			return *entry.second;
+		}
+	}
+
+	throw std::out_of_range("Node '" + name + "' has no component of type " + index.name());
 }
 
 bool Node::has_component(const std::type_index index)
 {
-	return components.count(index) > 0;
+	return std::any_of(components.begin(), components.end(), [&index](const auto &entry) { return entry.first == index; });
 }
 
 }        // namespace sg
@@ -21,6 +21,7 @@
 #include <string>
 #include <typeindex>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "scene_graph/components/transform.h"
@@ -58,10 +59,13 @@ class Node
 
 	void set_component(Component &component);
 
+	/**
+	 * @brief Components are stored under their get_type(), so the component found for T is always a T
+	 */
 	template <class T>
 	inline T &get_component()
 	{
-		return dynamic_cast<T &>(get_component(typeid(T)));
+		return static_cast<T &>(get_component(typeid(T)));
 	}
 
 	Component &get_component(const std::type_index index);
@@ -85,7 +89,8 @@ class Node
 
 	std::vector<Node *> children;
 
-	std::unordered_map<std::type_index, Component *> components;
+	/// A node has a handful of components, a linear search is faster than hashing
+	std::vector<std::pair<std::type_index, Component *>> components;
 };
 }        // namespace sg
 }        // namespace vkb
@@ -19,18 +19,26 @@
 
 #include <queue>
 
+#include <ctpl_stl.h>
+
 #include "component.h"
 #include "components/sub_mesh.h"
 #include "node.h"
+#include "script.h"
+#include "scripts/animation.h"
 
 namespace vkb
 {
 namespace sg
 {
+Scene::Scene() = default;
+
 Scene::Scene(const std::string &name) :
     name{name}
 {}
 
+Scene::~Scene() = default;
+
 void Scene::set_name(const std::string &new_name)
 {
 	name = new_name;
@@ -45,11 +53,17 @@ void Scene::set_nodes(std::vector<std::unique_ptr<Node>> &&n)
 {
 	assert(nodes.empty() && "Scene nodes were already set");
 	nodes = std::move(n);
+
+	transform_hierarchy->invalidate_structure();
+	node_names_outdated = true;
 }
 
 void Scene::add_node(std::unique_ptr<Node> &&n)
 {
 	nodes.emplace_back(std::move(n));
+
+	transform_hierarchy->invalidate_structure();
+	node_names_outdated = true;
 }
 
 void Scene::add_child(Node &child)
@@ -100,6 +114,40 @@ bool Scene::has_component(const std::type_index &type_info) const
 }
 
 Node *Scene::find_node(const std::string &node_name)
+{
+	if (node_names_outdated)
+	{
+		node_names.clear();
+		for (auto &node : nodes)
+		{
+			node_names[node->get_name()].push_back(node.get());
+		}
+		node_names_outdated = false;
+	}
+
+	auto it = node_names.find(node_name);
+
+	// Nodes may be attached to the tree without being owned by the scene, and the breadth first search decides
+	// which of several nodes of the same name is found
+	if (it == node_names.end() || it->second.size() > 1)
+	{
+		return search_node(node_name);
+	}
+
+	// Only the descendants of the root can be found
+	auto node = it->second[0];
+	for (auto parent = node->get_parent(); parent; parent = parent->get_parent())
+	{
+		if (parent == root)
+		{
+			return node;
+		}
+	}
+
+	return nullptr;
+}
+
+Node *Scene::search_node(const std::string &node_name)
 {
 	for (auto root_node : root->get_children())
 	{
@@ -135,5 +183,53 @@ Node &Scene::get_root_node()
 {
 	return *root;
 }
+
+void Scene::update_transforms()
+{
+	// Rebuilding renumbers the transforms, which the render thread reads while a double buffered hierarchy updates
+	if (transform_hierarchy->is_outdated() && !transform_hierarchy->is_double_buffered())
+	{
+		transform_hierarchy->build(nodes);
+	}
+
+	transform_hierarchy->update();
+}
+
+void Scene::publish_transforms()
+{
+	if (transform_hierarchy->is_outdated())
+	{
+		transform_hierarchy->build(nodes);
+	}
+
+	transform_hierarchy->publish();
+}
+
+TransformHierarchy &Scene::get_transform_hierarchy()
+{
+	return *transform_hierarchy;
+}
+
+void Scene::set_thread_count(uint32_t thread_count)
+{
+	if (thread_count > 1)
+	{
+		thread_pool = std::make_unique<ctpl::thread_pool>(thread_count);
+	}
+	else
+	{
+		thread_pool.reset();
+	}
+
+	transform_hierarchy->set_thread_pool(thread_pool.get());
+
+	for (auto script : get_component_view<Script>())
+	{
+		if (auto animation = dynamic_cast<Animation *>(script))
+		{
+			animation->set_thread_pool(thread_pool.get());
+		}
+	}
+}
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
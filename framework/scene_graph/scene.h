@@ -26,6 +26,7 @@
 
 #include "scene_graph/components/light.h"
 #include "scene_graph/components/texture.h"
+#include "scene_graph/transform_hierarchy.h"
 
 namespace vkb
 {
@@ -35,15 +36,94 @@ class Node;
 class Component;
 class SubMesh;
 
+/**
+ * @brief A view of the components of a type, iterated without copying them
+ *
+ * The components of a type are stored under their get_type(), which is T or a base of their class,
+ * so they are cast statically. The view is invalidated when components of the type are added or replaced.
+ */
+template <class T>
+class ComponentView
+{
+  public:
+	using Components = std::vector<std::unique_ptr<Component>>;
+
+	class Iterator
+	{
+	  public:
+		explicit Iterator(Components::const_iterator it) :
+		    it{it}
+		{}
+
+		T *operator*() const
+		{
+			return static_cast<T *>(it->get());
+		}
+
+		Iterator &operator++()
+		{
+			++it;
+			return *this;
+		}
+
+		bool operator==(const Iterator &other) const
+		{
+			return it == other.it;
+		}
+
+		bool operator!=(const Iterator &other) const
+		{
+			return it != other.it;
+		}
+
+	  private:
+		Components::const_iterator it;
+	};
+
+	explicit ComponentView(const Components &components) :
+	    components{&components}
+	{}
+
+	Iterator begin() const
+	{
+		return Iterator{components->begin()};
+	}
+
+	Iterator end() const
+	{
+		return Iterator{components->end()};
+	}
+
+	T *operator[](size_t index) const
+	{
+		return static_cast<T *>((*components)[index].get());
+	}
+
+	size_t size() const
+	{
+		return components->size();
+	}
+
+	bool empty() const
+	{
+		return components->empty();
+	}
+
+  private:
+	const Components *components;
+};
+
 /// @brief A collection of nodes organized in a tree structure.
 ///		   It can contain more than one root node.
 class Scene
 {
   public:
-	Scene() = default;
+	Scene();
 
 	Scene(const std::string &name);
 
+	~Scene();
+
 	void set_name(const std::string &name);
 
 	const std::string &get_name() const;
@@ -104,13 +184,25 @@ class Scene
 			result.resize(scene_components.size());
 			std::transform(scene_components.begin(), scene_components.end(), result.begin(),
 			               [](const std::unique_ptr<Component> &component) -> T * {
-				               return dynamic_cast<T *>(component.get());
+				               return static_cast<T *>(component.get());
 			               });
 		}
 
 		return result;
 	}
 
+	/**
+	 * @return View of the components of the given template type, which does not allocate
+	 */
+	template <class T>
+	ComponentView<T> get_component_view() const
+	{
+		static const std::vector<std::unique_ptr<Component>> no_components;
+
+		auto it = components.find(typeid(T));
+		return ComponentView<T>{it != components.end() ? it->second : no_components};
+	}
+
 	/**
 	 * @return List of components for the given type
 	 */
@@ -124,12 +216,37 @@ class Scene
 
 	bool has_component(const std::type_index &type_info) const;
 
+	/**
+	 * @brief Finds a node below the root node by name
+	 *        Names are looked up in an index, the tree is only searched breadth first for names which are missing or not unique.
+	 */
 	Node *find_node(const std::string &name);
 
 	void set_root_node(Node &node);
 
 	Node &get_root_node();
 
+	/**
+	 * @brief Computes the world matrices of the transforms which changed since the last call,
+	 *        rebuilding the transform hierarchy first if nodes were added or reparented
+	 */
+	void update_transforms();
+
+	/**
+	 * @brief Updates the transforms and publishes their world matrices for rendering
+	 *        A double buffered hierarchy is only rebuilt here, where no other thread updates or reads it.
+	 */
+	void publish_transforms();
+
+	TransformHierarchy &get_transform_hierarchy();
+
+	/**
+	 * @brief Updates large transform hierarchies and animations with many channels on a pool of threads
+	 *        Only the animations of the scene at the time of the call use the pool.
+	 * @param thread_count Number of threads, 1 to update everything on the calling thread
+	 */
+	void set_thread_count(uint32_t thread_count);
+
   private:
 	std::string name;
 
@@ -138,7 +255,19 @@ class Scene
 
 	Node *root{nullptr};
 
+	/// Nodes by name, rebuilt on the next lookup after nodes are added
+	std::unordered_map<std::string, std::vector<Node *>> node_names;
+
+	bool node_names_outdated{true};
+
+	Node *search_node(const std::string &name);
+
 	std::unordered_map<std::type_index, std::vector<std::unique_ptr<Component>>> components;
+
+	std::unique_ptr<TransformHierarchy> transform_hierarchy{std::make_unique<TransformHierarchy>()};
+
+	/// Shared by the transform hierarchy and the animations
+	std::unique_ptr<ctpl::thread_pool> thread_pool;
 };
 }        // namespace sg
 }        // namespace vkb
\ No newline at end of file
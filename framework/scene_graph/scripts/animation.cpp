@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2023, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,25 +17,70 @@
 
 #include "animation.h"
 
+#include "common/helpers.h"
+#include "core/util/logging.hpp"
 #include "scene_graph/node.h"
 
 namespace vkb
 {
 namespace sg
 {
+namespace
+{
+inline glm::quat to_quat(const glm::vec4 &value)
+{
+	glm::quat q;
+	q.x = value.x;
+	q.y = value.y;
+	q.z = value.z;
+	q.w = value.w;
+
+	return q;
+}
+
+inline geometry::Interpolation to_interpolation(AnimationType type)
+{
+	switch (type)
+	{
+		case AnimationType::Step:
+			return geometry::Interpolation::Step;
+		case AnimationType::CubicSpline:
+			return geometry::Interpolation::CubicSpline;
+		default:
+			return geometry::Interpolation::Linear;
+	}
+}
+}        // namespace
+
 Animation::Animation(const std::string &name) :
     Script{name}
 {
 }
 
 Animation::Animation(const Animation &other) :
-    channels{other.channels}
+    channels{other.channels},
+    channel_nodes{other.channel_nodes},
+    channel_targets{other.channel_targets}
 {
 }
 
+Animation::~Animation() = default;
+
 void Animation::add_channel(Node &node, const AnimationTarget &target, const AnimationSampler &sampler)
 {
-	channels.push_back({node, target, sampler});
+	if (!channels.add(to_interpolation(sampler.type), target == Rotation, sampler.inputs, sampler.outputs))
+	{
+		LOGW("Animation channel of node '{}' has fewer outputs than keyframes", node.get_name());
+		return;
+	}
+
+	channel_nodes.push_back(&node);
+	channel_targets.push_back(target);
+}
+
+void Animation::set_thread_pool(ctpl::thread_pool *thread_pool_)
+{
+	thread_pool = thread_pool_;
 }
 
 void Animation::update(float delta_time)
@@ -46,120 +91,39 @@ void Animation::update(float delta_time)
 		current_time -= end_time;
 	}
 
-	for (auto &channel : channels)
+	channels.evaluate(current_time, thread_pool);
+
+	apply_channels();
+}
+
+void Animation::apply_channels()
+{
+	for (size_t c = 0; c < channel_nodes.size(); ++c)
 	{
-		for (size_t i = 0; i < channel.sampler.inputs.size() - 1; ++i)
+		if (!channels.is_active(c))
+		{
+			continue;
+		}
+
+		auto &transform = channel_nodes[c]->get_transform();
+		auto &value     = channels.get_value(c);
+
+		switch (channel_targets[c])
 		{
-			if ((current_time >= channel.sampler.inputs[i]) && (current_time <= channel.sampler.inputs[i + 1]))
+			case Translation:
+			{
+				transform.set_translation(glm::vec3(value));
+				break;
+			}
+			case Rotation:
+			{
+				transform.set_rotation(to_quat(value));
+				break;
+			}
+			case Scale:
 			{
-				float time = (current_time - channel.sampler.inputs[i]) / (channel.sampler.inputs[i + 1] - channel.sampler.inputs[i]);
-
-				auto &transform = channel.node.get_transform();
-
-				if (channel.sampler.type == AnimationType::Linear)
-				{
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(glm::mix(channel.sampler.outputs[i],
-							                                             channel.sampler.outputs[i + 1],
-							                                             time)));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = channel.sampler.outputs[i].x;
-							q1.y = channel.sampler.outputs[i].y;
-							q1.z = channel.sampler.outputs[i].z;
-							q1.w = channel.sampler.outputs[i].w;
-
-							glm::quat q2;
-							q2.x = channel.sampler.outputs[i + 1].x;
-							q2.y = channel.sampler.outputs[i + 1].y;
-							q2.z = channel.sampler.outputs[i + 1].z;
-							q2.w = channel.sampler.outputs[i + 1].w;
-
-							transform.set_rotation(glm::normalize(glm::slerp(q1, q2, time)));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(glm::mix(channel.sampler.outputs[i],
-							                                       channel.sampler.outputs[i + 1],
-							                                       time)));
-						}
-					}
-				}
-				else if (channel.sampler.type == AnimationType::Step)
-				{
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(channel.sampler.outputs[i]));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = channel.sampler.outputs[i].x;
-							q1.y = channel.sampler.outputs[i].y;
-							q1.z = channel.sampler.outputs[i].z;
-							q1.w = channel.sampler.outputs[i].w;
-
-							transform.set_rotation(glm::normalize(q1));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(channel.sampler.outputs[i]));
-						}
-					}
-				}
-				else if (channel.sampler.type == AnimationType::CubicSpline)
-				{
-					float delta = channel.sampler.inputs[i + 1] - channel.sampler.inputs[i];
-
-					glm::vec4 p0 = channel.sampler.outputs[i * 3 + 1];              // Starting point
-					glm::vec4 p1 = channel.sampler.outputs[(i + 1) * 3 + 1];        // Ending point
-
-					glm::vec4 m0 = delta * channel.sampler.outputs[i * 3 + 2];              // Delta time * out tangent
-					glm::vec4 m1 = delta * channel.sampler.outputs[(i + 1) * 3 + 0];        // Delta time * in tangent of next point
-
-					// This equation is taken from the GLTF 2.0 specification Appendix C (https://github.com/KhronosGroup/glTF/tree/main/specification/2.0#appendix-c-spline-interpolation)
-					glm::vec4 result = (2.0f * glm::pow(time, 3.0f) - 3.0f * glm::pow(time, 2.0f) + 1.0f) * p0 + (glm::pow(time, 3.0f) - 2.0f * glm::pow(time, 2.0f) + time) * m0 + (-2.0f * glm::pow(time, 3.0f) + 3.0f * glm::pow(time, 2.0f)) * p1 + (glm::pow(time, 3.0f) - glm::pow(time, 2.0f)) * m1;
-
-					auto &transform = channel.node.get_transform();
-
-					switch (channel.target)
-					{
-						case Translation:
-						{
-							transform.set_translation(glm::vec3(result));
-							break;
-						}
-						case Rotation:
-						{
-							glm::quat q1;
-							q1.x = result.x;
-							q1.y = result.y;
-							q1.z = result.z;
-							q1.w = result.w;
-
-							transform.set_rotation(glm::normalize(q1));
-							break;
-						}
-
-						case Scale:
-						{
-							transform.set_scale(glm::vec3(result));
-						}
-					}
-				}
+				transform.set_scale(glm::vec3(value));
+				break;
 			}
 		}
 	}
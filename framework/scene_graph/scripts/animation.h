@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2024, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -23,6 +23,7 @@
 #include <typeinfo>
 #include <vector>
 
+#include "geometry/animation.hpp"
 #include "scene_graph/components/transform.h"
 #include "scene_graph/script.h"
 
@@ -53,15 +54,12 @@ struct AnimationSampler
 	std::vector<glm::vec4> outputs{};
 };
 
-struct AnimationChannel
-{
-	Node &node;
-
-	AnimationTarget target;
-
-	AnimationSampler sampler;
-};
-
+/**
+ * @brief Plays the channels of a glTF animation
+ *
+ * All the channels are evaluated first by vkb::geometry::AnimationChannels, in parallel if a thread pool was set,
+ * then applied to the transforms.
+ */
 class Animation : public Script
 {
   public:
@@ -69,20 +67,37 @@ class Animation : public Script
 
 	Animation(const Animation &);
 
+	~Animation();
+
 	virtual void update(float delta_time) override;
 
 	void update_times(float start_time, float end_time);
 
 	void add_channel(Node &node, const AnimationTarget &target, const AnimationSampler &sampler);
 
+	/**
+	 * @brief Evaluates the channels on the threads of a pool
+	 * @param thread_pool The pool, which must outlive the animation, or null to evaluate on the calling thread only
+	 */
+	void set_thread_pool(ctpl::thread_pool *thread_pool);
+
   private:
-	std::vector<AnimationChannel> channels;
+	geometry::AnimationChannels channels;
+
+	// Targets of the channels, indexed like the channels
+	std::vector<Node *> channel_nodes;
+
+	std::vector<AnimationTarget> channel_targets;
+
+	ctpl::thread_pool *thread_pool{nullptr};
 
 	float current_time{0.0f};
 
 	float start_time{std::numeric_limits<float>::max()};
 
 	float end_time{std::numeric_limits<float>::min()};
+
+	void apply_channels();
 };
 }        // namespace sg
 }        // namespace vkb
@@ -0,0 +1,230 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transform_hierarchy.h"
+
+#include <algorithm>
+#include <future>
+
+#include <ctpl_stl.h>
+
+#include "common/helpers.h"
+#include "node.h"
+#include "scene_graph/components/transform.h"
+
+namespace vkb
+{
+namespace sg
+{
+TransformHierarchy::TransformHierarchy() = default;
+
+TransformHierarchy::~TransformHierarchy() = default;
+
+void TransformHierarchy::build(const std::vector<std::unique_ptr<Node>> &nodes)
+{
+	transforms.clear();
+	parents.clear();
+	level_offsets.clear();
+
+	// Nodes which are not reachable from a root anymore fall back to walking up their parents
+	for (auto &node : nodes)
+	{
+		node->get_transform().hierarchy = nullptr;
+	}
+
+	for (auto &node : nodes)
+	{
+		if (!node->get_parent())
+		{
+			transforms.push_back(&node->get_transform());
+			parents.push_back(-1);
+		}
+	}
+
+	// Append the children of each level after it, which keeps parents before their children
+	size_t level_begin = 0;
+	while (level_begin < transforms.size())
+	{
+		size_t level_end = transforms.size();
+		level_offsets.push_back(to_u32(level_begin));
+
+		for (size_t i = level_begin; i < level_end; ++i)
+		{
+			for (auto child : transforms[i]->get_node().get_children())
+			{
+				transforms.push_back(&child->get_transform());
+				parents.push_back(static_cast<int32_t>(i));
+			}
+		}
+
+		level_begin = level_end;
+	}
+
+	level_offsets.push_back(to_u32(transforms.size()));
+
+	for (size_t i = 0; i < transforms.size(); ++i)
+	{
+		transforms[i]->hierarchy       = this;
+		transforms[i]->hierarchy_index = to_u32(i);
+	}
+
+	world_matrices.assign(transforms.size(), glm::mat4(1.0f));
+	dirty.assign(transforms.size(), 1);
+	unpublished.assign(transforms.size(), 0);
+
+	has_dirty = !transforms.empty();
+	outdated  = false;
+}
+
+void TransformHierarchy::update()
+{
+	if (outdated || !has_dirty)
+	{
+		return;
+	}
+
+	for (size_t level = 0; level + 1 < level_offsets.size(); ++level)
+	{
+		uint32_t begin = level_offsets[level];
+		uint32_t end   = level_offsets[level + 1];
+
+		if (!thread_pool || end - begin < PARALLEL_LEVEL_SIZE)
+		{
+			update_range(begin, end);
+			continue;
+		}
+
+		// The transforms of a level only read the previous levels, so they can be computed in any order
+		uint32_t chunk_count = to_u32(thread_pool->size());
+		uint32_t chunk_size  = (end - begin + chunk_count - 1) / chunk_count;
+
+		std::vector<std::future<void>> futures;
+		for (uint32_t chunk_begin = begin; chunk_begin < end; chunk_begin += chunk_size)
+		{
+			uint32_t chunk_end = std::min(chunk_begin + chunk_size, end);
+			futures.push_back(thread_pool->push([this, chunk_begin, chunk_end](size_t) { update_range(chunk_begin, chunk_end); }));
+		}
+
+		for (auto &future : futures)
+		{
+			future.get();
+		}
+	}
+
+	std::fill(dirty.begin(), dirty.end(), 0);
+	has_dirty       = false;
+	has_unpublished = true;
+}
+
+void TransformHierarchy::set_thread_pool(ctpl::thread_pool *thread_pool_)
+{
+	thread_pool = thread_pool_;
+}
+
+void TransformHierarchy::invalidate(uint32_t index)
+{
+	dirty[index] = 1;
+	has_dirty    = true;
+}
+
+void TransformHierarchy::invalidate_structure()
+{
+	outdated = true;
+}
+
+bool TransformHierarchy::is_outdated() const
+{
+	return outdated;
+}
+
+const glm::mat4 &TransformHierarchy::get_world_matrix(uint32_t index)
+{
+	update();
+
+	return world_matrices[index];
+}
+
+void TransformHierarchy::set_double_buffered(bool enable)
+{
+	double_buffered = enable;
+}
+
+bool TransformHierarchy::is_double_buffered() const
+{
+	return double_buffered;
+}
+
+void TransformHierarchy::publish()
+{
+	update();
+
+	// A rebuilt hierarchy has updated all of its world matrices, so they are all unpublished
+	published_world_matrices.resize(world_matrices.size());
+
+	if (!has_unpublished)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < world_matrices.size(); ++i)
+	{
+		if (unpublished[i])
+		{
+			published_world_matrices[i] = world_matrices[i];
+			unpublished[i]              = 0;
+		}
+	}
+
+	has_unpublished = false;
+}
+
+const glm::mat4 &TransformHierarchy::get_published_world_matrix(uint32_t index) const
+{
+	return published_world_matrices[index];
+}
+
+size_t TransformHierarchy::size() const
+{
+	return transforms.size();
+}
+
+void TransformHierarchy::update_range(uint32_t begin, uint32_t end)
+{
+	for (uint32_t i = begin; i < end; ++i)
+	{
+		int32_t parent = parents[i];
+
+		if (parent >= 0 && dirty[parent])
+		{
+			dirty[i] = 1;
+		}
+
+		if (dirty[i])
+		{
+			unpublished[i] = 1;
+
+			world_matrices[i] = transforms[i]->get_matrix();
+
+			if (parent >= 0)
+			{
+				world_matrices[i] = world_matrices[parent] * world_matrices[i];
+			}
+		}
+	}
+}
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,153 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/glm_common.h"
+
+namespace ctpl
+{
+class thread_pool;
+}
+
+namespace vkb
+{
+namespace sg
+{
+class Node;
+class Transform;
+
+/**
+ * @brief The world matrices of the transforms of a scene, stored contiguously in breadth-first order
+ *
+ * Parents always come before their children and the nodes of a depth level are contiguous,
+ * so that update() computes all the world matrices in one linear pass, one level at a time.
+ * A transform which changes marks itself dirty, and the pass propagates it to all its descendants.
+ *
+ * Adding or reparenting a node marks the hierarchy outdated, it is then rebuilt by the scene before the next update.
+ * Transforms of an outdated hierarchy compute their world matrix by walking up their parents.
+ *
+ * A double buffered hierarchy lets the next frame update while the current one is rendered:
+ * transforms then return the world matrices of the last publish(), and update() writes to a separate copy.
+ * publish() only copies the world matrices which update() changed since the previous publish().
+ */
+class TransformHierarchy
+{
+  public:
+	/// Depth levels with fewer nodes are updated on the calling thread
+	static constexpr size_t PARALLEL_LEVEL_SIZE = 4096;
+
+	TransformHierarchy();
+
+	~TransformHierarchy();
+
+	TransformHierarchy(const TransformHierarchy &) = delete;
+
+	TransformHierarchy(TransformHierarchy &&) = delete;
+
+	TransformHierarchy &operator=(const TransformHierarchy &) = delete;
+
+	TransformHierarchy &operator=(TransformHierarchy &&) = delete;
+
+	/**
+	 * @brief Lays out the transforms of the nodes, which are all marked dirty
+	 * @param nodes All the nodes of the scene, the nodes without parent are the roots
+	 */
+	void build(const std::vector<std::unique_ptr<Node>> &nodes);
+
+	/**
+	 * @brief Computes the world matrices of the dirty transforms and of their descendants
+	 */
+	void update();
+
+	/**
+	 * @brief Splits the large depth levels across the threads of a pool in update()
+	 * @param thread_pool The pool, which must outlive the hierarchy, or null to update on the calling thread only
+	 */
+	void set_thread_pool(ctpl::thread_pool *thread_pool);
+
+	void invalidate(uint32_t index);
+
+	/**
+	 * @brief Requests a rebuild, after nodes have been added or reparented
+	 */
+	void invalidate_structure();
+
+	bool is_outdated() const;
+
+	/**
+	 * @brief Returns the world matrix of a transform, updating the hierarchy first if a transform changed
+	 */
+	const glm::mat4 &get_world_matrix(uint32_t index);
+
+	/**
+	 * @brief Makes transforms read the published world matrices, so that they can be updated on another thread
+	 */
+	void set_double_buffered(bool enable);
+
+	bool is_double_buffered() const;
+
+	/**
+	 * @brief Copies the world matrices changed by update() since the last publish to the ones read by the transforms
+	 *        Must not run concurrently with update() or with readers of the published matrices.
+	 */
+	void publish();
+
+	/**
+	 * @brief Returns the world matrix of a transform as of the last publish(), without updating the hierarchy
+	 */
+	const glm::mat4 &get_published_world_matrix(uint32_t index) const;
+
+	size_t size() const;
+
+  private:
+	std::vector<Transform *> transforms;
+
+	/// Index of the parent of each transform, -1 for roots
+	std::vector<int32_t> parents;
+
+	std::vector<glm::mat4> world_matrices;
+
+	/// Copy of the world matrices read while the next ones are updated, when double buffered
+	std::vector<glm::mat4> published_world_matrices;
+
+	/// Set for the transforms which changed, and during update() for their descendants
+	std::vector<uint8_t> dirty;
+
+	/// Set for the world matrices which update() changed since the last publish()
+	std::vector<uint8_t> unpublished;
+
+	/// Index of the first transform of each depth level, followed by the size of the hierarchy
+	std::vector<uint32_t> level_offsets;
+
+	bool has_dirty{false};
+
+	bool has_unpublished{false};
+
+	bool outdated{true};
+
+	bool double_buffered{false};
+
+	ctpl::thread_pool *thread_pool{nullptr};
+
+	void update_range(uint32_t begin, uint32_t end);
+};
+}        // namespace sg
+}        // namespace vkb
@@ -0,0 +1,220 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "shader_cache.h"
+
+#include "common/helpers.h"
+#include "common/strings.h"
+#include "core/util/strings.hpp"
+#include "filesystem/legacy.h"
+#include "glsl_compiler.h"
+
+namespace vkb
+{
+namespace
+{
+constexpr uint32_t CACHE_ENTRY_MAGIC   = 0x43535356;        // "VSSC"
+constexpr uint32_t CACHE_ENTRY_VERSION = 2;
+
+/**
+ * @brief Appends the contents of files included with a directive that precompile_shader leaves for glslang to resolve
+ *        (e.g. indented or angle-bracket includes) to the key, so that editing them also invalidates the entry
+ */
+inline void write_unresolved_includes(std::ostringstream &os, const std::string &source)
+{
+	for (auto &line : split(source, '\n'))
+	{
+		auto directive = trim_left(line, " \t");
+		if (directive.find("#include") != 0)
+		{
+			continue;
+		}
+
+		auto begin = directive.find_first_of("\"<");
+		auto end   = directive.find_last_of("\">");
+		if (begin == std::string::npos || end == std::string::npos || end <= begin)
+		{
+			continue;
+		}
+
+		auto include_path = directive.substr(begin + 1, end - begin - 1);
+		write(os, include_path);
+
+		try
+		{
+			write(os, fs::read_shader(include_path));
+		}
+		catch (const std::exception &)
+		{
+			// Missing includes will fail compilation, no need to key anything else
+		}
+	}
+}
+
+inline void write_resources(std::ostringstream &os, const std::vector<ShaderResource> &resources)
+{
+	write(os, resources.size());
+	for (auto &resource : resources)
+	{
+		write(os,
+		      resource.stages,
+		      resource.type,
+		      resource.mode,
+		      resource.set,
+		      resource.binding,
+		      resource.location,
+		      resource.input_attachment_index,
+		      resource.vec_size,
+		      resource.columns,
+		      resource.array_size,
+		      resource.offset,
+		      resource.size,
+		      resource.constant_id,
+		      resource.qualifiers,
+		      resource.name);
+	}
+}
+
+inline void read_resources(std::istringstream &is, std::vector<ShaderResource> &resources)
+{
+	std::size_t count{0};
+	read(is, count);
+
+	// Every resource takes at least the size of its name, bound the count before allocating for it
+	if (!is.good() || count > stream_remaining(is) / sizeof(std::size_t))
+	{
+		is.setstate(std::ios::failbit);
+		return;
+	}
+
+	resources.resize(count);
+	for (auto &resource : resources)
+	{
+		read(is,
+		     resource.stages,
+		     resource.type,
+		     resource.mode,
+		     resource.set,
+		     resource.binding,
+		     resource.location,
+		     resource.input_attachment_index,
+		     resource.vec_size,
+		     resource.columns,
+		     resource.array_size,
+		     resource.offset,
+		     resource.size,
+		     resource.constant_id,
+		     resource.qualifiers,
+		     resource.name);
+	}
+}
+
+/**
+ * @brief Hashes a key into the name of its entry file
+ */
+inline uint64_t hash_key(const std::string &key)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	fnv1a(hash, key);
+	return hash;
+}
+}        // namespace
+
+DiskCache ShaderCache::disk_cache{"Shader", "spvcache", CACHE_ENTRY_MAGIC, CACHE_ENTRY_VERSION};
+
+DiskCache &ShaderCache::get_disk_cache()
+{
+	return disk_cache;
+}
+
+bool ShaderCache::is_enabled()
+{
+	return disk_cache.is_enabled();
+}
+
+std::string ShaderCache::compute_key(VkShaderStageFlagBits stage, const std::vector<uint8_t> &glsl_source, const std::string &entry_point, const ShaderVariant &shader_variant)
+{
+	std::ostringstream os;
+
+	write(os, CACHE_ENTRY_VERSION, stage, entry_point);
+	write(os, GLSLCompiler::get_target_language(), GLSLCompiler::get_target_language_version());
+
+	write(os, shader_variant.get_preamble());
+	write(os, shader_variant.get_processes().size());
+	for (auto &process : shader_variant.get_processes())
+	{
+		write(os, process);
+	}
+
+	// Runtime array sizes affect reflection, sort them since they live in an unordered map
+	std::map<std::string, size_t> runtime_array_sizes{shader_variant.get_runtime_array_sizes().begin(),
+	                                                  shader_variant.get_runtime_array_sizes().end()};
+	write(os, runtime_array_sizes);
+
+	std::string source{glsl_source.begin(), glsl_source.end()};
+	write(os, source);
+	write_unresolved_includes(os, source);
+
+	return os.str();
+}
+
+bool ShaderCache::load(const std::string &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources, std::string &info_log)
+{
+	std::vector<uint32_t>       entry_spirv;
+	std::vector<ShaderResource> entry_resources;
+	std::string                 entry_info_log;
+
+	bool found = disk_cache.load(hash_key(key), [&](std::istringstream &is) {
+		// Entries whose key only shares the hash are rejected
+		std::string entry_key;
+		read(is, entry_key);
+		if (is.fail() || entry_key != key)
+		{
+			return false;
+		}
+
+		read(is, entry_spirv);
+		read_resources(is, entry_resources);
+		read(is, entry_info_log);
+
+		return !is.fail() && !entry_spirv.empty();
+	});
+
+	if (!found)
+	{
+		return false;
+	}
+
+	spirv     = std::move(entry_spirv);
+	resources = std::move(entry_resources);
+	info_log  = std::move(entry_info_log);
+
+	return true;
+}
+
+void ShaderCache::store(const std::string &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources, const std::string &info_log, double compile_time_ms)
+{
+	disk_cache.store(
+	    hash_key(key), [&](std::ostringstream &os) {
+		    write(os, key);
+		    write(os, spirv);
+		    write_resources(os, resources);
+		    write(os, info_log);
+	    },
+	    compile_time_ms);
+}
+}        // namespace vkb
@@ -0,0 +1,87 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/shader_module.h"
+#include "disk_cache.h"
+
+namespace vkb
+{
+/**
+ * @brief Persistent, content-addressed cache of compiled SPIR-V and its reflection data
+ *
+ * Entries are keyed by everything that influences the output of GLSLCompiler and SPIRVReflection:
+ * the expanded shader source (with all includes resolved), the shader variant preamble, processes and
+ * runtime array sizes, the stage, the entry point and the glslang target environment.
+ * As included files are part of the expanded source, editing any of them yields a new key, so stale
+ * entries are never returned.
+ *
+ * The cache is disabled by default, call enable() on get_disk_cache() to start using it.
+ */
+class ShaderCache
+{
+  public:
+	/**
+	 * @brief Returns the disk cache that stores the entries, which controls whether the cache is enabled and keeps its stats
+	 */
+	static DiskCache &get_disk_cache();
+
+	static bool is_enabled();
+
+	/**
+	 * @brief Computes the cache key of a shader
+	 *        The key holds all of the inputs rather than a hash of them, so that an entry is only returned for the exact same inputs.
+	 * @param stage The Vulkan shader stage flag
+	 * @param glsl_source The GLSL source with all includes resolved
+	 * @param entry_point The entrypoint function name of the shader stage
+	 * @param shader_variant The shader variant
+	 */
+	static std::string compute_key(VkShaderStageFlagBits       stage,
+	                               const std::vector<uint8_t> &glsl_source,
+	                               const std::string          &entry_point,
+	                               const ShaderVariant        &shader_variant);
+
+	/**
+	 * @brief Looks up a cache entry
+	 *        Entries are found by a hash of the key, and only returned if the key stored in them is the same.
+	 * @param key The key of the entry
+	 * @param[out] spirv The cached SPIRV code
+	 * @param[out] resources The cached reflected shader resources
+	 * @param[out] info_log The cached compilation log
+	 * @return True if the entry was found and is valid
+	 */
+	static bool load(const std::string &key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources, std::string &info_log);
+
+	/**
+	 * @brief Stores a cache entry
+	 * @param key The key of the entry
+	 * @param spirv The compiled SPIRV code
+	 * @param resources The reflected shader resources
+	 * @param info_log The compilation log
+	 * @param compile_time_ms The time it took to compile and reflect the shader, used to compute the time saved by future hits
+	 */
+	static void store(const std::string &key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources, const std::string &info_log, double compile_time_ms);
+
+  private:
+	static DiskCache disk_cache;
+};
+}        // namespace vkb
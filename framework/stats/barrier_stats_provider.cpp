@@ -0,0 +1,69 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "barrier_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+BarrierStatsProvider::BarrierStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context(render_context)
+{
+	for (auto index : {StatIndex::barriers, StatIndex::barrier_calls})
+	{
+		if (requested_stats.erase(index) > 0)
+		{
+			stat_indices.insert(index);
+		}
+	}
+}
+
+bool BarrierStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.find(index) != stat_indices.end();
+}
+
+StatsProvider::Counters BarrierStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	auto &counters = render_context.get_barrier_counters();
+
+	// The barriers accumulate over all the frames rendered since the last sample
+	uint32_t barriers      = counters.barriers.exchange(0);
+	uint32_t barrier_calls = counters.barrier_calls.exchange(0);
+
+	if (is_available(StatIndex::barriers))
+	{
+		res[StatIndex::barriers].result = barriers;
+	}
+
+	if (is_available(StatIndex::barrier_calls))
+	{
+		res[StatIndex::barrier_calls].result = barrier_calls;
+	}
+
+	return res;
+}
+
+StatsProvider::Counters BarrierStatsProvider::continuous_sample(float delta_time)
+{
+	// The counters are atomics, so the sampling thread can read them back while the frames are recorded
+	return sample(delta_time);
+}
+}        // namespace vkb
@@ -0,0 +1,63 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "culling_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+CullingStatsProvider::CullingStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context(render_context)
+{
+	for (auto index : {StatIndex::drawn_submeshes, StatIndex::culled_submeshes})
+	{
+		if (requested_stats.erase(index) > 0)
+		{
+			stat_indices.insert(index);
+		}
+	}
+}
+
+bool CullingStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.find(index) != stat_indices.end();
+}
+
+StatsProvider::Counters CullingStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	// The counters accumulate over all the frames rendered since the last sample
+	auto &counters = render_context.get_culling_counters();
+
+	uint32_t drawn_submeshes  = counters.drawn_submeshes.exchange(0);
+	uint32_t culled_submeshes = counters.culled_submeshes.exchange(0);
+
+	if (is_available(StatIndex::drawn_submeshes))
+	{
+		res[StatIndex::drawn_submeshes].result = drawn_submeshes;
+	}
+
+	if (is_available(StatIndex::culled_submeshes))
+	{
+		res[StatIndex::culled_submeshes].result = culled_submeshes;
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,80 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "descriptor_cache_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+DescriptorCacheStatsProvider::DescriptorCacheStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context(render_context)
+{
+	for (auto index : {StatIndex::descriptor_sets_created, StatIndex::descriptor_sets_reused, StatIndex::descriptor_sets_retired})
+	{
+		if (requested_stats.erase(index) > 0)
+		{
+			stat_indices.insert(index);
+		}
+	}
+}
+
+bool DescriptorCacheStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.find(index) != stat_indices.end();
+}
+
+StatsProvider::Counters DescriptorCacheStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	auto &frames = render_context.get_render_frames();
+	if (frames.empty())
+	{
+		return res;
+	}
+
+	// All the frames share the same cache, which only exists with DescriptorManagementStrategy::CacheAcrossFrames
+	auto descriptor_cache = frames.front()->get_descriptor_cache();
+	if (!descriptor_cache)
+	{
+		return res;
+	}
+
+	// The cache statistics are cumulative, report what changed since the last sample
+	auto stats = descriptor_cache->get_stats();
+
+	if (is_available(StatIndex::descriptor_sets_created))
+	{
+		res[StatIndex::descriptor_sets_created].result = static_cast<double>(stats.created - previous_stats.created);
+	}
+
+	if (is_available(StatIndex::descriptor_sets_reused))
+	{
+		res[StatIndex::descriptor_sets_reused].result = static_cast<double>(stats.reused - previous_stats.reused);
+	}
+
+	if (is_available(StatIndex::descriptor_sets_retired))
+	{
+		res[StatIndex::descriptor_sets_retired].result = static_cast<double>(stats.retired - previous_stats.retired);
+	}
+
+	previous_stats = stats;
+
+	return res;
+}
+}        // namespace vkb
@@ -0,0 +1,67 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "frame_phase_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+FramePhaseStatsProvider::FramePhaseStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context(render_context)
+{
+	for (auto index : {StatIndex::frame_update_time, StatIndex::frame_update_wait_time, StatIndex::frame_acquire_time,
+	                   StatIndex::frame_record_time, StatIndex::frame_submit_time, StatIndex::frame_present_time})
+	{
+		if (requested_stats.erase(index) > 0)
+		{
+			stat_indices.insert(index);
+		}
+	}
+}
+
+bool FramePhaseStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.find(index) != stat_indices.end();
+}
+
+StatsProvider::Counters FramePhaseStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	// Unlike the culling counters, these are the durations of the last frame and not accumulated
+	auto &timings = render_context.get_frame_phase_timings();
+
+	const std::pair<StatIndex, const std::atomic<float> *> phases[] = {
+	    {StatIndex::frame_update_time, &timings.update},
+	    {StatIndex::frame_update_wait_time, &timings.update_wait},
+	    {StatIndex::frame_acquire_time, &timings.acquire},
+	    {StatIndex::frame_record_time, &timings.record},
+	    {StatIndex::frame_submit_time, &timings.submit},
+	    {StatIndex::frame_present_time, &timings.present}};
+
+	for (auto &phase : phases)
+	{
+		if (is_available(phase.first))
+		{
+			res[phase.first].result = phase.second->load();
+		}
+	}
+
+	return res;
+}
+}        // namespace vkb
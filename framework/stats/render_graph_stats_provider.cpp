@@ -0,0 +1,54 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render_graph_stats_provider.h"
+
+#include "rendering/render_context.h"
+
+namespace vkb
+{
+RenderGraphStatsProvider::RenderGraphStatsProvider(std::set<StatIndex> &requested_stats, RenderContext &render_context) :
+    render_context(render_context)
+{
+	if (requested_stats.erase(StatIndex::render_graph_memory_saved) > 0)
+	{
+		stat_indices.insert(StatIndex::render_graph_memory_saved);
+	}
+}
+
+bool RenderGraphStatsProvider::is_available(StatIndex index) const
+{
+	return stat_indices.find(index) != stat_indices.end();
+}
+
+StatsProvider::Counters RenderGraphStatsProvider::sample(float delta_time)
+{
+	Counters res;
+
+	auto &counters = render_context.get_render_graph_counters();
+
+	if (is_available(StatIndex::render_graph_memory_saved))
+	{
+		uint64_t attachment_memory = counters.attachment_memory.load();
+		uint64_t allocated_memory  = counters.allocated_memory.load();
+
+		res[StatIndex::render_graph_memory_saved].result = static_cast<double>(attachment_memory > allocated_memory ? attachment_memory - allocated_memory : 0);
+	}
+
+	return res;
+}
+}        // namespace vkb
@@ -19,10 +19,15 @@
 #include "stats/stats.h"
 #include "core/device.h"
 
+#include "barrier_stats_provider.h"
+#include "culling_stats_provider.h"
+#include "descriptor_cache_stats_provider.h"
+#include "frame_phase_stats_provider.h"
 #include "frame_time_stats_provider.h"
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 #	include "hwcpipe_stats_provider.h"
 #endif
+#include "render_graph_stats_provider.h"
 #include "vulkan_stats_provider.h"
 
 namespace vkb
@@ -65,6 +70,11 @@ void Stats::request_stats(const std::set<StatIndex> &wanted_stats,
 	// All supported stats will be removed from the given 'stats' set by the provider's constructor
 	// so subsequent providers only see requests for stats that aren't already supported.
 	providers.emplace_back(std::make_unique<FrameTimeStatsProvider>(stats));
+	providers.emplace_back(std::make_unique<CullingStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<DescriptorCacheStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<FramePhaseStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<RenderGraphStatsProvider>(stats, render_context));
+	providers.emplace_back(std::make_unique<BarrierStatsProvider>(stats, render_context));
 #ifdef VK_USE_PLATFORM_ANDROID_KHR
 	providers.emplace_back(std::make_unique<HWCPipeStatsProvider>(stats));
 #endif
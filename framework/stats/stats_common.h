@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <string>
 
@@ -63,6 +64,20 @@ enum class StatIndex
 	gpu_ext_read_bytes,
 	gpu_ext_write_bytes,
 	gpu_tex_cycles,
+	drawn_submeshes,
+	culled_submeshes,
+	descriptor_sets_created,
+	descriptor_sets_reused,
+	descriptor_sets_retired,
+	frame_update_time,
+	frame_update_wait_time,
+	frame_acquire_time,
+	frame_record_time,
+	frame_submit_time,
+	frame_present_time,
+	render_graph_memory_saved,
+	barriers,
+	barrier_calls,
 };
 
 struct StatIndexHash
@@ -107,6 +122,64 @@ struct CounterSamplingConfig
 	float speed{0.5f};
 };
 
+/**
+ * @brief Per-frame counters written by the render pipeline while culling and read back by the stats
+ */
+struct CullingCounters
+{
+	std::atomic<uint32_t> drawn_submeshes{0};
+
+	std::atomic<uint32_t> culled_submeshes{0};
+};
+
+/**
+ * @brief Durations in milliseconds of the phases of the last frame, written by the sample and the render context
+ *        The update overlaps the other phases when the sample pipelines its frames.
+ */
+struct FramePhaseTimings
+{
+	/// Scripts, animations and transforms
+	std::atomic<float> update{0.0f};
+
+	/// Time the main thread spent on the update, only the part which did not overlap the previous frame if pipelined
+	std::atomic<float> update_wait{0.0f};
+
+	/// Acquisition of the swapchain image and wait for the resources of the frame
+	std::atomic<float> acquire{0.0f};
+
+	std::atomic<float> record{0.0f};
+
+	/// Queue submission, without the presentation
+	std::atomic<float> submit{0.0f};
+
+	/// Time blocked in the presentation of the swapchain image
+	std::atomic<float> present{0.0f};
+};
+
+/**
+ * @brief Counters of the render graph, its barriers are counted with the ones of the command buffers
+ */
+struct RenderGraphCounters
+{
+	/// Memory the transient attachments would need without aliasing, in bytes, as of the last compilation
+	std::atomic<uint64_t> attachment_memory{0};
+
+	/// Memory allocated for the transient attachments, in bytes, as of the last compilation
+	std::atomic<uint64_t> allocated_memory{0};
+};
+
+/**
+ * @brief Counters of the pipeline barriers in the command buffers submitted by the render context,
+ *        accumulated until read back by the stats
+ */
+struct BarrierCounters
+{
+	std::atomic<uint32_t> barriers{0};
+
+	/// Number of pipeline barrier commands the barriers were batched in
+	std::atomic<uint32_t> barrier_calls{0};
+};
+
 // Per-statistic graph data
 class StatGraphData
 {
@@ -54,6 +54,20 @@ std::map<StatIndex, StatGraphData> StatsProvider::default_graph_map{
     {StatIndex::gpu_ext_write_stalls,  {"External Write Stalls",                       "{:4.1f} M/s",   static_cast<float>(1e-6)}},
     {StatIndex::gpu_ext_read_bytes,    {"External Read Bytes",                         "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
     {StatIndex::gpu_ext_write_bytes,   {"External Write Bytes",                        "{:4.1f} MiB/s", 1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::drawn_submeshes,       {"Drawn Submeshes",                             "{:4.0f}"}},
+    {StatIndex::culled_submeshes,      {"Culled Submeshes",                            "{:4.0f}"}},
+    {StatIndex::descriptor_sets_created, {"Descriptor Sets Created",                   "{:4.0f}"}},
+    {StatIndex::descriptor_sets_reused,  {"Descriptor Sets Reused",                    "{:4.0f}"}},
+    {StatIndex::descriptor_sets_retired, {"Descriptor Sets Retired",                   "{:4.0f}"}},
+    {StatIndex::frame_update_time,      {"Scene Update",                               "{:3.1f} ms"}},
+    {StatIndex::frame_update_wait_time, {"Scene Update Wait",                          "{:3.1f} ms"}},
+    {StatIndex::frame_acquire_time,     {"Acquire",                                    "{:3.1f} ms"}},
+    {StatIndex::frame_record_time,      {"Record",                                     "{:3.1f} ms"}},
+    {StatIndex::frame_submit_time,      {"Submit",                                     "{:3.1f} ms"}},
+    {StatIndex::frame_present_time,     {"Present Wait",                               "{:3.1f} ms"}},
+    {StatIndex::render_graph_memory_saved,  {"Attachment Memory Saved",                "{:4.1f} MiB", 1.0f / (1024.0f * 1024.0f)}},
+    {StatIndex::barriers,              {"Barriers",                                    "{:4.0f}"}},
+    {StatIndex::barrier_calls,         {"Barrier Calls",                               "{:4.0f}"}},
     // clang-format on
 };
 
@@ -364,6 +364,7 @@ void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 		// Perform a barrier to ensure all previous commands complete before ending the query
 		// This does not block later commands from executing as we use BOTTOM_OF_PIPE in the
 		// dst stage mask
+		cb.flush_barriers();
 		vkCmdPipelineBarrier(cb.get_handle(),
 		                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
 		                     VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
@@ -26,6 +26,9 @@
 #include "scene_graph/components/camera.h"
 #include "scene_graph/scripts/animation.h"
 
+#include <ctpl_stl.h>
+#include <future>
+
 #if defined(PLATFORM__MACOS)
 #include <TargetConditionals.h>
 #endif
@@ -280,8 +283,11 @@ class VulkanSample : public vkb::Application
 	 * @brief Loads the scene
 	 *
 	 * @param path The path of the glTF file
+	 * @param use_mesh_arenas Packs the geometry into a few device-local buffers, see GLTFLoader::set_mesh_arenas_enabled()
+	 *
+	 * Large transform hierarchies and animations of the scene are updated on a pool of threads, see sg::Scene::set_thread_count().
 	 */
-	void load_scene(const std::string &path);
+	void load_scene(const std::string &path, bool use_mesh_arenas = false);
 
 	/**
 	 * @brief Additional sample initialization
@@ -306,6 +312,14 @@ class VulkanSample : public vkb::Application
 
 	void set_render_pipeline(std::unique_ptr<RenderPipelineType> &&render_pipeline);
 
+	/**
+	 * @brief Sets whether the scene of the next frame is updated on a worker thread while the current frame is recorded and submitted
+	 * When enabled, scripts and animations run one frame ahead, and rendering reads the world matrices published at the start of the frame.
+	 * Only suitable for samples which do not modify the scene from draw_gui() or while drawing, and whose scripts do not add or reparent nodes.
+	 * @param enable If true, the scene update overlaps the rendering. Default state is false, where the scene is updated before rendering.
+	 */
+	void set_pipelined_update(bool enable);
+
 	/**
 	 * @brief Main loop sample events
 	 */
@@ -329,6 +343,11 @@ class VulkanSample : public vkb::Application
 	 */
 	void update_stats(float delta_time);
 
+	/**
+	 * @brief Blocks until the worker has finished updating the scene of the next frame, if pipelined
+	 */
+	void wait_for_scene_update();
+
 	/**
 	 * @brief Set viewport and scissor state in command buffer for a given extent
 	 */
@@ -423,11 +442,23 @@ class VulkanSample : public vkb::Application
 	bool high_priority_graphics_queue{false};
 
 	std::unique_ptr<vkb::core::HPPDebugUtils> debug_utils;
+
+	/** @brief Whether the scene update of the next frame overlaps the rendering of the current one */
+	bool pipelined_update{false};
+
+	/** @brief Single worker running the pipelined scene updates */
+	std::unique_ptr<ctpl::thread_pool> scene_update_thread;
+
+	/** @brief The pending or finished scene update of the next frame, not valid until the first pipelined frame */
+	std::future<void> scene_update;
 };
 
 template <vkb::BindingType bindingType>
 inline VulkanSample<bindingType>::~VulkanSample()
 {
+	wait_for_scene_update();
+	scene_update_thread.reset();
+
 	if (device)
 	{
 		device->get_handle().waitIdle();
@@ -625,10 +656,24 @@ inline void VulkanSample<bindingType>::draw_renderpass_impl(vkb::core::HPPComman
 
 	if (gui)
 	{
-		gui->draw(command_buffer);
+		// A subpass recorded in secondary command buffers can't have inline commands, so the gui gets its own
+		if (render_pipeline && render_pipeline->get_last_subpass_contents() == vk::SubpassContents::eSecondaryCommandBuffers)
+		{
+			auto &primary_command_buffer   = reinterpret_cast<vkb::CommandBuffer &>(command_buffer);
+			auto &secondary_command_buffer = primary_command_buffer.begin_secondary_command_buffer();
+
+			gui->draw(reinterpret_cast<vkb::core::HPPCommandBuffer &>(secondary_command_buffer));
+
+			secondary_command_buffer.end();
+			primary_command_buffer.execute_commands(secondary_command_buffer);
+		}
+		else
+		{
+			gui->draw(command_buffer);
+		}
 	}
 
-	command_buffer.get_handle().endRenderPass();
+	command_buffer.end_render_pass();
 }
 
 template <vkb::BindingType bindingType>
@@ -636,6 +681,8 @@ inline void VulkanSample<bindingType>::finish()
 {
 	Parent::finish();
 
+	wait_for_scene_update();
+
 	if (device)
 	{
 		device->get_handle().waitIdle();
@@ -911,7 +958,9 @@ inline void VulkanSample<bindingType>::input_event(const InputEvent &input_event
 	{
 		if (scene && scene->has_component<sg::Script>())
 		{
-			auto scripts = scene->get_components<sg::Script>();
+			wait_for_scene_update();
+
+			auto scripts = scene->get_component_view<sg::Script>();
 
 			for (auto script : scripts)
 			{
@@ -932,9 +981,16 @@ inline void VulkanSample<bindingType>::input_event(const InputEvent &input_event
 }
 
 template <vkb::BindingType bindingType>
-inline void VulkanSample<bindingType>::load_scene(const std::string &path)
+inline void VulkanSample<bindingType>::load_scene(const std::string &path, bool use_mesh_arenas)
 {
 	vkb::HPPGLTFLoader loader(*device);
+	loader.set_mesh_arenas_enabled(use_mesh_arenas);
+
+	// The pending update belongs to the previous scene
+	if (scene_update.valid())
+	{
+		scene_update.get();
+	}
 
 	scene = loader.read_scene_from_file(path);
 
@@ -943,6 +999,9 @@ inline void VulkanSample<bindingType>::load_scene(const std::string &path)
 		LOGE("Cannot load scene: {}", path.c_str());
 		throw std::runtime_error("Cannot load scene: " + path);
 	}
+
+	// Small hierarchies and animations stay on the calling thread, see TransformHierarchy and sg::Animation
+	scene->set_thread_count(std::thread::hardware_concurrency());
 }
 
 template <vkb::BindingType bindingType>
@@ -1163,7 +1222,9 @@ inline bool VulkanSample<bindingType>::resize(uint32_t width, uint32_t height)
 
 	if (scene && scene->has_component<sg::Script>())
 	{
-		auto scripts = scene->get_components<sg::Script>();
+		wait_for_scene_update();
+
+		auto scripts = scene->get_component_view<sg::Script>();
 
 		for (auto script : scripts)
 		{
@@ -1216,6 +1277,28 @@ inline void VulkanSample<bindingType>::set_render_pipeline(std::unique_ptr<Rende
 	}
 }
 
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::set_pipelined_update(bool enable)
+{
+	if (!enable)
+	{
+		// Finish the update in flight, the scene is then updated again before each frame is rendered
+		if (scene_update.valid())
+		{
+			scene_update.get();
+		}
+
+		scene_update_thread.reset();
+
+		if (scene)
+		{
+			scene->get_transform_hierarchy().set_double_buffered(false);
+		}
+	}
+
+	pipelined_update = enable;
+}
+
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::set_viewport_and_scissor(CommandBufferType const &command_buffer, Extent2DType const &extent)
 {
@@ -1239,15 +1322,60 @@ inline void VulkanSample<bindingType>::set_viewport_and_scissor_impl(vkb::core::
 template <vkb::BindingType bindingType>
 inline void VulkanSample<bindingType>::update(float delta_time)
 {
-	update_scene(delta_time);
+	auto &timings = render_context->get_frame_phase_timings();
+
+	Timer timer;
+	timer.start();
+
+	bool pipelined = pipelined_update && scene;
+
+	if (pipelined && scene_update.valid())
+	{
+		// The worker updated the scene of this frame while the previous one was rendered
+		scene_update.get();
+		timings.update_wait = static_cast<float>(timer.stop<Timer::Milliseconds>());
+	}
+	else
+	{
+		update_scene(delta_time);
+		timings.update      = static_cast<float>(timer.stop<Timer::Milliseconds>());
+		timings.update_wait = timings.update.load();
+	}
+
+	if (pipelined)
+	{
+		// Snapshot the world matrices this frame renders, before the worker moves on to the next frame
+		scene->get_transform_hierarchy().set_double_buffered(true);
+		scene->publish_transforms();
+	}
 
 	update_gui(delta_time);
 
+	if (pipelined)
+	{
+		if (!scene_update_thread)
+		{
+			scene_update_thread = std::make_unique<ctpl::thread_pool>(1);
+		}
+
+		scene_update = scene_update_thread->push([this, delta_time, &timings](size_t) {
+			Timer update_timer;
+			update_timer.start();
+
+			update_scene(delta_time);
+
+			timings.update = static_cast<float>(update_timer.stop<Timer::Milliseconds>());
+		});
+	}
+
+	timer.start();
 	auto &command_buffer = render_context->begin();
+	timings.acquire      = static_cast<float>(timer.stop<Timer::Milliseconds>());
 
 	// Collect the performance data for the sample graphs
 	update_stats(delta_time);
 
+	timer.start();
 	command_buffer.begin(vk::CommandBufferUsageFlagBits::eOneTimeSubmit);
 	stats->begin_sampling(command_buffer);
 
@@ -1263,8 +1391,12 @@ inline void VulkanSample<bindingType>::update(float delta_time)
 
 	stats->end_sampling(command_buffer);
 	command_buffer.end();
+	timings.record = static_cast<float>(timer.stop<Timer::Milliseconds>());
 
+	// The render context measures the presentation, which is part of the submission
+	timer.start();
 	render_context->submit(command_buffer);
+	timings.submit = static_cast<float>(timer.stop<Timer::Milliseconds>()) - timings.present.load();
 }
 
 template <vkb::BindingType bindingType>
@@ -1290,7 +1422,7 @@ inline void VulkanSample<bindingType>::update_debug_window()
 		{
 			if (auto camera_node = camera->get_node())
 			{
-				const glm::vec3 &pos = camera_node->get_transform().get_translation();
+				glm::vec3 pos = glm::vec3(camera_node->get_transform().get_world_matrix()[3]);
 				get_debug_info().template insert<field::Vector, float>("camera_pos", pos.x, pos.y, pos.z);
 			}
 		}
@@ -1326,7 +1458,7 @@ inline void VulkanSample<bindingType>::update_scene(float delta_time)
 		// Update scripts
 		if (scene->has_component<sg::Script>())
 		{
-			auto scripts = scene->get_components<sg::Script>();
+			auto scripts = scene->get_component_view<sg::Script>();
 
 			for (auto script : scripts)
 			{
@@ -1337,13 +1469,26 @@ inline void VulkanSample<bindingType>::update_scene(float delta_time)
 		// Update animations
 		if (scene->has_component<sg::Animation>())
 		{
-			auto animations = scene->get_components<sg::Animation>();
+			auto animations = scene->get_component_view<sg::Animation>();
 
 			for (auto animation : animations)
 			{
 				animation->update(delta_time);
 			}
 		}
+
+		// Compute the world matrices once, before any subpass reads them
+		scene->update_transforms();
+	}
+}
+
+template <vkb::BindingType bindingType>
+inline void VulkanSample<bindingType>::wait_for_scene_update()
+{
+	// Scripts must not be accessed while the worker updates them
+	if (scene_update.valid())
+	{
+		scene_update.wait();
 	}
 }
 
@@ -17,12 +17,11 @@
 
 #include "mobile_nerf.h"
 #include "filesystem/legacy.h"
+#include "geometry/gltf.hpp"
 #include "glm/gtx/matrix_decompose.hpp"
-#include "gltf_loader.h"
 #include "platform/platform.h"
 #include "rendering/subpasses/forward_subpass.h"
 #include "scene_graph/components/material.h"
-#include "scene_graph/components/mesh.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "stb_image.h"
 
@@ -45,36 +44,6 @@ struct RequestFeature
 	}
 };
 
-template <typename T>
-struct CopyBuffer
-{
-	std::vector<T> operator()(std::unordered_map<std::string, vkb::core::Buffer> &buffers, const char *buffer_name)
-	{
-		auto iter = buffers.find(buffer_name);
-		if (iter == buffers.cend())
-		{
-			return {};
-		}
-		auto &buffer = iter->second;
-
-		std::vector<T> out;
-
-		const size_t sz = buffer.get_size();
-		out.resize(sz / sizeof(T));
-		const bool already_mapped = buffer.get_data() != nullptr;
-		if (!already_mapped)
-		{
-			buffer.map();
-		}
-		memcpy(&out[0], buffer.get_data(), sz);
-		if (!already_mapped)
-		{
-			buffer.unmap();
-		}
-		return out;
-	}
-};
-
 void camera_set_look_at(vkb::Camera &camera, const glm::vec3 look, const glm::vec3 up)
 {
 	auto view_matrix = glm::lookAt(camera.position, look, up);
@@ -804,8 +773,7 @@ void MobileNerf::load_scene(int model_index, int sub_model_index, int models_ent
 {
 	Model &model = models[models_entry];
 
-	vkb::GLTFLoader loader{get_device()};
-	int             total_sub_sub_model = using_original_nerf_models[model_index] ? 8 : 1;
+	int total_sub_sub_model = using_original_nerf_models[model_index] ? 8 : 1;
 
 	for (int sub_model = 0; sub_model < total_sub_sub_model; sub_model++)
 	{
@@ -818,46 +786,35 @@ void MobileNerf::load_scene(int model_index, int sub_model_index, int models_ent
 
 		LOGI("Parsing nerf obj {}", inputfile);
 
-		auto scene = loader.read_scene_from_file(inputfile);
+		// Only the geometry is needed, read it on the CPU instead of reading back GPU buffers
+		auto gltf_model = vkb::geometry::load_gltf_from_file(vkb::fs::path::get(vkb::fs::path::Type::Assets) + inputfile);
 
-		for (auto &&mesh : scene->get_components<vkb::sg::Mesh>())
+		for (auto &mesh : gltf_model.meshes)
 		{
-			for (auto &&sub_mesh : mesh->get_submeshes())
+			for (auto &primitive : mesh.primitives)
 			{
-				auto       pts_               = CopyBuffer<glm::vec3>{}(sub_mesh->vertex_buffers, "position");
-				const auto texcoord_          = CopyBuffer<glm::vec2>{}(sub_mesh->vertex_buffers, "texcoord_0");
 				const auto vertex_start_index = static_cast<uint32_t>(model.vertices.size());
 
 				// Copy vertex data
 				{
-					model.vertices.resize(vertex_start_index + pts_.size());
-					for (size_t i = 0; i < pts_.size(); ++i)
+					model.vertices.resize(vertex_start_index + primitive.positions.size());
+					for (size_t i = 0; i < primitive.positions.size(); ++i)
 					{
-						model.vertices[vertex_start_index + i].position  = pts_[i];
-						model.vertices[vertex_start_index + i].tex_coord = glm::vec2(texcoord_[i].x, 1.0f - texcoord_[i].y);
+						model.vertices[vertex_start_index + i].position  = primitive.positions[i];
+						model.vertices[vertex_start_index + i].tex_coord = glm::vec2(primitive.texcoords[i].x, 1.0f - primitive.texcoords[i].y);
 					}
 				}
 
 				// Copy index data
 				{
-					auto index_buffer_ = sub_mesh->index_buffer.get();
-					if (index_buffer_)
+					const size_t nTriangles           = primitive.indices.size() / 3;
+					const auto   triangle_start_index = static_cast<uint32_t>(model.indices.size());
+					model.indices.resize(triangle_start_index + nTriangles);
+					for (size_t i = 0; i < nTriangles; ++i)
 					{
-						assert(sub_mesh->index_type == VkIndexType::VK_INDEX_TYPE_UINT32);
-						const size_t sz                   = index_buffer_->get_size();
-						const size_t nTriangles           = sz / sizeof(uint32_t) / 3;
-						const auto   triangle_start_index = static_cast<uint32_t>(model.indices.size());
-						model.indices.resize(triangle_start_index + nTriangles);
-						auto ptr = index_buffer_->get_data();
-						assert(!!ptr);
-						std::vector<uint32_t> tempBuffer(nTriangles * 3);
-						memcpy(&tempBuffer[0], ptr, sz);
-						for (size_t i = 0; i < nTriangles; ++i)
-						{
-							model.indices[triangle_start_index + i] = {vertex_start_index + uint32_t(tempBuffer[3 * i]),
-							                                           vertex_start_index + uint32_t(tempBuffer[3 * i + 1]),
-							                                           vertex_start_index + uint32_t(tempBuffer[3 * i + 2])};
-						}
+						model.indices[triangle_start_index + i] = {vertex_start_index + primitive.indices[3 * i],
+						                                           vertex_start_index + primitive.indices[3 * i + 1],
+						                                           vertex_start_index + primitive.indices[3 * i + 2]};
 					}
 				}
 			}
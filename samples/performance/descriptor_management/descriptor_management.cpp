@@ -34,6 +34,9 @@ DescriptorManagement::DescriptorManagement()
 
 	config.insert<vkb::IntSetting>(1, descriptor_caching.value, 1);
 	config.insert<vkb::IntSetting>(1, buffer_allocation.value, 1);
+
+	// Lets the framework write descriptor sets with update templates when caching is disabled
+	add_device_extension(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME, true);
 }
 
 bool DescriptorManagement::prepare(const vkb::ApplicationOptions &options)
@@ -58,7 +61,7 @@ bool DescriptorManagement::prepare(const vkb::ApplicationOptions &options)
 	set_render_pipeline(std::move(render_pipeline));
 
 	// Add a GUI with the stats you want to monitor
-	get_stats().request_stats({vkb::StatIndex::frame_times});
+	get_stats().request_stats({vkb::StatIndex::frame_times, vkb::StatIndex::descriptor_sets_created, vkb::StatIndex::descriptor_sets_reused});
 	create_gui(*window, &get_stats());
 
 	return true;
@@ -83,9 +86,19 @@ void DescriptorManagement::update(float delta_time)
 
 	render_context.get_active_frame().set_buffer_allocation_strategy(buffer_alloc_strategy);
 
-	auto descriptor_management_strategy = (descriptor_caching.value == 0) ?
-	                                          vkb::DescriptorManagementStrategy::CreateDirectly :
-	                                          vkb::DescriptorManagementStrategy::StoreInCache;
+	auto descriptor_management_strategy = vkb::DescriptorManagementStrategy::CreateDirectly;
+	if (descriptor_caching.value == 1)
+	{
+		descriptor_management_strategy = vkb::DescriptorManagementStrategy::StoreInCache;
+	}
+	else if (descriptor_caching.value == 2)
+	{
+		descriptor_management_strategy = vkb::DescriptorManagementStrategy::CreateDirectlyWithTemplate;
+	}
+	else if (descriptor_caching.value == 3)
+	{
+		descriptor_management_strategy = vkb::DescriptorManagementStrategy::CacheAcrossFrames;
+	}
 
 	render_context.get_active_frame().set_descriptor_management_strategy(descriptor_management_strategy);
 
@@ -46,7 +46,7 @@ class DescriptorManagement : public vkb::VulkanSample<vkb::BindingType::C>
 
 	RadioButtonGroup descriptor_caching{
 	    "Descriptor set caching",
-	    {"Disabled", "Enabled"},
+	    {"Disabled", "Enabled", "Disabled (update templates)", "Enabled (across frames)"},
 	    0};
 
 	RadioButtonGroup buffer_allocation{
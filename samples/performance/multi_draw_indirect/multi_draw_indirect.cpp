@@ -24,8 +24,13 @@
 #include "scene_graph/components/mesh.h"
 #include "scene_graph/components/pbr_material.h"
 
+#include <thread>
+
 namespace
 {
+/// Planes of vkb::Frustum tested by the CPU culling: left, right, back and front. The culling shaders skip the y planes as well
+constexpr uint32_t CULL_PLANES = 0x33;
+
 template <typename T>
 struct CopyBuffer
 {
@@ -89,6 +94,7 @@ MultiDrawIndirect::~MultiDrawIndirect()
 		device_address_buffer.reset();
 
 		cpu_staging_buffer.reset();
+		cpu_indirect_buffers.clear();
 		indirect_call_buffer.reset();
 	}
 }
@@ -152,6 +158,11 @@ void MultiDrawIndirect::build_command_buffers()
 	render_pass_begin_info.clearValueCount          = 2;
 	render_pass_begin_info.pClearValues             = clear_values;
 
+	if (cpu_indirect_buffers.size() != draw_cmd_buffers.size())
+	{
+		create_cpu_indirect_buffers();
+	}
+
 	for (size_t i = 0; i < draw_cmd_buffers.size(); ++i)
 	{
 		render_pass_begin_info.framebuffer = framebuffers[i];
@@ -174,15 +185,18 @@ void MultiDrawIndirect::build_command_buffers()
 		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 0, 1, vertex_buffer->get(), offsets);
 		vkCmdBindVertexBuffers(draw_cmd_buffers[i], 1, 1, model_information_buffer->get(), offsets);
 
+		// The CPU culls the commands of each command buffer in its own buffer
+		VkBuffer indirect_buffer = render_mode == RenderMode::CPU ? cpu_indirect_buffers[i]->get_handle() : indirect_call_buffer->get_handle();
+
 		if (m_enable_mdi && m_supports_mdi)
 		{
-			vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_call_buffer->get_handle(), 0, cpu_commands.size(), sizeof(cpu_commands[0]));
+			vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_buffer, 0, cpu_commands.size(), sizeof(cpu_commands[0]));
 		}
 		else
 		{
 			for (size_t j = 0; j < cpu_commands.size(); ++j)
 			{
-				vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_call_buffer->get_handle(), j * sizeof(cpu_commands[0]), 1, sizeof(cpu_commands[0]));
+				vkCmdDrawIndexedIndirect(draw_cmd_buffers[i], indirect_buffer, j * sizeof(cpu_commands[0]), 1, sizeof(cpu_commands[0]));
 			}
 		}
 
@@ -209,7 +223,11 @@ void MultiDrawIndirect::on_update_ui_overlay(vkb::Drawer &drawer)
 		if (render_mode == RenderMode::GPU || render_mode == RenderMode::GPU_DEVICE_ADDRESS)
 		{
 			// copy over the GPU-culled data to the CPU command so that we can count the number of instances
-			assert(!!indirect_call_buffer && !!cpu_staging_buffer && indirect_call_buffer->get_size() == cpu_staging_buffer->get_size());
+			if (!cpu_staging_buffer)
+			{
+				cpu_staging_buffer = std::make_unique<vkb::core::Buffer>(get_device(), indirect_call_buffer->get_size(), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU);
+			}
+			assert(!!indirect_call_buffer && indirect_call_buffer->get_size() == cpu_staging_buffer->get_size());
 			assert(cpu_commands.size() * sizeof(cpu_commands[0]) == cpu_staging_buffer->get_size());
 
 			auto &cmd = get_device().request_command_buffer();
@@ -222,11 +240,15 @@ void MultiDrawIndirect::on_update_ui_overlay(vkb::Drawer &drawer)
 			get_device().get_fence_pool().wait();
 
 			memcpy(cpu_commands.data(), cpu_staging_buffer->get_data(), cpu_staging_buffer->get_size());
-		}
 
-		for (auto &&cmd : cpu_commands)
+			for (auto &&cmd : cpu_commands)
+			{
+				instance_count += cmd.instanceCount;
+			}
+		}
+		else
 		{
-			instance_count += cmd.instanceCount;
+			instance_count = static_cast<uint32_t>(cpu_visible_count);
 		}
 		drawer.text("Instances: %d / %d", instance_count, 256);
 
@@ -292,6 +314,9 @@ bool MultiDrawIndirect::prepare(const vkb::ApplicationOptions &options)
 		}
 	}
 
+	// Only scenes with many thousands of models are split across threads
+	cpu_culler.set_thread_count(std::max(1u, std::thread::hardware_concurrency()));
+
 	create_samplers();
 	load_scene();
 	initialize_resources();
@@ -300,7 +325,6 @@ bool MultiDrawIndirect::prepare(const vkb::ApplicationOptions &options)
 	create_compute_pipeline();
 	initialize_descriptors();
 	build_command_buffers();
-	cpu_cull();        // initialize buffer
 	run_cull();
 
 	prepared = true;
@@ -479,9 +503,24 @@ void MultiDrawIndirect::initialize_resources()
 		*destPtr = srcPtr;
 	}
 
+	// The commands only differ by their instance count between frames
+	cpu_commands.resize(models.size());
+	cpu_bounding_spheres.clear();
+	cpu_bounding_spheres.reserve(models.size());
+
 	for (size_t i = 0; i < models.size(); ++i)
 	{
 		auto &model = models[i];
+
+		VkDrawIndexedIndirectCommand &command = cpu_commands[i];
+		command.firstIndex                    = model.index_buffer_offset / (sizeof(model.triangles[0][0]));
+		command.indexCount                    = static_cast<uint32_t>(model.triangles.size()) * 3;
+		command.vertexOffset                  = static_cast<int32_t>(model.vertex_buffer_offset / sizeof(Vertex));
+		command.firstInstance                 = i;
+		command.instanceCount                 = 1;
+
+		cpu_bounding_spheres.push_back(model.bounding_sphere.center, model.bounding_sphere.radius);
+
 		staging_vertex_buffer.update(model.vertices.data(), model.vertices.size() * sizeof(Vertex), model.vertex_buffer_offset);
 		staging_index_buffer.update(model.triangles.data(), model.triangles.size() * sizeof(model.triangles[0]), model.index_buffer_offset);
 
@@ -498,8 +537,20 @@ void MultiDrawIndirect::initialize_resources()
 	staging_index_buffer.flush();
 	staging_model_buffer.flush();
 
+	auto staging_command_buffer = vkb::core::Buffer::create_staging_buffer(get_device(), cpu_commands);
+
 	auto &cmd = get_device().request_command_buffer();
 	cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, VK_NULL_HANDLE);
+
+	// The GPU culling only writes the instance counts
+	cmd.copy_buffer(staging_command_buffer, *indirect_call_buffer, staging_command_buffer.get_size());
+
+	vkb::BufferMemoryBarrier command_barrier;
+	command_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	command_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+	command_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	command_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+	cmd.buffer_memory_barrier(*indirect_call_buffer, 0, VK_WHOLE_SIZE, command_barrier);
 	auto copy = [this, &cmd](vkb::core::Buffer &staging_buffer, VkBufferUsageFlags buffer_usage_flags) {
 		auto output_buffer = std::make_unique<vkb::core::Buffer>(get_device(), staging_buffer.get_size(), buffer_usage_flags | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT, queue_families);
 		cmd.copy_buffer(staging_buffer, *output_buffer, staging_buffer.get_size());
@@ -765,6 +816,11 @@ void MultiDrawIndirect::draw()
 {
 	ApiVulkanSample::prepare_frame();
 
+	if (render_mode == RenderMode::CPU)
+	{
+		cpu_cull();
+	}
+
 	// Command buffer to be submitted to the queue
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
@@ -814,7 +870,8 @@ void MultiDrawIndirect::run_cull()
 	switch (render_mode)
 	{
 		case RenderMode::CPU:
-			cpu_cull();
+			// Culling happens in draw(), once the command buffer of the frame is known
+			cpu_frustum.update(scene_uniform.proj * scene_uniform.view);
 			break;
 		case RenderMode::GPU:
 		case RenderMode::GPU_DEVICE_ADDRESS:
@@ -859,93 +916,32 @@ void MultiDrawIndirect::run_gpu_cull()
 	vkFreeCommandBuffers(get_device().get_handle(), get_device().get_command_pool().get_handle(), 1, &cmd);
 }
 
-namespace
+void MultiDrawIndirect::create_cpu_indirect_buffers()
 {
-/**
- * @brief Test for visibility using bounding sphere.
- * See https://www.gamedevs.org/uploads/fast-extraction-viewing-frustum-planes-from-world-view-projection-matrix.pdf
- */
-struct VisibilityTester
-{
-	explicit VisibilityTester(glm::mat4x4 view_matrix) :
-	    planes(get_view_planes(view_matrix))
-	{}
-	std::array<glm::vec4, 6> planes;
+	cpu_indirect_buffers.clear();
 
-	static std::array<glm::vec4, 6> get_view_planes(const glm::mat4x4 &mat)
-	{
-		using namespace glm;
-		std::array<vec4, 6> out{};
-		for (auto i = 0; i < 3; ++i)
-		{
-			for (size_t j = 0; j < 2; ++j)
-			{
-				const float sign = j ? 1.f : -1.f;
-				for (auto k = 0; k < 4; ++k)
-				{
-					out[2 * i + j][k] = mat[k][3] + sign * mat[k][i];
-				}
-			}
-		}
-
-		// normalize plane; see Appendix A.2
-		for (auto &&plane : out)
-		{
-			plane /= float(length(vec3(plane.xyz)));
-		}
-		return out;
-	}
-
-	bool is_visible(glm::vec3 origin, float radius) const
+	for (size_t i = 0; i < draw_cmd_buffers.size(); ++i)
 	{
-		using namespace glm;
-		std::array<int, 4> V{0, 1, 4, 5};
-		return std::all_of(V.begin(), V.end(), [this, origin, radius](size_t i) {
-			const auto &plane = planes[i];
-			return dot(origin, vec3(plane.xyz)) + plane.w + radius >= 0;
-		});
+		// Written sequentially by the CPU and read directly by the GPU
+		auto buffer = std::make_unique<vkb::core::Buffer>(get_device(),
+		                                                  cpu_commands.size() * sizeof(cpu_commands[0]),
+		                                                  VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+		                                                  VMA_MEMORY_USAGE_CPU_TO_GPU,
+		                                                  VMA_ALLOCATION_CREATE_MAPPED_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
+		buffer->update(cpu_commands);
+		cpu_indirect_buffers.push_back(std::move(buffer));
 	}
-};
-
-}        // namespace
+}
 
 void MultiDrawIndirect::cpu_cull()
 {
-	cpu_commands.resize(models.size());
-
-	VisibilityTester tester(scene_uniform.proj * scene_uniform.view);
-	for (size_t i = 0; i < models.size(); ++i)
-	{
-		// we control visibility by changing the instance count
-		auto                        &model = models[i];
-		VkDrawIndexedIndirectCommand cmd{};
-		cmd.firstIndex    = model.index_buffer_offset / (sizeof(model.triangles[0][0]));
-		cmd.indexCount    = static_cast<uint32_t>(model.triangles.size()) * 3;
-		cmd.vertexOffset  = static_cast<int32_t>(model.vertex_buffer_offset / sizeof(Vertex));
-		cmd.firstInstance = i;
-		cmd.instanceCount = tester.is_visible(model.bounding_sphere.center, model.bounding_sphere.radius);
-		cpu_commands[i]   = cmd;
-	}
-
-	const auto call_buffer_size = cpu_commands.size() * sizeof(cpu_commands[0]);
-	assert(!!indirect_call_buffer && indirect_call_buffer->get_size() == call_buffer_size);
+	// The previous submission of this command buffer has completed, so its commands can be overwritten
+	auto &buffer   = *cpu_indirect_buffers[current_buffer];
+	auto  commands = reinterpret_cast<VkDrawIndexedIndirectCommand *>(buffer.map());
 
-	if (!cpu_staging_buffer || cpu_staging_buffer->get_size() != call_buffer_size)
-	{
-		cpu_staging_buffer = std::make_unique<vkb::core::Buffer>(get_device(), models.size() * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-	}
-
-	cpu_staging_buffer->update(cpu_commands.data(), call_buffer_size, 0);
-	cpu_staging_buffer->flush();
-
-	auto &transfer_cmd = get_device().get_command_pool().request_command_buffer();
-	transfer_cmd.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, VK_NULL_HANDLE);
-	transfer_cmd.copy_buffer(*cpu_staging_buffer, *indirect_call_buffer, call_buffer_size);
-	transfer_cmd.end();
-
-	auto &queue = get_device().get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-	queue.submit(transfer_cmd, get_device().request_fence());
-	get_device().get_fence_pool().wait();
+	// Only the instance counts are written, there is no staging buffer, transfer or wait
+	cpu_visible_count = cpu_culler.cull(cpu_frustum.get_planes(), CULL_PLANES, cpu_bounding_spheres, &commands[0].instanceCount, sizeof(VkDrawIndexedIndirectCommand));
+	buffer.flush();
 }
 
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_multi_draw_indirect()
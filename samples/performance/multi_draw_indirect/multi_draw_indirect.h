@@ -18,6 +18,8 @@
 #pragma once
 
 #include "api_vulkan_sample.h"
+#include "geometry/culling.hpp"
+#include "geometry/frustum.h"
 
 /**
  * @brief Offloading processes from CPU to GPU
@@ -130,10 +132,18 @@ class MultiDrawIndirect : public ApiVulkanSample
 
 	// CPU Draw Calls
 	void                                      cpu_cull();
+	void                                      create_cpu_indirect_buffers();
 	std::vector<VkDrawIndexedIndirectCommand> cpu_commands;
 	std::unique_ptr<vkb::core::Buffer>        cpu_staging_buffer;
 	std::unique_ptr<vkb::core::Buffer>        indirect_call_buffer;
 
+	// One persistently mapped buffer of draw commands per command buffer, culled in place without any transfer
+	std::vector<std::unique_ptr<vkb::core::Buffer>> cpu_indirect_buffers;
+	vkb::geometry::BoundingSpheres                  cpu_bounding_spheres;
+	vkb::Frustum                                    cpu_frustum;
+	vkb::geometry::FrustumCuller                    cpu_culler;
+	size_t                                          cpu_visible_count = 0;
+
 	void request_gpu_features(vkb::PhysicalDevice &gpu) override;
 	void build_command_buffers() override;
 	void on_update_ui_overlay(vkb::Drawer &drawer) override;
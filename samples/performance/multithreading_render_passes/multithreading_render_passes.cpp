@@ -531,8 +531,7 @@ vkb::PipelineLayout &MultithreadingRenderPasses::ShadowSubpass::prepare_pipeline
 	assert(!shader_modules.empty());
 	auto vertex_shader_module = shader_modules[0];
 
-	vertex_shader_module->set_resource_mode("GlobalUniform", vkb::ShaderResourceMode::Dynamic);
-
+	// The batched GlobalUniform was made dynamic by GeometrySubpass::prepare()
 	return command_buffer.get_device().get_resource_cache().request_pipeline_layout({vertex_shader_module});
 }
 
@@ -102,7 +102,9 @@ bool PipelineBarriers::prepare(const vkb::ApplicationOptions &options)
 
 	get_stats().request_stats({vkb::StatIndex::frame_times,
 	                           vkb::StatIndex::gpu_vertex_cycles,
-	                           vkb::StatIndex::gpu_fragment_cycles},
+	                           vkb::StatIndex::gpu_fragment_cycles,
+	                           vkb::StatIndex::barriers,
+	                           vkb::StatIndex::barrier_calls},
 	                          vkb::CounterSamplingConfig{vkb::CounterSamplingMode::Continuous});
 
 	create_gui(*window, &get_stats());
@@ -77,6 +77,9 @@ void SpecializationConstants::ForwardSubpassCustomLights::prepare()
 
 			auto &vert_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_VERTEX_BIT, get_vertex_shader(), variant);
 			auto &frag_module = device.get_resource_cache().request_shader_module(VK_SHADER_STAGE_FRAGMENT_BIT, get_fragment_shader(), variant);
+
+			set_resource_modes(vert_module);
+			set_resource_modes(frag_module);
 		}
 	}
 }
@@ -58,7 +58,12 @@ bool SwapchainImages::prepare(const vkb::ApplicationOptions &options)
 
 	set_render_pipeline(std::move(render_pipeline));
 
-	get_stats().request_stats({vkb::StatIndex::frame_times});
+	get_stats().request_stats({vkb::StatIndex::frame_times,
+	                           vkb::StatIndex::frame_update_time,
+	                           vkb::StatIndex::frame_update_wait_time,
+	                           vkb::StatIndex::frame_acquire_time,
+	                           vkb::StatIndex::frame_record_time,
+	                           vkb::StatIndex::frame_present_time});
 	create_gui(*window, &get_stats());
 
 	return true;
@@ -77,6 +82,13 @@ void SwapchainImages::update(float delta_time)
 		last_swapchain_image_count = swapchain_image_count;
 	}
 
+	if (pipelined_update != last_pipelined_update)
+	{
+		set_pipelined_update(pipelined_update);
+
+		last_pipelined_update = pipelined_update;
+	}
+
 	VulkanSample::update(delta_time);
 }
 
@@ -88,6 +100,7 @@ void SwapchainImages::draw_gui()
 		    ImGui::SameLine();
 		    ImGui::RadioButton("Triple buffering", &swapchain_image_count, 3);
 		    ImGui::SameLine();
+		    ImGui::Checkbox("Pipelined update", &pipelined_update);
 	    },
 	    /* lines = */ 1);
 }
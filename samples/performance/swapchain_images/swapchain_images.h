@@ -44,6 +44,10 @@ class SwapchainImages : public vkb::VulkanSample<vkb::BindingType::C>
 	int swapchain_image_count{3};
 
 	int last_swapchain_image_count{3};
+
+	bool pipelined_update{false};
+
+	bool last_pipelined_update{false};
 };
 
 std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_swapchain_images();
@@ -0,0 +1,282 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "transient_aliasing.h"
+
+#include <cmath>
+
+#include "core/device.h"
+#include "gltf_loader.h"
+#include "gui.h"
+#include "rendering/postprocessing_renderpass.h"
+#include "rendering/subpasses/geometry_subpass.h"
+#include "rendering/subpasses/lighting_subpass.h"
+#include "stats/stats.h"
+
+TransientAliasing::TransientAliasing()
+{
+	auto &config = get_configuration();
+
+	config.insert<vkb::BoolSetting>(0, gui_aliasing, false);
+	config.insert<vkb::BoolSetting>(1, gui_aliasing, true);
+}
+
+TransientAliasing::~TransientAliasing()
+{
+	if (has_device())
+	{
+		get_device().wait_idle();
+		render_graph.reset();
+	}
+}
+
+bool TransientAliasing::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!VulkanSample::prepare(options))
+	{
+		return false;
+	}
+
+	load_scene("scenes/sponza/Sponza01.gltf");
+
+	auto &camera_node = vkb::add_free_camera(get_scene(), "main_camera", get_render_context().get_surface_extent());
+	camera            = dynamic_cast<vkb::sg::PerspectiveCamera *>(&camera_node.get_component<vkb::sg::Camera>());
+
+	auto geometry_vs = vkb::ShaderSource{"deferred/geometry.vert"};
+	auto geometry_fs = vkb::ShaderSource{"deferred/geometry.frag"};
+
+	// The G-buffer pass draws into depth, albedo and normal, in this order
+	std::unique_ptr<vkb::Subpass> gbuffer_subpass =
+	    std::make_unique<vkb::GeometrySubpass>(get_render_context(), std::move(geometry_vs), std::move(geometry_fs), get_scene(), *camera);
+	gbuffer_subpass->set_output_attachments({1, 2});
+	gbuffer_pipeline.add_subpass(std::move(gbuffer_subpass));
+
+	// Clear and store all the G-buffer attachments
+	gbuffer_pipeline.set_load_store(std::vector<vkb::LoadStoreInfo>(3));
+
+	auto gbuffer_clear_value = vkb::gbuffer::get_clear_value();
+	gbuffer_clear_value.erase(gbuffer_clear_value.begin());
+	gbuffer_pipeline.set_clear_value(gbuffer_clear_value);
+
+	auto lighting_vs = vkb::ShaderSource{"deferred/lighting.vert"};
+	auto lighting_fs = vkb::ShaderSource{"deferred/lighting.frag"};
+
+	// The lighting pass draws into its own image and reads the G-buffer, only as input attachments
+	std::unique_ptr<vkb::Subpass> lighting_subpass =
+	    std::make_unique<vkb::LightingSubpass>(get_render_context(), std::move(lighting_vs), std::move(lighting_fs), *camera, get_scene());
+	lighting_subpass->set_input_attachments({1, 2, 3});
+	lighting_subpass->set_disable_depth_stencil_attachment(true);
+	lighting_pipeline.add_subpass(std::move(lighting_subpass));
+
+	outline_pipeline = std::make_unique<vkb::PostProcessingPipeline>(get_render_context(), vkb::ShaderSource{"postprocessing/postprocessing.vert"});
+	outline_pipeline->add_pass().add_subpass(vkb::ShaderSource{"postprocessing/outline.frag"});
+
+	chromatic_aberration_pipeline = std::make_unique<vkb::PostProcessingPipeline>(get_render_context(), vkb::ShaderSource{"postprocessing/postprocessing.vert"});
+	chromatic_aberration_pipeline->add_pass().add_subpass(vkb::ShaderSource{"postprocessing/chromatic_aberration.frag"});
+
+	render_graph = std::make_unique<vkb::RenderGraph>(get_render_context());
+
+	aliasing = gui_aliasing;
+	build_render_graph();
+
+	get_stats().request_stats({vkb::StatIndex::barriers,
+	                           vkb::StatIndex::barrier_calls,
+	                           vkb::StatIndex::render_graph_memory_saved});
+
+	create_gui(*window, &get_stats());
+
+	return true;
+}
+
+void TransientAliasing::prepare_render_context()
+{
+	// The frames only hold the swapchain image, the graph creates all the other attachments
+	get_render_context().prepare(1, [](vkb::core::Image &&swapchain_image) {
+		std::vector<vkb::core::Image> images;
+		images.push_back(std::move(swapchain_image));
+
+		return std::make_unique<vkb::RenderTarget>(std::move(images));
+	});
+}
+
+void TransientAliasing::build_render_graph()
+{
+	using ImageUsage = vkb::RenderGraph::ImageUsage;
+
+	render_graph->clear();
+	render_graph->set_aliasing(aliasing);
+
+	VkFormat depth_format = vkb::get_suitable_depth_format(get_device().get_gpu().get_handle());
+	VkFormat color_format = get_render_context().get_format();
+
+	swapchain_image = render_graph->import_image("Swapchain", VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+	auto depth    = render_graph->create_image("Depth", depth_format);
+	auto albedo   = render_graph->create_image("Albedo", VK_FORMAT_R8G8B8A8_UNORM);
+	auto normal   = render_graph->create_image("Normal", VK_FORMAT_A2B10G10R10_UNORM_PACK32);
+	auto lit      = render_graph->create_image("Lit", color_format);
+	auto outlined = render_graph->create_image("Outlined", color_format);
+
+	render_graph->add_pass("G-buffer")
+	    .write(depth, ImageUsage::DepthStencilAttachment)
+	    .write(albedo, ImageUsage::ColorAttachment)
+	    .write(normal, ImageUsage::ColorAttachment)
+	    .set_execute([this](vkb::CommandBuffer &command_buffer, vkb::RenderTarget *render_target) {
+		    set_viewport_and_scissor(command_buffer, render_target->get_extent());
+		    gbuffer_pipeline.draw(command_buffer, *render_target);
+		    command_buffer.end_render_pass();
+	    });
+
+	// Depth is only stored if the outline pass samples it
+	std::vector<vkb::LoadStoreInfo> lighting_load_store = vkb::gbuffer::get_load_all_store_swapchain();
+	lighting_load_store[1].store_op                     = outline ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	lighting_pipeline.set_load_store(lighting_load_store);
+
+	render_graph->add_pass("Lighting")
+	    .write(lit, ImageUsage::ColorAttachment)
+	    .read(depth, ImageUsage::InputAttachment)
+	    .read(albedo, ImageUsage::InputAttachment)
+	    .read(normal, ImageUsage::InputAttachment)
+	    .set_execute([this](vkb::CommandBuffer &command_buffer, vkb::RenderTarget *render_target) {
+		    set_viewport_and_scissor(command_buffer, render_target->get_extent());
+		    lighting_pipeline.draw(command_buffer, *render_target);
+		    command_buffer.end_render_pass();
+	    });
+
+	// The outline pass is always declared, the graph culls it when nothing reads its output
+	render_graph->add_pass("Outline")
+	    .read(depth, ImageUsage::Sampled)
+	    .read(lit, ImageUsage::Sampled)
+	    .write(outlined, ImageUsage::ColorAttachment)
+	    .set_execute([this, depth, lit](vkb::CommandBuffer &command_buffer, vkb::RenderTarget *render_target) {
+		    glm::vec4 near_far = {camera->get_far_plane(), camera->get_near_plane(), -1.0f, -1.0f};
+
+		    auto &outline_pass = outline_pipeline->get_pass(0);
+		    outline_pass.set_uniform_data(near_far);
+		    outline_pass.get_subpass(0)
+		        .bind_sampled_image("depth_sampler", render_graph->get_view(depth))
+		        .bind_sampled_image("color_sampler", render_graph->get_view(lit));
+
+		    outline_pipeline->draw(command_buffer, *render_target);
+		    command_buffer.end_render_pass();
+	    });
+
+	auto chromatic_aberration_input = outline ? outlined : lit;
+
+	render_graph->add_pass("Chromatic aberration")
+	    .read(chromatic_aberration_input, ImageUsage::Sampled)
+	    .write(swapchain_image, ImageUsage::ColorAttachment)
+	    .set_execute([this, chromatic_aberration_input](vkb::CommandBuffer &command_buffer, vkb::RenderTarget *render_target) {
+		    auto &chromatic_aberration_pass = chromatic_aberration_pipeline->get_pass(0);
+		    chromatic_aberration_pass.set_uniform_data(std::sin(elapsed_time));
+		    chromatic_aberration_pass.get_subpass(0)
+		        .bind_sampled_image("color_sampler", render_graph->get_view(chromatic_aberration_input));
+
+		    chromatic_aberration_pipeline->draw(command_buffer, *render_target);
+
+		    if (has_gui())
+		    {
+			    get_gui().draw(command_buffer);
+		    }
+
+		    command_buffer.end_render_pass();
+	    });
+
+	render_graph_outdated = true;
+}
+
+void TransientAliasing::set_viewport_and_scissor(vkb::CommandBuffer &command_buffer, const VkExtent2D &extent)
+{
+	VkViewport viewport{};
+	viewport.width    = static_cast<float>(extent.width);
+	viewport.height   = static_cast<float>(extent.height);
+	viewport.minDepth = 0.0f;
+	viewport.maxDepth = 1.0f;
+	command_buffer.set_viewport(0, {viewport});
+
+	VkRect2D scissor{};
+	scissor.extent = extent;
+	command_buffer.set_scissor(0, {scissor});
+}
+
+void TransientAliasing::update(float delta_time)
+{
+	elapsed_time += delta_time;
+
+	if (gui_outline != outline || gui_aliasing != aliasing)
+	{
+		outline  = gui_outline;
+		aliasing = gui_aliasing;
+
+		build_render_graph();
+	}
+
+	VulkanSample::update(delta_time);
+}
+
+bool TransientAliasing::resize(uint32_t width, uint32_t height)
+{
+	// The render targets of the passes drawing to the swapchain refer to its previous images
+	render_graph_outdated = true;
+
+	return VulkanSample::resize(width, height);
+}
+
+void TransientAliasing::draw(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target)
+{
+	auto &extent = render_target.get_extent();
+
+	if (render_graph_outdated || extent.width != render_graph->get_extent().width || extent.height != render_graph->get_extent().height)
+	{
+		render_graph->compile(extent);
+		render_graph_outdated = false;
+	}
+
+	// POI
+	//
+	// The passes only declare which images they read and write. From these, the graph transitions
+	// each image to the layout of its next use, batching the barriers needed before a pass in one call.
+	// The swapchain image contents are discarded, the acquire semaphore waits at the color attachment output stage.
+	//
+
+	render_graph->bind_imported_image(swapchain_image, render_target.get_views()[0],
+	                                  VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+
+	render_graph->execute(command_buffer);
+}
+
+void TransientAliasing::draw_gui()
+{
+	const float mib = 1024.0f * 1024.0f;
+
+	float attachment_memory = static_cast<float>(render_graph->get_attachment_memory()) / mib;
+	float allocated_memory  = static_cast<float>(render_graph->get_allocated_memory()) / mib;
+
+	get_gui().show_options_window(
+	    /* body = */ [this, attachment_memory, allocated_memory]() {
+		    ImGui::Checkbox("Outline", &gui_outline);
+		    ImGui::SameLine();
+		    ImGui::Checkbox("Alias transient attachments", &gui_aliasing);
+		    ImGui::Text("Attachments: %.1f MiB, allocated: %.1f MiB", attachment_memory, allocated_memory);
+	    },
+	    /* lines = */ 2);
+}
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_transient_aliasing()
+{
+	return std::make_unique<TransientAliasing>();
+}
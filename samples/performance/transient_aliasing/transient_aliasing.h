@@ -0,0 +1,87 @@
+/* Copyright (c) 2024, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "rendering/postprocessing_pipeline.h"
+#include "rendering/render_graph.h"
+#include "rendering/render_pipeline.h"
+#include "scene_graph/components/perspective_camera.h"
+#include "vulkan_sample.h"
+
+/**
+ * @brief Deferred rendering followed by two post-processing passes, declared as a render graph
+ *
+ * The graph culls the outline pass when it is disabled, records the barriers between the passes,
+ * and aliases the G-buffer attachments with the ones of the post-processing passes.
+ */
+class TransientAliasing : public vkb::VulkanSample<vkb::BindingType::C>
+{
+  public:
+	TransientAliasing();
+
+	virtual ~TransientAliasing();
+
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+
+	virtual void update(float delta_time) override;
+
+	virtual bool resize(uint32_t width, uint32_t height) override;
+
+  private:
+	vkb::sg::PerspectiveCamera *camera{nullptr};
+
+	virtual void prepare_render_context() override;
+
+	void draw(vkb::CommandBuffer &command_buffer, vkb::RenderTarget &render_target) override;
+
+	virtual void draw_gui() override;
+
+	/**
+	 * @brief Declares the passes and images of the frame, the graph is compiled by the next draw
+	 */
+	void build_render_graph();
+
+	void set_viewport_and_scissor(vkb::CommandBuffer &command_buffer, const VkExtent2D &extent);
+
+	std::unique_ptr<vkb::RenderGraph> render_graph;
+
+	vkb::RenderGraph::ImageHandle swapchain_image{0};
+
+	/// Set when the graph must be compiled again, e.g. because the swapchain was recreated
+	bool render_graph_outdated{true};
+
+	vkb::RenderPipeline gbuffer_pipeline;
+
+	vkb::RenderPipeline lighting_pipeline;
+
+	std::unique_ptr<vkb::PostProcessingPipeline> outline_pipeline;
+
+	std::unique_ptr<vkb::PostProcessingPipeline> chromatic_aberration_pipeline;
+
+	float elapsed_time{0.0f};
+
+	bool outline{true};
+
+	bool gui_outline{true};
+
+	bool aliasing{true};
+
+	bool gui_aliasing{true};
+};
+
+std::unique_ptr<vkb::VulkanSample<vkb::BindingType::C>> create_transient_aliasing();